@@ -0,0 +1,91 @@
+#define _POSIX_C_SOURCE 199309L
+
+#include "clovo/cluster.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// corpus sizes timed, the largest is what an audit of a big leak looks like
+static const size_t sizes[] = {250000, 500000, 1000000, 2000000};
+#define BASE_WORDS 50000
+
+static double now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static uint64_t splitmix64(uint64_t *state) {
+  uint64_t z = (*state += 0x9e3779b97f4a7c15ULL);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+// a leak-like line: a third are variations on a shared base word
+// ("Falcon1987!", "falcon1988"), the rest random
+static size_t make_line(uint64_t *state, char bases[][9], char *out) {
+  static const char chars[] =
+      "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+  uint64_t r = splitmix64(state);
+  if (r % 3 == 0) {
+    const char *base = bases[(r >> 8) % BASE_WORDS];
+    int year = 1970 + (int)((r >> 32) % 56);
+    int len = snprintf(out, 32, "%s%d%s", base, year,
+                       (r >> 40) & 1 ? "!" : "");
+    if ((r >> 41) & 1)
+      out[0] = (char)(out[0] - 'a' + 'A');
+    return (size_t)len;
+  }
+  size_t len = 8 + r % 7;
+  for (size_t i = 0; i < len; i++)
+    out[i] = chars[splitmix64(state) % (sizeof(chars) - 1)];
+  out[len] = '\0';
+  return len;
+}
+
+int main(void) {
+  static char bases[BASE_WORDS][9];
+  uint64_t state = 11;
+  for (int b = 0; b < BASE_WORDS; b++) {
+    int len = 5 + (int)(splitmix64(&state) % 4);
+    for (int i = 0; i < len; i++)
+      bases[b][i] = (char)('a' + splitmix64(&state) % 26);
+    bases[b][len] = '\0';
+  }
+
+  printf("cluster_corpus, synthetic leak (1/3 base-word families)\n");
+  printf("  %9s %10s %10s %10s %9s\n", "lines", "add ms", "build ms",
+         "ns/line", "clusters");
+
+  for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+    cluster_corpus_t *corpus = cluster_corpus_create();
+    if (!corpus)
+      return 1;
+
+    char line[32];
+    double start = now_ns();
+    for (size_t i = 0; i < sizes[s]; i++) {
+      size_t len = make_line(&state, bases, line);
+      if (cluster_corpus_add(corpus, line, len) != GEN_SUCCESS) {
+        fprintf(stderr, "Error: add failed\n");
+        return 1;
+      }
+    }
+    double added = now_ns();
+    if (cluster_corpus_build(corpus, 2) != GEN_SUCCESS) {
+      fprintf(stderr, "Error: build failed\n");
+      return 1;
+    }
+    double built = now_ns();
+
+    printf("  %9zu %10.1f %10.1f %10.0f %9zu\n", sizes[s],
+           (added - start) / 1e6, (built - added) / 1e6,
+           (built - start) / sizes[s], cluster_count(corpus));
+    cluster_corpus_free(corpus);
+  }
+  return 0;
+}
@@ -0,0 +1,187 @@
+#define _POSIX_C_SOURCE 199309L
+
+#include "clovo/comparison.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define PAIRS 4096
+#define ROUNDS 50
+#define HISTORY 24
+#define HISTORY_THRESHOLD 3
+#define BATCH_PAIRS 500000
+
+static const int lengths[] = {8, 12, 16, 24, 32, 64, 128};
+
+static double now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static uint64_t splitmix64(uint64_t *state) {
+  uint64_t z = (*state += 0x9e3779b97f4a7c15ULL);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+// what edit_distance() used to do: a full matrix, one row malloc at a time
+static int matrix_distance(const char *s1, const char *s2) {
+  int len1 = strlen(s1);
+  int len2 = strlen(s2);
+  if (len1 == 0)
+    return len2;
+  if (len2 == 0)
+    return len1;
+
+  int **dp = malloc((len1 + 1) * sizeof(int *));
+  for (int i = 0; i <= len1; i++)
+    dp[i] = malloc((len2 + 1) * sizeof(int));
+  for (int i = 0; i <= len1; i++)
+    dp[i][0] = i;
+  for (int j = 0; j <= len2; j++)
+    dp[0][j] = j;
+  for (int i = 1; i <= len1; i++) {
+    for (int j = 1; j <= len2; j++) {
+      if (s1[i - 1] == s2[j - 1]) {
+        dp[i][j] = dp[i - 1][j - 1];
+      } else {
+        int min = dp[i - 1][j];
+        if (dp[i][j - 1] < min)
+          min = dp[i][j - 1];
+        if (dp[i - 1][j - 1] < min)
+          min = dp[i - 1][j - 1];
+        dp[i][j] = min + 1;
+      }
+    }
+  }
+  int result = dp[len1][len2];
+  for (int i = 0; i <= len1; i++)
+    free(dp[i]);
+  free(dp);
+  return result;
+}
+
+int main(void) {
+  static char a[PAIRS][129], b[PAIRS][129];
+  uint64_t state = 1;
+  long checksum = 0;
+
+  printf("edit_distance, %d pairs x %d rounds per length\n", PAIRS, ROUNDS);
+  printf("  %6s %12s %12s %8s\n", "length", "matrix ns", "myers ns",
+         "speedup");
+
+  for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++) {
+    int len = lengths[l];
+    // second password is the first with a few edits, like a password change
+    for (int p = 0; p < PAIRS; p++) {
+      for (int i = 0; i < len; i++)
+        a[p][i] = (char)(33 + splitmix64(&state) % 94);
+      a[p][len] = '\0';
+      memcpy(b[p], a[p], (size_t)len + 1);
+      for (int e = 0; e < 3; e++)
+        b[p][splitmix64(&state) % (uint64_t)len] =
+            (char)(33 + splitmix64(&state) % 94);
+    }
+
+    double start = now_ns();
+    for (int r = 0; r < ROUNDS; r++)
+      for (int p = 0; p < PAIRS; p++)
+        checksum += matrix_distance(a[p], b[p]);
+    double matrix = (now_ns() - start) / ((double)PAIRS * ROUNDS);
+
+    start = now_ns();
+    for (int r = 0; r < ROUNDS; r++)
+      for (int p = 0; p < PAIRS; p++)
+        checksum -= edit_distance(a[p], b[p]);
+    double myers = (now_ns() - start) / ((double)PAIRS * ROUNDS);
+
+    printf("  %6d %12.1f %12.1f %7.1fx\n", len, matrix, myers,
+           matrix / myers);
+  }
+
+  // a new password against the last 24 stored ones with 3 edits allowed:
+  // the band vs a full distance per entry
+  static char stored[HISTORY][13];
+  const char *history[HISTORY];
+  for (int e = 0; e < HISTORY; e++) {
+    for (int i = 0; i < 12; i++)
+      stored[e][i] = (char)(33 + splitmix64(&state) % 94);
+    stored[e][12] = '\0';
+    history[e] = stored[e];
+  }
+  int hits[2] = {0, 0};
+  double start = now_ns();
+  for (int p = 0; p < PAIRS; p++)
+    hits[0] += check_against_history(a[p] + 100, history, HISTORY,
+                                     HISTORY_THRESHOLD) >= 0;
+  double banded = (now_ns() - start) / PAIRS;
+  start = now_ns();
+  for (int p = 0; p < PAIRS; p++) {
+    for (int e = 0; e < HISTORY; e++) {
+      if (edit_distance(a[p] + 100, history[e]) <= HISTORY_THRESHOLD) {
+        hits[1]++;
+        break;
+      }
+    }
+  }
+  double full = (now_ns() - start) / PAIRS;
+  printf("check_against_history, %d entries, threshold %d: %.0f ns "
+         "(per-entry edit_distance: %.0f ns)\n",
+         HISTORY, HISTORY_THRESHOLD, banded, full);
+  checksum += hits[0] - hits[1];
+
+  // a rotation log of 12-character pairs: compare_batch() against reading
+  // and comparing one line at a time on this thread
+  FILE *log = tmpfile(), *results = tmpfile();
+  if (!log || !results)
+    return 1;
+  for (int p = 0; p < BATCH_PAIRS; p++)
+    fprintf(log, "%.12s\t%.12s\n", a[p % PAIRS] + 100, b[p % PAIRS] + 100);
+
+  rewind(log);
+  char line[64];
+  size_t similar[2] = {0, 0};
+  start = now_ns();
+  while (fgets(line, sizeof(line), log)) {
+    line[strcspn(line, "\r\n")] = '\0';
+    char *tab = strchr(line, '\t');
+    *tab = '\0';
+    similarity_result_t result = compare_passwords(line, tab + 1);
+    similar[0] += result.similarity_score > 0.7;
+    fprintf(results, "%.4f,%d\n", result.similarity_score,
+            result.edit_distance);
+  }
+  double serial = (now_ns() - start) / BATCH_PAIRS;
+
+  rewind(log);
+  rewind(results);
+  compare_batch_options_t options;
+  init_compare_batch_options(&options);
+  options.format = COMPARE_BATCH_CSV;
+  compare_batch_stats_t stats;
+  start = now_ns();
+  compare_batch(log, results, &options, &stats);
+  double batched = (now_ns() - start) / BATCH_PAIRS;
+  similar[1] = stats.too_similar;
+
+  rewind(log);
+  options.format = COMPARE_BATCH_SUMMARY;
+  start = now_ns();
+  compare_batch(log, NULL, &options, &stats);
+  double summary = (now_ns() - start) / BATCH_PAIRS;
+  printf("compare_batch, %d pairs: %.0f ns/pair csv, %.0f ns/pair summary "
+         "(line at a time: %.0f ns)\n",
+         BATCH_PAIRS, batched, summary, serial);
+  checksum += (long)similar[0] - (long)similar[1];
+  fclose(log);
+  fclose(results);
+
+  // both implementations must agree, so this is 0
+  printf("  checksum: %ld\n", checksum);
+  return checksum != 0;
+}
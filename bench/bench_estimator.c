@@ -0,0 +1,90 @@
+#define _POSIX_C_SOURCE 199309L
+
+#include "clovo/estimator.h"
+#include "clovo/generator.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// per-password latency budget for estimate_guesses(), checked against p99
+#define LATENCY_BUDGET_NS 20000.0
+#define MAX_ENTRIES 200000
+
+static double now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static int compare_doubles(const void *a, const void *b) {
+  double x = *(const double *)a;
+  double y = *(const double *)b;
+  return (x > y) - (x < y);
+}
+
+int main(int argc, char *argv[]) {
+  const char *corpus = argc > 1 ? argv[1] : "./data/common_passwords.txt";
+
+  init_generator("./data");
+
+  FILE *file = fopen(corpus, "r");
+  if (!file) {
+    fprintf(stderr, "Error: Cannot open file '%s'\n", corpus);
+    return 1;
+  }
+
+  static char entries[MAX_ENTRIES][ESTIMATE_MAX_LENGTH + 1];
+  static double latencies[MAX_ENTRIES];
+  char line[512];
+  int count = 0;
+  while (fgets(line, sizeof(line), file) && count < MAX_ENTRIES) {
+    line[strcspn(line, "\r\n")] = '\0';
+    if (line[0] == '\0')
+      continue;
+    snprintf(entries[count++], ESTIMATE_MAX_LENGTH + 1, "%.*s",
+             ESTIMATE_MAX_LENGTH, line);
+  }
+  fclose(file);
+
+  if (count == 0) {
+    fprintf(stderr, "Error: No passwords found in file\n");
+    return 1;
+  }
+
+  // the corpus mostly holds short passwords, add a few long worst cases
+  const char *worst[] = {
+      "correcthorsebatterystaplecorrecthorsebatterystaple12/31/1999qwer",
+      "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+      "1qaz2wsx3edc4rfv5tgb6yhn7ujm8ik9ol0p1qaz2wsx3edc4rfv5tgb6yhn7ujm",
+      NULL};
+  for (int i = 0; worst[i] && count < MAX_ENTRIES; i++)
+    snprintf(entries[count++], ESTIMATE_MAX_LENGTH + 1, "%s", worst[i]);
+
+  double checksum = 0.0;
+  double start = now_ns();
+  for (int i = 0; i < count; i++) {
+    double t0 = now_ns();
+    guess_estimate_t estimate = estimate_guesses(entries[i]);
+    latencies[i] = now_ns() - t0;
+    checksum += estimate.guesses_log10;
+  }
+  double total = now_ns() - start;
+
+  qsort(latencies, count, sizeof(double), compare_doubles);
+  double p50 = latencies[count / 2];
+  double p99 = latencies[(int)(count * 0.99)];
+  double max = latencies[count - 1];
+
+  printf("estimate_guesses: %d passwords in %.1f ms\n", count, total / 1e6);
+  printf("  throughput: %.0f passwords/sec\n", count / (total / 1e9));
+  printf("  latency:    p50 %.0f ns, p99 %.0f ns, max %.0f ns\n", p50, p99,
+         max);
+  printf("  budget:     p99 <= %.0f ns (%s)\n", LATENCY_BUDGET_NS,
+         p99 <= LATENCY_BUDGET_NS ? "ok" : "EXCEEDED");
+  printf("  checksum:   %.1f\n", checksum);
+
+  cleanup_generator();
+  return p99 <= LATENCY_BUDGET_NS ? 0 : 1;
+}
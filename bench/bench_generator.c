@@ -0,0 +1,201 @@
+#define _POSIX_C_SOURCE 199309L
+
+#include "clovo/charset.h"
+#include "clovo/drbg.h"
+#include "clovo/generator.h"
+#include "clovo/pool.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define PASSWORD_LENGTH 16
+#define GENERATIONS 1000000
+// bytes drawn one syscall at a time for the baseline, kept small
+#define SYSCALL_BYTES 100000
+#define DRBG_BYTES (64u << 20)
+#define POLICY_LENGTH 8
+#define POLICY_GENERATIONS 200000
+#define POOL_TAKES 4096
+#define KERNEL_WORDS (1u << 16)
+#define KERNEL_ROUNDS 2000
+
+static double now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static int compare_doubles(const void *a, const void *b) {
+  double x = *(const double *)a, y = *(const double *)b;
+  return (x > y) - (x < y);
+}
+
+// sorts samples in place
+static double percentile(double *samples, int n, double p) {
+  qsort(samples, n, sizeof(*samples), compare_doubles);
+  return samples[(int)(p * (n - 1))];
+}
+
+int main(void) {
+  generator_options_t opts;
+  init_generator_options(&opts);
+  opts.check_common = false;
+
+  char buffer[PASSWORD_LENGTH + 1];
+  unsigned checksum = 0;
+
+  // generate_password() end to end
+  uint64_t seeds_before = drbg_seed_count();
+  double start = now_ns();
+  for (int i = 0; i < GENERATIONS; i++) {
+    if (generate_password(buffer, sizeof(buffer), PASSWORD_LENGTH, &opts) !=
+        GEN_SUCCESS) {
+      fprintf(stderr, "Error: generation failed\n");
+      return 1;
+    }
+    checksum += (unsigned char)buffer[0];
+  }
+  double total = now_ns() - start;
+  uint64_t seeds = drbg_seed_count() - seeds_before;
+
+  printf("generate_password: %d x %d chars in %.1f ms\n", GENERATIONS,
+         PASSWORD_LENGTH, total / 1e6);
+  printf("  throughput: %.0f generations/sec\n", GENERATIONS / (total / 1e9));
+  printf("  seeding:    %llu system csprng reads (%.2f per 1M chars)\n",
+         (unsigned long long)seeds,
+         seeds * 1e6 / ((double)GENERATIONS * PASSWORD_LENGTH));
+
+  // the mapping kernel alone, vector vs scalar over the same words
+  charset_kernel_t kernel;
+  charset_kernel_init(&kernel,
+                      "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ"
+                      "0123456789!@#$%^&*()_+-=[]{}|;:,.<>?/~`");
+  uint16_t *words = malloc(KERNEL_WORDS * sizeof(*words));
+  char *mapped = malloc(KERNEL_WORDS);
+  if (!words || !mapped)
+    return 1;
+  drbg_random_bytes(words, KERNEL_WORDS * sizeof(*words));
+  double kernel_ns[2];
+  for (int scalar = 0; scalar < 2; scalar++) {
+    start = now_ns();
+    for (int r = 0; r < KERNEL_ROUNDS; r++) {
+      size_t n = scalar ? charset_map_words_scalar(&kernel, words,
+                                                   KERNEL_WORDS, mapped,
+                                                   KERNEL_WORDS)
+                        : charset_map_words(&kernel, words, KERNEL_WORDS,
+                                            mapped, KERNEL_WORDS);
+      checksum += (unsigned char)mapped[n - 1];
+    }
+    kernel_ns[scalar] = now_ns() - start;
+  }
+  double kernel_chars = (double)KERNEL_WORDS * KERNEL_ROUNDS;
+  printf("charset_map_words (%u chars, %d runs): %.2f ns/char vector, "
+         "%.2f ns/char scalar\n",
+         kernel.size, kernel.runs, kernel_ns[0] / kernel_chars,
+         kernel_ns[1] / kernel_chars);
+  free(words);
+  free(mapped);
+
+  // policy generation by construction vs generate-and-validate retries
+  password_policy_t pci;
+  init_policy(&pci, POLICY_PCI_DSS);
+  long long attempts_total = 0;
+  start = now_ns();
+  for (int i = 0; i < POLICY_GENERATIONS; i++) {
+    int attempts = 0;
+    if (generate_password_for_policy(buffer, sizeof(buffer), POLICY_LENGTH,
+                                     &pci, &opts, &attempts) != GEN_SUCCESS) {
+      fprintf(stderr, "Error: policy generation failed\n");
+      return 1;
+    }
+    attempts_total += attempts;
+    checksum += (unsigned char)buffer[0];
+  }
+  total = now_ns() - start;
+  printf("generate_password_for_policy (PCI-DSS, %d chars): %.0f ns/pw, "
+         "%.3f attempts/pw\n",
+         POLICY_LENGTH, total / POLICY_GENERATIONS,
+         (double)attempts_total / POLICY_GENERATIONS);
+
+  attempts_total = 0;
+  start = now_ns();
+  for (int i = 0; i < POLICY_GENERATIONS; i++) {
+    do {
+      attempts_total++;
+      generate_password(buffer, sizeof(buffer), POLICY_LENGTH, &opts);
+    } while (!validate_policy(buffer, &pci).passed);
+    checksum += (unsigned char)buffer[0];
+  }
+  total = now_ns() - start;
+  printf("  generate + validate_policy retries: %.0f ns/pw, "
+         "%.3f attempts/pw\n",
+         total / POLICY_GENERATIONS,
+         (double)attempts_total / POLICY_GENERATIONS);
+
+  // issuing latency: generate + analyze on the spot vs taking from a pool
+  static double latency[POOL_TAKES];
+  generator_options_t checked;
+  init_generator_options(&checked);
+  for (int i = 0; i < POOL_TAKES; i++) {
+    double t0 = now_ns();
+    generate_password(buffer, sizeof(buffer), PASSWORD_LENGTH, &checked);
+    password_strength_t analysis = analyze_password(buffer);
+    latency[i] = now_ns() - t0;
+    checksum += (unsigned)analysis.score;
+  }
+  double direct_p50 = percentile(latency, POOL_TAKES, 0.50);
+  double direct_p99 = percentile(latency, POOL_TAKES, 0.99);
+
+  pool_options_t pool_opts;
+  init_pool_options(&pool_opts);
+  pool_opts.capacity = POOL_TAKES;
+  pool_opts.length = PASSWORD_LENGTH;
+  pool_opts.opts = &checked;
+  password_pool_t *pool = password_pool_create(&pool_opts);
+  if (!pool)
+    return 1;
+  struct timespec fill_wait = {0, 1000000};
+  while (password_pool_stats(pool).available < POOL_TAKES)
+    nanosleep(&fill_wait, NULL);
+  for (int i = 0; i < POOL_TAKES; i++) {
+    password_strength_t analysis;
+    double t0 = now_ns();
+    password_pool_take(pool, buffer, sizeof(buffer), &analysis);
+    latency[i] = now_ns() - t0;
+    checksum += (unsigned)analysis.score;
+  }
+  password_pool_destroy(pool);
+  printf("issue + analyze: direct p50 %.0f ns p99 %.0f ns, "
+         "pool p50 %.0f ns p99 %.0f ns\n",
+         direct_p50, direct_p99, percentile(latency, POOL_TAKES, 0.50),
+         percentile(latency, POOL_TAKES, 0.99));
+
+  // raw generator output
+  unsigned char *bytes = malloc(DRBG_BYTES);
+  if (!bytes)
+    return 1;
+  start = now_ns();
+  for (size_t off = 0; off < DRBG_BYTES; off += 4096)
+    drbg_random_bytes(bytes + off, 4096);
+  total = now_ns() - start;
+  checksum += bytes[DRBG_BYTES - 1];
+  printf("drbg_random_bytes: %.0f MB/s\n",
+         DRBG_BYTES / 1e6 / (total / 1e9));
+  free(bytes);
+
+  // what every byte used to cost: one system csprng call
+  start = now_ns();
+  for (int i = 0; i < SYSCALL_BYTES; i++) {
+    unsigned char b;
+    secure_random_bytes(&b, 1);
+    checksum += b;
+  }
+  double per_byte_syscall = (now_ns() - start) / SYSCALL_BYTES;
+  printf("secure_random_bytes per byte: %.0f ns (drbg: %.1f ns)\n",
+         per_byte_syscall, total / DRBG_BYTES);
+
+  printf("  checksum:   %u\n", checksum);
+  drbg_clear();
+  return 0;
+}
@@ -0,0 +1,127 @@
+#define _POSIX_C_SOURCE 199309L
+
+#include "clovo/compliance.h"
+#include "clovo/generator.h"
+#include "clovo/policy.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// half random passwords, half taken from the common list, as a signup or
+// rotation audit sees them
+#define SAMPLES 8192
+#define ROUNDS 5
+#define MAX_SAMPLE_LENGTH 32
+
+static double now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+int main(int argc, char *argv[]) {
+  const char *corpus = argc > 1 ? argv[1] : "./data/common_passwords.txt";
+
+  init_generator("./data");
+
+  static char samples[SAMPLES][MAX_SAMPLE_LENGTH + 1];
+  int count = 0;
+  FILE *file = fopen(corpus, "r");
+  if (file) {
+    char line[512];
+    while (count < SAMPLES / 2 && fgets(line, sizeof(line), file)) {
+      line[strcspn(line, "\r\n")] = '\0';
+      if (line[0] != '\0')
+        snprintf(samples[count++], MAX_SAMPLE_LENGTH + 1, "%.*s",
+                 MAX_SAMPLE_LENGTH, line);
+    }
+    fclose(file);
+  }
+  generator_options_t opts;
+  init_generator_options(&opts);
+  while (count < SAMPLES) {
+    if (generate_password(samples[count], MAX_SAMPLE_LENGTH + 1,
+                          8 + count % 13, &opts) != GEN_SUCCESS)
+      return 1;
+    count++;
+  }
+
+  const policy_type_t types[] = {POLICY_BASIC, POLICY_NIST, POLICY_PCI_DSS};
+  int mismatches = 0;
+
+  printf("validate_policy, %d passwords x %d rounds\n", SAMPLES, ROUNDS);
+  printf("  %-8s %12s %12s %13s %8s\n", "policy", "full ns/pw",
+         "masked ns/pw", "verdict ns/pw", "speedup");
+  for (size_t t = 0; t < sizeof(types) / sizeof(types[0]); t++) {
+    password_policy_t policy;
+    init_policy(&policy, types[t]);
+    long passed[3] = {0};
+
+    // what validate_policy() did before: every detector, every time
+    double start = now_ns();
+    for (int r = 0; r < ROUNDS; r++) {
+      for (int i = 0; i < SAMPLES; i++) {
+        password_strength_t analysis = analyze_password(samples[i]);
+        passed[0] += validate_policy_analysis(&analysis, &policy).passed;
+      }
+    }
+    double full = (now_ns() - start) / ((double)SAMPLES * ROUNDS);
+
+    start = now_ns();
+    for (int r = 0; r < ROUNDS; r++)
+      for (int i = 0; i < SAMPLES; i++)
+        passed[1] += validate_policy(samples[i], &policy).passed;
+    double masked = (now_ns() - start) / ((double)SAMPLES * ROUNDS);
+
+    // the same checks with no messages and no 1.3 KB result
+    start = now_ns();
+    for (int r = 0; r < ROUNDS; r++)
+      for (int i = 0; i < SAMPLES; i++)
+        passed[2] += evaluate_policy(samples[i], &policy).violations == 0;
+    double verdict = (now_ns() - start) / ((double)SAMPLES * ROUNDS);
+
+    printf("  %-8s %12.0f %12.0f %13.0f %7.1fx\n",
+           policy_type_to_string(types[t]), full, masked, verdict,
+           full / verdict);
+    mismatches += passed[0] != passed[1] || passed[0] != passed[2];
+  }
+
+  // a credential export through the batch worker pool, verdicts written
+  FILE *in = tmpfile(), *out = tmpfile();
+  if (!in || !out)
+    return 1;
+  for (int r = 0; r < ROUNDS * 4; r++)
+    for (int i = 0; i < SAMPLES; i++)
+      fprintf(in, "%s\n", samples[i]);
+  password_policy_t nist;
+  init_policy(&nist, POLICY_NIST);
+  compliance_options_t options;
+  init_compliance_options(&options);
+  options.policy = &nist;
+
+  printf("check_compliance NIST, %d passwords\n", SAMPLES * ROUNDS * 4);
+  const compliance_format_t formats[] = {COMPLIANCE_SUMMARY, COMPLIANCE_CSV};
+  const char *format_names[] = {"summary", "csv"};
+  for (int f = 0; f < 2; f++) {
+    options.format = formats[f];
+    rewind(in);
+    rewind(out);
+    compliance_stats_t stats;
+    double start = now_ns();
+    if (check_compliance(in, out, &options, &stats) != GEN_SUCCESS)
+      return 1;
+    double elapsed = now_ns() - start;
+    printf("  %-8s %8.0f ns/pw  %zu non-compliant\n", format_names[f],
+           elapsed / (double)stats.passwords, stats.failed);
+  }
+  fclose(in);
+  fclose(out);
+
+  // every way must agree on every password
+  if (mismatches)
+    printf("  MISMATCH in %d policies\n", mismatches);
+  cleanup_generator();
+  return mismatches != 0;
+}
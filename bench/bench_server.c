@@ -0,0 +1,412 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "clovo/server.h"
+
+#include <netdb.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+// load test for --serve and --http: connections clients, each keeping depth
+// requests in flight, until requests answers have come back. latency is
+// from writing a request to reading its whole answer. with --connect it
+// drives a running server, without it starts both kinds in this process
+//
+//   bench_server [--connect <socket|host:port>] [--http] [--request kind]
+//                [--connections n] [--depth n] [--requests n]
+
+#define MAX_CONNECTIONS 256
+#define MAX_DEPTH 256
+#define READ_BUFFER 65536
+#define DEFAULT_REQUESTS 10000
+#define ANSWER_TIMEOUT 10
+
+static const char *const kinds[] = {"analyze", "policy", "generate",
+                                    "compare"};
+
+// one request of kind, as the line protocol and as http has it
+static const char *const line_requests[] = {
+    "analyze Tr0ub4dor&3\n", "policy nist Tr0ub4dor&3\n", "generate\n",
+    "compare Tr0ub4dor&3\tTr0ub4dor&4\n"};
+static const char *const http_requests[][2] = {
+    {"/analyze", "{\"password\":\"Tr0ub4dor&3\"}"},
+    {"/policy", "{\"policy\":\"nist\",\"password\":\"Tr0ub4dor&3\"}"},
+    {"/generate", NULL},
+    {"/compare", "{\"old\":\"Tr0ub4dor&3\",\"new\":\"Tr0ub4dor&4\"}"}};
+
+typedef struct {
+  const char *target; // a socket path, or host:port
+  bool http;
+  int kind;
+  int connections;
+  int depth;
+  size_t requests;
+} load_t;
+
+typedef struct {
+  const load_t *load;
+  size_t count; // answers to wait for
+  double *latencies;
+  size_t errors;
+  bool failed; // couldn't connect or the connection broke
+} client_t;
+
+static double now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static int connect_target(const char *target) {
+  const char *colon = strrchr(target, ':');
+  if (!colon || strchr(target, '/')) {
+    struct sockaddr_un address = {.sun_family = AF_UNIX};
+    if (strlen(target) >= sizeof(address.sun_path))
+      return -1;
+    strcpy(address.sun_path, target);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd >= 0 &&
+        connect(fd, (struct sockaddr *)&address, sizeof(address)) != 0) {
+      close(fd);
+      fd = -1;
+    }
+    return fd;
+  }
+
+  char host[256];
+  snprintf(host, sizeof(host), "%.*s", (int)(colon - target), target);
+  struct addrinfo hints = {.ai_socktype = SOCK_STREAM};
+  struct addrinfo *addresses;
+  if (getaddrinfo(host, colon + 1, &hints, &addresses) != 0)
+    return -1;
+  int fd = -1;
+  for (struct addrinfo *ai = addresses; ai && fd < 0; ai = ai->ai_next) {
+    fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+    if (fd >= 0 && connect(fd, ai->ai_addr, ai->ai_addrlen) != 0) {
+      close(fd);
+      fd = -1;
+    }
+  }
+  freeaddrinfo(addresses);
+  return fd;
+}
+
+// connect to target, giving up on an answer after ANSWER_TIMEOUT seconds
+static int open_connection(const char *target) {
+  int fd = connect_target(target);
+  struct timeval timeout = {ANSWER_TIMEOUT, 0};
+  if (fd >= 0)
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+  return fd;
+}
+
+// length of the whole answer at the start of data[0..len), 0 when it
+// hasn't all arrived. *error is set when it isn't a success
+static size_t answer_length(const char *data, size_t len, bool http,
+                            bool *error) {
+  if (!http) {
+    const char *newline = memchr(data, '\n', len);
+    if (!newline)
+      return 0;
+    *error = strncmp(data, "{\"error\"", 8) == 0;
+    return (size_t)(newline - data) + 1;
+  }
+
+  const char *head_end = NULL;
+  for (size_t i = 0; i + 4 <= len && !head_end; i++)
+    if (memcmp(data + i, "\r\n\r\n", 4) == 0)
+      head_end = data + i + 4;
+  if (!head_end)
+    return 0;
+  size_t body = 0;
+  for (const char *p = data; p < head_end; p++) {
+    if (strncasecmp(p, "\r\nContent-Length:", 17) == 0) {
+      body = strtoul(p + 17, NULL, 10);
+      break;
+    }
+  }
+  size_t total = (size_t)(head_end - data) + body;
+  if (total > len)
+    return 0;
+  *error = strncmp(data, "HTTP/1.1 200 ", 13) != 0;
+  return total;
+}
+
+static bool send_request(int fd, const char *request, size_t len) {
+  while (len > 0) {
+    ssize_t n = write(fd, request, len);
+    if (n <= 0)
+      return false;
+    request += n;
+    len -= (size_t)n;
+  }
+  return true;
+}
+
+static void *client_thread(void *arg) {
+  client_t *client = arg;
+  const load_t *load = client->load;
+  char request[512];
+  const char *body = http_requests[load->kind][1];
+  if (!load->http)
+    snprintf(request, sizeof(request), "%s", line_requests[load->kind]);
+  else if (body)
+    snprintf(request, sizeof(request),
+             "POST %s HTTP/1.1\r\nHost: bench\r\nContent-Length: %zu\r\n"
+             "\r\n%s",
+             http_requests[load->kind][0], strlen(body), body);
+  else
+    snprintf(request, sizeof(request),
+             "GET %s HTTP/1.1\r\nHost: bench\r\n\r\n",
+             http_requests[load->kind][0]);
+  size_t request_len = strlen(request);
+
+  int fd = open_connection(load->target);
+  char *buffer = malloc(READ_BUFFER);
+  if (fd < 0 || !buffer) {
+    client->failed = true;
+    free(buffer);
+    if (fd >= 0)
+      close(fd);
+    return NULL;
+  }
+
+  // requests are answered in order, so sent[i % depth] is the time the
+  // i-th was written until its answer is in
+  double sent[MAX_DEPTH];
+  size_t issued = 0, answered = 0, used = 0, start = 0;
+  while (answered < client->count) {
+    while (issued < client->count &&
+           issued - answered < (size_t)load->depth) {
+      sent[issued % (size_t)load->depth] = now_ns();
+      if (!send_request(fd, request, request_len))
+        goto broken;
+      issued++;
+    }
+
+    bool error = false;
+    size_t length = answer_length(buffer + start, used - start, load->http,
+                                  &error);
+    if (length == 0) {
+      if (start > 0) {
+        memmove(buffer, buffer + start, used - start);
+        used -= start;
+        start = 0;
+      }
+      ssize_t n = read(fd, buffer + used, READ_BUFFER - used);
+      if (n <= 0)
+        goto broken;
+      used += (size_t)n;
+      continue;
+    }
+    client->latencies[answered] =
+        now_ns() - sent[answered % (size_t)load->depth];
+    client->errors += error;
+    answered++;
+    start += length;
+  }
+  close(fd);
+  free(buffer);
+  return NULL;
+
+broken:
+  client->failed = true;
+  client->count = answered;
+  close(fd);
+  free(buffer);
+  return NULL;
+}
+
+static int compare_doubles(const void *a, const void *b) {
+  double x = *(const double *)a, y = *(const double *)b;
+  return (x > y) - (x < y);
+}
+
+// latency at quantile q of the sorted samples, in microseconds
+static double percentile(const double *sorted, size_t count, double q) {
+  size_t index = (size_t)(q * (double)(count - 1) + 0.5);
+  return sorted[index] / 1000.0;
+}
+
+static bool run_load(const load_t *load) {
+  client_t clients[MAX_CONNECTIONS];
+  pthread_t threads[MAX_CONNECTIONS];
+  double *latencies = malloc(load->requests * sizeof(double));
+  if (!latencies)
+    return false;
+
+  // the requests split over the connections
+  size_t offset = 0;
+  for (int i = 0; i < load->connections; i++) {
+    size_t share = load->requests / (size_t)load->connections +
+                   ((size_t)i < load->requests % (size_t)load->connections);
+    clients[i] = (client_t){
+        .load = load, .count = share, .latencies = latencies + offset};
+    offset += share;
+  }
+
+  double start = now_ns();
+  int started = 0;
+  for (; started < load->connections; started++)
+    if (pthread_create(&threads[started], NULL, client_thread,
+                       &clients[started]) != 0)
+      break;
+  for (int i = 0; i < started; i++)
+    pthread_join(threads[i], NULL);
+  double elapsed = now_ns() - start;
+
+  // answers of broken connections are left out
+  size_t count = 0, errors = 0;
+  bool failed = started < load->connections;
+  for (int i = 0; i < started; i++) {
+    memmove(latencies + count, clients[i].latencies,
+            clients[i].count * sizeof(double));
+    count += clients[i].count;
+    errors += clients[i].errors;
+    failed |= clients[i].failed;
+  }
+  if (count == 0) {
+    printf("  %-6s %-9s %5d %5d  no answers\n", load->http ? "http" : "lines",
+           kinds[load->kind], load->connections, load->depth);
+    free(latencies);
+    return false;
+  }
+  qsort(latencies, count, sizeof(double), compare_doubles);
+  printf("  %-6s %-9s %5d %5d %10.0f %8.1f %8.1f %8.1f %8.1f %8.1f",
+         load->http ? "http" : "lines", kinds[load->kind], load->connections,
+         load->depth, (double)count / (elapsed / 1e9),
+         percentile(latencies, count, 0.50), percentile(latencies, count, 0.90),
+         percentile(latencies, count, 0.99),
+         percentile(latencies, count, 0.999),
+         latencies[count - 1] / 1000.0);
+  if (errors)
+    printf("  %zu errors", errors);
+  if (failed)
+    printf("  connection failed");
+  printf("\n");
+  free(latencies);
+  return !failed && errors == 0;
+}
+
+static void print_header(void) {
+  printf("  %-6s %-9s %5s %5s %10s %8s %8s %8s %8s %8s\n", "proto",
+         "request", "conns", "depth", "req/s", "p50 us", "p90 us", "p99 us",
+         "p99.9 us", "max us");
+}
+
+static void *run_server(void *arg) {
+  server_run(arg);
+  return NULL;
+}
+
+// a line and an http server in this process, every load against both
+static int run_local(size_t requests) {
+  init_generator("./data");
+
+  char socket_path[64], http_target[32];
+  snprintf(socket_path, sizeof(socket_path), "/tmp/clovo_bench_%d.sock",
+           (int)getpid());
+  server_options_t options;
+  init_server_options(&options);
+  options.socket_path = socket_path;
+  server_t *lines = server_create(&options, NULL);
+  options.socket_path = NULL;
+  options.protocol = SERVER_HTTP;
+  options.port = 0;
+  server_t *http = server_create(&options, NULL);
+  if (!lines || !http) {
+    fprintf(stderr, "can't start the servers\n");
+    return 1;
+  }
+  snprintf(http_target, sizeof(http_target), "127.0.0.1:%d",
+           server_port(http));
+  pthread_t runners[2];
+  pthread_create(&runners[0], NULL, run_server, lines);
+  pthread_create(&runners[1], NULL, run_server, http);
+
+  const struct {
+    int connections;
+    int depth;
+  } shapes[] = {{1, 1}, {16, 1}, {16, 32}};
+  const int kinds_run[] = {1, 0}; // policy: server overhead, analyze: work
+  bool ok = true;
+
+  printf("server round trips, %zu requests per row\n", requests);
+  print_header();
+  for (int http_mode = 0; http_mode < 2; http_mode++) {
+    for (size_t k = 0; k < sizeof(kinds_run) / sizeof(kinds_run[0]); k++) {
+      for (size_t s = 0; s < sizeof(shapes) / sizeof(shapes[0]); s++) {
+        load_t load = {.target = http_mode ? http_target : socket_path,
+                       .http = http_mode,
+                       .kind = kinds_run[k],
+                       .connections = shapes[s].connections,
+                       .depth = shapes[s].depth,
+                       .requests = requests};
+        ok &= run_load(&load);
+      }
+    }
+  }
+
+  server_stop(lines);
+  server_stop(http);
+  pthread_join(runners[0], NULL);
+  pthread_join(runners[1], NULL);
+  server_destroy(lines);
+  server_destroy(http);
+  cleanup_generator();
+  return ok ? 0 : 1;
+}
+
+int main(int argc, char *argv[]) {
+  load_t load = {.target = NULL,
+                 .http = false,
+                 .kind = 1,
+                 .connections = 16,
+                 .depth = 1,
+                 .requests = DEFAULT_REQUESTS};
+  for (int i = 1; i < argc; i++) {
+    bool has_value = i + 1 < argc;
+    if (strcmp(argv[i], "--connect") == 0 && has_value) {
+      load.target = argv[++i];
+    } else if (strcmp(argv[i], "--http") == 0) {
+      load.http = true;
+    } else if (strcmp(argv[i], "--request") == 0 && has_value) {
+      const char *kind = argv[++i];
+      load.kind = -1;
+      for (int k = 0; k < 4; k++)
+        if (strcmp(kind, kinds[k]) == 0)
+          load.kind = k;
+    } else if (strcmp(argv[i], "--connections") == 0 && has_value) {
+      load.connections = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--depth") == 0 && has_value) {
+      load.depth = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--requests") == 0 && has_value) {
+      load.requests = strtoul(argv[++i], NULL, 10);
+    } else {
+      load.kind = -1;
+    }
+  }
+  if (load.kind < 0 || load.connections < 1 ||
+      load.connections > MAX_CONNECTIONS || load.depth < 1 ||
+      load.depth > MAX_DEPTH || load.requests < (size_t)load.connections) {
+    fprintf(stderr,
+            "usage: %s [--connect <socket|host:port>] [--http] "
+            "[--request analyze|policy|generate|compare]\n"
+            "       [--connections 1-%d] [--depth 1-%d] [--requests n]\n",
+            argv[0], MAX_CONNECTIONS, MAX_DEPTH);
+    return 2;
+  }
+
+  if (!load.target)
+    return run_local(load.requests);
+  print_header();
+  return run_load(&load) ? 0 : 1;
+}
@@ -1,6 +1,9 @@
 #ifndef ANALYZER_H
 #define ANALYZER_H
+#include "clovo/fuzzy.h"
+
 #include <stdbool.h>
+#include <stddef.h>
 
 typedef enum {
   NO_PASSWORD,
@@ -11,41 +14,81 @@ typedef enum {
   VERY_STRONG
 } strength_level_t;
 
+// detectors analyze_password_ex() runs on request. the character classes
+// and lengths are always filled in
+typedef enum {
+  ANALYZE_SEQUENTIAL = 1 << 0,     // has_sequential_pattern
+  ANALYZE_KEYBOARD = 1 << 1,       // has_keyboard_pattern, walk length
+  ANALYZE_REPEATS = 1 << 2,        // has_repeated_chars, _pattern
+  ANALYZE_DICTIONARY = 1 << 3,     // contains_dictionary_word
+  ANALYZE_LEETSPEAK = 1 << 4,      // contains_leetspeak
+  ANALYZE_COMMON_VARIANT = 1 << 5, // common_distance, nearest_common
+  ANALYZE_GUESSES = 1 << 6,        // guesses, guesses_log10
+  ANALYZE_ENTROPY = 1 << 7,        // entropy, crack_time_seconds
+  ANALYZE_ALL = (1 << 8) - 1       // everything, plus score and level
+} analyze_feature_t;
+
 typedef struct {
+  unsigned features; // the detectors that ran, see analyze_feature_t
   int score;
   int strength_score;
-  int length;
+  int length;      // characters (utf-8 code points)
+  int byte_length; // bytes, only differs from length for non-ascii input
   double entropy;
   bool has_lower;
   bool has_upper;
   bool has_digit;
   bool has_symbol;
+  bool has_other_letter; // letters of scripts without case (cjk, arabic, ...)
   strength_level_t level;
 
   // new analysis fields
   bool has_sequential_pattern;
   bool has_keyboard_pattern;
+  int keyboard_walk_length; // longest walk over adjacent keys
   bool has_repeated_chars;
   bool has_repeated_pattern;
   bool contains_dictionary_word;
   bool contains_leetspeak;
   bool contains_personal_info;
+  // nearest common password a few edits away (0 = on the list itself),
+  // -1 when none is close enough
+  int common_distance;
+  char nearest_common[FUZZY_MAX_LENGTH + 1];
   int pattern_penalty;
   double crack_time_seconds;
+
+  // minimum-guess estimate (see estimator.h)
+  double guesses;
+  double guesses_log10;
 } password_strength_t;
 
 password_strength_t analyze_password(const char *ps);
 
+// analyze pw[0..len) (no NUL needed) with only the detectors in features.
+// fields of the others stay false/0 (common_distance -1); score,
+// strength_score and level are only filled in for ANALYZE_ALL, the score
+// follows the guess estimate of the full analysis
+password_strength_t analyze_password_ex(const char *pw, size_t len,
+                                        unsigned features);
+
 void calculate_entropy(password_strength_t *ps);
 void determine_strength_level(password_strength_t *ps);
 void detect_patterns(password_strength_t *ps, const char *password);
 void detect_repetitions(password_strength_t *ps, const char *password);
 void check_dictionary_words(password_strength_t *ps, const char *password);
 void detect_leetspeak(password_strength_t *ps, const char *password);
+void detect_common_variant(password_strength_t *ps, const char *password);
 void detect_personal_info(password_strength_t *ps, const char *password,
                           const char *user_info);
 void estimate_crack_time(password_strength_t *ps);
 
+// the single pattern checks behind the analysis flags, for callers that only
+// need one of them (e.g. the policy generator re-checking candidates)
+bool has_sequential(const char *str, int len);
+bool has_repeated_chars(const char *str, int len);
+bool contains_dictionary_word(const char *str);
+
 const char *level_to_string(strength_level_t level);
 const char *format_crack_time(double seconds);
 
@@ -0,0 +1,62 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "clovo/generator.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+// line-by-line processing of a large file on several threads. the calling
+// thread reads the input in blocks of whole lines and hands them to a pool
+// of workers; each block keeps its input and output buffers for the whole
+// run, so after the first few blocks nothing is allocated. output is
+// written in input order
+
+// counters a line handler can bump, summed over the run
+#define BATCH_COUNTERS 32
+
+// output of one block, grown as needed and reused for the next block
+typedef struct {
+  char *data;
+  size_t used;
+  size_t capacity;
+} batch_output_t;
+
+// room for more bytes after used, false when out of memory
+bool batch_output_reserve(batch_output_t *out, size_t more);
+
+// output lines are put together by hand after reserving room for the
+// longest one, snprintf() can cost more than the work a line reports.
+// both write text or the decimal n at p and return the end
+char *batch_put_text(char *p, const char *text);
+char *batch_put_number(char *p, size_t n);
+
+// handle line number (1-based) of length len. the line has no newline, is
+// NUL-terminated and may be modified in place. output goes to out,
+// counters[i] add up into batch_stats_t. anything but GEN_SUCCESS stops
+// the run with that error
+typedef generator_error_t (*batch_line_fn)(void *context, char *line,
+                                           size_t len, size_t number,
+                                           batch_output_t *out,
+                                           size_t *counters);
+
+typedef struct {
+  int threads;         // 0 = one per online cpu
+  bool skip_empty;     // blank lines are counted but not handed over
+  batch_line_fn line;
+  void *context;       // shared by every worker, must be thread-safe
+} batch_job_t;
+
+typedef struct {
+  size_t lines; // input lines, blank ones included
+  size_t counters[BATCH_COUNTERS];
+} batch_stats_t;
+
+// run job over every line of in, writing the output to out (NULL to
+// discard it). stats (may be NULL) gets the totals of the lines handled,
+// also when the run stops early
+generator_error_t batch_run(FILE *in, FILE *out, const batch_job_t *job,
+                            batch_stats_t *stats);
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef BULK_H
+#define BULK_H
+
+#include "clovo/generator.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+// output formats for bulk generation
+typedef enum {
+  BULK_PLAIN, // one password per line
+  BULK_NDJSON // {"password":"..."} per line
+} bulk_format_t;
+
+typedef struct {
+  size_t length;
+  size_t count;
+  int threads; // 0 = one per online cpu
+  bool unique; // no password repeats within the run
+  bulk_format_t format;
+  const generator_options_t *opts; // NULL = defaults
+} bulk_options_t;
+
+// default options: 16 characters, one password, plain output
+void init_bulk_options(bulk_options_t *options);
+
+// generate options->count passwords into out from several threads, each with
+// its own generator state. lines from different threads interleave in
+// blocks. written (may be NULL) gets the number of passwords written
+generator_error_t generate_bulk(FILE *out, const bulk_options_t *options,
+                                size_t *written);
+
+#endif
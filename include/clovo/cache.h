@@ -0,0 +1,47 @@
+#ifndef CACHE_H
+#define CACHE_H
+
+#include "clovo/analyzer.h"
+#include "clovo/policy.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+// bounded cache of analysis results for passwords that are submitted over and
+// over. entries are found by a siphash of the password under a random
+// per-cache key, the password itself is never stored. split into shards with
+// their own lock and CLOCK eviction so concurrent callers rarely contend
+typedef struct analysis_cache analysis_cache_t;
+
+#define CACHE_DEFAULT_CAPACITY 4096
+#define CACHE_SHARDS 16
+
+typedef struct {
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t evictions;
+  size_t entries;
+  size_t capacity;
+} cache_stats_t;
+
+// create a cache holding up to capacity results (0 = default), NULL when out
+// of memory or no random key could be drawn
+analysis_cache_t *analysis_cache_create(size_t capacity);
+
+// free the cache, entries are wiped first
+void analysis_cache_destroy(analysis_cache_t *cache);
+
+// analyze_password() through the cache, cache may be NULL
+password_strength_t cached_analyze_password(analysis_cache_t *cache,
+                                            const char *password);
+
+// validate_policy() through the cache, cache may be NULL. each entry keeps
+// the verdict for the last policy it was checked against
+policy_result_t cached_validate_policy(analysis_cache_t *cache,
+                                       const char *password,
+                                       const password_policy_t *policy);
+
+// hit/miss counters summed over all shards
+cache_stats_t analysis_cache_stats(analysis_cache_t *cache);
+
+#endif
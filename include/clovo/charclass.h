@@ -0,0 +1,67 @@
+#ifndef CHARCLASS_H
+#define CHARCLASS_H
+
+#include <stdbool.h>
+
+// locale independent replacements for <ctype.h>. every lookup is a single
+// load from a 256-entry table indexed by the unsigned byte value, so any
+// char (including bytes >= 0x80) is safe to pass
+
+typedef enum {
+  CHAR_LOWER = 1 << 0,
+  CHAR_UPPER = 1 << 1,
+  CHAR_DIGIT = 1 << 2,
+  CHAR_PUNCT = 1 << 3,   // printable ascii symbols
+  CHAR_SPACE = 1 << 4,   // space, \t, \n, \v, \f, \r
+  CHAR_CONTROL = 1 << 5, // other ascii control bytes and DEL
+  CHAR_HIGH = 1 << 6,    // bytes >= 0x80
+  CHAR_LETTER = 1 << 7   // letters without case, only from decoded utf-8
+} char_class_t;
+
+#define CHAR_ALPHA (CHAR_LOWER | CHAR_UPPER)
+#define CHAR_ALNUM (CHAR_ALPHA | CHAR_DIGIT)
+// what the analyzer counts as a symbol: anything that isn't a letter/digit
+#define CHAR_SYMBOL (CHAR_PUNCT | CHAR_SPACE | CHAR_CONTROL | CHAR_HIGH)
+
+extern const unsigned char char_class_table[256];
+extern const unsigned char char_fold_table[256];
+extern const unsigned char char_unleet_table[256];
+
+// class bits of c
+static inline unsigned char_class(char c) {
+  return char_class_table[(unsigned char)c];
+}
+
+static inline bool char_is_lower(char c) {
+  return char_class(c) & CHAR_LOWER;
+}
+
+static inline bool char_is_upper(char c) {
+  return char_class(c) & CHAR_UPPER;
+}
+
+static inline bool char_is_digit(char c) {
+  return char_class(c) & CHAR_DIGIT;
+}
+
+static inline bool char_is_alpha(char c) {
+  return char_class(c) & CHAR_ALPHA;
+}
+
+// ascii lowercase of c, other bytes are returned unchanged
+static inline char char_fold(char c) {
+  return (char)char_fold_table[(unsigned char)c];
+}
+
+// lowercase of c with leetspeak substitutions undone (0 -> o, @ -> a, ...)
+static inline char char_unleet(char c) {
+  return (char)char_unleet_table[(unsigned char)c];
+}
+
+// lowercase n bytes of src into dst
+static inline void char_fold_copy(char *dst, const char *src, int n) {
+  for (int i = 0; i < n; i++)
+    dst[i] = char_fold(src[i]);
+}
+
+#endif
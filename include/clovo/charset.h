@@ -0,0 +1,51 @@
+#ifndef CHARSET_H
+#define CHARSET_H
+
+#include "clovo/generator.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+// precomputed charset for turning random 16-bit words into password
+// characters. each word w maps to chars[(w * size) >> 16] unless the low
+// 16 bits of that product fall below 65536 mod size, in which case it is
+// rejected (lemire's multiply-shift, so every character is exactly
+// uniform; at most 1 word in 256 is rejected for charsets under 256).
+//
+// chars are kept sorted, which turns them into a few runs of consecutive
+// byte values: an index maps to its character with one add plus one
+// compare-and-add per run, 16 at a time with sse2. charsets with more runs
+// than CHARSET_MAX_RUNS use the scalar table lookup, which always produces
+// the same output
+
+#define CHARSET_MAX 255
+#define CHARSET_MAX_RUNS 16
+
+typedef struct {
+  char chars[CHARSET_MAX + 1]; // sorted, NUL-terminated
+  uint16_t size;
+  uint16_t threshold; // 65536 mod size, words with lower low halves reject
+  int runs;           // 0 when there are too many for the vector path
+  uint8_t run_start[CHARSET_MAX_RUNS]; // first index of each run
+  uint8_t run_delta[CHARSET_MAX_RUNS]; // added to indices from that run on
+} charset_kernel_t;
+
+// build a kernel from the distinct bytes of chars
+generator_error_t charset_kernel_init(charset_kernel_t *kernel,
+                                      const char *chars);
+
+// fill out[0..n) with characters drawn from the calling thread's drbg
+generator_error_t charset_fill(const charset_kernel_t *kernel, char *out,
+                               size_t n);
+
+// the deterministic core of charset_fill(): maps word_count words and
+// returns how many of out[0..n) were filled. the vector and scalar versions
+// produce identical output, the scalar one is exposed for tests
+size_t charset_map_words(const charset_kernel_t *kernel,
+                         const uint16_t *words, size_t word_count, char *out,
+                         size_t n);
+size_t charset_map_words_scalar(const charset_kernel_t *kernel,
+                                const uint16_t *words, size_t word_count,
+                                char *out, size_t n);
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef CLUSTER_H
+#define CLUSTER_H
+
+#include "clovo/generator.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// families of near-identical passwords in a large corpus. two passwords are
+// linked when, ignoring case, deleting at most one character from each
+// makes them equal: one substitution, insertion or deletion apart, or two
+// edits at matching positions ("Summer2023!" / "summer2024!").
+//
+// passwords are visited most frequent first. one linked to a cluster's
+// representative joins it (the most frequent such cluster), any other
+// starts a cluster as its representative. every member is linked to its
+// representative, so a chain of links (password1, password12,
+// assword12, ...) can't pull unrelated passwords together the way the
+// connected components of the relation do.
+//
+// each representative stores itself and its one-character deletions as
+// keys in a single hash table, each password looks its own keys up. that
+// is length + 1 keys per password with no pairwise comparison, so building
+// is linear in the corpus
+
+typedef struct cluster_corpus cluster_corpus_t;
+
+// longest password clustered, longer lines are skipped
+#define CLUSTER_MAX_LENGTH 128
+
+typedef enum {
+  CLUSTER_TEXT,
+  CLUSTER_NDJSON // {"size":..,"distinct":..,"representative":..,"members":[..]}
+} cluster_format_t;
+
+typedef struct {
+  size_t lines;    // occurrences, duplicates included
+  size_t distinct; // distinct passwords
+  size_t first;    // first member, see cluster_member()
+} password_cluster_t;
+
+typedef struct {
+  size_t lines;    // passwords added, duplicates included
+  size_t distinct; // distinct passwords
+  size_t skipped;  // empty or longer than CLUSTER_MAX_LENGTH
+  size_t clusters; // clusters found by the last build
+  size_t clustered; // distinct passwords in those clusters
+} cluster_stats_t;
+
+cluster_corpus_t *cluster_corpus_create(void);
+void cluster_corpus_free(cluster_corpus_t *corpus);
+
+// add one occurrence of password[0..len)
+generator_error_t cluster_corpus_add(cluster_corpus_t *corpus,
+                                     const char *password, size_t len);
+
+// add every line of a file
+generator_error_t cluster_corpus_load(cluster_corpus_t *corpus,
+                                      const char *path);
+
+// link the passwords added so far and keep the clusters with at least
+// min_distinct distinct passwords, largest (by lines) first
+generator_error_t cluster_corpus_build(cluster_corpus_t *corpus,
+                                       size_t min_distinct);
+
+size_t cluster_count(const cluster_corpus_t *corpus);
+const password_cluster_t *cluster_at(const cluster_corpus_t *corpus,
+                                     size_t index);
+
+// k-th member of a cluster, most frequent first; member 0 is the
+// representative. count (may be NULL) gets its occurrences
+const char *cluster_member(const cluster_corpus_t *corpus,
+                           const password_cluster_t *cluster, size_t k,
+                           size_t *count);
+
+cluster_stats_t cluster_corpus_stats(const cluster_corpus_t *corpus);
+
+// write every built cluster with up to max_members members each
+void cluster_write(const cluster_corpus_t *corpus, FILE *out,
+                   cluster_format_t format, size_t max_members);
+
+#endif
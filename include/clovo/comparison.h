@@ -1,7 +1,11 @@
 #ifndef COMPARISON_H
 #define COMPARISON_H
 
+#include "clovo/generator.h"
+
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
 
 // similarity metrics
 typedef struct {
@@ -19,7 +23,53 @@ similarity_result_t compare_passwords(const char *pw1, const char *pw2);
 bool are_passwords_too_similar(const char *old_pw, const char *new_pw,
                                double threshold);
 
-// calculate edit distance (Levenshtein)
+// longest shorter input edit_distance() handles without allocating
+#define EDIT_DISTANCE_MAX_LENGTH 1024
+
+// calculate edit distance (Levenshtein) with bit-parallel column updates.
+// -1 when either string is NULL, or out of memory when both are longer
+// than EDIT_DISTANCE_MAX_LENGTH
 int edit_distance(const char *s1, const char *s2);
 
+// index of the first history entry within threshold edits of new_pw, -1
+// when there is none. each entry only runs the dp cells within threshold
+// of the diagonal (ukkonen's band) and stops as soon as a whole row is over
+// it; with sse2 sixteen entries share one pass, one byte lane each. NULL
+// entries are skipped
+int check_against_history(const char *new_pw, const char *const history[],
+                          size_t n, int threshold);
+
+// (old, new) pairs from a file, one per line: "old<TAB>new", or two csv
+// fields (quoted with "..." when they hold a comma or a quote) when the
+// line has no tab. further columns are ignored
+typedef enum {
+  COMPARE_BATCH_NDJSON,  // {"line":..,"similarity":..,"edit_distance":..,
+                         //  "too_similar":..} per pair
+  COMPARE_BATCH_CSV,     // line,similarity,edit_distance,too_similar
+  COMPARE_BATCH_SUMMARY  // nothing per pair, only the counts
+} compare_batch_format_t;
+
+typedef struct {
+  compare_batch_format_t format;
+  double threshold; // too similar above this similarity score
+  int threads;      // 0 = one per online cpu
+} compare_batch_options_t;
+
+typedef struct {
+  size_t lines;
+  size_t pairs;
+  size_t too_similar;
+  size_t malformed; // non-blank lines that aren't a pair, skipped
+} compare_batch_stats_t;
+
+// ndjson output, the 0.7 threshold compare_passwords() uses
+void init_compare_batch_options(compare_batch_options_t *options);
+
+// compare every pair of in on the batch worker pool (see batch.h) and
+// write one result per pair to out in input order. passwords are never
+// written back, results carry the line number instead
+generator_error_t compare_batch(FILE *in, FILE *out,
+                                const compare_batch_options_t *options,
+                                compare_batch_stats_t *stats);
+
 #endif
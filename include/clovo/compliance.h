@@ -0,0 +1,47 @@
+#ifndef COMPLIANCE_H
+#define COMPLIANCE_H
+
+#include "clovo/custom_policy.h"
+#include "clovo/generator.h"
+#include "clovo/policy.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+// a whole credential export checked against one policy, one password per
+// line, on the batch worker pool (see batch.h)
+
+typedef enum {
+  COMPLIANCE_NDJSON,  // {"line":..,"passed":..,"violations":[..]} per line
+  COMPLIANCE_CSV,     // line,passed,violations (names joined by '|')
+  COMPLIANCE_SUMMARY  // nothing per password, only the counts
+} compliance_format_t;
+
+typedef struct {
+  compliance_format_t format;
+  bool failing_only; // leave passing passwords out of the output
+  int threads;       // 0 = one per online cpu
+  // the policy to check, the custom one when it isn't NULL
+  const password_policy_t *policy;
+  const custom_policy_t *custom;
+} compliance_options_t;
+
+typedef struct {
+  size_t lines;
+  size_t passwords;
+  size_t failed;
+  size_t violations[POLICY_VIOLATION_COUNT]; // passwords breaking each rule
+} compliance_stats_t;
+
+// ndjson output of every password, no policy set yet
+void init_compliance_options(compliance_options_t *options);
+
+// check every non-blank line of in and write the verdicts to out (NULL to
+// discard them) in input order. passwords are never written back, verdicts
+// carry the line number instead, and no message is formatted on the way
+generator_error_t check_compliance(FILE *in, FILE *out,
+                                   const compliance_options_t *options,
+                                   compliance_stats_t *stats);
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef CUSTOM_POLICY_H
+#define CUSTOM_POLICY_H
+
+#include "clovo/analyzer.h"
+#include "clovo/generator.h"
+#include "clovo/policy.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+// policies read from a config file, one [name] section each:
+//
+//   # a # starts a comment anywhere on a line
+//   [corp]
+//   min_length = 12
+//   max_length = 64
+//   min_lower = 1          # also min_upper, min_digits, min_symbols
+//   max_repeat = 2         # longest run of one character
+//   allow_common = no      # also allow_sequential
+//   min_entropy = 50
+//   banned = acme, widget  # case-insensitive, may be given more than once
+//
+// banned substrings can't contain ',' or '#'. a setting left out is no
+// rule, and so is a limit of 0
+//
+// each policy is compiled when loaded: its rules become a flat table of
+// (measure, min, max) rows and the banned substrings one aho-corasick
+// automaton, so a check is a single pass over the password filling in the
+// measures and a short loop over the table. nothing changes after loading,
+// any number of threads can check against the same set without locking
+
+typedef struct policy_set policy_set_t;
+typedef struct custom_policy custom_policy_t;
+
+// longest policy name
+#define CUSTOM_POLICY_NAME_MAX 63
+
+// load every policy in path. NULL on failure with *error (may be NULL)
+// set to GEN_ERROR_FILE_ACCESS, GEN_ERROR_INVALID_CONFIG or
+// GEN_ERROR_NULL_POINTER, and *error_line (may be NULL) to the offending
+// line, 0 when the error isn't tied to one
+policy_set_t *policy_set_load(const char *path, generator_error_t *error,
+                              int *error_line);
+
+// the same for a config already in memory, text[0..len)
+policy_set_t *policy_set_parse(const char *text, size_t len,
+                               generator_error_t *error, int *error_line);
+
+void policy_set_free(policy_set_t *set);
+
+size_t policy_set_count(const policy_set_t *set);
+// policy i in file order, NULL past the end
+const custom_policy_t *policy_set_get(const policy_set_t *set, size_t i);
+// policy by name, NULL if there is none
+const custom_policy_t *policy_set_find(const policy_set_t *set,
+                                       const char *name);
+
+const char *custom_policy_name(const custom_policy_t *policy);
+
+// the detectors the policy's rules read, see analyze_password_ex()
+unsigned custom_policy_features(const custom_policy_t *policy);
+
+// violation mask (bits 1u << policy_violation_t) of pw[0..len) under
+// policy, 0 when it passes and POLICY_VIOLATION_INVALID without either.
+// analysis may be NULL; when given it must be of the same password with at
+// least custom_policy_features(policy), which lets one analysis serve
+// several policies
+uint32_t custom_policy_check(const custom_policy_t *policy, const char *pw,
+                             size_t len, const password_strength_t *analysis);
+
+// message for one violation of the policy with its limit filled in,
+// written to buffer like snprintf. returns the length of the message
+size_t custom_policy_describe(const custom_policy_t *policy,
+                              policy_violation_t violation, char *buffer,
+                              size_t size);
+
+#endif
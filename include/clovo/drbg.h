@@ -0,0 +1,29 @@
+#ifndef DRBG_H
+#define DRBG_H
+
+#include "clovo/generator.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+// per-thread ChaCha20 generator seeded from the system csprng. output is
+// produced a buffer at a time and the key is replaced from the keystream on
+// every refill (fast key erasure), so old output can't be recovered from the
+// current state. reseeded from the system every DRBG_RESEED_BYTES and after
+// fork()
+
+#define DRBG_RESEED_BYTES (1u << 20)
+
+// fill out with n random bytes
+generator_error_t drbg_random_bytes(void *out, size_t n);
+
+// force a reseed of the calling thread's generator on its next use
+void drbg_reseed(void);
+
+// wipe the calling thread's generator state
+void drbg_clear(void);
+
+// how many times the calling thread read the system csprng
+uint64_t drbg_seed_count(void);
+
+#endif
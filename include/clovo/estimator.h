@@ -0,0 +1,55 @@
+#ifndef ESTIMATOR_H
+#define ESTIMATOR_H
+
+#include <stdbool.h>
+
+// only this many leading bytes are matched, the tail is scored as bruteforce.
+// together with the caps below this bounds the per-password work
+#define ESTIMATE_MAX_LENGTH 64
+#define ESTIMATE_MAX_MATCHES 256
+#define ESTIMATE_MAX_SEQUENCE 16
+
+// kinds of matches the estimator knows about
+typedef enum {
+  MATCH_BRUTEFORCE,
+  MATCH_DICTIONARY,
+  MATCH_KEYBOARD,
+  MATCH_SEQUENCE,
+  MATCH_REPEAT,
+  MATCH_DATE
+} match_pattern_t;
+
+// one match over password[i..j] (inclusive)
+typedef struct {
+  match_pattern_t pattern;
+  int i;
+  int j;
+  double guesses;
+
+  // pattern specific details
+  int rank;         // dictionary: rank in the common list
+  bool l33t;        // dictionary: matched after undoing substitutions
+  int turns;        // keyboard: direction changes along the walk
+  int repeat_count; // repeat: how many times the base repeats
+  int year;         // date: parsed year
+} match_t;
+
+// cheapest decomposition of a password into matches
+typedef struct {
+  double guesses;
+  double guesses_log10;
+  int sequence_length;
+  match_t sequence[ESTIMATE_MAX_SEQUENCE];
+} guess_estimate_t;
+
+// estimate the number of guesses an attacker needs (zxcvbn style)
+guess_estimate_t estimate_guesses(const char *password);
+
+// list all matches found in password[0..length), returns the match count
+int enumerate_matches(const char *password, int length, match_t *matches,
+                      int max_matches);
+
+// get pattern name
+const char *match_pattern_to_string(match_pattern_t pattern);
+
+#endif
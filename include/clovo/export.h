@@ -2,6 +2,7 @@
 #define EXPORT_H
 
 #include "clovo/analyzer.h"
+#include <stddef.h>
 #include <stdio.h>
 
 // export formats
@@ -15,6 +16,15 @@ int export_analysis(const password_strength_t *result, const char *password,
 int export_analysis_stdout(const password_strength_t *result,
                            const char *password, export_format_t format);
 
+// analysis as one line of json with the fields --json prints, but not the
+// password, written to buffer like snprintf. returns the length of the
+// json, which was cut short if that is size or more
+size_t export_analysis_json(const password_strength_t *result, char *buffer,
+                            size_t size);
+
+// text as a quoted json string, written to buffer like snprintf
+size_t export_json_string(const char *text, char *buffer, size_t size);
+
 // export batch results
 int export_batch_results(const password_strength_t *results,
                          const char **passwords, int count,
@@ -0,0 +1,32 @@
+#ifndef FUZZY_H
+#define FUZZY_H
+
+#include <stddef.h>
+
+// near-match lookup in a fixed word list (symspell's symmetric deletions).
+// every entry is stored under itself and each string left after deleting
+// up to FUZZY_MAX_DISTANCE of its characters; a query generates its own
+// deletions and looks each one up. two strings within k edits always share
+// such a key, so the candidates found are verified with edit_distance()
+// and nothing else in the list is touched: lookup cost depends on the
+// query length, not on the list size. case is ignored throughout
+
+typedef struct fuzzy_index fuzzy_index_t;
+
+// deletions stored per entry, the largest distance a query can ask for
+#define FUZZY_MAX_DISTANCE 2
+// longest entry indexed, longer ones are never reported
+#define FUZZY_MAX_LENGTH 32
+
+// index entries[0..count). the entries are borrowed and must outlive the
+// index. NULL when out of memory
+fuzzy_index_t *fuzzy_index_build(const char *const *entries, size_t count);
+void fuzzy_index_free(fuzzy_index_t *index);
+
+// distance from s[0..len) to the nearest entry within max_distance edits,
+// -1 when there is none. ties go to the lowest entry index, which is
+// stored in *entry (may be NULL)
+int fuzzy_index_nearest(const fuzzy_index_t *index, const char *s, size_t len,
+                        int max_distance, size_t *entry);
+
+#endif
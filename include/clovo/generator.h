@@ -1,6 +1,8 @@
 #ifndef GENERATOR_H
 #define GENERATOR_H
 
+#include "clovo/policy.h"
+
 #include <stdbool.h>
 #include <stddef.h>
 
@@ -13,7 +15,10 @@ typedef enum {
   GEN_ERROR_BUFFER_TOO_SMALL = -4,
   GEN_ERROR_RANDOM_FAILED = -5,
   GEN_ERROR_COMMON_PASSWORD = -6,
-  GEN_ERROR_FILE_ACCESS = -7
+  GEN_ERROR_FILE_ACCESS = -7,
+  GEN_ERROR_NOT_UNIQUE = -8,
+  GEN_ERROR_POLICY_UNSATISFIED = -9,
+  GEN_ERROR_INVALID_CONFIG = -10
 } generator_error_t;
 
 // generation options
@@ -41,9 +46,48 @@ generator_error_t generate_password(char *buffer, size_t buffer_size,
                                     size_t length,
                                     const generator_options_t *opts);
 
+// generate a password that satisfies policy by construction: one character
+// of every required class at a random position, the rest from the whole
+// charset (opts' classes plus the required ones), fisher-yates shuffled.
+// only candidates with a sequence, a run or a common word the policy
+// forbids are drawn again. length is checked against the policy, not the
+// opts bounds. attempts (may be NULL) gets the number of candidates drawn
+generator_error_t generate_password_for_policy(char *buffer,
+                                               size_t buffer_size,
+                                               size_t length,
+                                               const password_policy_t *policy,
+                                               const generator_options_t *opts,
+                                               int *attempts);
+
 // check if its a common password
 bool is_common_password(const char *ps);
 
+// rank of s[0..len) in the loaded common list (1 = most common), 0 if absent
+size_t common_password_rank(const char *s, size_t len);
+
+// distance (0..FUZZY_MAX_DISTANCE, see fuzzy.h) from ps to the nearest
+// common password within max_distance edits ignoring case, -1 when none is
+// that close. ties go to the more common entry, stored in *nearest (may be
+// NULL) and valid until the list is freed
+int nearest_common_password(const char *ps, int max_distance,
+                            const char **nearest);
+
+// the list is_common_password() checks: the loaded file with the built-in
+// list appended, or the built-in list alone. entry index has rank index + 1
+// unless it repeats an earlier entry
+size_t common_password_count(void);
+const char *common_password_at(size_t index);
+
+// ranks of all prefixes of s[0..max_len), see generator.c
+size_t common_password_prefix_ranks(const char *s, size_t max_len,
+                                    size_t *ranks);
+
+// fill buffer with bytes from the system csprng
+generator_error_t secure_random_bytes(unsigned char *buffer, size_t size);
+
+// zero memory that held secrets, never optimized away
+void secure_wipe(void *buffer, size_t size);
+
 // initialize generator module
 generator_error_t init_generator(const char *data_dir);
 
@@ -53,7 +97,8 @@ void cleanup_generator(void);
 // get error message
 const char *generator_error_string(generator_error_t err);
 
-// generate passphrase (multiple words)
+// generate passphrase (multiple words) from the built-in list, see
+// passphrase.h for word lists and formatting options
 generator_error_t generate_passphrase(char *buffer, size_t buffer_size,
                                       int word_count,
                                       const generator_options_t *opts);
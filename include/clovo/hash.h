@@ -0,0 +1,11 @@
+#ifndef HASH_H
+#define HASH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// SipHash-2-4 of data under a 128-bit key. keyed so that tables indexed by
+// it can't be flooded and don't reveal what they hold
+uint64_t siphash24(const uint64_t key[2], const void *data, size_t len);
+
+#endif
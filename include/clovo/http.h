@@ -0,0 +1,58 @@
+#ifndef HTTP_H
+#define HTTP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// the part of http/1.1 the server speaks: requests with a content-length
+// body or none (no chunked encoding), keep-alive and pipelining. nothing
+// is copied, a request points into the bytes it was parsed from
+
+typedef enum {
+  HTTP_COMPLETE,   // a whole request, length bytes
+  HTTP_INCOMPLETE, // the rest hasn't arrived yet
+  HTTP_TOO_LARGE,  // longer than max_request
+  HTTP_BAD_REQUEST
+} http_parse_t;
+
+typedef struct {
+  const char *method;
+  size_t method_len;
+  const char *path; // without the query string
+  size_t path_len;
+  const char *body;
+  size_t body_len;
+  bool keep_alive; // what the version and the connection header ask for
+  size_t length;   // the whole request, head and body
+} http_request_t;
+
+// parse the request at the start of data[0..len), at most max_request
+// bytes with its body. request is only filled in for HTTP_COMPLETE
+http_parse_t http_parse_request(const char *data, size_t len,
+                                size_t max_request, http_request_t *request);
+
+// true when the request is method name on path
+bool http_request_is(const http_request_t *request, const char *method,
+                     const char *path);
+
+// status line and headers of a json response with body_len bytes of
+// body, written to buffer like snprintf
+size_t http_response_head(char *buffer, size_t size, int status,
+                          size_t body_len, bool keep_alive);
+
+// a field of a flat json object: the string, number or literal value of
+// name, decoded, in value[0..size)
+typedef struct {
+  const char *name;
+  char *value;
+  size_t size;
+  bool found;
+} http_json_field_t;
+
+// fill in fields from the json object text[0..len). other members are
+// skipped. false when the text isn't one flat object, a value doesn't fit
+// its field or a string holds \u0000
+bool http_json_fields(const char *text, size_t len, http_json_field_t *fields,
+                      size_t count);
+
+#endif
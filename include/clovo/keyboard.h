@@ -0,0 +1,27 @@
+#ifndef KEYBOARD_H
+#define KEYBOARD_H
+
+// a run of keys where each one touches the previous one on some layout
+typedef struct {
+  int i; // first character
+  int j; // last character (inclusive)
+  int turns;
+  int shifted;
+  int layout;
+} keyboard_walk_t;
+
+// find walks of 3+ keys on any supported layout in one pass over s[0..len)
+// returns the number of walks written, ordered by end position
+int find_keyboard_walks(const char *s, int len, keyboard_walk_t *walks,
+                        int max_walks);
+
+// length of the longest walk in s[0..len), 0 if there is none
+int longest_keyboard_walk(const char *s, int len);
+
+// guesses needed to find a walk of this shape on its layout
+double keyboard_walk_guesses(const keyboard_walk_t *walk);
+
+// get layout name
+const char *keyboard_layout_name(int layout);
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef MARKOV_H
+#define MARKOV_H
+
+#include "clovo/generator.h"
+
+#include <stddef.h>
+
+// pronounceable passwords from an order-2 letter model trained at build
+// time (tools/gen_markov.c). each row of the model is a cumulative
+// frequency array of 26 uint16 summing to a power of two, so the whole
+// table is ~37 KB and a letter costs one uniform draw plus a binary search.
+// candidates on the common password list are drawn again. the quantized
+// table is the model and the rejected mass is accounted for, so the
+// entropies below are exact for what the generator actually produces
+
+#define PRONOUNCEABLE_MIN_LENGTH 8
+#define PRONOUNCEABLE_MAX_LENGTH 64
+
+// generate length lowercase letters. surprisal (may be NULL) gets
+// -log2 P(password): the bits an attacker who knows the model needs to
+// guess this particular password
+generator_error_t generate_pronounceable(char *buffer, size_t buffer_size,
+                                         size_t length, double *surprisal);
+
+// -log2 P(password) for any string, INFINITY if the generator can't
+// produce it
+double pronounceable_surprisal(const char *password);
+
+// shannon entropy in bits of the generator's output at this length, the
+// average surprisal over everything it can produce
+double pronounceable_entropy(size_t length);
+
+#endif
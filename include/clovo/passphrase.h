@@ -0,0 +1,81 @@
+#ifndef PASSPHRASE_H
+#define PASSPHRASE_H
+
+#include "clovo/generator.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define PASSPHRASE_MAX_WORDS 32
+#define PASSPHRASE_MAX_DIGITS 8
+#define PASSPHRASE_MAX_SEPARATOR 8
+// longer entries are skipped when a list is loaded
+#define WORDLIST_MAX_WORD 64
+
+// one word: arena[offset .. offset + length), not NUL-terminated
+typedef struct {
+  uint32_t offset;
+  uint32_t length;
+} wordlist_entry_t;
+
+// a word list: the raw file contents (mapped read-only when loaded from
+// disk) plus an offset table into it. one word per line; for lines with
+// several fields (diceware "11111<tab>abacus") the last field is the word.
+// blank lines, '#' comments, all-digit words and case-insensitive
+// duplicates are dropped so every entry is a distinct choice
+typedef struct {
+  const char *arena;
+  size_t arena_size;
+  wordlist_entry_t *entries;
+  uint32_t count;
+  uint32_t max_length; // longest word in bytes
+  uint32_t cased;      // words starting with an ascii letter
+  void *map;           // mapping or heap copy backing arena, NULL if borrowed
+  size_t map_size;
+} wordlist_t;
+
+typedef enum {
+  PASSPHRASE_LOWER,       // apple-banana
+  PASSPHRASE_TITLE,       // Apple-Banana
+  PASSPHRASE_UPPER,       // APPLE-BANANA
+  PASSPHRASE_RANDOM_TITLE // each word title case or not, one bit each
+} passphrase_case_t;
+
+typedef struct {
+  int word_count;
+  const char *separator; // up to PASSPHRASE_MAX_SEPARATOR bytes, may be ""
+  passphrase_case_t capitalization;
+  int digits; // length of a random number inserted as its own token
+  const wordlist_t *words; // NULL = built-in list
+} passphrase_options_t;
+
+// load a word list from a file
+generator_error_t wordlist_load(wordlist_t *list, const char *path);
+
+// index words in data[0..size), which must outlive the list
+generator_error_t wordlist_from_buffer(wordlist_t *list, const char *data,
+                                       size_t size);
+
+void wordlist_free(wordlist_t *list);
+
+// the small list compiled into the program
+const wordlist_t *builtin_wordlist(void);
+
+// default options: 4 built-in words joined by '-', lower case, no digits
+void init_passphrase_options(passphrase_options_t *opts);
+
+// bytes needed for the longest passphrase opts can produce, without the NUL
+size_t passphrase_max_length(const passphrase_options_t *opts);
+
+// entropy in bits of a passphrase drawn with opts. exact as long as the
+// separator doesn't occur inside words; with an empty separator it is an
+// upper bound because word boundaries can become ambiguous
+double passphrase_entropy(const passphrase_options_t *opts);
+
+// generate a passphrase with one forward pass over buffer. entropy (may be
+// NULL) gets passphrase_entropy(opts)
+generator_error_t generate_passphrase_ex(char *buffer, size_t buffer_size,
+                                         const passphrase_options_t *opts,
+                                         double *entropy);
+
+#endif
@@ -1,7 +1,11 @@
 #ifndef POLICY_H
 #define POLICY_H
 
+#include "clovo/analyzer.h"
+
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
 // policy types
 typedef enum {
@@ -23,22 +27,96 @@ typedef struct {
   bool allow_sequential_patterns;
   bool allow_repeated_chars;
   int min_entropy;
+  // analyzer detectors validate_policy() runs (analyze_feature_t), the
+  // ones the rules above need as set by init_policy()
+  unsigned features;
 } password_policy_t;
 
-// policy validation result
+// policy validation result with the messages, over 1.2 KB. checking many
+// passwords should use policy_verdict_t instead
 typedef struct {
   bool passed;
   int violations_count;
   char violations[10][128]; // max 10 violation messages
 } policy_result_t;
 
+// rules a password can break, bit (1u << code) in a violation mask
+typedef enum {
+  POLICY_VIOLATION_TOO_SHORT,
+  POLICY_VIOLATION_TOO_LONG,
+  POLICY_VIOLATION_LOWERCASE, // too few lowercase letters
+  POLICY_VIOLATION_UPPERCASE,
+  POLICY_VIOLATION_DIGITS,
+  POLICY_VIOLATION_SYMBOLS,
+  POLICY_VIOLATION_SEQUENTIAL,
+  POLICY_VIOLATION_REPEATED,
+  POLICY_VIOLATION_COMMON,
+  POLICY_VIOLATION_ENTROPY,
+  POLICY_VIOLATION_REPEAT_RUN, // a character repeated too many times
+  POLICY_VIOLATION_BANNED,     // contains a banned substring
+  POLICY_VIOLATION_INVALID,    // no password or no policy
+  POLICY_VIOLATION_COUNT
+} policy_violation_t;
+
+// policy validation result without any text: the rules broken and what
+// was measured. messages are only made by policy_violation_message() or
+// policy_verdict_to_result() when they are shown
+typedef struct {
+  uint32_t violations; // bits 1u << policy_violation_t, 0 = passed
+  int length;          // characters
+  float entropy;       // bits, 0 unless the analysis had ANALYZE_ENTROPY
+} policy_verdict_t;
+
 // initialize policy with defaults
 void init_policy(password_policy_t *policy, policy_type_t type);
 
-// validate password against policy
+// the detectors policy's rules read, see analyze_password_ex()
+unsigned policy_features(const password_policy_t *policy);
+
+// validate password against policy. only the detectors in
+// policy->features run, plus any a rule changed after init_policy() needs
 policy_result_t validate_policy(const char *password,
                                 const password_policy_t *policy);
 
+// validate an existing analysis against policy (no re-analysis). the
+// analysis needs at least policy_features(policy)
+policy_result_t validate_policy_analysis(const password_strength_t *analysis,
+                                         const password_policy_t *policy);
+
+// validate_policy() and validate_policy_analysis() without formatting
+// any messages
+policy_verdict_t evaluate_policy(const char *password,
+                                 const password_policy_t *policy);
+policy_verdict_t evaluate_policy_analysis(const password_strength_t *analysis,
+                                          const password_policy_t *policy);
+
+// message for one violation of policy (may be NULL for the limits), the
+// same text validate_policy() gives, written to buffer like snprintf.
+// returns the length of the message
+size_t policy_violation_message(const password_policy_t *policy,
+                                policy_violation_t violation, char *buffer,
+                                size_t size);
+
+// every message of verdict, in policy_violation_t order
+policy_result_t policy_verdict_to_result(const policy_verdict_t *verdict,
+                                         const password_policy_t *policy);
+
+// most policies one validate_policies() call evaluates, one bit each
+#define POLICY_SET_MAX 32
+
+// analyze password once, with the detectors every policy in
+// policies[0..count) needs, and check each policy against that analysis.
+// bit i of the result is set when policies[i] passed. details (may be NULL)
+// receives count results with the violation messages; without it no
+// message is formatted. policies past POLICY_SET_MAX are ignored
+uint32_t validate_policies(const char *password,
+                           const password_policy_t *policies, size_t count,
+                           policy_result_t *details);
+
+// short stable name of a violation ("too_short", "common", ...) for
+// machine-readable output
+const char *policy_violation_name(policy_violation_t violation);
+
 // get policy name
 const char *policy_type_to_string(policy_type_t type);
 
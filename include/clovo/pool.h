@@ -0,0 +1,56 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include "clovo/analyzer.h"
+#include "clovo/generator.h"
+#include "clovo/policy.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ring of passwords generated, checked and analyzed ahead of time by a
+// background thread, for callers that need a password with low latency.
+// taking one is a single compare-and-swap on the ring head; the slot is
+// wiped as soon as it has been copied out. the thread wakes up when fewer
+// than low_water passwords are left and fills the ring back up. every
+// password still in the ring is wiped when the pool is destroyed
+typedef struct password_pool password_pool_t;
+
+#define POOL_DEFAULT_CAPACITY 1024
+#define POOL_MAX_LENGTH 256
+
+typedef struct {
+  size_t capacity;  // passwords kept ready, rounded up to a power of two
+  size_t low_water; // refill below this many (0 = a quarter of capacity)
+  size_t length;
+  const generator_options_t *opts; // NULL = defaults, copied
+  const password_policy_t *policy; // NULL = none, copied
+} pool_options_t;
+
+typedef struct {
+  uint64_t issued;    // passwords taken
+  uint64_t generated; // passwords put in the ring
+  uint64_t empty;     // takes that found the ring empty and generated inline
+  size_t available;
+  size_t capacity;
+} pool_stats_t;
+
+// default options: 1024 passwords of 16 characters, no policy
+void init_pool_options(pool_options_t *options);
+
+// create a pool and start its refill thread. NULL when the options can't
+// produce a password, out of memory or the thread can't be started
+password_pool_t *password_pool_create(const pool_options_t *options);
+
+// stop the refill thread, wipe every pooled password and free the pool
+void password_pool_destroy(password_pool_t *pool);
+
+// copy the next password into buffer and its analysis into analysis (may be
+// NULL). when the ring is empty one is generated on the spot
+generator_error_t password_pool_take(password_pool_t *pool, char *buffer,
+                                     size_t buffer_size,
+                                     password_strength_t *analysis);
+
+pool_stats_t password_pool_stats(password_pool_t *pool);
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef SAMPLER_H
+#define SAMPLER_H
+
+#include "clovo/generator.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+// uniform random indices in [0, range) with Lemire's multiply-shift method.
+// several indices come out of each 64-bit word: multiplying by range moves
+// one index into the high half and leaves the rest of the randomness in the
+// low half for the next one. a word is only rejected when its final low
+// half falls below 2^64 mod range^k (k indices per word), which keeps every
+// index exactly uniform. k is chosen so that happens less than 1 in 256
+
+// largest number of indices drawn from one word for this range
+int sampler_batch_size(uint32_t range);
+
+// fill out with n indices in [0, range), all drawn from the calling thread's
+// drbg in one block (plus a refill in the rare case of rejections)
+generator_error_t random_indices(uint32_t range, uint32_t *out, size_t n);
+
+// single index in [0, range)
+generator_error_t random_index(uint32_t range, uint32_t *out);
+
+// unbiased fisher-yates shuffle of items[0..n). each swap position uses
+// one 32-bit word with the same multiply-shift rejection
+generator_error_t random_shuffle(char *items, size_t n);
+
+// the deterministic core of random_indices(): turns word_count words into
+// indices and returns how many of out[0..n) were filled. exposed for tests
+size_t indices_from_words(uint32_t range, const uint64_t *words,
+                          size_t word_count, uint32_t *out, size_t n);
+
+#endif
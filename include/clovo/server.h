@@ -0,0 +1,81 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include "clovo/custom_policy.h"
+#include "clovo/generator.h"
+
+#include <stddef.h>
+
+// long-running checker, so the common password list is loaded once
+// instead of by every process a signup starts. it reads one request per
+// line, answered by one line of json, in order:
+//
+//   analyze <password>          the fields --json prints, minus the password
+//   policy <name> <password>    {"policy":..,"passed":..,"violations":[..]}
+//   generate [length]           {"password":".."}, 16 characters by default
+//   compare <old>\t<new>        {"similarity":..,"edit_distance":..,
+//                                "too_similar":..}
+//   ping                        {"ok":true}
+//
+// a request that can't be answered gets {"error":".."}. blank lines are
+// skipped. speaking http/1.1 instead it takes the same requests as json
+// bodies, with keep-alive and pipelining:
+//
+//   POST /analyze   {"password":..}
+//   POST /policy    {"policy":..,"password":..}
+//   POST /generate  {"length":..}, or GET /generate for the default
+//   POST /compare   {"old":..,"new":..}
+//
+// and answers with the json above, errors with a 4xx status.
+//
+// one thread runs an edge-triggered epoll loop over every socket and hands
+// the whole requests a connection has sent to a pool of workers as one
+// job, so a connection never has more than one job running and its
+// answers keep their order, while different connections are served in
+// parallel. every connection buffer is allocated when the server is made
+
+// longest request: a line with its newline, or an http request with its
+// headers and body
+#define SERVER_MAX_REQUEST 4096
+
+typedef struct server server_t;
+
+typedef enum { SERVER_LINES, SERVER_HTTP } server_protocol_t;
+
+typedef struct {
+  server_protocol_t protocol;
+  // a unix socket, replaced if one is left behind by a server that is gone,
+  // or NULL to listen on tcp
+  const char *socket_path;
+  const char *host;    // NULL = 127.0.0.1
+  int port;            // 0 = any free one, see server_port()
+  int threads;         // workers, 0 = one per online cpu
+  int max_connections; // more are closed right away, 0 = 1024
+  // policies "policy <name>" finds besides nist, pci and basic (may be NULL)
+  const policy_set_t *custom;
+} server_options_t;
+
+// line protocol, no socket or port yet, defaults for the rest
+void init_server_options(server_options_t *options);
+
+// bind and listen on the socket (a unix one readable and writable by owner
+// and group) and fill the generate pool. error (may be NULL) says why when
+// NULL is returned
+server_t *server_create(const server_options_t *options,
+                        generator_error_t *error);
+
+// the tcp port listened on, -1 on a unix socket
+int server_port(const server_t *server);
+
+// serve until server_stop(), on the calling thread
+generator_error_t server_run(server_t *server);
+
+// make server_run() return once the requests being handled are answered.
+// safe to call from a signal handler or another thread
+void server_stop(server_t *server);
+
+// close every connection, remove the socket and free the server, after
+// server_run() returned
+void server_destroy(server_t *server);
+
+#endif
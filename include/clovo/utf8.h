@@ -0,0 +1,33 @@
+#ifndef UTF8_H
+#define UTF8_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// returned by utf8_decode() for malformed input
+#define UTF8_INVALID 0xFFFFFFFFu
+
+// character classes of a whole string
+typedef struct {
+  int code_points;
+  // CHAR_LOWER/UPPER/DIGIT/LETTER (see charclass.h) for letters and digits
+  // of any script, CHAR_PUNCT for every other symbol, space or bad byte.
+  // combining marks add nothing, they belong to the previous letter
+  unsigned classes;
+  bool ascii; // no byte >= 0x80
+} text_class_t;
+
+// decode one code point from s[0..len), len > 0. returns the bytes used
+// (1-4); overlong forms, surrogates and truncated sequences use one byte and
+// give UTF8_INVALID
+size_t utf8_decode(const char *s, size_t len, uint32_t *code_point);
+
+// CHAR_* class of a code point (0 for combining marks)
+unsigned unicode_class(uint32_t code_point);
+
+// count code points and collect classes of s[0..len). runs of ascii are
+// classified 16 bytes at a time, only non-ascii bytes are decoded
+text_class_t classify_text(const char *s, size_t len);
+
+#endif
@@ -1,7 +1,12 @@
 #include "clovo/analyzer.h"
+#include "clovo/charclass.h"
+#include "clovo/estimator.h"
+#include "clovo/generator.h"
+#include "clovo/keyboard.h"
+#include "clovo/utf8.h"
 
-#include <ctype.h>
 #include <math.h>
+#include <stdlib.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <string.h>
@@ -15,61 +20,30 @@ static const char *common_words[] = {
     "user",     "root",     "guest",    "system",  "service",  "account",
     "access",   "security", NULL};
 
-// keyboard patterns (horizontal sequences)
-static const char *keyboard_patterns[] = {
-    "qwerty",   "asdfgh", "zxcvbn", "qwertyuiop", "asdfghjkl",
-    "zxcvbnm",  "123456", "654321", "qwerty123",  "1qaz2wsx",
-    "1q2w3e4r", "qwe123", NULL};
-
 // check if string contains a sequential pattern (123, abc, etc)
-static bool has_sequential(const char *str, int len) {
+bool has_sequential(const char *str, int len) {
   if (len < 3)
     return false;
 
   for (int i = 0; i <= len - 3; i++) {
-    // check forward sequences
-    if (isdigit(str[i]) && isdigit(str[i + 1]) && isdigit(str[i + 2])) {
-      int diff1 = str[i + 1] - str[i];
-      int diff2 = str[i + 2] - str[i + 1];
-      if (diff1 == diff2 && (diff1 == 1 || diff1 == -1)) {
-        return true;
-      }
-    }
-    // check letter sequences
-    if (isalpha(str[i]) && isalpha(str[i + 1]) && isalpha(str[i + 2])) {
-      char c1 = tolower(str[i]);
-      char c2 = tolower(str[i + 1]);
-      char c3 = tolower(str[i + 2]);
-      if (c2 - c1 == 1 && c3 - c2 == 1) {
-        return true;
-      }
-    }
-  }
-  return false;
-}
-
-// check if string contains keyboard pattern
-static bool has_keyboard_pattern(const char *str) {
-  char lower[256];
-  int len = strlen(str);
-  if (len >= 256)
-    len = 255;
-
-  for (int i = 0; i < len; i++) {
-    lower[i] = tolower((unsigned char)str[i]);
-  }
-  lower[len] = '\0';
-
-  for (int i = 0; keyboard_patterns[i] != NULL; i++) {
-    if (strstr(lower, keyboard_patterns[i]) != NULL) {
+    // three digits stepping by one either way, or three letters (folded,
+    // so any case) stepping forwards. run holds the class bits they share
+    char c1 = char_fold(str[i]);
+    char c2 = char_fold(str[i + 1]);
+    char c3 = char_fold(str[i + 2]);
+    unsigned run = char_class(c1) & char_class(c2) & char_class(c3);
+    int diff1 = c2 - c1;
+    int diff2 = c3 - c2;
+    if ((run & CHAR_DIGIT) && diff1 == diff2 && (diff1 == 1 || diff1 == -1))
+      return true;
+    if ((run & CHAR_ALPHA) && diff1 == 1 && diff2 == 1)
       return true;
-    }
   }
   return false;
 }
 
 // check for repeated characters (aaa, 111, etc)
-static bool has_repeated_chars(const char *str, int len) {
+bool has_repeated_chars(const char *str, int len) {
   if (len < 3)
     return false;
 
@@ -105,19 +79,14 @@ static bool has_repeated_pattern(const char *str, int len) {
   return false;
 }
 
-// check if password contains dictionary words (made non-static for use in
-// leetspeak detection)
-static bool contains_dictionary_word_internal(const char *str);
-
-static bool contains_dictionary_word_internal(const char *str) {
+// check if password contains dictionary words
+bool contains_dictionary_word(const char *str) {
   char lower[256];
   int len = strlen(str);
   if (len >= 256)
     len = 255;
 
-  for (int i = 0; i < len; i++) {
-    lower[i] = tolower((unsigned char)str[i]);
-  }
+  char_fold_copy(lower, str, len);
   lower[len] = '\0';
 
   for (int i = 0; common_words[i] != NULL; i++) {
@@ -128,28 +97,40 @@ static bool contains_dictionary_word_internal(const char *str) {
   return false;
 }
 
-void detect_patterns(password_strength_t *ps, const char *password) {
-  if (!ps || !password)
-    return;
-
-  ps->has_sequential_pattern = has_sequential(password, ps->length);
-  ps->has_keyboard_pattern = has_keyboard_pattern(password);
-
-  // apply penalty for patterns
+static void detect_sequences(password_strength_t *ps, const char *password) {
+  ps->has_sequential_pattern = has_sequential(password, ps->byte_length);
   if (ps->has_sequential_pattern) {
     ps->pattern_penalty += 15;
   }
+}
+
+static void detect_keyboard_walks(password_strength_t *ps,
+                                  const char *password) {
+  // walks over adjacent keys on qwerty/azerty/qwertz/dvorak/keypad,
+  // three keys happen by accident too often to count
+  ps->keyboard_walk_length = longest_keyboard_walk(password, ps->byte_length);
+  ps->has_keyboard_pattern = ps->keyboard_walk_length >= 4;
   if (ps->has_keyboard_pattern) {
-    ps->pattern_penalty += 20;
+    // 10 for four keys up to 20 for six or more
+    int penalty = (ps->keyboard_walk_length - 2) * 5;
+    ps->pattern_penalty += penalty < 20 ? penalty : 20;
   }
 }
 
+void detect_patterns(password_strength_t *ps, const char *password) {
+  if (!ps || !password)
+    return;
+
+  detect_sequences(ps, password);
+  detect_keyboard_walks(ps, password);
+}
+
 void detect_repetitions(password_strength_t *ps, const char *password) {
   if (!ps || !password)
     return;
 
-  ps->has_repeated_chars = has_repeated_chars(password, ps->length);
-  ps->has_repeated_pattern = has_repeated_pattern(password, ps->length);
+  ps->has_repeated_chars = has_repeated_chars(password, ps->byte_length);
+  ps->has_repeated_pattern = has_repeated_pattern(password, ps->byte_length);
 
   // apply penalty for repetitions
   if (ps->has_repeated_chars) {
@@ -164,7 +145,7 @@ void check_dictionary_words(password_strength_t *ps, const char *password) {
   if (!ps || !password)
     return;
 
-  ps->contains_dictionary_word = contains_dictionary_word_internal(password);
+  ps->contains_dictionary_word = contains_dictionary_word(password);
 
   // apply penalty for dictionary words
   if (ps->contains_dictionary_word) {
@@ -189,15 +170,24 @@ void estimate_crack_time(password_strength_t *ps) {
   // divide by 2 because on average you find it halfway through
   ps->crack_time_seconds = total_combinations / (2.0 * attempts_per_second);
 
+  // the guess estimate knows where the patterns are, prefer it when it
+  // says the password falls sooner than its character pool suggests
+  if (ps->guesses > 0.0) {
+    double guess_time = ps->guesses / attempts_per_second;
+    if (guess_time < ps->crack_time_seconds)
+      ps->crack_time_seconds = guess_time;
+  }
+
   // if entropy is very low, set minimum time
   if (ps->entropy < 10) {
     ps->crack_time_seconds = 0.001; // milliseconds
   }
 }
 
-// format crack time in human readable format
+// format crack time in human readable format. one buffer per thread, the
+// server formats analyses on several workers at once
 const char *format_crack_time(double seconds) {
-  static char buffer[128];
+  static _Thread_local char buffer[128];
 
   if (seconds < 1.0) {
     snprintf(buffer, sizeof(buffer), "instant");
@@ -243,39 +233,109 @@ const char *format_crack_time(double seconds) {
   return buffer;
 }
 
-password_strength_t analyze_password(const char *ps) {
-  password_strength_t result = {0};
+// an attacker trying the common list with up to common_distance edits
+// finds the password after rank * (edits per entry) guesses: each edit
+// inserts or replaces one of 95 printable characters at one of length + 1
+// places (deleting one is cheaper). the guess estimate only sees exact
+// words, so it is lowered to that
+static void limit_guesses_to_common_variant(password_strength_t *ps) {
+  if (ps->common_distance < 0)
+    return;
 
-  if (ps == NULL) {
-    result.level = NO_PASSWORD;
-    return result;
+  size_t length = strlen(ps->nearest_common);
+  double rank = (double)common_password_rank(ps->nearest_common, length);
+  if (rank == 0.0)
+    rank = (double)common_password_count();
+  double edits = (double)(length + 1) * 95.0;
+  double guesses = rank * pow(edits, ps->common_distance);
+  if (guesses < 1.0)
+    guesses = 1.0;
+  if (guesses < ps->guesses) {
+    ps->guesses = guesses;
+    ps->guesses_log10 = log10(guesses);
   }
+}
 
-  // iterate through the string until the end
-  for (int i = 0; ps[i] != '\0'; i++) {
-    result.length++;
-    if (isupper(ps[i])) {
-      result.has_upper = 1;
-    } else if (isdigit(ps[i])) {
-      result.has_digit = 1;
-    } else if (islower(ps[i])) {
-      result.has_lower = 1;
-    } else {
-      // if it's not upper, digit, or lower, it must be a symbol
-      result.has_symbol = 1;
-    }
-  }
+// analysis of the NUL-terminated ps[0..bytes)
+static password_strength_t analyze(const char *ps, size_t bytes,
+                                   unsigned features) {
+  password_strength_t result = {0};
+  result.common_distance = -1;
+  result.features = features & ANALYZE_ALL;
+
+  // length in characters (utf-8 code points), the pattern detectors below
+  // work on bytes
+  text_class_t text = classify_text(ps, bytes);
+  result.length = text.code_points;
+  result.byte_length = (int)bytes;
+
+  result.has_upper = (text.classes & CHAR_UPPER) != 0;
+  result.has_digit = (text.classes & CHAR_DIGIT) != 0;
+  result.has_lower = (text.classes & CHAR_LOWER) != 0;
+  result.has_other_letter = (text.classes & CHAR_LETTER) != 0;
+  // if it's not a letter or digit, it must be a symbol
+  result.has_symbol = (text.classes & CHAR_PUNCT) != 0;
 
   // detect patterns and weaknesses
-  detect_patterns(&result, ps);
-  detect_repetitions(&result, ps);
-  check_dictionary_words(&result, ps);
-  detect_leetspeak(&result, ps);
+  if (features & ANALYZE_SEQUENTIAL)
+    detect_sequences(&result, ps);
+  if (features & ANALYZE_KEYBOARD)
+    detect_keyboard_walks(&result, ps);
+  if (features & ANALYZE_REPEATS)
+    detect_repetitions(&result, ps);
+  if (features & ANALYZE_DICTIONARY)
+    check_dictionary_words(&result, ps);
+  if (features & ANALYZE_LEETSPEAK)
+    detect_leetspeak(&result, ps);
+  if (features & ANALYZE_COMMON_VARIANT)
+    detect_common_variant(&result, ps);
+
+  if (features & ANALYZE_GUESSES) {
+    guess_estimate_t estimate = estimate_guesses(ps);
+    result.guesses = estimate.guesses;
+    result.guesses_log10 = estimate.guesses_log10;
+    limit_guesses_to_common_variant(&result);
+  }
+
+  if (features & ANALYZE_ENTROPY) {
+    calculate_entropy(&result);
+    estimate_crack_time(&result);
+  }
+  if ((features & ANALYZE_ALL) == ANALYZE_ALL)
+    determine_strength_level(&result);
 
-  calculate_entropy(&result);
-  estimate_crack_time(&result);
-  determine_strength_level(&result);
+  return result;
+}
 
+password_strength_t analyze_password(const char *ps) {
+  if (ps == NULL) {
+    password_strength_t result = {0};
+    result.common_distance = -1;
+    result.level = NO_PASSWORD;
+    return result;
+  }
+  return analyze(ps, strlen(ps), ANALYZE_ALL);
+}
+
+password_strength_t analyze_password_ex(const char *pw, size_t len,
+                                        unsigned features) {
+  if (pw == NULL)
+    return analyze_password(NULL);
+
+  // the detectors want a terminated string
+  char small[256];
+  char *copy = len < sizeof(small) ? small : malloc(len + 1);
+  if (!copy)
+    return analyze_password(NULL);
+  memcpy(copy, pw, len);
+  copy[len] = '\0';
+
+  // an embedded NUL ends the password as it would for analyze_password()
+  password_strength_t result = analyze(copy, strlen(copy), features);
+
+  secure_wipe(copy, len + 1);
+  if (copy != small)
+    free(copy);
   return result;
 }
 
@@ -296,6 +356,8 @@ void calculate_entropy(password_strength_t *ps) {
     pool_size += 10; // 0-9
   if (ps->has_symbol)
     pool_size += 32; // common special characters
+  if (ps->has_other_letter)
+    pool_size += 64; // caseless scripts, between an abjad and the kana
 
   // calculate entropy using the formula
   if (pool_size <= 0) {
@@ -305,74 +367,46 @@ void calculate_entropy(password_strength_t *ps) {
   ps->entropy = ps->length * (log(pool_size) / log(2));
 }
 
+// guesses (as log10) at which each level starts, the zxcvbn thresholds,
+// and the score each one starts at. scores between two thresholds grow
+// linearly with the log, 10^14 guesses and more score 100
+static const struct {
+  double guesses_log10;
+  int score;
+  strength_level_t level;
+} score_steps[] = {
+    {0.0, 0, VERY_WEAK}, {3.0, 30, WEAK},         {6.0, 50, MEDIUM},
+    {8.0, 70, STRONG},   {10.0, 85, VERY_STRONG}, {14.0, 100, VERY_STRONG},
+};
+
 /*
 scoring logic:
-- length gives 0-40 points
-- character variety gives 0-40 points
-- entropy gives 0-20 points
-- pattern penalties reduce score (up to -35 points)
-total = 0-100 points (can go negative, but we cap at 0)
+the score follows the number of guesses estimate_guesses() says an
+attacker needs, so a pattern costs what it makes easier to guess: a
+dictionary word inside a long random string barely matters, the same word
+alone falls in a few guesses. the pattern flags and penalty are reported
+but don't add up to the score
 */
 void determine_strength_level(password_strength_t *ps) {
-  ps->score = 0;
-
-  // score based on length
-  if (ps->length >= 16) {
-    ps->score += 40;
-  } else if (ps->length >= 12) {
-    ps->score += 30;
-  } else if (ps->length >= 8) {
-    ps->score += 20;
-  } else if (ps->length >= 6) {
-    ps->score += 10;
+  size_t steps = sizeof(score_steps) / sizeof(score_steps[0]);
+  double magnitude = ps->guesses_log10 > 0.0 ? ps->guesses_log10 : 0.0;
+
+  size_t step = 0;
+  while (step + 1 < steps && magnitude >= score_steps[step + 1].guesses_log10)
+    step++;
+
+  if (step + 1 < steps) {
+    double from = score_steps[step].guesses_log10;
+    double to = score_steps[step + 1].guesses_log10;
+    int span = score_steps[step + 1].score - score_steps[step].score;
+    ps->score = score_steps[step].score +
+                (int)((magnitude - from) / (to - from) * span);
   } else {
-    ps->score += 5;
-  }
-
-  // score based on character variety
-  int variaty = 0;
-  if (ps->has_upper)
-    variaty++;
-  if (ps->has_lower)
-    variaty++;
-  if (ps->has_digit)
-    variaty++;
-  if (ps->has_symbol)
-    variaty++;
-
-  ps->score += variaty * 10;
-
-  // score based on entropy
-  if (ps->entropy >= 60) {
-    ps->score += 20;
-  } else if (ps->entropy >= 40) {
-    ps->score += 15;
-  } else if (ps->entropy >= 28) {
-    ps->score += 10;
-  } else if (ps->entropy >= 20) {
-    ps->score += 5;
-  }
-
-  // apply pattern penalties
-  ps->score -= ps->pattern_penalty;
-  if (ps->score < 0) {
-    ps->score = 0;
+    ps->score = 100;
   }
 
   ps->strength_score = ps->score;
-
-  // determine strength level based on final score
-  if (ps->score >= 85) {
-    ps->level = VERY_STRONG;
-  } else if (ps->score >= 70) {
-    ps->level = STRONG;
-  } else if (ps->score >= 50) {
-    ps->level = MEDIUM;
-  } else if (ps->score >= 30) {
-    ps->level = WEAK;
-  } else {
-    ps->level = VERY_WEAK;
-  }
+  ps->level = score_steps[step].level;
 }
 
 // detect leetspeak patterns (P@ssw0rd -> password)
@@ -386,50 +420,53 @@ void detect_leetspeak(password_strength_t *ps, const char *password) {
   if (len >= 256)
     len = 255;
 
-  for (int i = 0; i < len; i++) {
-    char c = tolower((unsigned char)password[i]);
-    switch (c) {
-    case '0':
-      normalized[i] = 'o';
-      break;
-    case '1':
-      normalized[i] = 'l';
-      break;
-    case '3':
-      normalized[i] = 'e';
-      break;
-    case '4':
-      normalized[i] = 'a';
-      break;
-    case '5':
-      normalized[i] = 's';
-      break;
-    case '7':
-      normalized[i] = 't';
-      break;
-    case '@':
-      normalized[i] = 'a';
-      break;
-    case '$':
-      normalized[i] = 's';
-      break;
-    case '!':
-      normalized[i] = 'i';
-      break;
-    default:
-      normalized[i] = c;
-      break;
-    }
-  }
+  for (int i = 0; i < len; i++)
+    normalized[i] = char_unleet(password[i]);
   normalized[len] = '\0';
 
-  // check if normalized version contains dictionary words
-  if (contains_dictionary_word_internal(normalized)) {
+  // check if normalized version contains dictionary words, a word that is
+  // already there without substitutions was penalized by
+  // check_dictionary_words() and isn't charged twice
+  if (!ps->contains_dictionary_word &&
+      contains_dictionary_word(normalized)) {
     ps->contains_leetspeak = true;
     ps->pattern_penalty += 15;
   }
 }
 
+// edits that are allowed to a listed password before a password stops
+// counting as a variant of it: two of a short one leave little of it
+static int common_variant_distance(int length) {
+  if (length >= 10)
+    return 2;
+  return length >= 6 ? 1 : 0;
+}
+
+// detect small edits of a common password (passwordd, qwerty12e). the
+// detectors above often already explain why such a password is weak (a
+// word, a walk), so this only tops the penalty up to what being next to a
+// listed password costs
+void detect_common_variant(password_strength_t *ps, const char *password) {
+  if (!ps || !password)
+    return;
+
+  ps->common_distance = -1;
+  ps->nearest_common[0] = '\0';
+
+  const char *nearest = NULL;
+  int distance = nearest_common_password(
+      password, common_variant_distance(ps->byte_length), &nearest);
+  if (distance < 0)
+    return;
+
+  ps->common_distance = distance;
+  snprintf(ps->nearest_common, sizeof(ps->nearest_common), "%s", nearest);
+
+  int penalty = distance <= 1 ? 20 : 15;
+  if (ps->pattern_penalty < penalty)
+    ps->pattern_penalty = penalty;
+}
+
 // detect personal information (dates, common names, etc.)
 void detect_personal_info(password_strength_t *ps, const char *password,
                           const char *user_info) {
@@ -452,14 +489,10 @@ void detect_personal_info(password_strength_t *ps, const char *password,
   if (info_len >= 256)
     info_len = 255;
 
-  for (int i = 0; i < pw_len; i++) {
-    lower_pw[i] = tolower((unsigned char)password[i]);
-  }
+  char_fold_copy(lower_pw, password, pw_len);
   lower_pw[pw_len] = '\0';
 
-  for (int i = 0; i < info_len; i++) {
-    lower_info[i] = tolower((unsigned char)user_info[i]);
-  }
+  char_fold_copy(lower_info, user_info, info_len);
   lower_info[info_len] = '\0';
 
   // check if password contains user info
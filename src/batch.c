@@ -0,0 +1,348 @@
+#include "clovo/batch.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// input read per block, grown for a line longer than that
+#define BLOCK_BYTES (256 * 1024)
+#define MAX_THREADS 256
+// blocks in flight per worker: one being handled while the next waits
+#define BLOCKS_PER_THREAD 2
+
+typedef enum { BLOCK_FREE, BLOCK_READY, BLOCK_DONE } block_state_t;
+
+typedef struct {
+  char *input; // whole lines, one spare byte for the last terminator
+  size_t input_used;
+  size_t input_capacity;
+  size_t first_line;
+  batch_output_t output;
+  batch_stats_t stats;
+  generator_error_t error;
+  block_state_t state;
+} batch_block_t;
+
+// blocks are used in sequence order, block seq lives in blocks[seq % count]
+typedef struct {
+  const batch_job_t *job;
+  batch_block_t *blocks;
+  size_t count;
+  size_t published; // blocks handed to the workers so far
+  size_t taken;     // blocks a worker has started on
+  bool stop;
+  pthread_mutex_t lock;
+  pthread_cond_t work; // a block was published or the run is over
+  pthread_cond_t done; // a block was finished
+} batch_run_t;
+
+bool batch_output_reserve(batch_output_t *out, size_t more) {
+  if (out->capacity - out->used >= more)
+    return true;
+  size_t capacity = out->capacity ? out->capacity : 4096;
+  while (capacity - out->used < more)
+    capacity *= 2;
+  char *data = realloc(out->data, capacity);
+  if (!data)
+    return false;
+  out->data = data;
+  out->capacity = capacity;
+  return true;
+}
+
+char *batch_put_text(char *p, const char *text) {
+  size_t len = strlen(text);
+  memcpy(p, text, len);
+  return p + len;
+}
+
+char *batch_put_number(char *p, size_t n) {
+  char digits[20];
+  int count = 0;
+  do {
+    digits[count++] = (char)('0' + n % 10);
+    n /= 10;
+  } while (n > 0);
+  while (count > 0)
+    *p++ = digits[--count];
+  return p;
+}
+
+// ============================================
+// Workers
+// ============================================
+
+static void handle_block(const batch_job_t *job, batch_block_t *block) {
+  memset(&block->stats, 0, sizeof(block->stats));
+  block->output.used = 0;
+  block->error = GEN_SUCCESS;
+
+  char *p = block->input, *end = block->input + block->input_used;
+  size_t number = block->first_line;
+  while (p < end) {
+    char *newline = memchr(p, '\n', (size_t)(end - p));
+    char *line_end = newline ? newline : end;
+    size_t len = (size_t)(line_end - p);
+    if (len > 0 && p[len - 1] == '\r')
+      len--;
+    p[len] = '\0';
+
+    block->stats.lines++;
+    if (len > 0 || !job->skip_empty) {
+      generator_error_t err = job->line(job->context, p, len, number,
+                                        &block->output,
+                                        block->stats.counters);
+      if (err != GEN_SUCCESS) {
+        block->error = err;
+        return;
+      }
+    }
+    number++;
+    p = line_end + 1;
+  }
+}
+
+static void *batch_worker(void *arg) {
+  batch_run_t *run = arg;
+
+  pthread_mutex_lock(&run->lock);
+  for (;;) {
+    while (!run->stop && run->taken == run->published)
+      pthread_cond_wait(&run->work, &run->lock);
+    if (run->taken == run->published)
+      break;
+    batch_block_t *block = &run->blocks[run->taken++ % run->count];
+    pthread_mutex_unlock(&run->lock);
+
+    handle_block(run->job, block);
+
+    pthread_mutex_lock(&run->lock);
+    block->state = BLOCK_DONE;
+    pthread_cond_signal(&run->done);
+  }
+  pthread_mutex_unlock(&run->lock);
+  return NULL;
+}
+
+// ============================================
+// Reading and writing
+// ============================================
+
+static bool grow_input(batch_block_t *block, size_t capacity) {
+  if (block->input_capacity >= capacity)
+    return true;
+  char *input = realloc(block->input, capacity);
+  if (!input)
+    return false;
+  block->input = input;
+  block->input_capacity = capacity;
+  return true;
+}
+
+// the partial line after the last newline of a block, moved to the next
+typedef struct {
+  char *data;
+  size_t used;
+  size_t capacity;
+} carry_t;
+
+// fill a block with the carried partial line and then whole lines from in,
+// counting them into *lines
+static generator_error_t fill_block(batch_block_t *block, FILE *in,
+                                    carry_t *carry, bool *eof,
+                                    size_t *lines) {
+  if (!grow_input(block, carry->used + BLOCK_BYTES + 1))
+    return GEN_ERROR_NULL_POINTER;
+  if (carry->used > 0)
+    memcpy(block->input, carry->data, carry->used);
+  size_t used = carry->used;
+  size_t split = 0; // end of the last whole line
+
+  for (;;) {
+    size_t room = block->input_capacity - 1 - used;
+    size_t n = fread(block->input + used, 1, room, in);
+    used += n;
+    if (n < room) {
+      if (ferror(in))
+        return GEN_ERROR_FILE_ACCESS;
+      *eof = true;
+      split = used;
+      break;
+    }
+
+    for (size_t i = used; i > 0; i--) {
+      if (block->input[i - 1] == '\n') {
+        split = i;
+        break;
+      }
+    }
+    if (split > 0)
+      break;
+    // one line longer than the whole block
+    if (!grow_input(block, block->input_capacity * 2))
+      return GEN_ERROR_NULL_POINTER;
+  }
+
+  size_t rest = used - split;
+  if (rest > carry->capacity) {
+    char *data = realloc(carry->data, rest);
+    if (!data)
+      return GEN_ERROR_NULL_POINTER;
+    carry->data = data;
+    carry->capacity = rest;
+  }
+  if (rest > 0)
+    memcpy(carry->data, block->input + split, rest);
+  carry->used = rest;
+  block->input_used = split;
+
+  size_t count = 0;
+  const char *p = block->input, *end = block->input + split;
+  while ((p = memchr(p, '\n', (size_t)(end - p))) != NULL) {
+    count++;
+    p++;
+  }
+  if (split > 0 && block->input[split - 1] != '\n')
+    count++; // last line of the file without a newline
+  *lines = count;
+  return GEN_SUCCESS;
+}
+
+// wait for the oldest block in flight, write its output and free it
+static generator_error_t flush_block(batch_run_t *run, size_t seq, FILE *out,
+                                     batch_stats_t *stats) {
+  batch_block_t *block = &run->blocks[seq % run->count];
+  pthread_mutex_lock(&run->lock);
+  while (block->state != BLOCK_DONE)
+    pthread_cond_wait(&run->done, &run->lock);
+  pthread_mutex_unlock(&run->lock);
+
+  stats->lines += block->stats.lines;
+  for (int i = 0; i < BATCH_COUNTERS; i++)
+    stats->counters[i] += block->stats.counters[i];
+
+  generator_error_t err = block->error;
+  if (err == GEN_SUCCESS && out && block->output.used > 0 &&
+      fwrite(block->output.data, 1, block->output.used, out) !=
+          block->output.used)
+    err = GEN_ERROR_FILE_ACCESS;
+  block->state = BLOCK_FREE;
+  return err;
+}
+
+static bool block_done(batch_run_t *run, size_t seq) {
+  pthread_mutex_lock(&run->lock);
+  bool done = run->blocks[seq % run->count].state == BLOCK_DONE;
+  pthread_mutex_unlock(&run->lock);
+  return done;
+}
+
+// ============================================
+// Public API
+// ============================================
+
+generator_error_t batch_run(FILE *in, FILE *out, const batch_job_t *job,
+                            batch_stats_t *stats) {
+  batch_stats_t totals;
+  memset(&totals, 0, sizeof(totals));
+  if (stats)
+    *stats = totals;
+  if (!in || !job || !job->line)
+    return GEN_ERROR_NULL_POINTER;
+
+  int threads = job->threads;
+  if (threads <= 0) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    threads = cpus > 0 ? (int)cpus : 1;
+  }
+  if (threads > MAX_THREADS)
+    threads = MAX_THREADS;
+
+  batch_run_t run = {.job = job,
+                     .count = (size_t)threads * BLOCKS_PER_THREAD};
+  run.blocks = calloc(run.count, sizeof(*run.blocks));
+  if (!run.blocks)
+    return GEN_ERROR_NULL_POINTER;
+  pthread_mutex_init(&run.lock, NULL);
+  pthread_cond_init(&run.work, NULL);
+  pthread_cond_init(&run.done, NULL);
+
+  pthread_t workers[MAX_THREADS];
+  int started = 0;
+  for (; started < threads; started++) {
+    if (pthread_create(&workers[started], NULL, batch_worker, &run) != 0)
+      break;
+  }
+
+  generator_error_t err = GEN_SUCCESS;
+  carry_t carry = {0};
+  bool eof = false;
+  size_t next_line = 1, read = 0, written = 0;
+  while (!eof && err == GEN_SUCCESS) {
+    if (read - written == run.count)
+      err = flush_block(&run, written++, out, &totals);
+    if (err != GEN_SUCCESS)
+      break;
+
+    batch_block_t *block = &run.blocks[read % run.count];
+    size_t lines;
+    err = fill_block(block, in, &carry, &eof, &lines);
+    if (err != GEN_SUCCESS || block->input_used == 0)
+      break;
+    block->first_line = next_line;
+    next_line += lines;
+
+    if (started == 0) {
+      // no threads at all: do the work here
+      handle_block(job, block);
+      block->state = BLOCK_DONE;
+    } else {
+      pthread_mutex_lock(&run.lock);
+      block->state = BLOCK_READY;
+      run.published++;
+      pthread_cond_signal(&run.work);
+      pthread_mutex_unlock(&run.lock);
+    }
+    read++;
+
+    // write out whatever is already finished, in order
+    while (err == GEN_SUCCESS && written < read && block_done(&run, written))
+      err = flush_block(&run, written++, out, &totals);
+  }
+
+  // every published block is finished before the buffers go
+  while (written < read) {
+    generator_error_t flushed = flush_block(&run, written++, out, &totals);
+    if (err == GEN_SUCCESS)
+      err = flushed;
+  }
+
+  pthread_mutex_lock(&run.lock);
+  run.stop = true;
+  pthread_cond_broadcast(&run.work);
+  pthread_mutex_unlock(&run.lock);
+  for (int t = 0; t < started; t++)
+    pthread_join(workers[t], NULL);
+
+  for (size_t i = 0; i < run.count; i++) {
+    batch_block_t *block = &run.blocks[i];
+    if (block->input)
+      secure_wipe(block->input, block->input_capacity);
+    if (block->output.data)
+      secure_wipe(block->output.data, block->output.capacity);
+    free(block->input);
+    free(block->output.data);
+  }
+  if (carry.data)
+    secure_wipe(carry.data, carry.capacity);
+  free(carry.data);
+  free(run.blocks);
+  pthread_cond_destroy(&run.done);
+  pthread_cond_destroy(&run.work);
+  pthread_mutex_destroy(&run.lock);
+
+  if (stats)
+    *stats = totals;
+  return err;
+}
@@ -0,0 +1,267 @@
+#include "clovo/bulk.h"
+#include "clovo/drbg.h"
+#include "clovo/hash.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// passwords a worker claims, generates and writes at a time
+#define BLOCK_PASSWORDS 1024
+#define MAX_THREADS 256
+// consecutive duplicates before giving up on uniqueness, only reached when
+// count is close to the number of possible passwords
+#define MAX_DUPLICATE_RETRIES 64
+
+// fixed-size set of password fingerprints, filled concurrently with CAS.
+// equal passwords always collide, so uniqueness is exact; two different
+// passwords with the same fingerprint only cost a regeneration
+typedef struct {
+  _Atomic uint64_t *slots; // 0 = empty
+  size_t mask;
+  uint64_t key[2];
+} unique_set_t;
+
+typedef struct {
+  FILE *out;
+  const bulk_options_t *options;
+  const generator_options_t *opts;
+  unique_set_t *unique;
+
+  atomic_size_t next; // first password of the next unclaimed block
+  atomic_size_t written;
+  atomic_int error; // first failure, stops every worker
+  pthread_mutex_t out_lock;
+} bulk_job_t;
+
+// ============================================
+// Unique set
+// ============================================
+
+static bool unique_set_init(unique_set_t *set, size_t count) {
+  size_t slots = 16;
+  while (slots < count * 2)
+    slots <<= 1;
+
+  set->slots = calloc(slots, sizeof(*set->slots));
+  if (!set->slots)
+    return false;
+  set->mask = slots - 1;
+  if (secure_random_bytes((unsigned char *)set->key, sizeof(set->key)) !=
+      GEN_SUCCESS) {
+    free(set->slots);
+    return false;
+  }
+  return true;
+}
+
+static void unique_set_free(unique_set_t *set) {
+  free(set->slots);
+  secure_wipe(set->key, sizeof(set->key));
+}
+
+// false if the password was already in the set
+static bool unique_set_insert(unique_set_t *set, const char *password,
+                              size_t len) {
+  uint64_t hash = siphash24(set->key, password, len);
+  if (hash == 0)
+    hash = 1;
+
+  for (size_t i = hash & set->mask;; i = (i + 1) & set->mask) {
+    uint64_t seen =
+        atomic_load_explicit(&set->slots[i], memory_order_relaxed);
+    if (seen == 0 &&
+        atomic_compare_exchange_strong(&set->slots[i], &seen, hash))
+      return true;
+    // the CAS failed if another thread took the slot, seen holds its hash
+    if (seen == hash)
+      return false;
+  }
+}
+
+// ============================================
+// Workers
+// ============================================
+
+// append password as one output line, returns the bytes written
+static size_t format_line(char *dst, const char *password, size_t len,
+                          bulk_format_t format) {
+  char *p = dst;
+  if (format == BULK_NDJSON) {
+    memcpy(p, "{\"password\":\"", 13);
+    p += 13;
+    for (size_t i = 0; i < len; i++) {
+      if (password[i] == '"' || password[i] == '\\')
+        *p++ = '\\';
+      *p++ = password[i];
+    }
+    *p++ = '"';
+    *p++ = '}';
+  } else {
+    memcpy(p, password, len);
+    p += len;
+  }
+  *p++ = '\n';
+  return (size_t)(p - dst);
+}
+
+static generator_error_t generate_one(bulk_job_t *job, char *password,
+                                      size_t size) {
+  size_t length = job->options->length;
+  for (int retry = 0; retry <= MAX_DUPLICATE_RETRIES; retry++) {
+    generator_error_t err =
+        generate_password(password, size, length, job->opts);
+    if (err != GEN_SUCCESS)
+      return err;
+    if (!job->unique || unique_set_insert(job->unique, password, length))
+      return GEN_SUCCESS;
+  }
+  return GEN_ERROR_NOT_UNIQUE;
+}
+
+static void *bulk_worker(void *arg) {
+  bulk_job_t *job = arg;
+  size_t length = job->options->length;
+  size_t count = job->options->count;
+  // worst case per line: every character escaped plus the json wrapping
+  size_t line_max = 2 * length + 17;
+  size_t buffer_size = BLOCK_PASSWORDS * line_max;
+  char *buffer = malloc(buffer_size);
+  char *password = malloc(length + 1);
+
+  if (!buffer || !password) {
+    int expected = GEN_SUCCESS;
+    atomic_compare_exchange_strong(&job->error, &expected,
+                                   GEN_ERROR_NULL_POINTER);
+    free(buffer);
+    free(password);
+    return NULL;
+  }
+
+  while (atomic_load(&job->error) == GEN_SUCCESS) {
+    size_t first = atomic_fetch_add(&job->next, BLOCK_PASSWORDS);
+    if (first >= count)
+      break;
+    size_t n = count - first < BLOCK_PASSWORDS ? count - first
+                                               : BLOCK_PASSWORDS;
+
+    size_t used = 0;
+    size_t done = 0;
+    for (; done < n; done++) {
+      generator_error_t err = generate_one(job, password, length + 1);
+      if (err != GEN_SUCCESS) {
+        int expected = GEN_SUCCESS;
+        atomic_compare_exchange_strong(&job->error, &expected, err);
+        break;
+      }
+      used += format_line(buffer + used, password, length,
+                          job->options->format);
+    }
+
+    pthread_mutex_lock(&job->out_lock);
+    bool ok = fwrite(buffer, 1, used, job->out) == used;
+    pthread_mutex_unlock(&job->out_lock);
+    secure_wipe(buffer, used);
+
+    if (!ok) {
+      int expected = GEN_SUCCESS;
+      atomic_compare_exchange_strong(&job->error, &expected,
+                                     GEN_ERROR_FILE_ACCESS);
+      break;
+    }
+    atomic_fetch_add(&job->written, done);
+  }
+
+  secure_wipe(password, length + 1);
+  free(password);
+  free(buffer);
+  drbg_clear();
+  return NULL;
+}
+
+// ============================================
+// Public API
+// ============================================
+
+void init_bulk_options(bulk_options_t *options) {
+  if (!options)
+    return;
+  options->length = 16;
+  options->count = 1;
+  options->threads = 0;
+  options->unique = false;
+  options->format = BULK_PLAIN;
+  options->opts = NULL;
+}
+
+generator_error_t generate_bulk(FILE *out, const bulk_options_t *options,
+                                size_t *written) {
+  if (written)
+    *written = 0;
+  if (!out || !options)
+    return GEN_ERROR_NULL_POINTER;
+  if (options->count == 0)
+    return GEN_SUCCESS;
+
+  generator_options_t default_opts;
+  const generator_options_t *opts = options->opts;
+  if (!opts) {
+    init_generator_options(&default_opts);
+    opts = &default_opts;
+  }
+
+  // reject bad lengths/charsets once instead of in every worker
+  char probe[257];
+  generator_error_t err =
+      generate_password(probe, sizeof(probe), options->length, opts);
+  secure_wipe(probe, sizeof(probe));
+  if (err != GEN_SUCCESS)
+    return err;
+
+  int threads = options->threads;
+  if (threads <= 0) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    threads = cpus > 0 ? (int)cpus : 1;
+  }
+  if (threads > MAX_THREADS)
+    threads = MAX_THREADS;
+  size_t blocks = (options->count + BLOCK_PASSWORDS - 1) / BLOCK_PASSWORDS;
+  if ((size_t)threads > blocks)
+    threads = (int)blocks;
+
+  unique_set_t unique;
+  if (options->unique && !unique_set_init(&unique, options->count))
+    return GEN_ERROR_NULL_POINTER;
+
+  bulk_job_t job = {.out = out,
+                    .options = options,
+                    .opts = opts,
+                    .unique = options->unique ? &unique : NULL};
+  atomic_init(&job.next, 0);
+  atomic_init(&job.written, 0);
+  atomic_init(&job.error, GEN_SUCCESS);
+  pthread_mutex_init(&job.out_lock, NULL);
+
+  pthread_t workers[MAX_THREADS];
+  int started = 0;
+  for (; started < threads; started++) {
+    if (pthread_create(&workers[started], NULL, bulk_worker, &job) != 0)
+      break;
+  }
+  // no threads at all: do the work here
+  if (started == 0)
+    bulk_worker(&job);
+  for (int t = 0; t < started; t++)
+    pthread_join(workers[t], NULL);
+
+  pthread_mutex_destroy(&job.out_lock);
+  if (options->unique)
+    unique_set_free(&unique);
+
+  if (written)
+    *written = atomic_load(&job.written);
+  return (generator_error_t)atomic_load(&job.error);
+}
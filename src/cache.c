@@ -0,0 +1,288 @@
+#include "clovo/cache.h"
+#include "clovo/generator.h"
+#include "clovo/hash.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+  uint64_t hash; // 0 = free slot, real hashes are forced non-zero
+  bool referenced;
+  bool has_verdict;
+  password_strength_t analysis;
+  password_policy_t policy; // what verdict was computed for
+  policy_verdict_t verdict; // messages are made again on a hit
+} cache_entry_t;
+
+// entries live in a flat array; an open addressing index (linear probing,
+// slot + 1 per bucket) finds them by hash
+typedef struct {
+  pthread_mutex_t lock;
+  cache_entry_t *entries;
+  uint32_t *index;
+  size_t index_mask;
+  size_t slots;
+  size_t used;
+  size_t hand; // CLOCK hand
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t evictions;
+} cache_shard_t;
+
+struct analysis_cache {
+  uint64_t key[2];
+  size_t capacity;
+  cache_shard_t shards[CACHE_SHARDS];
+};
+
+// ============================================
+// Shards
+// ============================================
+
+static bool shard_init(cache_shard_t *shard, size_t slots) {
+  size_t buckets = 1;
+  while (buckets < slots * 2)
+    buckets <<= 1;
+
+  shard->entries = calloc(slots, sizeof(*shard->entries));
+  shard->index = calloc(buckets, sizeof(*shard->index));
+  if (!shard->entries || !shard->index) {
+    free(shard->entries);
+    free(shard->index);
+    shard->entries = NULL;
+    shard->index = NULL;
+    return false;
+  }
+  shard->index_mask = buckets - 1;
+  shard->slots = slots;
+  pthread_mutex_init(&shard->lock, NULL);
+  return true;
+}
+
+static void shard_free(cache_shard_t *shard) {
+  if (!shard->entries)
+    return;
+  secure_wipe(shard->entries, shard->slots * sizeof(*shard->entries));
+  free(shard->entries);
+  free(shard->index);
+  pthread_mutex_destroy(&shard->lock);
+}
+
+// entry with this hash, NULL if it isn't cached (lock held)
+static cache_entry_t *shard_find(cache_shard_t *shard, uint64_t hash) {
+  size_t b = hash & shard->index_mask;
+  while (shard->index[b]) {
+    cache_entry_t *entry = &shard->entries[shard->index[b] - 1];
+    if (entry->hash == hash)
+      return entry;
+    b = (b + 1) & shard->index_mask;
+  }
+  return NULL;
+}
+
+// drop hash from the index, shifting later probes back so no tombstones are
+// needed (lock held)
+static void shard_unindex(cache_shard_t *shard, uint64_t hash) {
+  size_t mask = shard->index_mask;
+  size_t hole = hash & mask;
+  while (shard->entries[shard->index[hole] - 1].hash != hash)
+    hole = (hole + 1) & mask;
+
+  shard->index[hole] = 0;
+  for (size_t b = (hole + 1) & mask; shard->index[b]; b = (b + 1) & mask) {
+    size_t home = shard->entries[shard->index[b] - 1].hash & mask;
+    // move the entry into the hole unless its home lies in (hole, b]
+    bool stays = hole <= b ? (home > hole && home <= b)
+                           : (home > hole || home <= b);
+    if (!stays) {
+      shard->index[hole] = shard->index[b];
+      shard->index[b] = 0;
+      hole = b;
+    }
+  }
+}
+
+// a slot for a new entry: a free one, or the first unreferenced one under
+// the CLOCK hand (lock held)
+static cache_entry_t *shard_claim(cache_shard_t *shard, uint64_t hash) {
+  size_t slot;
+  if (shard->used < shard->slots) {
+    slot = shard->used++;
+  } else {
+    while (shard->entries[shard->hand].referenced) {
+      shard->entries[shard->hand].referenced = false;
+      shard->hand = (shard->hand + 1) % shard->slots;
+    }
+    slot = shard->hand;
+    shard->hand = (shard->hand + 1) % shard->slots;
+    shard_unindex(shard, shard->entries[slot].hash);
+    shard->evictions++;
+  }
+
+  cache_entry_t *entry = &shard->entries[slot];
+  memset(entry, 0, sizeof(*entry));
+  entry->hash = hash;
+
+  size_t b = hash & shard->index_mask;
+  while (shard->index[b])
+    b = (b + 1) & shard->index_mask;
+  shard->index[b] = (uint32_t)(slot + 1);
+  return entry;
+}
+
+// ============================================
+// Public API
+// ============================================
+
+analysis_cache_t *analysis_cache_create(size_t capacity) {
+  if (capacity == 0)
+    capacity = CACHE_DEFAULT_CAPACITY;
+
+  analysis_cache_t *cache = calloc(1, sizeof(*cache));
+  if (!cache)
+    return NULL;
+
+  if (secure_random_bytes((unsigned char *)cache->key, sizeof(cache->key)) !=
+      GEN_SUCCESS) {
+    free(cache);
+    return NULL;
+  }
+
+  size_t slots = (capacity + CACHE_SHARDS - 1) / CACHE_SHARDS;
+  for (int s = 0; s < CACHE_SHARDS; s++) {
+    if (!shard_init(&cache->shards[s], slots)) {
+      analysis_cache_destroy(cache);
+      return NULL;
+    }
+  }
+  cache->capacity = slots * CACHE_SHARDS;
+  return cache;
+}
+
+void analysis_cache_destroy(analysis_cache_t *cache) {
+  if (!cache)
+    return;
+  for (int s = 0; s < CACHE_SHARDS; s++)
+    shard_free(&cache->shards[s]);
+  secure_wipe(cache->key, sizeof(cache->key));
+  free(cache);
+}
+
+static uint64_t password_hash(const analysis_cache_t *cache,
+                              const char *password) {
+  uint64_t hash = siphash24(cache->key, password, strlen(password));
+  return hash ? hash : 1;
+}
+
+// top bits pick the shard, low bits the bucket inside it
+static cache_shard_t *shard_for(analysis_cache_t *cache, uint64_t hash) {
+  return &cache->shards[hash >> 60 & (CACHE_SHARDS - 1)];
+}
+
+static bool same_policy(const password_policy_t *a,
+                        const password_policy_t *b) {
+  return a->min_length == b->min_length && a->max_length == b->max_length &&
+         a->require_lowercase == b->require_lowercase &&
+         a->require_uppercase == b->require_uppercase &&
+         a->require_digits == b->require_digits &&
+         a->require_symbols == b->require_symbols &&
+         a->allow_common_passwords == b->allow_common_passwords &&
+         a->allow_sequential_patterns == b->allow_sequential_patterns &&
+         a->allow_repeated_chars == b->allow_repeated_chars &&
+         a->min_entropy == b->min_entropy;
+}
+
+password_strength_t cached_analyze_password(analysis_cache_t *cache,
+                                            const char *password) {
+  if (!cache || !password)
+    return analyze_password(password);
+
+  uint64_t hash = password_hash(cache, password);
+  cache_shard_t *shard = shard_for(cache, hash);
+
+  pthread_mutex_lock(&shard->lock);
+  cache_entry_t *entry = shard_find(shard, hash);
+  if (entry) {
+    password_strength_t result = entry->analysis;
+    entry->referenced = true;
+    shard->hits++;
+    pthread_mutex_unlock(&shard->lock);
+    return result;
+  }
+  shard->misses++;
+  pthread_mutex_unlock(&shard->lock);
+
+  // analyze without holding the lock, another caller may race us to insert
+  password_strength_t result = analyze_password(password);
+
+  pthread_mutex_lock(&shard->lock);
+  if (!shard_find(shard, hash))
+    shard_claim(shard, hash)->analysis = result;
+  pthread_mutex_unlock(&shard->lock);
+  return result;
+}
+
+policy_result_t cached_validate_policy(analysis_cache_t *cache,
+                                       const char *password,
+                                       const password_policy_t *policy) {
+  if (!cache || !password || !policy)
+    return validate_policy(password, policy);
+
+  uint64_t hash = password_hash(cache, password);
+  cache_shard_t *shard = shard_for(cache, hash);
+  password_strength_t analysis;
+  bool analyzed = false;
+
+  pthread_mutex_lock(&shard->lock);
+  cache_entry_t *entry = shard_find(shard, hash);
+  if (entry) {
+    entry->referenced = true;
+    shard->hits++;
+    if (entry->has_verdict && same_policy(&entry->policy, policy)) {
+      policy_verdict_t verdict = entry->verdict;
+      pthread_mutex_unlock(&shard->lock);
+      return policy_verdict_to_result(&verdict, policy);
+    }
+    analysis = entry->analysis;
+    analyzed = true;
+  } else {
+    shard->misses++;
+  }
+  pthread_mutex_unlock(&shard->lock);
+
+  if (!analyzed)
+    analysis = analyze_password(password);
+  policy_verdict_t verdict = evaluate_policy_analysis(&analysis, policy);
+
+  pthread_mutex_lock(&shard->lock);
+  entry = shard_find(shard, hash);
+  if (!entry) {
+    entry = shard_claim(shard, hash);
+    entry->analysis = analysis;
+  }
+  entry->policy = *policy;
+  entry->verdict = verdict;
+  entry->has_verdict = true;
+  pthread_mutex_unlock(&shard->lock);
+  return policy_verdict_to_result(&verdict, policy);
+}
+
+cache_stats_t analysis_cache_stats(analysis_cache_t *cache) {
+  cache_stats_t stats = {0};
+  if (!cache)
+    return stats;
+
+  stats.capacity = cache->capacity;
+  for (int s = 0; s < CACHE_SHARDS; s++) {
+    cache_shard_t *shard = &cache->shards[s];
+    pthread_mutex_lock(&shard->lock);
+    stats.hits += shard->hits;
+    stats.misses += shard->misses;
+    stats.evictions += shard->evictions;
+    stats.entries += shard->used;
+    pthread_mutex_unlock(&shard->lock);
+  }
+  return stats;
+}
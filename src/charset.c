@@ -0,0 +1,156 @@
+#include "clovo/charset.h"
+#include "clovo/drbg.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// words fetched from the drbg at a time, a 256 character password plus
+// room for rejections takes two blocks at most
+#define WORD_BLOCK 160
+#define LANES 16
+
+generator_error_t charset_kernel_init(charset_kernel_t *kernel,
+                                      const char *chars) {
+  if (!kernel || !chars)
+    return GEN_ERROR_NULL_POINTER;
+
+  bool present[256] = {false};
+  for (const unsigned char *p = (const unsigned char *)chars; *p; p++)
+    present[*p] = true;
+
+  memset(kernel, 0, sizeof(*kernel));
+  size_t size = 0;
+  for (int c = 1; c < 256; c++)
+    if (present[c])
+      kernel->chars[size++] = (char)c;
+  if (size == 0)
+    return GEN_ERROR_NO_CHARSET;
+
+  kernel->size = (uint16_t)size;
+  kernel->threshold = (uint16_t)(65536u % size);
+
+  // a run starts wherever the next character isn't the previous one plus
+  // one. deltas are byte differences, so they are meant to wrap
+  int runs = 0;
+  for (size_t i = 0; i < size; i++) {
+    unsigned char c = (unsigned char)kernel->chars[i];
+    if (i > 0 && c == (unsigned char)kernel->chars[i - 1] + 1)
+      continue;
+    if (runs == CHARSET_MAX_RUNS) {
+      runs = 0;
+      break;
+    }
+    unsigned char offset = (unsigned char)(c - i);
+    unsigned char previous = 0;
+    for (int r = 0; r < runs; r++)
+      previous = (unsigned char)(previous + kernel->run_delta[r]);
+    kernel->run_start[runs] = (uint8_t)i;
+    kernel->run_delta[runs] = (uint8_t)(offset - previous);
+    runs++;
+  }
+  kernel->runs = runs;
+  return GEN_SUCCESS;
+}
+
+size_t charset_map_words_scalar(const charset_kernel_t *kernel,
+                                const uint16_t *words, size_t word_count,
+                                char *out, size_t n) {
+  if (!kernel || !words || !out)
+    return 0;
+
+  size_t filled = 0;
+  for (size_t i = 0; i < word_count && filled < n; i++) {
+    uint32_t m = (uint32_t)words[i] * kernel->size;
+    if ((uint16_t)m < kernel->threshold)
+      continue;
+    out[filled++] = kernel->chars[m >> 16];
+  }
+  return filled;
+}
+
+size_t charset_map_words(const charset_kernel_t *kernel,
+                         const uint16_t *words, size_t word_count, char *out,
+                         size_t n) {
+  if (!kernel || !words || !out)
+    return 0;
+
+  size_t filled = 0, used = 0;
+#ifdef __SSE2__
+  if (kernel->runs > 0) {
+    const __m128i size = _mm_set1_epi16((short)kernel->size);
+    const __m128i threshold = _mm_set1_epi16((short)kernel->threshold);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i base = _mm_set1_epi8((char)kernel->run_delta[0]);
+    __m128i start[CHARSET_MAX_RUNS], delta[CHARSET_MAX_RUNS];
+    for (int r = 1; r < kernel->runs; r++) {
+      start[r] = _mm_set1_epi8((char)kernel->run_start[r]);
+      delta[r] = _mm_set1_epi8((char)kernel->run_delta[r]);
+    }
+
+    while (filled + LANES <= n && used + LANES <= word_count) {
+      __m128i a = _mm_loadu_si128((const __m128i *)(words + used));
+      __m128i b = _mm_loadu_si128((const __m128i *)(words + used + 8));
+
+      // threshold - low saturates to 0 exactly when the word is accepted
+      __m128i low_a = _mm_mullo_epi16(a, size);
+      __m128i low_b = _mm_mullo_epi16(b, size);
+      __m128i rejected = _mm_or_si128(_mm_subs_epu16(threshold, low_a),
+                                      _mm_subs_epu16(threshold, low_b));
+      if (_mm_movemask_epi8(_mm_cmpeq_epi16(rejected, zero)) != 0xFFFF) {
+        // rare: map this block one word at a time, like the scalar path
+        size_t end = used + LANES;
+        for (; used < end; used++) {
+          uint32_t m = (uint32_t)words[used] * kernel->size;
+          if ((uint16_t)m >= kernel->threshold)
+            out[filled++] = kernel->chars[m >> 16];
+        }
+        continue;
+      }
+
+      __m128i index = _mm_packus_epi16(_mm_mulhi_epu16(a, size),
+                                       _mm_mulhi_epu16(b, size));
+      __m128i c = _mm_add_epi8(index, base);
+      for (int r = 1; r < kernel->runs; r++) {
+        // index >= start, unsigned
+        __m128i from = _mm_cmpeq_epi8(_mm_max_epu8(index, start[r]), index);
+        c = _mm_add_epi8(c, _mm_and_si128(from, delta[r]));
+      }
+      _mm_storeu_si128((__m128i *)(out + filled), c);
+      filled += LANES;
+      used += LANES;
+    }
+  }
+#endif
+
+  return filled + charset_map_words_scalar(kernel, words + used,
+                                           word_count - used, out + filled,
+                                           n - filled);
+}
+
+generator_error_t charset_fill(const charset_kernel_t *kernel, char *out,
+                               size_t n) {
+  if (!kernel || !out)
+    return GEN_ERROR_NULL_POINTER;
+
+  uint16_t words[WORD_BLOCK];
+  generator_error_t status = GEN_SUCCESS;
+  size_t filled = 0;
+  while (filled < n) {
+    // a few words more than characters still missing covers rejections
+    size_t want = n - filled + (n - filled) / 64 + 4;
+    if (want > WORD_BLOCK)
+      want = WORD_BLOCK;
+    if (drbg_random_bytes(words, want * sizeof(*words)) != GEN_SUCCESS) {
+      status = GEN_ERROR_RANDOM_FAILED;
+      break;
+    }
+    filled += charset_map_words(kernel, words, want, out + filled,
+                                n - filled);
+    secure_wipe(words, want * sizeof(*words));
+  }
+  return status;
+}
@@ -0,0 +1,480 @@
+#include "clovo/cluster.h"
+#include "clovo/charclass.h"
+#include "clovo/hash.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+// a key slot packs the high bits of the key's hash with the entry id + 1 in
+// the low bits, 0 = empty. the slot index comes from the low hash bits, so
+// a false match needs ~38 bits of fingerprint plus the index to agree
+#define ID_BITS 26
+#define ID_MASK ((UINT64_C(1) << ID_BITS) - 1)
+#define MAX_ENTRIES ID_MASK
+
+typedef struct {
+  size_t offset; // into the arena, NUL-terminated
+  uint32_t length;
+  uint32_t count;
+} cluster_entry_t;
+
+struct cluster_corpus {
+  char *arena;
+  size_t arena_size;
+  size_t arena_capacity;
+
+  cluster_entry_t *entries;
+  uint64_t *hashes; // of each entry, for growing the dedup table
+  size_t count;
+  size_t entry_capacity;
+  size_t hash_capacity;
+
+  uint32_t *dedup; // entry index + 1, 0 = empty
+  size_t dedup_mask;
+
+  uint64_t key[2];
+  size_t lines;
+  size_t skipped;
+
+  // results of the last build
+  password_cluster_t *clusters;
+  size_t cluster_count;
+  uint32_t *members; // entry indices grouped by cluster
+  size_t clustered;
+};
+
+// ============================================
+// Distinct Passwords
+// ============================================
+
+static bool dedup_grow(cluster_corpus_t *corpus) {
+  size_t slots = corpus->dedup ? (corpus->dedup_mask + 1) * 2 : 1024;
+  uint32_t *table = calloc(slots, sizeof(*table));
+  if (!table)
+    return false;
+  for (size_t i = 0; i < corpus->count; i++) {
+    size_t s = corpus->hashes[i] & (slots - 1);
+    while (table[s])
+      s = (s + 1) & (slots - 1);
+    table[s] = (uint32_t)(i + 1);
+  }
+  free(corpus->dedup);
+  corpus->dedup = table;
+  corpus->dedup_mask = slots - 1;
+  return true;
+}
+
+static bool reserve(void **items, size_t *capacity, size_t needed,
+                    size_t item_size) {
+  if (needed <= *capacity)
+    return true;
+  size_t grown = *capacity ? *capacity : 1024;
+  while (grown < needed)
+    grown *= 2;
+  void *resized = realloc(*items, grown * item_size);
+  if (!resized)
+    return false;
+  *items = resized;
+  *capacity = grown;
+  return true;
+}
+
+cluster_corpus_t *cluster_corpus_create(void) {
+  cluster_corpus_t *corpus = calloc(1, sizeof(*corpus));
+  if (!corpus)
+    return NULL;
+  // keyed so a crafted corpus can't flood the tables
+  if (secure_random_bytes((unsigned char *)corpus->key,
+                          sizeof(corpus->key)) != GEN_SUCCESS ||
+      !dedup_grow(corpus)) {
+    free(corpus);
+    return NULL;
+  }
+  return corpus;
+}
+
+static void free_build(cluster_corpus_t *corpus) {
+  free(corpus->clusters);
+  free(corpus->members);
+  corpus->clusters = NULL;
+  corpus->members = NULL;
+  corpus->cluster_count = 0;
+  corpus->clustered = 0;
+}
+
+void cluster_corpus_free(cluster_corpus_t *corpus) {
+  if (!corpus)
+    return;
+  free_build(corpus);
+  secure_wipe(corpus->arena, corpus->arena_size);
+  free(corpus->arena);
+  free(corpus->entries);
+  free(corpus->hashes);
+  free(corpus->dedup);
+  secure_wipe(corpus->key, sizeof(corpus->key));
+  free(corpus);
+}
+
+generator_error_t cluster_corpus_add(cluster_corpus_t *corpus,
+                                     const char *password, size_t len) {
+  if (!corpus || !password)
+    return GEN_ERROR_NULL_POINTER;
+  if (len == 0 || len > CLUSTER_MAX_LENGTH) {
+    corpus->skipped++;
+    return GEN_SUCCESS;
+  }
+
+  uint64_t hash = siphash24(corpus->key, password, len);
+  size_t s = hash & corpus->dedup_mask;
+  for (; corpus->dedup[s]; s = (s + 1) & corpus->dedup_mask) {
+    cluster_entry_t *e = &corpus->entries[corpus->dedup[s] - 1];
+    if (e->length == len &&
+        memcmp(corpus->arena + e->offset, password, len) == 0) {
+      if (e->count < UINT32_MAX)
+        e->count++;
+      corpus->lines++;
+      return GEN_SUCCESS;
+    }
+  }
+
+  if (corpus->count == MAX_ENTRIES)
+    return GEN_ERROR_INVALID_LENGTH;
+  if (!reserve((void **)&corpus->arena, &corpus->arena_capacity,
+               corpus->arena_size + len + 1, 1) ||
+      !reserve((void **)&corpus->entries, &corpus->entry_capacity,
+               corpus->count + 1, sizeof(*corpus->entries)) ||
+      !reserve((void **)&corpus->hashes, &corpus->hash_capacity,
+               corpus->count + 1, sizeof(*corpus->hashes)))
+    return GEN_ERROR_NULL_POINTER;
+
+  cluster_entry_t *e = &corpus->entries[corpus->count];
+  e->offset = corpus->arena_size;
+  e->length = (uint32_t)len;
+  e->count = 1;
+  memcpy(corpus->arena + corpus->arena_size, password, len);
+  corpus->arena[corpus->arena_size + len] = '\0';
+  corpus->arena_size += len + 1;
+  corpus->hashes[corpus->count] = hash;
+  corpus->dedup[s] = (uint32_t)(corpus->count + 1);
+  corpus->count++;
+  corpus->lines++;
+
+  // keep the table at most half full
+  if (corpus->count * 2 > corpus->dedup_mask + 1 && !dedup_grow(corpus))
+    return GEN_ERROR_NULL_POINTER;
+  return GEN_SUCCESS;
+}
+
+generator_error_t cluster_corpus_load(cluster_corpus_t *corpus,
+                                      const char *path) {
+  if (!corpus || !path)
+    return GEN_ERROR_NULL_POINTER;
+  FILE *file = fopen(path, "r");
+  if (!file)
+    return GEN_ERROR_FILE_ACCESS;
+
+  char line[CLUSTER_MAX_LENGTH + 3];
+  generator_error_t status = GEN_SUCCESS;
+  while (status == GEN_SUCCESS && fgets(line, sizeof(line), file)) {
+    size_t len = strcspn(line, "\r\n");
+    if (line[len] == '\0' && !feof(file)) {
+      // longer than the buffer: skip the rest of the line
+      int c;
+      while ((c = fgetc(file)) != EOF && c != '\n')
+        ;
+      corpus->skipped++;
+      continue;
+    }
+    status = cluster_corpus_add(corpus, line, len);
+  }
+  secure_wipe(line, sizeof(line));
+  fclose(file);
+  return status;
+}
+
+// ============================================
+// Linking
+// ============================================
+
+typedef struct {
+  uint32_t count;
+  uint32_t id;
+} ranked_entry_t;
+
+static int by_count_desc(const void *a, const void *b) {
+  const ranked_entry_t *x = a, *y = b;
+  if (x->count != y->count)
+    return x->count < y->count ? 1 : -1;
+  return (x->id > y->id) - (x->id < y->id);
+}
+
+// visiting position of the representative key hash belongs to, or none
+// (UINT32_MAX)
+static uint32_t key_owner(const uint64_t *slots, size_t mask, uint64_t hash) {
+  uint64_t fingerprint = hash & ~ID_MASK;
+  for (size_t s = hash & mask; slots[s] != 0; s = (s + 1) & mask) {
+    if ((slots[s] & ~ID_MASK) == fingerprint)
+      return (uint32_t)((slots[s] & ID_MASK) - 1);
+  }
+  return UINT32_MAX;
+}
+
+static void claim_key(uint64_t *slots, size_t mask, uint64_t hash,
+                      uint32_t position) {
+  size_t s = hash & mask;
+  while (slots[s] != 0)
+    s = (s + 1) & mask;
+  slots[s] = (hash & ~ID_MASK) | (position + 1);
+}
+
+// the keys of password[0..len): itself and its one-character deletions,
+// returns how many
+static size_t password_keys(const cluster_corpus_t *corpus,
+                            const char *password, size_t len,
+                            uint64_t *keys) {
+  char folded[CLUSTER_MAX_LENGTH];
+  char variant[CLUSTER_MAX_LENGTH];
+  char_fold_copy(folded, password, (int)len);
+
+  size_t count = 0;
+  keys[count++] = siphash24(corpus->key, folded, len);
+  for (size_t p = 0; p < len; p++) {
+    // deleting either of two equal neighbours gives the same key
+    if (p > 0 && folded[p] == folded[p - 1])
+      continue;
+    memcpy(variant, folded, p);
+    memcpy(variant + p, folded + p + 1, len - p - 1);
+    keys[count++] = siphash24(corpus->key, variant, len - 1);
+  }
+  secure_wipe(folded, sizeof(folded));
+  secure_wipe(variant, sizeof(variant));
+  return count;
+}
+
+// visit the passwords most frequent first (order). one linked to a
+// representative joins the first such, parent[id] = representative,
+// anything else becomes a representative and claims its keys
+static bool link_entries(cluster_corpus_t *corpus, const ranked_entry_t *order,
+                         uint32_t *parent) {
+  size_t keys = 0;
+  for (size_t i = 0; i < corpus->count; i++)
+    keys += corpus->entries[i].length + 1;
+  // at most three quarters full
+  size_t slot_count = 1024;
+  while (slot_count < keys + keys / 3)
+    slot_count *= 2;
+  uint64_t *slots = calloc(slot_count, sizeof(*slots));
+  if (!slots)
+    return false;
+
+  uint64_t hashes[CLUSTER_MAX_LENGTH + 1];
+  for (size_t i = 0; i < corpus->count; i++) {
+    uint32_t id = order[i].id;
+    const cluster_entry_t *e = &corpus->entries[id];
+    size_t count =
+        password_keys(corpus, corpus->arena + e->offset, e->length, hashes);
+
+    // representatives never share a key, the one visited first is the
+    // most frequent linked one
+    uint32_t first = UINT32_MAX;
+    for (size_t k = 0; k < count; k++) {
+      uint32_t owner = key_owner(slots, slot_count - 1, hashes[k]);
+      if (owner < first)
+        first = owner;
+    }
+    if (first != UINT32_MAX) {
+      parent[id] = order[first].id;
+      continue;
+    }
+    parent[id] = id;
+    for (size_t k = 0; k < count; k++)
+      claim_key(slots, slot_count - 1, hashes[k], (uint32_t)i);
+  }
+  free(slots);
+  return true;
+}
+
+// ============================================
+// Grouping
+// ============================================
+
+static int by_size_desc(const void *a, const void *b) {
+  const password_cluster_t *x = a, *y = b;
+  if (x->lines != y->lines)
+    return x->lines < y->lines ? 1 : -1;
+  if (x->distinct != y->distinct)
+    return x->distinct < y->distinct ? 1 : -1;
+  return (x->first > y->first) - (x->first < y->first);
+}
+
+generator_error_t cluster_corpus_build(cluster_corpus_t *corpus,
+                                       size_t min_distinct) {
+  if (!corpus)
+    return GEN_ERROR_NULL_POINTER;
+  free_build(corpus);
+  if (min_distinct == 0)
+    min_distinct = 1;
+
+  size_t n = corpus->count;
+  uint32_t *parent = malloc((n + 1) * sizeof(*parent));
+  uint32_t *size = calloc(n + 1, sizeof(*size));
+  size_t *start = calloc(n + 1, sizeof(*start));
+  ranked_entry_t *ranked = malloc((n + 1) * sizeof(*ranked));
+  corpus->members = malloc((n + 1) * sizeof(*corpus->members));
+  generator_error_t status = GEN_ERROR_NULL_POINTER;
+  if (!parent || !size || !start || !ranked || !corpus->members)
+    goto done;
+
+  for (size_t i = 0; i < n; i++) {
+    ranked[i].count = corpus->entries[i].count;
+    ranked[i].id = (uint32_t)i;
+  }
+  qsort(ranked, n, sizeof(*ranked), by_count_desc);
+  if (!link_entries(corpus, ranked, parent))
+    goto done;
+
+  // distinct passwords of each representative
+  for (size_t i = 0; i < n; i++)
+    size[parent[i]]++;
+
+  // offsets of each representative's members, in id order
+  size_t offset = 0, clusters = 0;
+  for (size_t r = 0; r < n; r++) {
+    start[r] = offset;
+    offset += size[r];
+    if (size[r] >= min_distinct)
+      clusters++;
+  }
+
+  // members go in most frequent first: placing them in that order keeps it
+  // within every cluster, with the representative first
+  for (size_t i = 0; i < n; i++) {
+    uint32_t root = parent[ranked[i].id];
+    corpus->members[start[root]++] = ranked[i].id;
+  }
+
+  corpus->clusters = malloc((clusters + 1) * sizeof(*corpus->clusters));
+  if (!corpus->clusters)
+    goto done;
+  size_t c = 0;
+  offset = 0;
+  for (size_t r = 0; r < n; r++) {
+    if (size[r] >= min_distinct) {
+      password_cluster_t *cl = &corpus->clusters[c++];
+      cl->first = offset;
+      cl->distinct = size[r];
+      cl->lines = 0;
+      for (size_t k = 0; k < size[r]; k++)
+        cl->lines += corpus->entries[corpus->members[offset + k]].count;
+      corpus->clustered += size[r];
+    }
+    offset += size[r];
+  }
+  qsort(corpus->clusters, clusters, sizeof(*corpus->clusters), by_size_desc);
+  corpus->cluster_count = clusters;
+  status = GEN_SUCCESS;
+
+done:
+  free(parent);
+  free(size);
+  free(start);
+  free(ranked);
+  if (status != GEN_SUCCESS)
+    free_build(corpus);
+  return status;
+}
+
+// ============================================
+// Results
+// ============================================
+
+size_t cluster_count(const cluster_corpus_t *corpus) {
+  return corpus ? corpus->cluster_count : 0;
+}
+
+const password_cluster_t *cluster_at(const cluster_corpus_t *corpus,
+                                     size_t index) {
+  if (!corpus || index >= corpus->cluster_count)
+    return NULL;
+  return &corpus->clusters[index];
+}
+
+static const cluster_entry_t *member_entry(const cluster_corpus_t *corpus,
+                                           const password_cluster_t *cluster,
+                                           size_t k) {
+  return &corpus->entries[corpus->members[cluster->first + k]];
+}
+
+const char *cluster_member(const cluster_corpus_t *corpus,
+                           const password_cluster_t *cluster, size_t k,
+                           size_t *count) {
+  if (!corpus || !cluster || k >= cluster->distinct)
+    return NULL;
+  const cluster_entry_t *e = member_entry(corpus, cluster, k);
+  if (count)
+    *count = e->count;
+  return corpus->arena + e->offset;
+}
+
+cluster_stats_t cluster_corpus_stats(const cluster_corpus_t *corpus) {
+  cluster_stats_t stats = {0};
+  if (!corpus)
+    return stats;
+  stats.lines = corpus->lines;
+  stats.distinct = corpus->count;
+  stats.skipped = corpus->skipped;
+  stats.clusters = corpus->cluster_count;
+  stats.clustered = corpus->clustered;
+  return stats;
+}
+
+static void write_json_string(FILE *out, const char *s) {
+  fputc('"', out);
+  for (; *s; s++) {
+    unsigned char c = (unsigned char)*s;
+    if (c == '"' || c == '\\')
+      fprintf(out, "\\%c", c);
+    else if (c < 0x20)
+      fprintf(out, "\\u%04x", c);
+    else
+      fputc(c, out);
+  }
+  fputc('"', out);
+}
+
+void cluster_write(const cluster_corpus_t *corpus, FILE *out,
+                   cluster_format_t format, size_t max_members) {
+  if (!corpus || !out)
+    return;
+
+  for (size_t i = 0; i < corpus->cluster_count; i++) {
+    const password_cluster_t *cl = &corpus->clusters[i];
+    size_t shown = cl->distinct < max_members ? cl->distinct : max_members;
+    const char *representative =
+        corpus->arena + member_entry(corpus, cl, 0)->offset;
+
+    if (format == CLUSTER_NDJSON) {
+      fprintf(out, "{\"size\":%zu,\"distinct\":%zu,\"representative\":",
+              cl->lines, cl->distinct);
+      write_json_string(out, representative);
+      fputs(",\"members\":[", out);
+      for (size_t k = 0; k < shown; k++) {
+        const cluster_entry_t *e = member_entry(corpus, cl, k);
+        fputs(k ? ",{\"password\":" : "{\"password\":", out);
+        write_json_string(out, corpus->arena + e->offset);
+        fprintf(out, ",\"count\":%u}", e->count);
+      }
+      fputs("]}\n", out);
+    } else {
+      fprintf(out, "#%zu  %zu lines, %zu distinct  representative: %s\n",
+              i + 1, cl->lines, cl->distinct, representative);
+      for (size_t k = 0; k < shown; k++) {
+        const cluster_entry_t *e = member_entry(corpus, cl, k);
+        fprintf(out, "    %s (%u)\n", corpus->arena + e->offset, e->count);
+      }
+      if (shown < cl->distinct)
+        fprintf(out, "    ... %zu more\n", cl->distinct - shown);
+    }
+  }
+}
@@ -1,59 +1,358 @@
 #include "clovo/comparison.h"
+#include "clovo/batch.h"
 
+#include <limits.h>
+#include <math.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// bit-parallel levenshtein (myers 1999, in hyyro's formulation). the
+// shorter string is the pattern: each dp column is kept as two bit vectors
+// of vertical deltas, +1 (pv) and -1 (mv), one bit per pattern character,
+// and a whole column is advanced per text character with a dozen word
+// operations. peq[c] has the bits of the pattern positions holding c
+
+#define BLOCK_BITS 64
+// blocks kept on the stack, longer patterns allocate theirs
+#define STACK_BLOCKS (EDIT_DISTANCE_MAX_LENGTH / BLOCK_BITS)
+
+// peq entries are only cleared for bytes that occur in either string. the
+// blocks of byte c are peq[c * blocks ..]
+static void clear_peq(uint64_t *peq, const char *s, int len, int blocks) {
+  // blocks outermost: the other order gets turned into a short memset per
+  // byte, which costs far more than the stores
+  for (int b = 0; b < blocks; b++)
+    for (int i = 0; i < len; i++)
+      peq[(unsigned char)s[i] * blocks + b] = 0;
+}
+
+// pattern of at most 64 characters
+static int myers_single(const char *pattern, int m, const char *text, int n) {
+  uint64_t peq[256];
+  for (int j = 0; j < n; j++)
+    peq[(unsigned char)text[j]] = 0;
+  for (int i = 0; i < m; i++)
+    peq[(unsigned char)pattern[i]] = 0;
+  for (int i = 0; i < m; i++)
+    peq[(unsigned char)pattern[i]] |= (uint64_t)1 << i;
+
+  uint64_t pv = ~(uint64_t)0, mv = 0;
+  uint64_t last = (uint64_t)1 << (m - 1);
+  int score = m;
+
+  for (int j = 0; j < n; j++) {
+    uint64_t eq = peq[(unsigned char)text[j]];
+    uint64_t xv = eq | mv;
+    uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+    uint64_t ph = mv | ~(xh | pv);
+    uint64_t mh = pv & xh;
+    // ph and mh never share a bit, so at most one of these is 1
+    score += ((ph & last) != 0) - ((mh & last) != 0);
+    // the top row of the table is 0, 1, 2, ...: a +1 enters from above
+    ph = (ph << 1) | 1;
+    mh <<= 1;
+    pv = mh | ~(xv | ph);
+    mv = ph & xv;
+  }
+  return score;
+}
+
+// pattern split into 64-row blocks, each column is advanced block by block
+// with the horizontal delta at the bottom of one block carried into the next.
+// peq has 256 * blocks words, pv and mv blocks each
+static int myers_blocked(const char *pattern, int m, const char *text, int n,
+                         uint64_t *peq, uint64_t *pv, uint64_t *mv) {
+  int blocks = (m + BLOCK_BITS - 1) / BLOCK_BITS;
+
+  clear_peq(peq, text, n, blocks);
+  clear_peq(peq, pattern, m, blocks);
+  for (int i = 0; i < m; i++)
+    peq[(unsigned char)pattern[i] * blocks + i / BLOCK_BITS] |=
+        (uint64_t)1 << (i % BLOCK_BITS);
+  for (int b = 0; b < blocks; b++) {
+    pv[b] = ~(uint64_t)0;
+    mv[b] = 0;
+  }
+
+  int score = m;
+
+  for (int j = 0; j < n; j++) {
+    const uint64_t *eqs = peq + (unsigned char)text[j] * blocks;
+    // horizontal delta entering the block from above as two bits, +1 and
+    // -1; kept branch-free since the deltas on random text don't predict
+    uint64_t carry_p = 1, carry_m = 0;
+    for (int b = 0; b < blocks; b++) {
+      uint64_t eq = eqs[b];
+      uint64_t xv = eq | mv[b];
+      eq |= carry_m;
+      uint64_t xh = (((eq & pv[b]) + pv[b]) ^ pv[b]) | eq;
+      uint64_t ph = mv[b] | ~(xh | pv[b]);
+      uint64_t mh = pv[b] & xh;
+
+      int top = b == blocks - 1 ? (m - 1) % BLOCK_BITS : BLOCK_BITS - 1;
+      uint64_t out_p = (ph >> top) & 1, out_m = (mh >> top) & 1;
+
+      ph = (ph << 1) | carry_p;
+      mh = (mh << 1) | carry_m;
+      pv[b] = mh | ~(xv | ph);
+      mv[b] = ph & xv;
+      carry_p = out_p;
+      carry_m = out_m;
+    }
+    score += (int)carry_p - (int)carry_m;
+  }
+  return score;
+}
+
 int edit_distance(const char *s1, const char *s2) {
   if (!s1 || !s2)
     return -1;
 
-  int len1 = strlen(s1);
-  int len2 = strlen(s2);
+  size_t len1 = strlen(s1);
+  size_t len2 = strlen(s2);
 
+  // the distance is symmetric, the shorter string becomes the pattern
+  if (len1 > len2) {
+    const char *s = s1;
+    s1 = s2;
+    s2 = s;
+    size_t len = len1;
+    len1 = len2;
+    len2 = len;
+  }
   if (len1 == 0)
-    return len2;
-  if (len2 == 0)
-    return len1;
+    return len2 > INT_MAX ? -1 : (int)len2;
+  if (len2 > INT_MAX)
+    return -1;
 
-  // dynamic programming table
-  int **dp = malloc((len1 + 1) * sizeof(int *));
-  for (int i = 0; i <= len1; i++) {
-    dp[i] = malloc((len2 + 1) * sizeof(int));
+  if (len1 <= BLOCK_BITS)
+    return myers_single(s1, (int)len1, s2, (int)len2);
+  if (len1 <= EDIT_DISTANCE_MAX_LENGTH) {
+    uint64_t peq[256 * STACK_BLOCKS];
+    uint64_t pv[STACK_BLOCKS], mv[STACK_BLOCKS];
+    return myers_blocked(s1, (int)len1, s2, (int)len2, peq, pv, mv);
   }
 
-  // initialize base cases
-  for (int i = 0; i <= len1; i++) {
-    dp[i][0] = i;
+  size_t blocks = (len1 + BLOCK_BITS - 1) / BLOCK_BITS;
+  uint64_t *words = malloc((256 + 2) * blocks * sizeof(*words));
+  if (!words)
+    return -1;
+  int distance = myers_blocked(s1, (int)len1, s2, (int)len2, words,
+                               words + 256 * blocks, words + 257 * blocks);
+  free(words);
+  return distance;
+}
+
+// ============================================
+// History Check
+// ============================================
+
+// widest band kept on the stack, larger thresholds use edit_distance()
+#define MAX_BAND_THRESHOLD 31
+// entries checked together, one per byte of an sse2 register
+#define HISTORY_LANES 16
+// longest string the lanes take, longer entries are checked on their own
+#define LANE_MAX_LENGTH 64
+
+static int min3(int a, int b, int c) {
+  int m = a < b ? a : b;
+  return m < c ? m : c;
+}
+
+// ukkonen's band: only cells within k of the diagonal can lead to a
+// distance <= k, everything outside counts as k + 1. false as soon as a
+// whole row is over k
+static bool within_distance(const char *a, int la, const char *b, int lb,
+                            int k) {
+  if (la - lb > k || lb - la > k)
+    return false;
+
+  int rows[2][2 * MAX_BAND_THRESHOLD + 1];
+  int *prev = rows[0], *cur = rows[1];
+  int cap = k + 1;
+
+  for (int d = -k; d <= k; d++)
+    prev[d + k] = d < 0 || d > lb ? cap : d;
+
+  for (int i = 1; i <= la; i++) {
+    int row_min = cap;
+    for (int d = -k; d <= k; d++) {
+      int j = i + d, v;
+      if (j < 0 || j > lb) {
+        v = cap;
+      } else if (j == 0) {
+        v = i < cap ? i : cap;
+      } else {
+        int diag = prev[d + k] + (a[i - 1] != b[j - 1]);
+        int up = d < k ? prev[d + k + 1] + 1 : cap;
+        int left = d > -k ? cur[d + k - 1] + 1 : cap;
+        v = min3(diag, up, left);
+        if (v > cap)
+          v = cap;
+      }
+      cur[d + k] = v;
+      if (v < row_min)
+        row_min = v;
+    }
+    if (row_min > k)
+      return false;
+    int *swap = prev;
+    prev = cur;
+    cur = swap;
   }
-  for (int j = 0; j <= len2; j++) {
-    dp[0][j] = j;
+  return prev[lb - la + k] <= k;
+}
+
+static bool too_close(const char *pw, size_t len, const char *entry, int k) {
+  size_t entry_len = strlen(entry);
+  if (k <= MAX_BAND_THRESHOLD && len <= INT_MAX && entry_len <= INT_MAX)
+    return within_distance(pw, (int)len, entry, (int)entry_len, k);
+  int distance = edit_distance(pw, entry);
+  return distance >= 0 && distance <= k;
+}
+
+#ifdef __SSE2__
+// the same band for up to HISTORY_LANES entries at once, lane l holding
+// entry texts[l]. the entries are transposed so that position j of every
+// entry is one 16-byte load. returns a bitmask of the lanes within k
+static unsigned lanes_within_distance(const char *pattern, int m,
+                                      const char *const texts[],
+                                      const int lengths[], int count, int k) {
+  uint8_t columns[LANE_MAX_LENGTH][HISTORY_LANES];
+  uint8_t length_bytes[HISTORY_LANES];
+  memset(columns, 0, sizeof(columns));
+  memset(length_bytes, 0, sizeof(length_bytes));
+  for (int l = 0; l < count; l++) {
+    for (int j = 0; j < lengths[l]; j++)
+      columns[j][l] = (uint8_t)texts[l][j];
+    length_bytes[l] = (uint8_t)lengths[l];
   }
 
-  // fill the table
-  for (int i = 1; i <= len1; i++) {
-    for (int j = 1; j <= len2; j++) {
-      if (s1[i - 1] == s2[j - 1]) {
-        dp[i][j] = dp[i - 1][j - 1];
+  const __m128i one = _mm_set1_epi8(1);
+  const __m128i cap = _mm_set1_epi8((char)(k + 1));
+  const __m128i limit = _mm_set1_epi8((char)k);
+  const __m128i text_len =
+      _mm_loadu_si128((const __m128i *)length_bytes);
+  __m128i band[2][2 * MAX_BAND_THRESHOLD + 1];
+  __m128i *prev = band[0], *cur = band[1];
+
+  // row 0 is 0, 1, 2, ... along the text, cut off past each text's end
+  for (int d = -k; d <= k; d++) {
+    __m128i v = d < 0 ? cap : _mm_set1_epi8((char)d);
+    __m128i inside = _mm_cmpeq_epi8(
+        _mm_max_epu8(text_len, _mm_set1_epi8((char)(d < 0 ? 0 : d))),
+        text_len);
+    prev[d + k] = _mm_or_si128(_mm_and_si128(inside, v),
+                               _mm_andnot_si128(inside, cap));
+  }
+
+  for (int i = 1; i <= m; i++) {
+    __m128i p = _mm_set1_epi8(pattern[i - 1]);
+    __m128i row_min = cap;
+    for (int d = -k; d <= k; d++) {
+      int j = i + d;
+      __m128i v;
+      if (j < 0 || j > LANE_MAX_LENGTH) {
+        v = cap;
+      } else if (j == 0) {
+        v = _mm_set1_epi8((char)(i < k + 1 ? i : k + 1));
       } else {
-        int min = dp[i - 1][j];
-        if (dp[i][j - 1] < min)
-          min = dp[i][j - 1];
-        if (dp[i - 1][j - 1] < min)
-          min = dp[i - 1][j - 1];
-        dp[i][j] = min + 1;
+        __m128i text = _mm_loadu_si128((const __m128i *)columns[j - 1]);
+        __m128i cost = _mm_andnot_si128(_mm_cmpeq_epi8(text, p), one);
+        v = _mm_adds_epu8(prev[d + k], cost);
+        if (d < k)
+          v = _mm_min_epu8(v, _mm_adds_epu8(prev[d + k + 1], one));
+        if (d > -k)
+          v = _mm_min_epu8(v, _mm_adds_epu8(cur[d + k - 1], one));
+        v = _mm_min_epu8(v, cap);
+        // j <= length, per lane
+        __m128i inside = _mm_cmpeq_epi8(
+            _mm_max_epu8(text_len, _mm_set1_epi8((char)j)), text_len);
+        v = _mm_or_si128(_mm_and_si128(inside, v),
+                         _mm_andnot_si128(inside, cap));
       }
+      cur[d + k] = v;
+      row_min = _mm_min_epu8(row_min, v);
     }
+    // every lane's row is over k: none of them can come back under it
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(row_min, limit),
+                                         row_min)) == 0)
+      return 0;
+    __m128i *swap = prev;
+    prev = cur;
+    cur = swap;
   }
 
-  int result = dp[len1][len2];
+  uint8_t last[2 * MAX_BAND_THRESHOLD + 1][HISTORY_LANES];
+  for (int d = -k; d <= k; d++)
+    _mm_storeu_si128((__m128i *)last[d + k], prev[d + k]);
 
-  // free memory
-  for (int i = 0; i <= len1; i++) {
-    free(dp[i]);
+  unsigned hits = 0;
+  for (int l = 0; l < count; l++) {
+    int d = lengths[l] - m;
+    if (d >= -k && d <= k && last[d + k][l] <= k)
+      hits |= 1u << l;
   }
-  free(dp);
+  return hits;
+}
+#endif
 
-  return result;
+int check_against_history(const char *new_pw, const char *const history[],
+                          size_t n, int threshold) {
+  if (!new_pw || !history || threshold < 0 || n > INT_MAX)
+    return -1;
+
+  size_t len = strlen(new_pw);
+
+  // entries go in chunks of HISTORY_LANES so the first hit is found before
+  // later entries are looked at
+  for (size_t base = 0; base < n; base += HISTORY_LANES) {
+    size_t end = n - base < HISTORY_LANES ? n : base + HISTORY_LANES;
+    unsigned hits = 0;
+
+#ifdef __SSE2__
+    const char *texts[HISTORY_LANES];
+    int lengths[HISTORY_LANES], slots[HISTORY_LANES];
+    int count = 0;
+    bool lanes = threshold <= MAX_BAND_THRESHOLD && len <= LANE_MAX_LENGTH;
+#endif
+
+    for (size_t e = base; e < end; e++) {
+      if (!history[e])
+        continue;
+#ifdef __SSE2__
+      size_t entry_len = strlen(history[e]);
+      if (lanes && entry_len <= LANE_MAX_LENGTH) {
+        texts[count] = history[e];
+        lengths[count] = (int)entry_len;
+        slots[count++] = (int)(e - base);
+        continue;
+      }
+#endif
+      if (too_close(new_pw, len, history[e], threshold))
+        hits |= 1u << (e - base);
+    }
+
+#ifdef __SSE2__
+    if (count > 0) {
+      unsigned lane_hits = lanes_within_distance(new_pw, (int)len, texts,
+                                                 lengths, count, threshold);
+      for (int l = 0; l < count; l++)
+        if (lane_hits & (1u << l))
+          hits |= 1u << slots[l];
+    }
+#endif
+
+    for (int b = 0; hits && b < HISTORY_LANES; b++)
+      if (hits & (1u << b))
+        return (int)(base + (size_t)b);
+  }
+  return -1;
 }
 
 similarity_result_t compare_passwords(const char *pw1, const char *pw2) {
@@ -73,26 +372,31 @@ similarity_result_t compare_passwords(const char *pw1, const char *pw2) {
     return result;
   }
 
-  // calculate edit distance
+  // calculate edit distance, both strings too long to compare count as
+  // entirely different
   result.edit_distance = edit_distance(pw1, pw2);
+  if (result.edit_distance < 0)
+    result.edit_distance = max_len;
 
   // calculate similarity score (0.0 to 1.0)
   result.similarity_score = 1.0 - ((double)result.edit_distance / max_len);
 
-  // count common characters
-  int char_count1[256] = {0};
-  int char_count2[256] = {0};
-
-  for (int i = 0; pw1[i]; i++) {
-    char_count1[(unsigned char)pw1[i]]++;
-  }
-  for (int i = 0; pw2[i]; i++) {
-    char_count2[(unsigned char)pw2[i]]++;
-  }
-
-  for (int i = 0; i < 256; i++) {
-    int min = char_count1[i] < char_count2[i] ? char_count1[i] : char_count2[i];
-    result.common_chars += min;
+  // count common characters: pw1's counts, used up by pw2. only the
+  // counters of bytes in either string are cleared, short passwords
+  // would otherwise spend most of the call zeroing the table
+  int char_count[256];
+  for (int i = 0; i < len1; i++)
+    char_count[(unsigned char)pw1[i]] = 0;
+  for (int i = 0; i < len2; i++)
+    char_count[(unsigned char)pw2[i]] = 0;
+  for (int i = 0; i < len1; i++)
+    char_count[(unsigned char)pw1[i]]++;
+  for (int i = 0; i < len2; i++) {
+    int *count = &char_count[(unsigned char)pw2[i]];
+    if (*count > 0) {
+      (*count)--;
+      result.common_chars++;
+    }
   }
 
   // count common positions
@@ -117,3 +421,142 @@ bool are_passwords_too_similar(const char *old_pw, const char *new_pw,
   similarity_result_t result = compare_passwords(old_pw, new_pw);
   return result.similarity_score > threshold;
 }
+
+// ============================================
+// Batch Comparison
+// ============================================
+
+// counters of a batch run, see batch_line_fn
+enum { COUNT_PAIRS, COUNT_TOO_SIMILAR, COUNT_MALFORMED };
+
+// longest ndjson or csv result line
+#define RESULT_LINE_MAX 96
+
+// unquote the csv field at *p in place and step past its delimiter.
+// returns the delimiter (',' or '\0'), -1 for a broken quoted field
+static int csv_field(char **p, char **field) {
+  char *src = *p, *dst = *p;
+  *field = dst;
+  if (*src == '"') {
+    for (src++;; src++) {
+      if (*src == '\0')
+        return -1;
+      if (*src == '"') {
+        if (src[1] != '"')
+          break;
+        src++; // "" is a quote
+      }
+      *dst++ = *src;
+    }
+    src++;
+  } else {
+    while (*src != '\0' && *src != ',')
+      *dst++ = *src++;
+  }
+
+  int delimiter = *src;
+  if (delimiter != '\0' && delimiter != ',')
+    return -1; // text after a closing quote
+  *dst = '\0';
+  *p = delimiter ? src + 1 : src;
+  return delimiter;
+}
+
+// split a line into its two passwords in place
+static bool split_pair(char *line, size_t len, char **old_pw, char **new_pw) {
+  char *tab = memchr(line, '\t', len);
+  if (tab) {
+    *tab = '\0';
+    *old_pw = line;
+    *new_pw = tab + 1;
+    char *extra = strchr(*new_pw, '\t');
+    if (extra)
+      *extra = '\0';
+    return true;
+  }
+
+  char *p = line;
+  return csv_field(&p, old_pw) == ',' && csv_field(&p, new_pw) >= 0;
+}
+
+// a score in [0, 1] as %.4f prints it
+static char *put_score(char *p, double score) {
+  long scaled = lround(score * 10000);
+  *p++ = (char)('0' + scaled / 10000);
+  *p++ = '.';
+  for (long unit = 1000; unit > 0; unit /= 10)
+    *p++ = (char)('0' + scaled / unit % 10);
+  return p;
+}
+
+static generator_error_t compare_line(void *context, char *line, size_t len,
+                                      size_t number, batch_output_t *out,
+                                      size_t *counters) {
+  const compare_batch_options_t *options = context;
+  char *old_pw, *new_pw;
+  if (!split_pair(line, len, &old_pw, &new_pw)) {
+    counters[COUNT_MALFORMED]++;
+    return GEN_SUCCESS;
+  }
+
+  similarity_result_t result = compare_passwords(old_pw, new_pw);
+  bool too_similar = result.similarity_score > options->threshold;
+  counters[COUNT_PAIRS]++;
+  counters[COUNT_TOO_SIMILAR] += too_similar;
+  if (options->format == COMPARE_BATCH_SUMMARY)
+    return GEN_SUCCESS;
+
+  if (!batch_output_reserve(out, RESULT_LINE_MAX))
+    return GEN_ERROR_NULL_POINTER;
+  char *p = out->data + out->used;
+  bool csv = options->format == COMPARE_BATCH_CSV;
+  p = batch_put_text(p, csv ? "" : "{\"line\":");
+  p = batch_put_number(p, number);
+  p = batch_put_text(p, csv ? "," : ",\"similarity\":");
+  p = put_score(p, result.similarity_score);
+  p = batch_put_text(p, csv ? "," : ",\"edit_distance\":");
+  p = batch_put_number(p, (size_t)result.edit_distance);
+  p = batch_put_text(p, csv ? "," : ",\"too_similar\":");
+  p = batch_put_text(p, too_similar ? "true" : "false");
+  p = batch_put_text(p, csv ? "\n" : "}\n");
+  out->used = (size_t)(p - out->data);
+  return GEN_SUCCESS;
+}
+
+void init_compare_batch_options(compare_batch_options_t *options) {
+  if (!options)
+    return;
+  options->format = COMPARE_BATCH_NDJSON;
+  options->threshold = 0.7;
+  options->threads = 0;
+}
+
+generator_error_t compare_batch(FILE *in, FILE *out,
+                                const compare_batch_options_t *options,
+                                compare_batch_stats_t *stats) {
+  if (stats)
+    memset(stats, 0, sizeof(*stats));
+  if (!in || !options)
+    return GEN_ERROR_NULL_POINTER;
+
+  if (out && options->format == COMPARE_BATCH_CSV &&
+      fputs("line,similarity,edit_distance,too_similar\n", out) == EOF)
+    return GEN_ERROR_FILE_ACCESS;
+
+  batch_job_t job = {.threads = options->threads,
+                     .skip_empty = true,
+                     .line = compare_line,
+                     .context = (void *)options};
+  batch_stats_t totals;
+  generator_error_t err = batch_run(
+      in, options->format == COMPARE_BATCH_SUMMARY ? NULL : out, &job,
+      &totals);
+
+  if (stats) {
+    stats->lines = totals.lines;
+    stats->pairs = totals.counters[COUNT_PAIRS];
+    stats->too_similar = totals.counters[COUNT_TOO_SIMILAR];
+    stats->malformed = totals.counters[COUNT_MALFORMED];
+  }
+  return err;
+}
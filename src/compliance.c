@@ -0,0 +1,105 @@
+#include "clovo/compliance.h"
+#include "clovo/batch.h"
+
+#include <string.h>
+
+// counters of a batch run, see batch_line_fn. the violation counts follow
+// the fixed ones, one per policy_violation_t
+enum { COUNT_PASSWORDS, COUNT_FAILED, COUNT_VIOLATIONS };
+
+_Static_assert(COUNT_VIOLATIONS + POLICY_VIOLATION_COUNT <= BATCH_COUNTERS,
+               "batch counters can't hold every violation");
+
+// longest verdict line: every violation name listed
+#define VERDICT_LINE_MAX 256
+
+static uint32_t line_violations(const compliance_options_t *options,
+                                const char *line, size_t len) {
+  if (options->custom)
+    return custom_policy_check(options->custom, line, len, NULL);
+
+  const password_policy_t *policy = options->policy;
+  password_strength_t analysis = analyze_password_ex(
+      line, len, policy->features | policy_features(policy));
+  return evaluate_policy_analysis(&analysis, policy).violations;
+}
+
+static generator_error_t compliance_line(void *context, char *line,
+                                         size_t len, size_t number,
+                                         batch_output_t *out,
+                                         size_t *counters) {
+  const compliance_options_t *options = context;
+  uint32_t violations = line_violations(options, line, len);
+
+  counters[COUNT_PASSWORDS]++;
+  counters[COUNT_FAILED] += violations != 0;
+  for (int v = 0; v < POLICY_VIOLATION_COUNT; v++)
+    counters[COUNT_VIOLATIONS + v] += (violations >> v) & 1;
+  if (options->format == COMPLIANCE_SUMMARY ||
+      (options->failing_only && violations == 0))
+    return GEN_SUCCESS;
+
+  if (!batch_output_reserve(out, VERDICT_LINE_MAX))
+    return GEN_ERROR_NULL_POINTER;
+  char *p = out->data + out->used;
+  bool csv = options->format == COMPLIANCE_CSV;
+  p = batch_put_text(p, csv ? "" : "{\"line\":");
+  p = batch_put_number(p, number);
+  p = batch_put_text(p, csv ? "," : ",\"passed\":");
+  p = batch_put_text(p, violations ? "false" : "true");
+  p = batch_put_text(p, csv ? "," : ",\"violations\":[");
+  bool first = true;
+  for (int v = 0; v < POLICY_VIOLATION_COUNT; v++) {
+    if (!(violations & ((uint32_t)1 << v)))
+      continue;
+    if (!first)
+      p = batch_put_text(p, csv ? "|" : ",");
+    first = false;
+    p = batch_put_text(p, csv ? "" : "\"");
+    p = batch_put_text(p, policy_violation_name((policy_violation_t)v));
+    p = batch_put_text(p, csv ? "" : "\"");
+  }
+  p = batch_put_text(p, csv ? "\n" : "]}\n");
+  out->used = (size_t)(p - out->data);
+  return GEN_SUCCESS;
+}
+
+void init_compliance_options(compliance_options_t *options) {
+  if (!options)
+    return;
+  options->format = COMPLIANCE_NDJSON;
+  options->failing_only = false;
+  options->threads = 0;
+  options->policy = NULL;
+  options->custom = NULL;
+}
+
+generator_error_t check_compliance(FILE *in, FILE *out,
+                                   const compliance_options_t *options,
+                                   compliance_stats_t *stats) {
+  if (stats)
+    memset(stats, 0, sizeof(*stats));
+  if (!in || !options || (!options->policy && !options->custom))
+    return GEN_ERROR_NULL_POINTER;
+
+  if (out && options->format == COMPLIANCE_CSV &&
+      fputs("line,passed,violations\n", out) == EOF)
+    return GEN_ERROR_FILE_ACCESS;
+
+  batch_job_t job = {.threads = options->threads,
+                     .skip_empty = true,
+                     .line = compliance_line,
+                     .context = (void *)options};
+  batch_stats_t totals;
+  generator_error_t err = batch_run(
+      in, options->format == COMPLIANCE_SUMMARY ? NULL : out, &job, &totals);
+
+  if (stats) {
+    stats->lines = totals.lines;
+    stats->passwords = totals.counters[COUNT_PASSWORDS];
+    stats->failed = totals.counters[COUNT_FAILED];
+    for (int v = 0; v < POLICY_VIOLATION_COUNT; v++)
+      stats->violations[v] = totals.counters[COUNT_VIOLATIONS + v];
+  }
+  return err;
+}
@@ -0,0 +1,653 @@
+#include "clovo/custom_policy.h"
+#include "clovo/charclass.h"
+#include "clovo/utf8.h"
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// bounds on what a config may ask for
+#define MAX_LIMIT 100000
+#define MAX_BANNED_BYTES (1 << 20)
+
+// what a check measures about a password, the rows of the decision table
+// compare one of these against a range
+typedef enum {
+  MEASURE_LENGTH, // code points
+  MEASURE_LOWER,
+  MEASURE_UPPER,
+  MEASURE_DIGITS,
+  MEASURE_SYMBOLS,
+  MEASURE_RUN,    // longest run of one code point
+  MEASURE_BANNED, // 1 when a banned substring was found
+  MEASURE_SEQUENTIAL,
+  MEASURE_REPEATED,
+  MEASURE_COMMON,
+  MEASURE_ENTROPY, // whole bits
+  MEASURE_COUNT
+} measure_t;
+
+// the policy breaks violation when the measure falls outside [min, max]
+typedef struct {
+  unsigned char measure;
+  unsigned char violation;
+  int min;
+  int max;
+} rule_t;
+
+struct custom_policy {
+  char name[CUSTOM_POLICY_NAME_MAX + 1];
+  rule_t rules[POLICY_VIOLATION_COUNT];
+  int rule_count;
+  int limits[POLICY_VIOLATION_COUNT]; // for the messages
+  unsigned features;
+  // banned substrings as a dfa over byte columns: bytes that appear in no
+  // substring share column 0 and case folds into the same column, so the
+  // table is states x columns rather than states x 256
+  unsigned char column[256];
+  uint32_t columns;
+  uint32_t *next; // next[state * columns + column], NULL without substrings
+  unsigned char *match; // a substring ends in this state
+};
+
+struct policy_set {
+  custom_policy_t *policies;
+  size_t count;
+};
+
+// ============================================
+// Compiling
+// ============================================
+
+// one section while it is being read
+typedef struct {
+  bool set[POLICY_VIOLATION_COUNT];
+  int limits[POLICY_VIOLATION_COUNT];
+  char *banned; // folded substrings, each NUL-terminated
+  size_t banned_used;
+  size_t banned_capacity;
+} draft_t;
+
+static void add_rule(custom_policy_t *policy, policy_violation_t violation,
+                     measure_t measure, int min, int max) {
+  rule_t *rule = &policy->rules[policy->rule_count++];
+  rule->measure = (unsigned char)measure;
+  rule->violation = (unsigned char)violation;
+  rule->min = min;
+  rule->max = max;
+}
+
+// aho-corasick over the draft's substrings, goto and failure links folded
+// into one full transition table so the scan never backtracks
+static bool compile_banned(custom_policy_t *policy, const draft_t *draft) {
+  const unsigned char *text = (const unsigned char *)draft->banned;
+  size_t bytes = draft->banned_used;
+
+  unsigned char used[256] = {0};
+  for (size_t i = 0; i < bytes; i++)
+    used[text[i]] = 1;
+  used[0] = 0;
+  unsigned char folded_column[256] = {0};
+  policy->columns = 1;
+  for (int b = 1; b < 256; b++) {
+    if (used[b])
+      folded_column[b] = (unsigned char)policy->columns++;
+  }
+  for (int b = 0; b < 256; b++)
+    policy->column[b] = folded_column[(unsigned char)char_fold((char)b)];
+
+  size_t capacity = bytes + 1; // every byte a new state at worst
+  uint32_t columns = policy->columns;
+  policy->next = calloc(capacity * columns, sizeof(*policy->next));
+  policy->match = calloc(capacity, 1);
+  uint32_t *fail = calloc(capacity, sizeof(*fail));
+  uint32_t *queue = calloc(capacity, sizeof(*queue));
+  if (!policy->next || !policy->match || !fail || !queue) {
+    free(fail);
+    free(queue);
+    return false;
+  }
+
+  // the trie. state 0 is the root, so 0 doubles as "no child yet"
+  uint32_t states = 1, state = 0;
+  for (size_t i = 0; i < bytes; i++) {
+    if (text[i] == '\0') {
+      policy->match[state] = 1;
+      state = 0;
+      continue;
+    }
+    uint32_t *slot =
+        &policy->next[(size_t)state * columns + folded_column[text[i]]];
+    if (*slot == 0)
+      *slot = states++;
+    state = *slot;
+  }
+
+  // breadth first, so a state's failure target (always shallower) has its
+  // row complete before the state's own missing transitions copy from it
+  size_t head = 0, tail = 0;
+  for (uint32_t c = 1; c < columns; c++) {
+    if (policy->next[c] != 0)
+      queue[tail++] = policy->next[c];
+  }
+  while (head < tail) {
+    uint32_t s = queue[head++];
+    uint32_t *row = &policy->next[(size_t)s * columns];
+    const uint32_t *fallback = &policy->next[(size_t)fail[s] * columns];
+    for (uint32_t c = 0; c < columns; c++) {
+      uint32_t t = row[c];
+      if (t == 0) {
+        row[c] = fallback[c];
+        continue;
+      }
+      fail[t] = fallback[c];
+      policy->match[t] |= policy->match[fail[t]];
+      queue[tail++] = t;
+    }
+  }
+  free(fail);
+  free(queue);
+
+  uint32_t *shrunk =
+      realloc(policy->next, (size_t)states * columns * sizeof(*policy->next));
+  if (shrunk)
+    policy->next = shrunk;
+  return true;
+}
+
+// the draft as a table of rules, in policy_violation_t order
+static bool compile_policy(custom_policy_t *policy, const draft_t *draft) {
+  static const measure_t measures[POLICY_VIOLATION_COUNT] = {
+      [POLICY_VIOLATION_TOO_SHORT] = MEASURE_LENGTH,
+      [POLICY_VIOLATION_TOO_LONG] = MEASURE_LENGTH,
+      [POLICY_VIOLATION_LOWERCASE] = MEASURE_LOWER,
+      [POLICY_VIOLATION_UPPERCASE] = MEASURE_UPPER,
+      [POLICY_VIOLATION_DIGITS] = MEASURE_DIGITS,
+      [POLICY_VIOLATION_SYMBOLS] = MEASURE_SYMBOLS,
+      [POLICY_VIOLATION_SEQUENTIAL] = MEASURE_SEQUENTIAL,
+      [POLICY_VIOLATION_REPEATED] = MEASURE_REPEATED,
+      [POLICY_VIOLATION_COMMON] = MEASURE_COMMON,
+      [POLICY_VIOLATION_ENTROPY] = MEASURE_ENTROPY,
+      [POLICY_VIOLATION_REPEAT_RUN] = MEASURE_RUN,
+      [POLICY_VIOLATION_BANNED] = MEASURE_BANNED,
+  };
+
+  for (int v = 0; v < POLICY_VIOLATION_COUNT; v++) {
+    if (!draft->set[v])
+      continue;
+    int limit = draft->limits[v];
+    policy->limits[v] = limit;
+    switch ((policy_violation_t)v) {
+    case POLICY_VIOLATION_TOO_LONG:
+    case POLICY_VIOLATION_REPEAT_RUN:
+      // the longest allowed, 0 for no limit
+      if (limit > 0)
+        add_rule(policy, v, measures[v], 0, limit);
+      break;
+    case POLICY_VIOLATION_SEQUENTIAL:
+    case POLICY_VIOLATION_REPEATED:
+    case POLICY_VIOLATION_COMMON:
+    case POLICY_VIOLATION_BANNED:
+      // forbidden outright
+      add_rule(policy, v, measures[v], 0, 0);
+      break;
+    default:
+      // the fewest required
+      if (limit > 0)
+        add_rule(policy, v, measures[v], limit, INT_MAX);
+      break;
+    }
+  }
+
+  for (int r = 0; r < policy->rule_count; r++) {
+    switch (policy->rules[r].measure) {
+    case MEASURE_SEQUENTIAL:
+      policy->features |= ANALYZE_SEQUENTIAL;
+      break;
+    case MEASURE_REPEATED:
+      policy->features |= ANALYZE_REPEATS;
+      break;
+    case MEASURE_COMMON:
+      policy->features |= ANALYZE_DICTIONARY;
+      break;
+    case MEASURE_ENTROPY:
+      policy->features |= ANALYZE_ENTROPY;
+      break;
+    default:
+      break;
+    }
+  }
+
+  return !draft->set[POLICY_VIOLATION_BANNED] ||
+         compile_banned(policy, draft);
+}
+
+// ============================================
+// Parsing
+// ============================================
+
+static char *trim(char *s) {
+  while (char_class(*s) & CHAR_SPACE)
+    s++;
+  char *end = s + strlen(s);
+  while (end > s && (char_class(end[-1]) & CHAR_SPACE))
+    end--;
+  *end = '\0';
+  return s;
+}
+
+static bool parse_int(const char *value, int *out) {
+  char *end;
+  long n = strtol(value, &end, 10);
+  if (end == value || *end != '\0' || n < 0 || n > MAX_LIMIT)
+    return false;
+  *out = (int)n;
+  return true;
+}
+
+static bool parse_bool(const char *value, bool *out) {
+  if (strcmp(value, "yes") == 0 || strcmp(value, "true") == 0 ||
+      strcmp(value, "1") == 0) {
+    *out = true;
+  } else if (strcmp(value, "no") == 0 || strcmp(value, "false") == 0 ||
+             strcmp(value, "0") == 0) {
+    *out = false;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+// append the comma-separated substrings of value, case-folded
+static bool add_banned(draft_t *draft, char *value) {
+  for (char *save = NULL, *item = strtok_r(value, ",", &save); item;
+       item = strtok_r(NULL, ",", &save)) {
+    item = trim(item);
+    size_t len = strlen(item);
+    if (len == 0)
+      continue;
+    if (draft->banned_used + len + 1 > MAX_BANNED_BYTES)
+      return false;
+    if (draft->banned_used + len + 1 > draft->banned_capacity) {
+      size_t capacity = draft->banned_capacity ? draft->banned_capacity : 256;
+      while (capacity < draft->banned_used + len + 1)
+        capacity *= 2;
+      char *banned = realloc(draft->banned, capacity);
+      if (!banned)
+        return false;
+      draft->banned = banned;
+      draft->banned_capacity = capacity;
+    }
+    char_fold_copy(draft->banned + draft->banned_used, item, (int)len);
+    draft->banned_used += len;
+    draft->banned[draft->banned_used++] = '\0';
+  }
+  draft->set[POLICY_VIOLATION_BANNED] |= draft->banned_used > 0;
+  return true;
+}
+
+// apply one "key = value" line to the draft
+static bool parse_setting(draft_t *draft, const char *key, char *value) {
+  static const struct {
+    const char *key;
+    policy_violation_t violation;
+  } limits[] = {
+      {"min_length", POLICY_VIOLATION_TOO_SHORT},
+      {"max_length", POLICY_VIOLATION_TOO_LONG},
+      {"min_lower", POLICY_VIOLATION_LOWERCASE},
+      {"min_upper", POLICY_VIOLATION_UPPERCASE},
+      {"min_digits", POLICY_VIOLATION_DIGITS},
+      {"min_symbols", POLICY_VIOLATION_SYMBOLS},
+      {"max_repeat", POLICY_VIOLATION_REPEAT_RUN},
+      {"min_entropy", POLICY_VIOLATION_ENTROPY},
+  };
+  static const struct {
+    const char *key;
+    policy_violation_t violation;
+  } allows[] = {
+      {"allow_sequential", POLICY_VIOLATION_SEQUENTIAL},
+      {"allow_repeated", POLICY_VIOLATION_REPEATED},
+      {"allow_common", POLICY_VIOLATION_COMMON},
+  };
+
+  for (size_t i = 0; i < sizeof(limits) / sizeof(limits[0]); i++) {
+    if (strcmp(key, limits[i].key) != 0)
+      continue;
+    int limit;
+    if (!parse_int(value, &limit))
+      return false;
+    draft->set[limits[i].violation] = true;
+    draft->limits[limits[i].violation] = limit;
+    return true;
+  }
+  for (size_t i = 0; i < sizeof(allows) / sizeof(allows[0]); i++) {
+    if (strcmp(key, allows[i].key) != 0)
+      continue;
+    bool allow;
+    if (!parse_bool(value, &allow))
+      return false;
+    draft->set[allows[i].violation] = !allow;
+    return true;
+  }
+  if (strcmp(key, "banned") == 0)
+    return add_banned(draft, value);
+  return false;
+}
+
+static void free_policy(custom_policy_t *policy) {
+  free(policy->next);
+  free(policy->match);
+}
+
+void policy_set_free(policy_set_t *set) {
+  if (!set)
+    return;
+  for (size_t i = 0; i < set->count; i++)
+    free_policy(&set->policies[i]);
+  free(set->policies);
+  free(set);
+}
+
+// compile the draft as the set's newest policy and start a fresh draft
+static bool finish_policy(policy_set_t *set, draft_t *draft) {
+  bool ok = compile_policy(&set->policies[set->count - 1], draft);
+  free(draft->banned);
+  memset(draft, 0, sizeof(*draft));
+  return ok;
+}
+
+policy_set_t *policy_set_parse(const char *text, size_t len,
+                               generator_error_t *error, int *error_line) {
+  generator_error_t err = GEN_SUCCESS;
+  int line_number = 0;
+  policy_set_t *set = calloc(1, sizeof(*set));
+  char *copy = malloc(len + 1);
+  draft_t draft = {0};
+  if (!set || !copy || (!text && len > 0)) {
+    err = GEN_ERROR_NULL_POINTER;
+    goto done;
+  }
+  if (len > 0)
+    memcpy(copy, text, len);
+  copy[len] = '\0';
+
+  char *next = copy;
+  while (next && err == GEN_SUCCESS) {
+    char *line = next;
+    next = strchr(line, '\n');
+    if (next)
+      *next++ = '\0';
+    line_number++;
+    char *comment = strchr(line, '#');
+    if (comment)
+      *comment = '\0';
+    line = trim(line);
+    if (*line == '\0')
+      continue;
+
+    if (*line == '[') {
+      char *close = strchr(line, ']');
+      if (!close || close[1] != '\0') {
+        err = GEN_ERROR_INVALID_CONFIG;
+        break;
+      }
+      *close = '\0';
+      char *name = trim(line + 1);
+      if (*name == '\0' || strlen(name) > CUSTOM_POLICY_NAME_MAX ||
+          policy_set_find(set, name)) {
+        err = GEN_ERROR_INVALID_CONFIG;
+        break;
+      }
+      if (set->count > 0 && !finish_policy(set, &draft)) {
+        err = GEN_ERROR_NULL_POINTER;
+        break;
+      }
+      custom_policy_t *policies =
+          realloc(set->policies, (set->count + 1) * sizeof(*policies));
+      if (!policies) {
+        err = GEN_ERROR_NULL_POINTER;
+        break;
+      }
+      set->policies = policies;
+      memset(&set->policies[set->count], 0, sizeof(*policies));
+      strcpy(set->policies[set->count].name, name);
+      set->count++;
+      continue;
+    }
+
+    char *equals = strchr(line, '=');
+    if (set->count == 0 || !equals) {
+      err = GEN_ERROR_INVALID_CONFIG;
+      break;
+    }
+    *equals = '\0';
+    if (!parse_setting(&draft, trim(line), trim(equals + 1)))
+      err = GEN_ERROR_INVALID_CONFIG;
+  }
+
+  if (err == GEN_SUCCESS) {
+    line_number = 0;
+    if (set->count > 0 && !finish_policy(set, &draft))
+      err = GEN_ERROR_NULL_POINTER;
+  }
+
+done:
+  free(draft.banned);
+  free(copy);
+  if (err != GEN_SUCCESS) {
+    policy_set_free(set);
+    set = NULL;
+  }
+  if (error)
+    *error = err;
+  if (error_line)
+    *error_line = err == GEN_ERROR_INVALID_CONFIG ? line_number : 0;
+  return set;
+}
+
+policy_set_t *policy_set_load(const char *path, generator_error_t *error,
+                              int *error_line) {
+  if (error_line)
+    *error_line = 0;
+  FILE *file = path ? fopen(path, "r") : NULL;
+  if (!file) {
+    if (error)
+      *error = path ? GEN_ERROR_FILE_ACCESS : GEN_ERROR_NULL_POINTER;
+    return NULL;
+  }
+
+  char *text = NULL;
+  size_t used = 0, capacity = 0;
+  bool ok = true;
+  for (;;) {
+    if (used == capacity) {
+      capacity = capacity ? capacity * 2 : 4096;
+      char *grown = realloc(text, capacity);
+      if (!grown) {
+        ok = false;
+        break;
+      }
+      text = grown;
+    }
+    size_t n = fread(text + used, 1, capacity - used, file);
+    used += n;
+    if (n == 0)
+      break;
+  }
+  bool failed = ferror(file);
+  fclose(file);
+
+  policy_set_t *set = NULL;
+  if (!ok || failed) {
+    if (error)
+      *error = ok ? GEN_ERROR_FILE_ACCESS : GEN_ERROR_NULL_POINTER;
+  } else {
+    set = policy_set_parse(text, used, error, error_line);
+  }
+  free(text);
+  return set;
+}
+
+// ============================================
+// Lookup
+// ============================================
+
+size_t policy_set_count(const policy_set_t *set) {
+  return set ? set->count : 0;
+}
+
+const custom_policy_t *policy_set_get(const policy_set_t *set, size_t i) {
+  return set && i < set->count ? &set->policies[i] : NULL;
+}
+
+const custom_policy_t *policy_set_find(const policy_set_t *set,
+                                       const char *name) {
+  for (size_t i = 0; set && name && i < set->count; i++) {
+    if (strcmp(set->policies[i].name, name) == 0)
+      return &set->policies[i];
+  }
+  return NULL;
+}
+
+const char *custom_policy_name(const custom_policy_t *policy) {
+  return policy ? policy->name : NULL;
+}
+
+unsigned custom_policy_features(const custom_policy_t *policy) {
+  return policy ? policy->features : 0;
+}
+
+// ============================================
+// Checking
+// ============================================
+
+uint32_t custom_policy_check(const custom_policy_t *policy, const char *pw,
+                             size_t len, const password_strength_t *analysis) {
+  if (!policy || !pw)
+    return (uint32_t)1 << POLICY_VIOLATION_INVALID;
+
+  // one pass for the counts, the longest run and the banned substrings
+  int measure[MEASURE_COUNT] = {0};
+  uint32_t state = 0, previous = 0;
+  int run = 0;
+  bool banned = false;
+  for (size_t i = 0; i < len;) {
+    uint32_t cp;
+    unsigned classes;
+    size_t n = 1;
+    unsigned char byte = (unsigned char)pw[i];
+    if (byte < 0x80) {
+      cp = byte;
+      classes = char_class((char)byte);
+      if (!(classes & CHAR_ALNUM))
+        classes = CHAR_PUNCT;
+    } else {
+      n = utf8_decode(pw + i, len - i, &cp);
+      classes = unicode_class(cp);
+      if (cp == UTF8_INVALID)
+        cp = 0x110000 + byte; // bad bytes only repeat when they're equal
+    }
+
+    if (policy->next && !banned) {
+      for (size_t k = 0; k < n; k++) {
+        state = policy->next[(size_t)state * policy->columns +
+                             policy->column[(unsigned char)pw[i + k]]];
+        banned |= policy->match[state];
+      }
+    }
+
+    measure[MEASURE_LENGTH]++;
+    measure[MEASURE_LOWER] += (classes & CHAR_LOWER) != 0;
+    measure[MEASURE_UPPER] += (classes & CHAR_UPPER) != 0;
+    measure[MEASURE_DIGITS] += (classes & CHAR_DIGIT) != 0;
+    measure[MEASURE_SYMBOLS] += (classes & CHAR_PUNCT) != 0;
+    run = i > 0 && cp == previous ? run + 1 : 1;
+    if (run > measure[MEASURE_RUN])
+      measure[MEASURE_RUN] = run;
+    previous = cp;
+    i += n;
+  }
+  measure[MEASURE_BANNED] = banned;
+
+  if (policy->features) {
+    password_strength_t local;
+    if (!analysis) {
+      local = analyze_password_ex(pw, len, policy->features);
+      analysis = &local;
+    }
+    measure[MEASURE_SEQUENTIAL] = analysis->has_sequential_pattern;
+    measure[MEASURE_REPEATED] = analysis->has_repeated_chars;
+    measure[MEASURE_COMMON] = analysis->contains_dictionary_word;
+    measure[MEASURE_ENTROPY] =
+        analysis->entropy < MAX_LIMIT ? (int)analysis->entropy : MAX_LIMIT;
+  }
+
+  uint32_t violations = 0;
+  for (int r = 0; r < policy->rule_count; r++) {
+    const rule_t *rule = &policy->rules[r];
+    int value = measure[rule->measure];
+    if (value < rule->min || value > rule->max)
+      violations |= (uint32_t)1 << rule->violation;
+  }
+  return violations;
+}
+
+size_t custom_policy_describe(const custom_policy_t *policy,
+                              policy_violation_t violation, char *buffer,
+                              size_t size) {
+  int limit = policy && (unsigned)violation < POLICY_VIOLATION_COUNT
+                  ? policy->limits[violation]
+                  : 0;
+  const char *plural = limit == 1 ? "" : "s";
+  int n;
+  switch (violation) {
+  case POLICY_VIOLATION_TOO_SHORT:
+    n = snprintf(buffer, size, "Password too short (minimum %d characters)",
+                 limit);
+    break;
+  case POLICY_VIOLATION_TOO_LONG:
+    n = snprintf(buffer, size, "Password too long (maximum %d characters)",
+                 limit);
+    break;
+  case POLICY_VIOLATION_LOWERCASE:
+    n = snprintf(buffer, size, "Needs at least %d lowercase letter%s", limit,
+                 plural);
+    break;
+  case POLICY_VIOLATION_UPPERCASE:
+    n = snprintf(buffer, size, "Needs at least %d uppercase letter%s", limit,
+                 plural);
+    break;
+  case POLICY_VIOLATION_DIGITS:
+    n = snprintf(buffer, size, "Needs at least %d digit%s", limit, plural);
+    break;
+  case POLICY_VIOLATION_SYMBOLS:
+    n = snprintf(buffer, size, "Needs at least %d symbol%s", limit, plural);
+    break;
+  case POLICY_VIOLATION_SEQUENTIAL:
+    n = snprintf(buffer, size, "Contains sequential patterns");
+    break;
+  case POLICY_VIOLATION_REPEATED:
+    n = snprintf(buffer, size, "Contains repeated characters");
+    break;
+  case POLICY_VIOLATION_COMMON:
+    n = snprintf(buffer, size, "Contains common dictionary word");
+    break;
+  case POLICY_VIOLATION_ENTROPY:
+    n = snprintf(buffer, size, "Entropy too low (minimum %.1f bits)",
+                 (double)limit);
+    break;
+  case POLICY_VIOLATION_REPEAT_RUN:
+    n = snprintf(buffer, size, "Same character more than %d time%s in a row",
+                 limit, plural);
+    break;
+  case POLICY_VIOLATION_BANNED:
+    n = snprintf(buffer, size, "Contains a banned word");
+    break;
+  default:
+    n = snprintf(buffer, size, "Invalid input");
+    break;
+  }
+  return n > 0 ? (size_t)n : 0;
+}
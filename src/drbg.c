@@ -0,0 +1,192 @@
+#include "clovo/drbg.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+// keystream blocks produced per refill, the first 32 bytes become the next
+// key and the rest is served
+#define CHACHA_BLOCK 64
+#define REFILL_BLOCKS 8
+#define KEY_BYTES 32
+#define BUFFER_BYTES (REFILL_BLOCKS * CHACHA_BLOCK - KEY_BYTES)
+
+typedef struct {
+  uint32_t key[8];
+  uint64_t counter;
+  unsigned char buffer[BUFFER_BYTES];
+  size_t available; // unread bytes at the end of buffer
+  size_t since_seed;
+  uint64_t seeds;
+  unsigned fork_generation;
+  bool seeded;
+} drbg_state_t;
+
+static _Thread_local drbg_state_t state;
+
+// ============================================
+// ChaCha20 (RFC 8439 block function)
+// ============================================
+
+#define ROTL32(x, n) (uint32_t)(((x) << (n)) | ((x) >> (32 - (n))))
+
+#define QUARTER_ROUND(a, b, c, d)                                              \
+  do {                                                                         \
+    a += b;                                                                    \
+    d = ROTL32(d ^ a, 16);                                                     \
+    c += d;                                                                    \
+    b = ROTL32(b ^ c, 12);                                                     \
+    a += b;                                                                    \
+    d = ROTL32(d ^ a, 8);                                                      \
+    c += d;                                                                    \
+    b = ROTL32(b ^ c, 7);                                                      \
+  } while (0)
+
+static void store_le32(unsigned char *p, uint32_t v) {
+  p[0] = (unsigned char)v;
+  p[1] = (unsigned char)(v >> 8);
+  p[2] = (unsigned char)(v >> 16);
+  p[3] = (unsigned char)(v >> 24);
+}
+
+static uint32_t load_le32(const unsigned char *p) {
+  return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 |
+         (uint32_t)p[3] << 24;
+}
+
+// one 64-byte keystream block; the nonce is always zero, the 64-bit counter
+// never repeats under one key because keys are replaced on every refill
+static void chacha20_block(const uint32_t key[8], uint64_t counter,
+                           unsigned char out[CHACHA_BLOCK]) {
+  uint32_t input[16] = {
+      0x61707865, 0x3320646e, 0x79622d32, 0x6b206574,
+      key[0],     key[1],     key[2],     key[3],
+      key[4],     key[5],     key[6],     key[7],
+      (uint32_t)counter, (uint32_t)(counter >> 32), 0, 0};
+  uint32_t x[16];
+  memcpy(x, input, sizeof(x));
+
+  for (int i = 0; i < 10; i++) {
+    QUARTER_ROUND(x[0], x[4], x[8], x[12]);
+    QUARTER_ROUND(x[1], x[5], x[9], x[13]);
+    QUARTER_ROUND(x[2], x[6], x[10], x[14]);
+    QUARTER_ROUND(x[3], x[7], x[11], x[15]);
+    QUARTER_ROUND(x[0], x[5], x[10], x[15]);
+    QUARTER_ROUND(x[1], x[6], x[11], x[12]);
+    QUARTER_ROUND(x[2], x[7], x[8], x[13]);
+    QUARTER_ROUND(x[3], x[4], x[9], x[14]);
+  }
+
+  for (int i = 0; i < 16; i++)
+    store_le32(out + 4 * i, x[i] + input[i]);
+}
+
+// ============================================
+// Seeding
+// ============================================
+
+// bumped in the child after fork() so every thread state reseeds instead of
+// repeating the parent's stream
+static atomic_uint fork_generation;
+
+#ifndef _WIN32
+static pthread_once_t atfork_once = PTHREAD_ONCE_INIT;
+
+static void on_fork_child(void) {
+  atomic_fetch_add_explicit(&fork_generation, 1, memory_order_relaxed);
+}
+
+static void register_atfork(void) {
+  pthread_atfork(NULL, NULL, on_fork_child);
+}
+#endif
+
+static bool seed(drbg_state_t *s) {
+#ifndef _WIN32
+  pthread_once(&atfork_once, register_atfork);
+#endif
+
+  uint32_t fresh[8];
+  if (secure_random_bytes((unsigned char *)fresh, sizeof(fresh)) !=
+      GEN_SUCCESS)
+    return false;
+
+  // mix into the old key rather than replacing it, a weak reseed can't make
+  // the state worse
+  for (int i = 0; i < 8; i++)
+    s->key[i] ^= fresh[i];
+  secure_wipe(fresh, sizeof(fresh));
+
+  s->counter = 0;
+  s->available = 0;
+  s->since_seed = 0;
+  s->seeds++;
+  s->fork_generation =
+      atomic_load_explicit(&fork_generation, memory_order_relaxed);
+  s->seeded = true;
+  return true;
+}
+
+static void refill(drbg_state_t *s) {
+  unsigned char block[CHACHA_BLOCK];
+
+  // first block: next key + the start of the output
+  chacha20_block(s->key, s->counter++, block);
+  memcpy(s->buffer, block + KEY_BYTES, CHACHA_BLOCK - KEY_BYTES);
+
+  unsigned char *out = s->buffer + CHACHA_BLOCK - KEY_BYTES;
+  for (int b = 1; b < REFILL_BLOCKS; b++, out += CHACHA_BLOCK)
+    chacha20_block(s->key, s->counter++, out);
+
+  // the key that produced this buffer is gone after this
+  for (int i = 0; i < 8; i++)
+    s->key[i] = load_le32(block + 4 * i);
+  secure_wipe(block, sizeof(block));
+  s->available = BUFFER_BYTES;
+}
+
+// ============================================
+// Public API
+// ============================================
+
+generator_error_t drbg_random_bytes(void *out, size_t n) {
+  if (!out)
+    return GEN_ERROR_NULL_POINTER;
+
+  drbg_state_t *s = &state;
+  unsigned char *dst = out;
+  unsigned generation =
+      atomic_load_explicit(&fork_generation, memory_order_relaxed);
+
+  while (n > 0) {
+    if (!s->seeded || s->since_seed >= DRBG_RESEED_BYTES ||
+        s->fork_generation != generation) {
+      if (!seed(s))
+        return GEN_ERROR_RANDOM_FAILED;
+    }
+    if (s->available == 0)
+      refill(s);
+
+    size_t take = n < s->available ? n : s->available;
+    unsigned char *src = s->buffer + BUFFER_BYTES - s->available;
+    memcpy(dst, src, take);
+    // served bytes never stay in memory
+    memset(src, 0, take);
+
+    s->available -= take;
+    s->since_seed += take;
+    dst += take;
+    n -= take;
+  }
+  return GEN_SUCCESS;
+}
+
+void drbg_reseed(void) { state.since_seed = DRBG_RESEED_BYTES; }
+
+void drbg_clear(void) { secure_wipe(&state, sizeof(state)); }
+
+uint64_t drbg_seed_count(void) { return state.seeds; }
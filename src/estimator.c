@@ -0,0 +1,670 @@
+#include "clovo/estimator.h"
+#include "clovo/charclass.h"
+#include "clovo/generator.h"
+#include "clovo/keyboard.h"
+
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+guess estimation works like zxcvbn:
+1. enumerate every dictionary, keyboard, sequence, repeat and date match
+   together with its position and the guesses needed to find it
+2. find the decomposition of the password into matches (gaps are filled
+   with bruteforce over the character classes they use) that minimizes
+     l! * product(guesses) + MIN_GUESSES_BEFORE_GROWING_SEQUENCE^(l - 1)
+   where l is the number of matches, via dynamic programming over the end
+   position and l
+everything lives in fixed-size arrays on the stack, the work is bounded by
+ESTIMATE_MAX_LENGTH, ESTIMATE_MAX_MATCHES and ESTIMATE_MAX_SEQUENCE
+*/
+
+// the least a bruteforce character costs, zxcvbn's 10^n
+#define BRUTEFORCE_CARDINALITY 10.0
+#define MIN_GUESSES_BEFORE_GROWING_SEQUENCE 10000.0
+#define MIN_SUBMATCH_GUESSES_SINGLE_CHAR 10.0
+#define MIN_SUBMATCH_GUESSES_MULTI_CHAR 50.0
+#define MIN_YEAR_SPACE 20
+#define REFERENCE_YEAR 2026
+
+// longest substring looked up in the common list
+#define DICTIONARY_MAX_WORD 32
+// longest repeated unit looked for ("abcabc" has a unit of 3)
+#define REPEAT_MAX_UNIT 16
+
+static double n_choose_k(int n, int k) {
+  if (k > n)
+    return 0.0;
+  if (k == 0)
+    return 1.0;
+  double r = 1.0;
+  for (int d = 1; d <= k; d++) {
+    r *= n;
+    r /= d;
+    n--;
+  }
+  return r;
+}
+
+// characters a bruteforce attack over these classes has to try per
+// position. a byte >= 0x80 counts 16, about 64 letters per two-byte
+// character
+static double class_cardinality(unsigned classes) {
+  double cardinality = 0.0;
+  if (classes & CHAR_LOWER)
+    cardinality += 26;
+  if (classes & CHAR_UPPER)
+    cardinality += 26;
+  if (classes & CHAR_DIGIT)
+    cardinality += 10;
+  if (classes & (CHAR_PUNCT | CHAR_SPACE | CHAR_CONTROL))
+    cardinality += 33;
+  if (classes & CHAR_HIGH)
+    cardinality += 16;
+  return cardinality > BRUTEFORCE_CARDINALITY ? cardinality
+                                              : BRUTEFORCE_CARDINALITY;
+}
+
+static double token_cardinality(const char *token, int length) {
+  unsigned classes = 0;
+  for (int i = 0; i < length; i++)
+    classes |= char_class(token[i]);
+  return class_cardinality(classes);
+}
+
+// guesses for token[0..length) made of random characters of its classes
+static double bruteforce_guesses(const char *token, int length) {
+  double guesses = pow(token_cardinality(token, length), length);
+  if (guesses > DBL_MAX)
+    guesses = DBL_MAX;
+  // a bruteforce token must never beat the submatch minimums
+  double min_guesses = length == 1 ? MIN_SUBMATCH_GUESSES_SINGLE_CHAR + 1
+                                   : MIN_SUBMATCH_GUESSES_MULTI_CHAR + 1;
+  return guesses > min_guesses ? guesses : min_guesses;
+}
+
+// ============================================
+// Dictionary matching
+// ============================================
+
+// how many ways the token could have been capitalized
+static double uppercase_variations(const char *token, int len) {
+  int upper = 0;
+  int lower = 0;
+  for (int i = 0; i < len; i++) {
+    if (char_is_upper(token[i]))
+      upper++;
+    else if (char_is_lower(token[i]))
+      lower++;
+  }
+  if (upper == 0)
+    return 1.0;
+
+  // Capitalized, capitalizeD and CAPITALIZED are the first things tried
+  bool first_only = upper == 1 && char_is_upper(token[0]);
+  bool last_only = upper == 1 && char_is_upper(token[len - 1]);
+  if (lower == 0 || first_only || last_only)
+    return 2.0;
+
+  double variations = 0.0;
+  int limit = upper < lower ? upper : lower;
+  for (int i = 1; i <= limit; i++)
+    variations += n_choose_k(upper + lower, i);
+  return variations;
+}
+
+// how many ways substitutions could have been applied to the token
+static double l33t_variations(const char *lower, const char *plain, int len) {
+  int subbed = 0;
+  int unsubbed = 0;
+  for (int i = 0; i < len; i++) {
+    if (lower[i] != plain[i]) {
+      subbed++;
+    } else {
+      // plain letter that could have been substituted but wasn't
+      for (int k = 0; k < len; k++) {
+        if (lower[k] != plain[k] && plain[k] == lower[i]) {
+          unsubbed++;
+          break;
+        }
+      }
+    }
+  }
+  if (subbed == 0)
+    return 1.0;
+  if (unsubbed == 0)
+    return 2.0;
+
+  double variations = 0.0;
+  int limit = subbed < unsubbed ? subbed : unsubbed;
+  for (int i = 1; i <= limit; i++)
+    variations += n_choose_k(subbed + unsubbed, i);
+  return variations;
+}
+
+static int match_dictionary(const char *password, int n, match_t *out,
+                            int count, int max) {
+  char lower[ESTIMATE_MAX_LENGTH];
+  char plain[ESTIMATE_MAX_LENGTH];
+  // subs[k] = substituted characters in password[0..k)
+  int subs[ESTIMATE_MAX_LENGTH + 1];
+
+  subs[0] = 0;
+  for (int i = 0; i < n; i++) {
+    lower[i] = char_fold(password[i]);
+    plain[i] = char_unleet(password[i]);
+    subs[i + 1] = subs[i] + (plain[i] != lower[i]);
+  }
+
+  size_t ranks[DICTIONARY_MAX_WORD];
+  size_t plain_ranks[DICTIONARY_MAX_WORD];
+
+  for (int i = 0; i < n && count < max; i++) {
+    int max_len = n - i < DICTIONARY_MAX_WORD ? n - i : DICTIONARY_MAX_WORD;
+    int found = (int)common_password_prefix_ranks(lower + i, max_len, ranks);
+    int plain_found = 0;
+    if (subs[i + max_len] != subs[i])
+      plain_found =
+          (int)common_password_prefix_ranks(plain + i, max_len, plain_ranks);
+
+    int scan = found > plain_found ? found : plain_found;
+    for (int len = 3; len <= scan && count < max; len++) {
+      bool l33t = false;
+      size_t rank = len <= found ? ranks[len - 1] : 0;
+      if (rank == 0 && len <= plain_found && subs[i + len] != subs[i]) {
+        rank = plain_ranks[len - 1];
+        l33t = rank != 0;
+      }
+      if (rank == 0)
+        continue;
+
+      match_t *m = &out[count++];
+      memset(m, 0, sizeof(*m));
+      m->pattern = MATCH_DICTIONARY;
+      m->i = i;
+      m->j = i + len - 1;
+      m->rank = (int)rank;
+      m->l33t = l33t;
+      m->guesses = (double)rank * uppercase_variations(password + i, len);
+      if (l33t)
+        m->guesses *= l33t_variations(lower + i, plain + i, len);
+    }
+  }
+  return count;
+}
+
+// ============================================
+// Keyboard matching
+// ============================================
+
+static int match_keyboard(const char *password, int n, match_t *out,
+                          int count, int max) {
+  keyboard_walk_t walks[ESTIMATE_MAX_MATCHES];
+  int found = find_keyboard_walks(password, n, walks, max - count);
+
+  for (int w = 0; w < found; w++) {
+    match_t *m = &out[count++];
+    memset(m, 0, sizeof(*m));
+    m->pattern = MATCH_KEYBOARD;
+    m->i = walks[w].i;
+    m->j = walks[w].j;
+    m->turns = walks[w].turns;
+    m->guesses = keyboard_walk_guesses(&walks[w]);
+  }
+  return count;
+}
+
+// ============================================
+// Sequence matching (abc, 13579, zyx)
+// ============================================
+
+static int add_sequence(const char *password, int i, int j, int delta,
+                        match_t *out, int count) {
+  if (j - i < 2 || delta == 0 || abs(delta) > 5)
+    return count;
+
+  char first = password[i];
+  double base;
+  if (strchr("aAzZ019", first))
+    base = 4.0;
+  else if (char_is_digit(first))
+    base = 10.0;
+  else
+    base = 26.0;
+  if (delta < 0)
+    base *= 2.0;
+
+  match_t *m = &out[count++];
+  memset(m, 0, sizeof(*m));
+  m->pattern = MATCH_SEQUENCE;
+  m->i = i;
+  m->j = j;
+  m->guesses = base * (j - i + 1);
+  return count;
+}
+
+static int match_sequences(const char *password, int n, match_t *out,
+                           int count, int max) {
+  if (n < 3)
+    return count;
+
+  int i = 0;
+  int last_delta = password[1] - password[0];
+  for (int k = 2; k < n && count < max; k++) {
+    int delta = password[k] - password[k - 1];
+    if (delta == last_delta)
+      continue;
+    count = add_sequence(password, i, k - 1, last_delta, out, count);
+    i = k - 1;
+    last_delta = delta;
+  }
+  if (count < max)
+    count = add_sequence(password, i, n - 1, last_delta, out, count);
+  return count;
+}
+
+// ============================================
+// Repeat matching (aaa, abcabc)
+// ============================================
+
+static double most_guessable(const char *password, int n, int depth,
+                             guess_estimate_t *estimate);
+
+static int match_repeats(const char *password, int n, int depth, match_t *out,
+                         int count, int max) {
+  int i = 0;
+  while (i < n && count < max) {
+    int best_unit = 0;
+    int best_count = 0;
+    for (int unit = 1; unit <= REPEAT_MAX_UNIT && unit * 2 <= n - i; unit++) {
+      int repeats = 1;
+      while (i + (repeats + 1) * unit <= n &&
+             memcmp(password + i, password + i + repeats * unit, unit) == 0)
+        repeats++;
+      if (repeats < (unit == 1 ? 3 : 2))
+        continue;
+      if (unit * repeats > best_unit * best_count) {
+        best_unit = unit;
+        best_count = repeats;
+      }
+    }
+
+    if (best_unit == 0) {
+      i++;
+      continue;
+    }
+
+    // the base is scored on its own, nested repeats are not searched
+    double base_guesses;
+    if (best_unit == 1 || depth > 0)
+      base_guesses = bruteforce_guesses(password + i, best_unit);
+    else
+      base_guesses = most_guessable(password + i, best_unit, depth + 1, NULL);
+
+    match_t *m = &out[count++];
+    memset(m, 0, sizeof(*m));
+    m->pattern = MATCH_REPEAT;
+    m->i = i;
+    m->j = i + best_unit * best_count - 1;
+    m->repeat_count = best_count;
+    m->guesses = base_guesses * best_count;
+    i = m->j + 1;
+  }
+  return count;
+}
+
+// ============================================
+// Date matching (1987, 12/31/1999, 311299)
+// ============================================
+
+static bool valid_day_month(int a, int b) {
+  return (a >= 1 && a <= 31 && b >= 1 && b <= 12) ||
+         (b >= 1 && b <= 31 && a >= 1 && a <= 12);
+}
+
+static int normalize_year(int value, int digits) {
+  if (digits == 4)
+    return value;
+  if (digits == 2)
+    return value > REFERENCE_YEAR % 100 + 5 ? 1900 + value : 2000 + value;
+  return -1;
+}
+
+// try year-first and year-last readings of three numbers, return the year
+// closest to the reference year or -1 when nothing is a plausible date
+static int parse_date(const int values[3], const int digits[3]) {
+  int best = -1;
+  for (int year_at = 0; year_at <= 2; year_at += 2) {
+    int year = normalize_year(values[year_at], digits[year_at]);
+    if (year < 1000 || year > 2050)
+      continue;
+    int a = values[year_at == 0 ? 1 : 0];
+    int b = values[year_at == 0 ? 2 : 1];
+    if (!valid_day_month(a, b))
+      continue;
+    if (best < 0 || abs(year - REFERENCE_YEAR) < abs(best - REFERENCE_YEAR))
+      best = year;
+  }
+  return best;
+}
+
+static int add_date(int i, int j, int year, bool has_day, bool separator,
+                    match_t *out, int count) {
+  int year_space = abs(year - REFERENCE_YEAR);
+  if (year_space < MIN_YEAR_SPACE)
+    year_space = MIN_YEAR_SPACE;
+
+  match_t *m = &out[count++];
+  memset(m, 0, sizeof(*m));
+  m->pattern = MATCH_DATE;
+  m->i = i;
+  m->j = j;
+  m->year = year;
+  m->guesses = (double)year_space;
+  if (has_day) {
+    m->guesses *= 365.0;
+    if (separator)
+      m->guesses *= 4.0;
+  }
+  return count;
+}
+
+static int read_number(const char *s, int len) {
+  int value = 0;
+  for (int k = 0; k < len; k++)
+    value = value * 10 + (s[k] - '0');
+  return value;
+}
+
+static int match_dates(const char *password, int n, match_t *out, int count,
+                       int max) {
+  for (int i = 0; i < n && count < max; i++) {
+    if (!char_is_digit(password[i]))
+      continue;
+
+    int run = 0;
+    while (i + run < n && char_is_digit(password[i + run]))
+      run++;
+
+    // recent years on their own
+    if (run >= 4) {
+      int year = read_number(password + i, 4);
+      if (year >= 1900 && year <= 2050)
+        count = add_date(i, i + 3, year, false, false, out, count);
+    }
+
+    // dates without separators, 4 to 8 digits split into three numbers
+    for (int len = 4; len <= 8 && len <= run && count < max; len++) {
+      int best = -1;
+      for (int s1 = 1; s1 < len - 1; s1++) {
+        for (int s2 = s1 + 1; s2 < len; s2++) {
+          int digits[3] = {s1, s2 - s1, len - s2};
+          if (digits[0] > 4 || digits[1] > 2 || digits[2] > 4)
+            continue;
+          int values[3] = {read_number(password + i, digits[0]),
+                           read_number(password + i + s1, digits[1]),
+                           read_number(password + i + s2, digits[2])};
+          int year = parse_date(values, digits);
+          if (year >= 0 && (best < 0 || abs(year - REFERENCE_YEAR) <
+                                            abs(best - REFERENCE_YEAR)))
+            best = year;
+        }
+      }
+      if (best >= 0)
+        count = add_date(i, i + len - 1, best, true, false, out, count);
+    }
+
+    // dates with separators: d{1,4} sep d{1,2} sep d{1,4}
+    if (count < max && run <= 4 && i + run < n) {
+      char sep = password[i + run];
+      if (strchr(" -/\\_.", sep)) {
+        int k = i + run + 1;
+        int mid = 0;
+        while (k + mid < n && mid < 3 &&
+               char_is_digit(password[k + mid]))
+          mid++;
+        if (mid >= 1 && mid <= 2 && k + mid < n && password[k + mid] == sep) {
+          int t = k + mid + 1;
+          int last = 0;
+          while (t + last < n && last < 5 &&
+                 char_is_digit(password[t + last]))
+            last++;
+          if (last >= 1 && last <= 4) {
+            int digits[3] = {run, mid, last};
+            int values[3] = {read_number(password + i, run),
+                             read_number(password + k, mid),
+                             read_number(password + t, last)};
+            int year = parse_date(values, digits);
+            if (year >= 0)
+              count = add_date(i, t + last - 1, year, true, true, out,
+                               count);
+          }
+        }
+      }
+    }
+  }
+  return count;
+}
+
+static int enumerate_matches_depth(const char *password, int length, int depth,
+                                   match_t *matches, int max_matches) {
+  int count = 0;
+  count = match_keyboard(password, length, matches, count, max_matches);
+  count = match_sequences(password, length, matches, count, max_matches);
+  count = match_repeats(password, length, depth, matches, count, max_matches);
+  count = match_dates(password, length, matches, count, max_matches);
+  // dictionary last, it is the matcher most likely to fill the list
+  count = match_dictionary(password, length, matches, count, max_matches);
+  return count;
+}
+
+int enumerate_matches(const char *password, int length, match_t *matches,
+                      int max_matches) {
+  if (!password || !matches || length <= 0 || max_matches <= 0)
+    return 0;
+  if (length > ESTIMATE_MAX_LENGTH)
+    length = ESTIMATE_MAX_LENGTH;
+  return enumerate_matches_depth(password, length, 0, matches, max_matches);
+}
+
+// ============================================
+// Minimum-guess decomposition
+// ============================================
+
+// m[k][l] encodes the last match of the best l-match sequence ending at k:
+// >= 0 is an index into the match list, <= -2 is bruteforce starting at
+// -(m + 2), NO_MATCH means no such sequence
+#define NO_MATCH (-1)
+#define BRUTEFORCE_FROM(i) (-(i) - 2)
+
+typedef struct {
+  double pi[ESTIMATE_MAX_LENGTH][ESTIMATE_MAX_SEQUENCE + 1];
+  double g[ESTIMATE_MAX_LENGTH][ESTIMATE_MAX_SEQUENCE + 1];
+  int m[ESTIMATE_MAX_LENGTH][ESTIMATE_MAX_SEQUENCE + 1];
+  int max_l[ESTIMATE_MAX_LENGTH];
+} optimal_t;
+
+// l! and MIN_GUESSES_BEFORE_GROWING_SEQUENCE^(l - 1) for every l
+static const double factorials[ESTIMATE_MAX_SEQUENCE + 1] = {
+    1.0,       1.0,        2.0,         6.0,          24.0,
+    120.0,     720.0,      5040.0,      40320.0,      362880.0,
+    3628800.0, 39916800.0, 479001600.0, 6227020800.0, 87178291200.0,
+    1307674368000.0, 20922789888000.0};
+static const double sequence_growth[ESTIMATE_MAX_SEQUENCE + 1] = {
+    0.0,  1e0,  1e4,  1e8,  1e12, 1e16, 1e20, 1e24, 1e28,
+    1e32, 1e36, 1e40, 1e44, 1e48, 1e52, 1e56, 1e60};
+
+static void dp_update(optimal_t *opt, int encoded, int i, int k,
+                      double guesses, int l) {
+  double pi = guesses;
+  if (l > 1)
+    pi *= opt->pi[i - 1][l - 1];
+  double g = factorials[l] * pi + sequence_growth[l];
+
+  // only keep it if no sequence with as few or fewer matches is as good
+  for (int cl = 1; cl <= opt->max_l[k] && cl <= l; cl++) {
+    if (opt->m[k][cl] != NO_MATCH && opt->g[k][cl] <= g)
+      return;
+  }
+
+  opt->g[k][l] = g;
+  opt->pi[k][l] = pi;
+  opt->m[k][l] = encoded;
+  if (l > opt->max_l[k])
+    opt->max_l[k] = l;
+}
+
+static void dp_extend(optimal_t *opt, int encoded, int i, int k,
+                      double guesses, bool skip_after_bruteforce) {
+  if (i == 0) {
+    dp_update(opt, encoded, i, k, guesses, 1);
+    return;
+  }
+  for (int l = 1; l <= opt->max_l[i - 1] && l < ESTIMATE_MAX_SEQUENCE; l++) {
+    int prev = opt->m[i - 1][l];
+    if (prev == NO_MATCH)
+      continue;
+    // two bruteforce tokens in a row are just one longer token
+    if (skip_after_bruteforce && prev <= BRUTEFORCE_FROM(0))
+      continue;
+    dp_update(opt, encoded, i, k, guesses, l + 1);
+  }
+}
+
+static double most_guessable(const char *password, int n, int depth,
+                             guess_estimate_t *estimate) {
+  match_t matches[ESTIMATE_MAX_MATCHES];
+  int count = enumerate_matches_depth(password, n, depth, matches,
+                                      ESTIMATE_MAX_MATCHES);
+
+  optimal_t opt;
+  for (int k = 0; k < n; k++) {
+    opt.max_l[k] = 0;
+    for (int l = 0; l <= ESTIMATE_MAX_SEQUENCE; l++)
+      opt.m[k][l] = NO_MATCH;
+  }
+
+  // bucket matches by their end position
+  int order[ESTIMATE_MAX_MATCHES];
+  int starts[ESTIMATE_MAX_LENGTH + 1] = {0};
+  for (int x = 0; x < count; x++)
+    starts[matches[x].j + 1]++;
+  for (int k = 0; k < n; k++)
+    starts[k + 1] += starts[k];
+  int fill[ESTIMATE_MAX_LENGTH];
+  memcpy(fill, starts, sizeof(int) * n);
+  for (int x = 0; x < count; x++)
+    order[fill[matches[x].j]++] = x;
+
+  for (int k = 0; k < n; k++) {
+    for (int x = starts[k]; x < starts[k + 1]; x++) {
+      match_t *m = &matches[order[x]];
+      int token_len = m->j - m->i + 1;
+      if (token_len < n) {
+        double min_guesses = token_len == 1 ? MIN_SUBMATCH_GUESSES_SINGLE_CHAR
+                                            : MIN_SUBMATCH_GUESSES_MULTI_CHAR;
+        if (m->guesses < min_guesses)
+          m->guesses = min_guesses;
+      }
+      if (m->guesses < 1.0)
+        m->guesses = 1.0;
+      dp_extend(&opt, order[x], m->i, k, m->guesses, false);
+    }
+
+    // bruteforce from every start position up to k, the power is only
+    // recomputed when an earlier start adds a character class
+    double bruteforce = 1.0;
+    unsigned classes = 0;
+    double cardinality = 0.0;
+    for (int i = k; i >= 0; i--) {
+      classes |= char_class(password[i]);
+      if (class_cardinality(classes) != cardinality) {
+        cardinality = class_cardinality(classes);
+        bruteforce = pow(cardinality, k - i + 1);
+      } else {
+        bruteforce *= cardinality;
+      }
+      double min_guesses = i == k ? MIN_SUBMATCH_GUESSES_SINGLE_CHAR + 1
+                                  : MIN_SUBMATCH_GUESSES_MULTI_CHAR + 1;
+      dp_extend(&opt, BRUTEFORCE_FROM(i), i, k,
+                bruteforce > min_guesses ? bruteforce : min_guesses, true);
+    }
+  }
+
+  // pick the sequence length with the fewest guesses at the end
+  int k = n - 1;
+  int best_l = 1;
+  for (int l = 1; l <= opt.max_l[k]; l++) {
+    if (opt.m[k][l] != NO_MATCH &&
+        (opt.m[k][best_l] == NO_MATCH || opt.g[k][l] < opt.g[k][best_l]))
+      best_l = l;
+  }
+  double guesses = opt.g[k][best_l];
+
+  if (estimate) {
+    int l = best_l;
+    estimate->sequence_length = l;
+    while (k >= 0 && l > 0) {
+      int encoded = opt.m[k][l];
+      match_t *out = &estimate->sequence[l - 1];
+      if (encoded >= 0) {
+        *out = matches[encoded];
+      } else {
+        memset(out, 0, sizeof(*out));
+        out->pattern = MATCH_BRUTEFORCE;
+        out->i = -(encoded + 2);
+        out->j = k;
+        out->guesses = bruteforce_guesses(password + out->i, k - out->i + 1);
+      }
+      k = out->i - 1;
+      l--;
+    }
+  }
+  return guesses;
+}
+
+guess_estimate_t estimate_guesses(const char *password) {
+  guess_estimate_t estimate = {0};
+  estimate.guesses = 1.0;
+
+  if (!password || password[0] == '\0')
+    return estimate;
+
+  int length = (int)strlen(password);
+  int n = length > ESTIMATE_MAX_LENGTH ? ESTIMATE_MAX_LENGTH : length;
+
+  estimate.guesses = most_guessable(password, n, 0, &estimate);
+  estimate.guesses_log10 = log10(estimate.guesses);
+
+  // whatever didn't fit is treated as random
+  if (length > n) {
+    double cardinality = token_cardinality(password + n, length - n);
+    estimate.guesses_log10 += (length - n) * log10(cardinality);
+    double tail = pow(cardinality, length - n);
+    estimate.guesses = estimate.guesses < DBL_MAX / tail
+                           ? estimate.guesses * tail
+                           : DBL_MAX;
+  }
+  return estimate;
+}
+
+const char *match_pattern_to_string(match_pattern_t pattern) {
+  switch (pattern) {
+  case MATCH_BRUTEFORCE:
+    return "bruteforce";
+  case MATCH_DICTIONARY:
+    return "dictionary";
+  case MATCH_KEYBOARD:
+    return "keyboard";
+  case MATCH_SEQUENCE:
+    return "sequence";
+  case MATCH_REPEAT:
+    return "repeat";
+  case MATCH_DATE:
+    return "date";
+  default:
+    return "unknown";
+  }
+}
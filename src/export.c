@@ -18,6 +18,7 @@ int export_analysis_stdout(const password_strength_t *result,
     printf("  \"crack_time_seconds\": %.2f,\n", result->crack_time_seconds);
     printf("  \"crack_time\": \"%s\",\n",
            format_crack_time(result->crack_time_seconds));
+    printf("  \"guesses_log10\": %.2f,\n", result->guesses_log10);
     printf("  \"score\": %d,\n", result->strength_score);
     printf("  \"rating\": \"%s\",\n", level_to_string(result->level));
     printf("  \"has_lowercase\": %s,\n", result->has_lower ? "true" : "false");
@@ -28,12 +29,17 @@ int export_analysis_stdout(const password_strength_t *result,
            result->has_sequential_pattern ? "true" : "false");
     printf("  \"has_keyboard_pattern\": %s,\n",
            result->has_keyboard_pattern ? "true" : "false");
+    printf("  \"keyboard_walk_length\": %d,\n", result->keyboard_walk_length);
     printf("  \"has_repeated_chars\": %s,\n",
            result->has_repeated_chars ? "true" : "false");
     printf("  \"has_repeated_pattern\": %s,\n",
            result->has_repeated_pattern ? "true" : "false");
     printf("  \"contains_dictionary_word\": %s,\n",
            result->contains_dictionary_word ? "true" : "false");
+    if (result->common_distance >= 0)
+      printf("  \"nearest_common_password\": \"%s\",\n",
+             result->nearest_common);
+    printf("  \"common_distance\": %d,\n", result->common_distance);
     printf("  \"pattern_penalty\": %d\n", result->pattern_penalty);
     printf("}\n");
     break;
@@ -70,6 +76,91 @@ int export_analysis_stdout(const password_strength_t *result,
   return 0;
 }
 
+// where the next part of a snprintf-like output goes and how much room is
+// left for it, nothing once the buffer is full
+static char *json_tail(char *buffer, size_t size, size_t used) {
+  return used < size ? buffer + used : NULL;
+}
+
+static size_t json_room(size_t size, size_t used) {
+  return used < size ? size - used : 0;
+}
+
+// append part to buffer at used, snprintf-like
+static size_t json_put(char *buffer, size_t size, size_t used,
+                       const char *part) {
+  for (; *part; part++, used++)
+    if (used + 1 < size)
+      buffer[used] = *part;
+  return used;
+}
+
+size_t export_json_string(const char *text, char *buffer, size_t size) {
+  size_t used = json_put(buffer, size, 0, "\"");
+  for (const char *p = text ? text : ""; *p; p++) {
+    char part[8];
+    if (*p == '"' || *p == '\\') {
+      snprintf(part, sizeof(part), "\\%c", *p);
+    } else if ((unsigned char)*p < 0x20) {
+      snprintf(part, sizeof(part), "\\u%04x", (unsigned)(unsigned char)*p);
+    } else {
+      part[0] = *p;
+      part[1] = '\0';
+    }
+    used = json_put(buffer, size, used, part);
+  }
+  used = json_put(buffer, size, used, "\"");
+  if (size > 0)
+    buffer[used < size ? used : size - 1] = '\0';
+  return used;
+}
+
+size_t export_analysis_json(const password_strength_t *result, char *buffer,
+                            size_t size) {
+  if (!result)
+    return 0;
+
+  size_t used = (size_t)snprintf(
+      buffer, size,
+      "{\"length\":%d,\"entropy\":%.2f,\"crack_time_seconds\":%.2f,"
+      "\"crack_time\":\"%s\",\"guesses_log10\":%.2f,\"score\":%d,"
+      "\"rating\":\"%s\",\"has_lowercase\":%s,\"has_uppercase\":%s,"
+      "\"has_digits\":%s,\"has_symbols\":%s,",
+      result->length, result->entropy, result->crack_time_seconds,
+      format_crack_time(result->crack_time_seconds), result->guesses_log10,
+      result->strength_score, level_to_string(result->level),
+      result->has_lower ? "true" : "false",
+      result->has_upper ? "true" : "false",
+      result->has_digit ? "true" : "false",
+      result->has_symbol ? "true" : "false");
+  used += (size_t)snprintf(
+      json_tail(buffer, size, used), json_room(size, used),
+      "\"has_sequential_pattern\":%s,\"has_keyboard_pattern\":%s,"
+      "\"keyboard_walk_length\":%d,\"has_repeated_chars\":%s,"
+      "\"has_repeated_pattern\":%s,\"contains_dictionary_word\":%s,",
+      result->has_sequential_pattern ? "true" : "false",
+      result->has_keyboard_pattern ? "true" : "false",
+      result->keyboard_walk_length,
+      result->has_repeated_chars ? "true" : "false",
+      result->has_repeated_pattern ? "true" : "false",
+      result->contains_dictionary_word ? "true" : "false");
+  if (result->common_distance >= 0) {
+    used += (size_t)snprintf(json_tail(buffer, size, used),
+                             json_room(size, used),
+                             "\"nearest_common_password\":");
+    used += export_json_string(result->nearest_common,
+                               json_tail(buffer, size, used),
+                               json_room(size, used));
+    used += (size_t)snprintf(json_tail(buffer, size, used),
+                             json_room(size, used), ",");
+  }
+  used += (size_t)snprintf(json_tail(buffer, size, used),
+                           json_room(size, used),
+                           "\"common_distance\":%d,\"pattern_penalty\":%d}",
+                           result->common_distance, result->pattern_penalty);
+  return used;
+}
+
 int export_analysis(const password_strength_t *result, const char *password,
                     const char *filename, export_format_t format) {
   if (!result || !password || !filename)
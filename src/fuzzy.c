@@ -0,0 +1,255 @@
+#include "clovo/fuzzy.h"
+#include "clovo/charclass.h"
+#include "clovo/comparison.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// longest query that can still be within FUZZY_MAX_DISTANCE of an entry
+#define MAX_QUERY (FUZZY_MAX_LENGTH + FUZZY_MAX_DISTANCE)
+// the string itself, its single and its double deletions
+#define MAX_KEYS (1 + MAX_QUERY + MAX_QUERY * (MAX_QUERY - 1) / 2)
+// candidate ids remembered per query so repeats aren't verified again
+#define SEEN_IDS 64
+
+#define HASH_BASE 0x100000001b3ULL
+// an entry id leaves the rest of a 32-bit slot to the key tag, keep at
+// least 8 bits of it
+#define MAX_ID_BITS 24
+
+// the keys live in one array grouped by bucket (the top bits of the key
+// hash); a 32-bit slot holds the entry id in its low id_bits and low bits
+// of the hash as a tag above it.
+// entries come from the list file and queries never insert, so nothing a
+// user types can lengthen a bucket
+struct fuzzy_index {
+  const char *const *entries;
+  unsigned char *lengths; // 0 = not indexed
+  size_t count;
+  uint32_t *offsets; // bucket b is slots[offsets[b] .. offsets[b + 1])
+  uint32_t *slots;
+  int shift;
+  int id_bits;
+};
+
+static uint32_t slot_tag(const fuzzy_index_t *index, uint64_t key) {
+  return (uint32_t)key << index->id_bits;
+}
+
+static uint64_t mix64(uint64_t x) {
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+static uint64_t finish_key(uint64_t h, size_t len) {
+  return mix64(h ^ (uint64_t)len << 56);
+}
+
+// key of s and of every string left after deleting up to depth characters
+// of it. the strings are polynomial hashes built from prefix hashes, so
+// each deletion costs a few multiplies however long s is. deleting the
+// first or second of two equal neighbours gives the same string, only the
+// first is kept
+static size_t deletion_keys(const unsigned char *s, size_t len, int depth,
+                            uint64_t *keys) {
+  uint64_t prefix[MAX_QUERY + 1], power[MAX_QUERY + 1];
+  prefix[0] = 0;
+  power[0] = 1;
+  for (size_t i = 0; i < len; i++) {
+    prefix[i + 1] = prefix[i] * HASH_BASE + s[i];
+    power[i + 1] = power[i] * HASH_BASE;
+  }
+// hash of s[a..b) on its own
+#define SPAN(a, b) (prefix[b] - prefix[a] * power[(b) - (a)])
+
+  size_t n = 0;
+  keys[n++] = finish_key(prefix[len], len);
+  if (depth < 1 || len < 1)
+    return n;
+
+  for (size_t i = 0; i < len; i++) {
+    if (i > 0 && s[i] == s[i - 1])
+      continue;
+    uint64_t h = prefix[i] * power[len - 1 - i] + SPAN(i + 1, len);
+    keys[n++] = finish_key(h, len - 1);
+  }
+  if (depth < 2 || len < 2)
+    return n;
+
+  for (size_t i = 0; i < len; i++) {
+    if (i > 0 && s[i] == s[i - 1])
+      continue;
+    for (size_t j = i + 1; j < len; j++) {
+      if (j > i + 1 && s[j] == s[j - 1])
+        continue;
+      uint64_t h = prefix[i] * power[len - 2 - i] +
+                   SPAN(i + 1, j) * power[len - 1 - j] + SPAN(j + 1, len);
+      keys[n++] = finish_key(h, len - 2);
+    }
+  }
+#undef SPAN
+  return n;
+}
+
+// case-folded copy of entry i, false if it isn't indexed
+static bool folded_entry(const fuzzy_index_t *index, size_t i,
+                         unsigned char *out, size_t *len) {
+  *len = index->lengths[i];
+  if (*len == 0)
+    return false;
+  char_fold_copy((char *)out, index->entries[i], (int)*len);
+  return true;
+}
+
+fuzzy_index_t *fuzzy_index_build(const char *const *entries, size_t count) {
+  if (!entries && count > 0)
+    return NULL;
+
+  fuzzy_index_t *index = calloc(1, sizeof(*index));
+  if (!index)
+    return NULL;
+  index->entries = entries;
+  index->count = count;
+  index->lengths = calloc(count ? count : 1, 1);
+
+  // bound the key count from the lengths to size the buckets
+  size_t bound = 0;
+  for (size_t i = 0; index->lengths && i < count; i++) {
+    size_t len = entries[i] ? strlen(entries[i]) : 0;
+    if (len == 0 || len > FUZZY_MAX_LENGTH)
+      continue;
+    index->lengths[i] = (unsigned char)len;
+    bound += 1 + len + len * (len - 1) / 2;
+  }
+
+  // about sixteen keys per bucket: a bucket is one cache line of slots,
+  // and the fill pointers below stay in cache while placing
+  size_t buckets = 16;
+  int bits = 4;
+  while (buckets < bound / 16) {
+    buckets <<= 1;
+    bits++;
+  }
+  index->shift = 64 - bits;
+  index->id_bits = 1;
+  while (index->id_bits < 32 && ((size_t)1 << index->id_bits) < count)
+    index->id_bits++;
+  index->offsets = calloc(buckets + 1, sizeof(*index->offsets));
+  if (!index->lengths || !index->offsets || index->id_bits > MAX_ID_BITS ||
+      bound > UINT32_MAX) {
+    fuzzy_index_free(index);
+    return NULL;
+  }
+
+  // count per bucket, turn the counts into starts, then place. the keys
+  // are generated twice rather than kept, they are cheap to recompute
+  uint64_t keys[MAX_KEYS];
+  unsigned char folded[FUZZY_MAX_LENGTH];
+  size_t len, total = 0;
+  for (size_t i = 0; i < count; i++) {
+    if (!folded_entry(index, i, folded, &len))
+      continue;
+    size_t n = deletion_keys(folded, len, FUZZY_MAX_DISTANCE, keys);
+    for (size_t k = 0; k < n; k++)
+      index->offsets[(keys[k] >> index->shift) + 1]++;
+    total += n;
+  }
+  for (size_t b = 0; b < buckets; b++)
+    index->offsets[b + 1] += index->offsets[b];
+
+  index->slots = malloc((total ? total : 1) * sizeof(*index->slots));
+  uint32_t *fill = malloc(buckets * sizeof(*fill));
+  if (!index->slots || !fill) {
+    free(fill);
+    fuzzy_index_free(index);
+    return NULL;
+  }
+  memcpy(fill, index->offsets, buckets * sizeof(*fill));
+
+  for (size_t i = 0; i < count; i++) {
+    if (!folded_entry(index, i, folded, &len))
+      continue;
+    size_t n = deletion_keys(folded, len, FUZZY_MAX_DISTANCE, keys);
+    for (size_t k = 0; k < n; k++)
+      index->slots[fill[keys[k] >> index->shift]++] =
+          slot_tag(index, keys[k]) | (uint32_t)i;
+  }
+  free(fill);
+  return index;
+}
+
+void fuzzy_index_free(fuzzy_index_t *index) {
+  if (!index)
+    return;
+  free(index->lengths);
+  free(index->offsets);
+  free(index->slots);
+  free(index);
+}
+
+int fuzzy_index_nearest(const fuzzy_index_t *index, const char *s, size_t len,
+                        int max_distance, size_t *entry) {
+  if (!index || !s || max_distance < 0)
+    return -1;
+  if (max_distance > FUZZY_MAX_DISTANCE)
+    max_distance = FUZZY_MAX_DISTANCE;
+  if (len == 0 || len > FUZZY_MAX_LENGTH + (size_t)max_distance)
+    return -1;
+
+  char query[MAX_QUERY + 1];
+  char_fold_copy(query, s, (int)len);
+  query[len] = '\0';
+
+  uint64_t keys[MAX_KEYS];
+  size_t n = deletion_keys((const unsigned char *)query, len, max_distance,
+                           keys);
+
+  int best = -1;
+  size_t best_id = 0;
+  uint32_t seen[SEEN_IDS];
+  size_t seen_count = 0;
+  char candidate[FUZZY_MAX_LENGTH + 1];
+
+  for (size_t k = 0; k < n && best != 0; k++) {
+    uint64_t bucket = keys[k] >> index->shift;
+    uint32_t tag = slot_tag(index, keys[k]);
+    uint32_t id_mask = ~(uint32_t)0 >> (32 - index->id_bits);
+    for (uint32_t p = index->offsets[bucket]; p < index->offsets[bucket + 1];
+         p++) {
+      if ((index->slots[p] & ~id_mask) != tag)
+        continue;
+      uint32_t id = index->slots[p] & id_mask;
+      bool repeat = false;
+      for (size_t q = 0; q < seen_count && !repeat; q++)
+        repeat = seen[q] == id;
+      if (repeat)
+        continue;
+      if (seen_count < SEEN_IDS)
+        seen[seen_count++] = id;
+
+      size_t candidate_len;
+      folded_entry(index, id, (unsigned char *)candidate, &candidate_len);
+      size_t gap = candidate_len > len ? candidate_len - len
+                                       : len - candidate_len;
+      if (gap > (size_t)max_distance)
+        continue;
+      candidate[candidate_len] = '\0';
+      int d = edit_distance(query, candidate);
+      if (d < 0 || d > max_distance)
+        continue;
+      if (best < 0 || d < best || (d == best && id < best_id)) {
+        best = d;
+        best_id = id;
+      }
+    }
+  }
+
+  if (best >= 0 && entry)
+    *entry = best_id;
+  return best;
+}
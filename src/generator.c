@@ -1,9 +1,15 @@
 #define _GNU_SOURCE
 
 #include "clovo/generator.h"
+#include "clovo/analyzer.h"
+#include "clovo/charclass.h"
+#include "clovo/charset.h"
+#include "clovo/drbg.h"
+#include "clovo/fuzzy.h"
+#include "clovo/sampler.h"
 
-#include <ctype.h>
 #include <errno.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -29,6 +35,119 @@ static const char DIGITS[] = "0123456789";
 static char **common_passwords_list = NULL;
 static size_t common_passwords_count = 0;
 
+// always-available fallback when the external list is missing
+static const char *minimal_common[] = {
+    "111111",     "123123",    "12345", "123456",   "12345678", "123456789",
+    "1234567890", "abc123",    "admin", "football", "letmein",  "monkey",
+    "password",   "password1", "qwert", "qwerty",   "welcome",  NULL};
+
+// open-addressing hash index over common_passwords_list. a slot holds the
+// entry hash and list index + 1 (0 = empty). the list is ordered by
+// frequency so the index doubles as the rank used by the guess estimator
+typedef struct {
+  unsigned int hash;
+  unsigned int index;
+} common_slot_t;
+
+static common_slot_t *common_passwords_index = NULL;
+static size_t common_passwords_index_mask = 0;
+
+// one bit per hashed prefix of every entry, lets substring scans stop as
+// soon as no listed password starts with what has been read so far
+static unsigned char *common_prefix_filter = NULL;
+#define PREFIX_FILTER_BITS (1u << 23)
+
+// near matches: the loaded list's deletion index, built with the hash
+// index, or one over the built-in list made on first use
+static fuzzy_index_t *common_fuzzy_index = NULL;
+static fuzzy_index_t *minimal_fuzzy_index = NULL;
+static pthread_once_t minimal_fuzzy_once = PTHREAD_ONCE_INIT;
+
+#define FNV_OFFSET 2166136261u
+#define FNV_PRIME 16777619u
+
+static unsigned int hash_step(unsigned int h, char c) {
+  return (h ^ (unsigned char)c) * FNV_PRIME;
+}
+
+static unsigned int hash_bytes(const char *s, size_t len) {
+  unsigned int h = FNV_OFFSET; // fnv-1a
+  for (size_t i = 0; i < len; i++)
+    h = hash_step(h, s[i]);
+  return h;
+}
+
+static bool prefix_filter_test(unsigned int h) {
+  unsigned int bit = h & (PREFIX_FILTER_BITS - 1);
+  return common_prefix_filter[bit >> 3] & (1u << (bit & 7));
+}
+
+static void index_common_entry(size_t i) {
+  const char *entry = common_passwords_list[i];
+  unsigned int h = FNV_OFFSET;
+  for (size_t k = 0; entry[k]; k++) {
+    h = hash_step(h, entry[k]);
+    unsigned int bit = h & (PREFIX_FILTER_BITS - 1);
+    common_prefix_filter[bit >> 3] |= (unsigned char)(1u << (bit & 7));
+  }
+
+  size_t slot = h & common_passwords_index_mask;
+  while (common_passwords_index[slot].index != 0) {
+    // keep the first (most common) occurrence of duplicates
+    const char *other =
+        common_passwords_list[common_passwords_index[slot].index - 1];
+    if (common_passwords_index[slot].hash == h && strcmp(other, entry) == 0)
+      return;
+    slot = (slot + 1) & common_passwords_index_mask;
+  }
+  common_passwords_index[slot].hash = h;
+  common_passwords_index[slot].index = (unsigned int)(i + 1);
+}
+
+static void build_common_index(void) {
+  size_t slots = 1;
+  while (slots < common_passwords_count * 2)
+    slots <<= 1;
+
+  common_passwords_index = calloc(slots, sizeof(common_slot_t));
+  common_prefix_filter = calloc(PREFIX_FILTER_BITS / 8, 1);
+  if (!common_passwords_index || !common_prefix_filter) {
+    // lookups fall back to the minimal list
+    free(common_passwords_index);
+    free(common_prefix_filter);
+    common_passwords_index = NULL;
+    common_prefix_filter = NULL;
+    return;
+  }
+  common_passwords_index_mask = slots - 1;
+
+  for (size_t i = 0; i < common_passwords_count; i++)
+    index_common_entry(i);
+
+  // without it nearest_common_password() only sees the built-in list
+  common_fuzzy_index = fuzzy_index_build(
+      (const char *const *)common_passwords_list, common_passwords_count);
+}
+
+static void build_minimal_fuzzy_index(void) {
+  minimal_fuzzy_index = fuzzy_index_build(
+      minimal_common, sizeof(minimal_common) / sizeof(minimal_common[0]) - 1);
+}
+
+static size_t lookup_common_index(const char *s, size_t len, unsigned int h) {
+  size_t slot = h & common_passwords_index_mask;
+  while (common_passwords_index[slot].index != 0) {
+    if (common_passwords_index[slot].hash == h) {
+      const char *entry =
+          common_passwords_list[common_passwords_index[slot].index - 1];
+      if (strncmp(entry, s, len) == 0 && entry[len] == '\0')
+        return common_passwords_index[slot].index;
+    }
+    slot = (slot + 1) & common_passwords_index_mask;
+  }
+  return 0;
+}
+
 // get random bytes from system, different methods for different platforms
 static int get_random_bytes(unsigned char *buffer, size_t size) {
 #ifdef _WIN32
@@ -74,6 +193,27 @@ static int get_random_bytes(unsigned char *buffer, size_t size) {
 #endif
 }
 
+void secure_wipe(void *buffer, size_t size) {
+#if defined(__GNUC__) || defined(__clang__)
+  // the empty asm claims to read the buffer, so the memset can't be dropped
+  // as a dead store but still gets the vectorized implementation
+  memset(buffer, 0, size);
+  __asm__ __volatile__("" : : "r"(buffer) : "memory");
+#else
+  // volatile stores can't be dropped as dead by the optimizer
+  volatile unsigned char *p = buffer;
+  while (size--)
+    *p++ = 0;
+#endif
+}
+
+generator_error_t secure_random_bytes(unsigned char *buffer, size_t size) {
+  if (!buffer)
+    return GEN_ERROR_NULL_POINTER;
+  return get_random_bytes(buffer, size) == 0 ? GEN_SUCCESS
+                                             : GEN_ERROR_RANDOM_FAILED;
+}
+
 // load common passwords from file into memory
 generator_error_t load_common_passwords(const char *filepath) {
   FILE *file = fopen(filepath, "r");
@@ -94,7 +234,8 @@ generator_error_t load_common_passwords(const char *filepath) {
     return GEN_ERROR_FILE_ACCESS;
   }
 
-  common_passwords_list = malloc(count * sizeof(char *));
+  size_t minimal_count = sizeof(minimal_common) / sizeof(minimal_common[0]) - 1;
+  common_passwords_list = malloc((count + minimal_count) * sizeof(char *));
   if (!common_passwords_list) {
     fclose(file);
     fprintf(stderr, "Memory allocation failed for common passwords.\n");
@@ -118,14 +259,31 @@ generator_error_t load_common_passwords(const char *filepath) {
     }
   }
 
+  // the minimal list goes after the loaded entries so a single index lookup
+  // covers both, entries already in the file are skipped by the index
+  for (size_t i = 0; i < minimal_count; i++) {
+    char *dup = strdup(minimal_common[i]);
+    if (dup)
+      common_passwords_list[index++] = dup;
+  }
+
   common_passwords_count = index;
   fclose(file);
+  build_common_index();
   // loaded silently, no need to spam the user
   return GEN_SUCCESS;
 }
 
 // free the common passwords list from memory
 void free_common_passwords(void) {
+  fuzzy_index_free(common_fuzzy_index);
+  common_fuzzy_index = NULL;
+  free(common_passwords_index);
+  free(common_prefix_filter);
+  common_passwords_index = NULL;
+  common_prefix_filter = NULL;
+  common_passwords_index_mask = 0;
+
   if (common_passwords_list) {
     for (size_t i = 0; i < common_passwords_count; i++)
       free(common_passwords_list[i]);
@@ -160,7 +318,50 @@ generator_error_t init_generator(const char *data_dir) {
   return GEN_SUCCESS;
 }
 
-void cleanup_generator(void) { free_common_passwords(); }
+void cleanup_generator(void) {
+  free_common_passwords();
+  drbg_clear();
+}
+
+// one kernel per combination of the four include_* options, built once
+#define CLASS_LOWER 1u
+#define CLASS_UPPER 2u
+#define CLASS_DIGITS 4u
+#define CLASS_SYMBOLS 8u
+
+static charset_kernel_t class_kernels[16];
+static pthread_once_t class_kernels_once = PTHREAD_ONCE_INIT;
+
+static void init_class_kernels(void) {
+  for (unsigned mask = 1; mask < 16; mask++) {
+    char charset[128] = "";
+    if (mask & CLASS_LOWER)
+      strcat(charset, LOWERCASE);
+    if (mask & CLASS_UPPER)
+      strcat(charset, UPPERCASE);
+    if (mask & CLASS_DIGITS)
+      strcat(charset, DIGITS);
+    if (mask & CLASS_SYMBOLS)
+      strcat(charset, SYMBOLS);
+    charset_kernel_init(&class_kernels[mask], charset);
+  }
+}
+
+// NULL for the empty mask
+static const charset_kernel_t *class_kernel(unsigned mask) {
+  if (mask == 0)
+    return NULL;
+  pthread_once(&class_kernels_once, init_class_kernels);
+  return &class_kernels[mask];
+}
+
+// NULL when opts includes no class
+static const charset_kernel_t *options_kernel(const generator_options_t *opts) {
+  return class_kernel((opts->include_lowercase ? CLASS_LOWER : 0) |
+                      (opts->include_uppercase ? CLASS_UPPER : 0) |
+                      (opts->include_digits ? CLASS_DIGITS : 0) |
+                      (opts->include_symbols ? CLASS_SYMBOLS : 0));
+}
 
 // main password generation logic
 generator_error_t generate_password(char *buffer, size_t buffer_size,
@@ -182,16 +383,8 @@ generator_error_t generate_password(char *buffer, size_t buffer_size,
   if (length > 256)
     return GEN_ERROR_INVALID_LENGTH;
 
-  char charset[256] = "";
-  if (opts->include_lowercase)
-    strcat(charset, LOWERCASE);
-  if (opts->include_uppercase)
-    strcat(charset, UPPERCASE);
-  if (opts->include_digits)
-    strcat(charset, DIGITS);
-  if (opts->include_symbols)
-    strcat(charset, SYMBOLS);
-  if (charset[0] == '\0')
+  const charset_kernel_t *kernel = options_kernel(opts);
+  if (!kernel)
     return GEN_ERROR_NO_CHARSET;
 
   generator_error_t status = GEN_SUCCESS;
@@ -203,26 +396,11 @@ generator_error_t generate_password(char *buffer, size_t buffer_size,
       return GEN_ERROR_COMMON_PASSWORD;
     attempts++;
 
-    unsigned char *random_bytes = malloc(length);
-    if (!random_bytes)
-      return GEN_ERROR_NULL_POINTER;
-
-    size_t charset_len = strlen(charset);
-    size_t max_acceptable = 256 - (256 % charset_len);
-
-    for (size_t i = 0; i < length; i++) {
-      unsigned char random_val;
-      do {
-        if (get_random_bytes(&random_val, 1) != 0) {
-          free(random_bytes);
-          return GEN_ERROR_RANDOM_FAILED;
-        }
-      } while (random_val >= max_acceptable);
-
-      buffer[i] = charset[random_val % charset_len];
+    if (charset_fill(kernel, buffer, length) != GEN_SUCCESS) {
+      secure_wipe(buffer, length);
+      return GEN_ERROR_RANDOM_FAILED;
     }
     buffer[length] = '\0';
-    free(random_bytes);
 
     if (opts->check_common && is_common_password(buffer)) {
       status = GEN_ERROR_COMMON_PASSWORD;
@@ -236,6 +414,128 @@ generator_error_t generate_password(char *buffer, size_t buffer_size,
   return status;
 }
 
+// candidates are only redrawn for rare pattern matches, running out means
+// the policy can't be met with this charset and length
+#define MAX_POLICY_ATTEMPTS 100
+
+// entropy the analyzer would compute for a length-character password using
+// the classes found in chars, without analyzing it
+static double candidate_entropy(const char *chars, size_t length) {
+  password_strength_t ps = {0};
+  ps.length = (int)length;
+  for (size_t i = 0; chars[i]; i++) {
+    unsigned cls = char_class(chars[i]);
+    ps.has_lower |= (cls & CHAR_LOWER) != 0;
+    ps.has_upper |= (cls & CHAR_UPPER) != 0;
+    ps.has_digit |= (cls & CHAR_DIGIT) != 0;
+    ps.has_symbol |= (cls & CHAR_SYMBOL) != 0;
+  }
+  calculate_entropy(&ps);
+  return ps.entropy;
+}
+
+generator_error_t generate_password_for_policy(char *buffer,
+                                               size_t buffer_size,
+                                               size_t length,
+                                               const password_policy_t *policy,
+                                               const generator_options_t *opts,
+                                               int *attempts) {
+  if (attempts)
+    *attempts = 0;
+  if (!buffer || !policy)
+    return GEN_ERROR_NULL_POINTER;
+  if (buffer_size < length + 1)
+    return GEN_ERROR_BUFFER_TOO_SMALL;
+
+  generator_options_t default_opts;
+  if (!opts) {
+    init_generator_options(&default_opts);
+    opts = &default_opts;
+  }
+
+  if (length == 0 || length > 256 ||
+      (policy->min_length > 0 && length < (size_t)policy->min_length) ||
+      (policy->max_length > 0 && length > (size_t)policy->max_length))
+    return GEN_ERROR_INVALID_LENGTH;
+
+  const unsigned classes[4] = {CLASS_LOWER, CLASS_UPPER, CLASS_DIGITS,
+                               CLASS_SYMBOLS};
+  bool include[4] = {opts->include_lowercase, opts->include_uppercase,
+                     opts->include_digits, opts->include_symbols};
+  bool required[4] = {policy->require_lowercase, policy->require_uppercase,
+                      policy->require_digits, policy->require_symbols};
+
+  unsigned mask = 0;
+  size_t required_count = 0;
+  for (int c = 0; c < 4; c++) {
+    if (include[c] || required[c])
+      mask |= classes[c];
+    required_count += required[c];
+  }
+  const charset_kernel_t *kernel = class_kernel(mask);
+  if (!kernel)
+    return GEN_ERROR_NO_CHARSET;
+  if (required_count > length)
+    return GEN_ERROR_INVALID_LENGTH;
+
+  // the analyzer's entropy only depends on length and the classes present,
+  // so a policy it can't meet even with every class is rejected up front
+  if (policy->min_entropy > 0 &&
+      candidate_entropy(kernel->chars, length) < policy->min_entropy)
+    return GEN_ERROR_INVALID_LENGTH;
+
+  generator_error_t status = GEN_ERROR_POLICY_UNSATISFIED;
+
+  for (int attempt = 1; attempt <= MAX_POLICY_ATTEMPTS; attempt++) {
+    if (attempts)
+      *attempts = attempt;
+
+    // required classes first, then the fill, then shuffle them together so
+    // the required characters land on uniformly random positions
+    size_t pos = 0;
+    for (int c = 0; c < 4; c++) {
+      if (!required[c])
+        continue;
+      if (charset_fill(class_kernel(classes[c]), buffer + pos++, 1) !=
+          GEN_SUCCESS) {
+        status = GEN_ERROR_RANDOM_FAILED;
+        break;
+      }
+    }
+    if (status == GEN_ERROR_RANDOM_FAILED ||
+        charset_fill(kernel, buffer + pos, length - pos) != GEN_SUCCESS) {
+      status = GEN_ERROR_RANDOM_FAILED;
+      break;
+    }
+    buffer[length] = '\0';
+    if (random_shuffle(buffer, length) != GEN_SUCCESS) {
+      status = GEN_ERROR_RANDOM_FAILED;
+      break;
+    }
+
+    if (!policy->allow_sequential_patterns &&
+        has_sequential(buffer, (int)length))
+      continue;
+    if (!policy->allow_repeated_chars &&
+        has_repeated_chars(buffer, (int)length))
+      continue;
+    if (!policy->allow_common_passwords && contains_dictionary_word(buffer))
+      continue;
+    if (opts->check_common && is_common_password(buffer))
+      continue;
+    if (policy->min_entropy > 0 &&
+        candidate_entropy(buffer, length) < policy->min_entropy)
+      continue;
+
+    status = GEN_SUCCESS;
+    break;
+  }
+
+  if (status != GEN_SUCCESS)
+    secure_wipe(buffer, length + 1);
+  return status;
+}
+
 // check if password is in the common passwords list
 bool is_common_password(const char *ps) {
   if (!ps)
@@ -246,24 +546,91 @@ bool is_common_password(const char *ps) {
   if (len >= sizeof(lower_ps))
     len = sizeof(lower_ps) - 1;
 
-  for (size_t i = 0; i < len; i++)
-    lower_ps[i] = (char)tolower((unsigned char)ps[i]);
+  char_fold_copy(lower_ps, ps, (int)len);
   lower_ps[len] = '\0';
 
-  for (size_t i = 0; i < common_passwords_count; i++)
-    if (strcmp(lower_ps, common_passwords_list[i]) == 0)
-      return true;
+  return common_password_rank(lower_ps, len) != 0;
+}
+
+// look up a (len-bounded) string in the loaded list (which has the built-in
+// minimal list appended) or, when nothing is loaded, in the minimal list.
+// returns its 1-based rank or 0 when it isn't there
+size_t common_password_rank(const char *s, size_t len) {
+  if (!s)
+    return 0;
+
+  if (common_passwords_index)
+    return lookup_common_index(s, len, hash_bytes(s, len));
+
+  for (size_t i = 0; minimal_common[i]; i++)
+    if (strncmp(minimal_common[i], s, len) == 0 &&
+        minimal_common[i][len] == '\0')
+      return i + 1;
+
+  return 0;
+}
+
+// nearest entry within max_distance edits, ignoring case. the deletion
+// index only has the built-in list when no file is loaded
+int nearest_common_password(const char *ps, int max_distance,
+                            const char **nearest) {
+  if (!ps)
+    return -1;
+
+  size_t entry;
+  int distance;
+  if (common_fuzzy_index) {
+    distance = fuzzy_index_nearest(common_fuzzy_index, ps, strlen(ps),
+                                   max_distance, &entry);
+    if (distance >= 0 && nearest)
+      *nearest = common_passwords_list[entry];
+    return distance;
+  }
+
+  pthread_once(&minimal_fuzzy_once, build_minimal_fuzzy_index);
+  distance = fuzzy_index_nearest(minimal_fuzzy_index, ps, strlen(ps),
+                                 max_distance, &entry);
+  if (distance >= 0 && nearest)
+    *nearest = minimal_common[entry];
+  return distance;
+}
 
-  const char *minimal_common[] = {
-      "111111",     "123123",    "12345", "123456",   "12345678", "123456789",
-      "1234567890", "abc123",    "admin", "football", "letmein",  "monkey",
-      "password",   "password1", "qwert", "qwerty",   "welcome",  NULL};
+// entries of the list is_common_password() checks against
+size_t common_password_count(void) {
+  if (common_passwords_list)
+    return common_passwords_count;
+  return sizeof(minimal_common) / sizeof(minimal_common[0]) - 1;
+}
 
-  for (int i = 0; minimal_common[i]; i++)
-    if (strcmp(lower_ps, minimal_common[i]) == 0)
-      return true;
+const char *common_password_at(size_t index) {
+  if (index >= common_password_count())
+    return NULL;
+  return common_passwords_list ? common_passwords_list[index]
+                               : minimal_common[index];
+}
 
-  return false;
+// ranks of every prefix of s[0..max_len): ranks[k] gets the rank of
+// s[0..k] (0 if absent). stops early once no listed password starts with
+// the prefix read so far and returns how many prefixes were filled in
+size_t common_password_prefix_ranks(const char *s, size_t max_len,
+                                    size_t *ranks) {
+  if (!s || !ranks)
+    return 0;
+
+  if (!common_passwords_index) {
+    for (size_t k = 0; k < max_len; k++)
+      ranks[k] = common_password_rank(s, k + 1);
+    return max_len;
+  }
+
+  unsigned int h = FNV_OFFSET;
+  for (size_t k = 0; k < max_len; k++) {
+    h = hash_step(h, s[k]);
+    if (!prefix_filter_test(h))
+      return k;
+    ranks[k] = lookup_common_index(s, k + 1, h);
+  }
+  return max_len;
 }
 
 // convert error code to readable string
@@ -285,84 +652,13 @@ const char *generator_error_string(generator_error_t error) {
     return "NULL pointer provided or memory allocation failed";
   case GEN_ERROR_FILE_ACCESS:
     return "Failed to read common password file";
+  case GEN_ERROR_NOT_UNIQUE:
+    return "Not enough distinct passwords of this length";
+  case GEN_ERROR_POLICY_UNSATISFIED:
+    return "Could not satisfy the policy (max retries exceeded)";
+  case GEN_ERROR_INVALID_CONFIG:
+    return "Invalid policy configuration";
   default:
     return "Unknown error";
   }
 }
-
-// common word list for passphrase generation
-static const char *passphrase_words[] = {
-    "apple",    "banana",   "cherry",   "dragon",    "eagle",     "forest",
-    "garden",   "hammer",   "island",   "jungle",    "knight",    "lighthouse",
-    "mountain", "ocean",    "planet",   "quasar",    "river",     "sunset",
-    "tiger",    "universe", "valley",   "waterfall", "xylophone", "yacht",
-    "zebra",    "anchor",   "bridge",   "castle",    "diamond",   "elephant",
-    "falcon",   "galaxy",   "horizon",  "igloo",     "jaguar",    "kangaroo",
-    "leopard",  "mermaid",  "nebula",   "octopus",   "penguin",   "quill",
-    "rainbow",  "sapphire", "tornado",  "umbrella",  "volcano",   "whale",
-    "xenon",    "yogurt",   "zeppelin", NULL};
-
-// generate passphrase (multiple words)
-generator_error_t generate_passphrase(char *buffer, size_t buffer_size,
-                                      int word_count,
-                                      const generator_options_t *opts) {
-  if (!buffer)
-    return GEN_ERROR_NULL_POINTER;
-
-  if (word_count < 2 || word_count > 10) {
-    return GEN_ERROR_INVALID_LENGTH;
-  }
-
-  // count available words
-  int word_list_size = 0;
-  while (passphrase_words[word_list_size] != NULL) {
-    word_list_size++;
-  }
-
-  if (word_list_size == 0) {
-    return GEN_ERROR_NO_CHARSET;
-  }
-
-  // estimate max length needed
-  size_t max_length =
-      (word_count * 15) + word_count; // 15 chars per word + separators
-  if (buffer_size < max_length + 1) {
-    return GEN_ERROR_BUFFER_TOO_SMALL;
-  }
-
-  // get random bytes for word selection
-  unsigned char random_bytes[10];
-  if (get_random_bytes(random_bytes, word_count) != 0) {
-    return GEN_ERROR_RANDOM_FAILED;
-  }
-
-  buffer[0] = '\0';
-
-  for (int i = 0; i < word_count; i++) {
-    int word_index = random_bytes[i] % word_list_size;
-    const char *word = passphrase_words[word_index];
-
-    if (i > 0) {
-      strcat(buffer, "-");
-    }
-    strcat(buffer, word);
-  }
-
-  // check if generated passphrase is too common
-  if (opts && opts->check_common && is_common_password(buffer)) {
-    // try once more
-    buffer[0] = '\0';
-    if (get_random_bytes(random_bytes, word_count) != 0) {
-      return GEN_ERROR_RANDOM_FAILED;
-    }
-    for (int i = 0; i < word_count; i++) {
-      int word_index = random_bytes[i] % word_list_size;
-      const char *word = passphrase_words[word_index];
-      if (i > 0)
-        strcat(buffer, "-");
-      strcat(buffer, word);
-    }
-  }
-
-  return GEN_SUCCESS;
-}
\ No newline at end of file
@@ -0,0 +1,309 @@
+#define _GNU_SOURCE // memmem
+
+#include "clovo/http.h"
+#include "clovo/charclass.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+
+// header name against a lowercase name, ignoring case
+static bool header_is(const char *name, size_t len, const char *expected) {
+  return len == strlen(expected) && strncasecmp(name, expected, len) == 0;
+}
+
+// a comma-separated header value holds token, ignoring case
+static bool value_has(const char *value, size_t len, const char *token) {
+  size_t token_len = strlen(token);
+  for (size_t i = 0; i + token_len <= len; i++) {
+    if (strncasecmp(value + i, token, token_len) == 0 &&
+        (i == 0 || value[i - 1] == ' ' || value[i - 1] == ',') &&
+        (i + token_len == len || value[i + token_len] == ' ' ||
+         value[i + token_len] == ','))
+      return true;
+  }
+  return false;
+}
+
+http_parse_t http_parse_request(const char *data, size_t len,
+                                size_t max_request, http_request_t *request) {
+  size_t scan = len < max_request ? len : max_request;
+  const char *head_end = memmem(data, scan, "\r\n\r\n", 4);
+  if (!head_end)
+    return len >= max_request ? HTTP_TOO_LARGE : HTTP_INCOMPLETE;
+
+  // request line: method, target and version, one space apart
+  const char *line_end = memchr(data, '\r', (size_t)(head_end - data) + 1);
+  const char *method = data;
+  const char *target = memchr(method, ' ', (size_t)(line_end - method));
+  if (!target || target == method)
+    return HTTP_BAD_REQUEST;
+  target++;
+  const char *version = memchr(target, ' ', (size_t)(line_end - target));
+  if (!version || *target != '/')
+    return HTTP_BAD_REQUEST;
+  version++;
+  size_t version_len = (size_t)(line_end - version);
+  if (version_len != 8 || strncmp(version, "HTTP/1.", 7) != 0 ||
+      (version[7] != '0' && version[7] != '1'))
+    return HTTP_BAD_REQUEST;
+  bool keep_alive = version[7] == '1';
+
+  // headers, only the ones that frame the request or end the connection
+  uint64_t content_length = 0;
+  bool has_length = false;
+  for (const char *line = line_end + 2; line < head_end + 2;) {
+    const char *end = memchr(line, '\r', (size_t)(head_end + 2 - line));
+    const char *colon = memchr(line, ':', (size_t)(end - line));
+    if (!colon || colon == line)
+      return HTTP_BAD_REQUEST;
+    const char *value = colon + 1;
+    while (value < end && (*value == ' ' || *value == '\t'))
+      value++;
+    size_t value_len = (size_t)(end - value);
+    while (value_len > 0 &&
+           (value[value_len - 1] == ' ' || value[value_len - 1] == '\t'))
+      value_len--;
+
+    size_t name_len = (size_t)(colon - line);
+    if (header_is(line, name_len, "content-length")) {
+      uint64_t parsed = 0;
+      if (value_len == 0 || value_len > 9)
+        return value_len == 0 ? HTTP_BAD_REQUEST : HTTP_TOO_LARGE;
+      for (size_t i = 0; i < value_len; i++) {
+        if (!char_is_digit(value[i]))
+          return HTTP_BAD_REQUEST;
+        parsed = parsed * 10 + (uint64_t)(value[i] - '0');
+      }
+      // a second, different length could frame the request two ways
+      if (has_length && parsed != content_length)
+        return HTTP_BAD_REQUEST;
+      content_length = parsed;
+      has_length = true;
+    } else if (header_is(line, name_len, "transfer-encoding")) {
+      return HTTP_BAD_REQUEST;
+    } else if (header_is(line, name_len, "connection")) {
+      if (value_has(value, value_len, "close"))
+        keep_alive = false;
+      else if (value_has(value, value_len, "keep-alive"))
+        keep_alive = true;
+    }
+    line = end + 2;
+  }
+
+  size_t head = (size_t)(head_end - data) + 4;
+  if (content_length > max_request - head)
+    return HTTP_TOO_LARGE;
+  if (head + content_length > len)
+    return HTTP_INCOMPLETE;
+
+  const char *query = memchr(target, '?', (size_t)(version - 1 - target));
+  request->method = method;
+  request->method_len = (size_t)(target - 1 - method);
+  request->path = target;
+  request->path_len = (size_t)((query ? query : version - 1) - target);
+  request->body = data + head;
+  request->body_len = (size_t)content_length;
+  request->keep_alive = keep_alive;
+  request->length = head + (size_t)content_length;
+  return HTTP_COMPLETE;
+}
+
+bool http_request_is(const http_request_t *request, const char *method,
+                     const char *path) {
+  return request->method_len == strlen(method) &&
+         memcmp(request->method, method, request->method_len) == 0 &&
+         request->path_len == strlen(path) &&
+         memcmp(request->path, path, request->path_len) == 0;
+}
+
+static const char *status_reason(int status) {
+  switch (status) {
+  case 200:
+    return "OK";
+  case 400:
+    return "Bad Request";
+  case 404:
+    return "Not Found";
+  case 405:
+    return "Method Not Allowed";
+  case 413:
+    return "Content Too Large";
+  default:
+    return "Internal Server Error";
+  }
+}
+
+size_t http_response_head(char *buffer, size_t size, int status,
+                          size_t body_len, bool keep_alive) {
+  return (size_t)snprintf(buffer, size,
+                          "HTTP/1.1 %d %s\r\n"
+                          "Content-Type: application/json\r\n"
+                          "Content-Length: %zu\r\n"
+                          "%s\r\n",
+                          status, status_reason(status), body_len,
+                          keep_alive ? "" : "Connection: close\r\n");
+}
+
+static const char *skip_space(const char *p, const char *end) {
+  while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n'))
+    p++;
+  return p;
+}
+
+static int hex_value(char c) {
+  if (c >= '0' && c <= '9')
+    return c - '0';
+  c = char_fold(c);
+  return c >= 'a' && c <= 'f' ? c - 'a' + 10 : -1;
+}
+
+// the 4 hex digits at p, -1 when they aren't
+static long hex4(const char *p, const char *end) {
+  if (end - p < 4)
+    return -1;
+  long value = 0;
+  for (int i = 0; i < 4; i++) {
+    int digit = hex_value(p[i]);
+    if (digit < 0)
+      return -1;
+    value = value * 16 + digit;
+  }
+  return value;
+}
+
+// append byte to value[0..size) at *used, counting what doesn't fit
+static void put_byte(char *value, size_t size, size_t *used, char byte) {
+  if (*used + 1 < size)
+    value[*used] = byte;
+  (*used)++;
+}
+
+// decode the string after the opening quote at *p into value (may be NULL
+// to skip it) and move past the closing quote. returns the decoded
+// length, which didn't fit when it is size or more, or -1 if malformed
+static long json_string(const char **p, const char *end, char *value,
+                        size_t size) {
+  size_t used = 0;
+  const char *s = *p;
+  for (; s < end && *s != '"'; s++) {
+    if ((unsigned char)*s < 0x20)
+      return -1;
+    if (*s != '\\') {
+      put_byte(value, size, &used, *s);
+      continue;
+    }
+    if (++s == end)
+      return -1;
+    const char *simple = strchr("\"\\/bfnrt", *s);
+    if (simple && *s != '\0') {
+      put_byte(value, size, &used, "\"\\/\b\f\n\r\t"[simple - "\"\\/bfnrt"]);
+      continue;
+    }
+    if (*s != 'u')
+      return -1;
+    // \u0000 would cut the value short where it is used as a C string
+    long code = hex4(s + 1, end);
+    if (code <= 0 || (code >= 0xdc00 && code <= 0xdfff))
+      return -1;
+    s += 4;
+    if (code >= 0xd800 && code <= 0xdbff) {
+      // a surrogate pair, the low half must follow
+      long low = end - s > 2 && s[1] == '\\' && s[2] == 'u'
+                     ? hex4(s + 3, end)
+                     : -1;
+      if (low < 0xdc00 || low > 0xdfff)
+        return -1;
+      code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+      s += 6;
+    }
+    // utf-8
+    if (code < 0x80) {
+      put_byte(value, size, &used, (char)code);
+    } else if (code < 0x800) {
+      put_byte(value, size, &used, (char)(0xc0 | code >> 6));
+      put_byte(value, size, &used, (char)(0x80 | (code & 0x3f)));
+    } else if (code < 0x10000) {
+      put_byte(value, size, &used, (char)(0xe0 | code >> 12));
+      put_byte(value, size, &used, (char)(0x80 | ((code >> 6) & 0x3f)));
+      put_byte(value, size, &used, (char)(0x80 | (code & 0x3f)));
+    } else {
+      put_byte(value, size, &used, (char)(0xf0 | code >> 18));
+      put_byte(value, size, &used, (char)(0x80 | ((code >> 12) & 0x3f)));
+      put_byte(value, size, &used, (char)(0x80 | ((code >> 6) & 0x3f)));
+      put_byte(value, size, &used, (char)(0x80 | (code & 0x3f)));
+    }
+  }
+  if (s == end)
+    return -1;
+  if (size > 0)
+    value[used < size ? used : size - 1] = '\0';
+  *p = s + 1;
+  return (long)used;
+}
+
+bool http_json_fields(const char *text, size_t len, http_json_field_t *fields,
+                      size_t count) {
+  for (size_t i = 0; i < count; i++)
+    fields[i].found = false;
+
+  const char *end = text + len;
+  const char *p = skip_space(text, end);
+  if (p == end || *p++ != '{')
+    return false;
+  p = skip_space(p, end);
+  if (p < end && *p == '}')
+    return skip_space(p + 1, end) == end;
+
+  for (;;) {
+    p = skip_space(p, end);
+    char name[32];
+    if (p == end || *p++ != '"')
+      return false;
+    long name_len = json_string(&p, end, name, sizeof(name));
+    if (name_len < 0)
+      return false;
+    p = skip_space(p, end);
+    if (p == end || *p++ != ':')
+      return false;
+    p = skip_space(p, end);
+
+    http_json_field_t *field = NULL;
+    for (size_t i = 0; i < count && name_len < (long)sizeof(name); i++)
+      if (strcmp(fields[i].name, name) == 0)
+        field = &fields[i];
+
+    if (p < end && *p == '"') {
+      p++;
+      long value_len = json_string(&p, end, field ? field->value : NULL,
+                                   field ? field->size : 0);
+      if (value_len < 0 || (field && (size_t)value_len >= field->size))
+        return false;
+    } else {
+      // a number, true, false or null, kept as written
+      const char *start = p;
+      while (p < end && ((char_class(*p) & CHAR_ALNUM) || *p == '-' ||
+                         *p == '+' || *p == '.'))
+        p++;
+      size_t token_len = (size_t)(p - start);
+      if (token_len == 0 || (field && token_len >= field->size))
+        return false;
+      if (field) {
+        memcpy(field->value, start, token_len);
+        field->value[token_len] = '\0';
+      }
+    }
+    if (field)
+      field->found = true;
+
+    p = skip_space(p, end);
+    if (p < end && *p == ',') {
+      p++;
+      continue;
+    }
+    if (p == end || *p++ != '}')
+      return false;
+    return skip_space(p, end) == end;
+  }
+}
@@ -0,0 +1,195 @@
+#include "clovo/keyboard.h"
+
+#include "keyboard_layouts.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// walks shorter than this are too common by accident to report
+#define MIN_WALK_LENGTH 3
+
+// per-layout state of the walk that ends at the current character. a walk
+// can be made of parallel strokes (wsx + edc, 1qaz + 2wsx): when a straight
+// stroke of 3+ keys breaks, the next key may restart next to the stroke's
+// first key and the walk continues in the same direction
+typedef struct {
+  int start;
+  int last_key; // key id + 1, 0 when the character isn't on the layout
+  int last_direction;
+  int turns;
+  int shifted;
+  int stroke_key; // first key of the current stroke
+  int stroke_length;
+  bool parallel; // every stroke so far went in last_direction
+} walk_state_t;
+
+static int key_direction(int layout, int from, int to) {
+  const unsigned char *neighbors = keyboard_neighbors[layout][from - 1];
+  for (int d = 0; d < KEYBOARD_DIRECTIONS; d++) {
+    if (neighbors[d] == to)
+      return d;
+  }
+  return -1;
+}
+
+static bool is_horizontal(int direction) {
+  return direction == 0 || direction == 1;
+}
+
+// can `key` start a stroke parallel to the current straight one
+static bool starts_parallel_stroke(int layout, const walk_state_t *state,
+                                   int key) {
+  if (!state->parallel || state->stroke_length < 3 ||
+      state->last_direction < 0)
+    return false;
+
+  // the jump has to go across the stroke: sideways for column strokes,
+  // up or down for row strokes
+  int jump = key_direction(layout, state->stroke_key, key);
+  if (jump < 0)
+    return false;
+  return is_horizontal(jump) != is_horizontal(state->last_direction);
+}
+
+static int emit_walk(const walk_state_t *state, int layout, int end,
+                     keyboard_walk_t *walks, int count, int max_walks,
+                     int *longest) {
+  int length = end - state->start + 1;
+  if (length < MIN_WALK_LENGTH)
+    return count;
+  if (length > *longest)
+    *longest = length;
+  if (!walks || count >= max_walks)
+    return count;
+
+  keyboard_walk_t *walk = &walks[count++];
+  walk->i = state->start;
+  walk->j = end;
+  walk->turns = state->turns;
+  walk->shifted = state->shifted;
+  walk->layout = layout;
+  return count;
+}
+
+// one pass over s, stores up to max_walks walks when walks is not NULL
+static int scan_walks(const char *s, int len, keyboard_walk_t *walks,
+                      int max_walks, int *longest) {
+  *longest = 0;
+  if (!s || len < MIN_WALK_LENGTH)
+    return 0;
+
+  walk_state_t states[KEYBOARD_LAYOUT_COUNT] = {0};
+  int count = 0;
+
+  for (int k = 0; k < len; k++) {
+    unsigned char c = (unsigned char)s[k];
+
+    for (int l = 0; l < KEYBOARD_LAYOUT_COUNT; l++) {
+      walk_state_t *state = &states[l];
+      int code = keyboard_keys[l][c];
+      int key = code & 0x7F;
+      int shifted = code >> 7;
+
+      int d = -1;
+      if (key != 0 && state->last_key != 0)
+        d = key_direction(l, state->last_key, key);
+
+      if (d >= 0) {
+        if (d != state->last_direction) {
+          state->turns++;
+          if (state->last_direction >= 0)
+            state->parallel = false;
+        }
+        state->last_direction = d;
+        state->stroke_length++;
+        state->shifted += shifted;
+      } else if (key != 0 && starts_parallel_stroke(l, state, key)) {
+        // the jump to the next stroke counts as one more turn
+        state->turns++;
+        state->stroke_key = key;
+        state->stroke_length = 1;
+        state->shifted += shifted;
+      } else {
+        // the walk ending at k - 1 is over, a new one may start here
+        count = emit_walk(state, l, k - 1, walks, count, max_walks, longest);
+        state->start = k;
+        state->last_direction = -1;
+        state->turns = 0;
+        state->shifted = shifted;
+        state->stroke_key = key;
+        state->stroke_length = 1;
+        state->parallel = true;
+      }
+      state->last_key = key;
+    }
+  }
+
+  for (int l = 0; l < KEYBOARD_LAYOUT_COUNT; l++)
+    count =
+        emit_walk(&states[l], l, len - 1, walks, count, max_walks, longest);
+  return count;
+}
+
+int find_keyboard_walks(const char *s, int len, keyboard_walk_t *walks,
+                        int max_walks) {
+  int longest;
+  if (!walks || max_walks <= 0)
+    return 0;
+  return scan_walks(s, len, walks, max_walks, &longest);
+}
+
+int longest_keyboard_walk(const char *s, int len) {
+  int longest;
+  scan_walks(s, len, NULL, 0, &longest);
+  return longest;
+}
+
+static double n_choose_k(int n, int k) {
+  if (k > n)
+    return 0.0;
+  double r = 1.0;
+  for (int d = 1; d <= k; d++) {
+    r *= n;
+    r /= d;
+    n--;
+  }
+  return r;
+}
+
+double keyboard_walk_guesses(const keyboard_walk_t *walk) {
+  if (!walk || walk->layout < 0 || walk->layout >= KEYBOARD_LAYOUT_COUNT)
+    return 0.0;
+
+  double starting = keyboard_starting_positions[walk->layout];
+  double degree = keyboard_average_degree[walk->layout];
+  int length = walk->j - walk->i + 1;
+
+  // any start key, then up to `turns` direction changes along the way
+  double guesses = 0.0;
+  for (int i = 2; i <= length; i++) {
+    int possible_turns = walk->turns < i - 1 ? walk->turns : i - 1;
+    for (int t = 1; t <= possible_turns; t++)
+      guesses += n_choose_k(i - 1, t - 1) * starting * pow(degree, t);
+  }
+
+  if (walk->shifted > 0) {
+    int unshifted = length - walk->shifted;
+    if (unshifted == 0) {
+      guesses *= 2.0;
+    } else {
+      double variations = 0.0;
+      int limit = walk->shifted < unshifted ? walk->shifted : unshifted;
+      for (int i = 1; i <= limit; i++)
+        variations += n_choose_k(walk->shifted + unshifted, i);
+      guesses *= variations;
+    }
+  }
+  return guesses;
+}
+
+const char *keyboard_layout_name(int layout) {
+  if (layout < 0 || layout >= KEYBOARD_LAYOUT_COUNT)
+    return "unknown";
+  return keyboard_layout_names[layout];
+}
@@ -1,10 +1,19 @@
 #include "clovo/analyzer.h"
+#include "clovo/bulk.h"
+#include "clovo/cluster.h"
+#include "clovo/cache.h"
 #include "clovo/generator.h"
+#include "clovo/markov.h"
+#include "clovo/passphrase.h"
 #include "clovo/ui.h"
 #include "clovo/policy.h"
 #include "clovo/comparison.h"
+#include "clovo/compliance.h"
+#include "clovo/custom_policy.h"
 #include "clovo/export.h"
+#include "clovo/server.h"
 
+#include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -12,6 +21,8 @@
 
 #define MAX_PASSWORD_LENGTH 256
 #define DEFAULT_GENERATE_LENGTH 16
+#define DEFAULT_PRONOUNCEABLE_LENGTH 14
+#define DEFAULT_CLUSTER_MEMBERS 10
 #define MAX_BATCH_SIZE 1000
 
 void print_usage(const char *program_name) {
@@ -47,14 +58,36 @@ void print_usage(const char *program_name) {
          cyan, program_name, reset);
   printf("    %s%s --generate [length]%s           Generate password (default: %d)\n", 
          cyan, program_name, reset, DEFAULT_GENERATE_LENGTH);
+  printf("    %s%s --generate <len> --count <n>%s  Bulk generate (--unique, --ndjson, --threads <t>)\n", 
+         cyan, program_name, reset);
+  printf("    %s%s --generate <len> --policy <t>%s  Generate a password compliant with a policy\n", 
+         cyan, program_name, reset);
   printf("    %s%s --passphrase [words]%s         Generate passphrase (default: 4 words)\n", 
          cyan, program_name, reset);
+  printf("    %s%s --passphrase <n> --wordlist <f>%s Use a word list (--separator, --capitalize, --digits)\n", 
+         cyan, program_name, reset);
+  printf("    %s%s --pronounceable [length]%s      Generate a pronounceable password (default: %d)\n", 
+         cyan, program_name, reset, DEFAULT_PRONOUNCEABLE_LENGTH);
   printf("    %s%s --batch <file>%s                Analyze passwords from file\n", 
          cyan, program_name, reset);
+  printf("    %s%s --cluster <file>%s              Group near-identical passwords (--min-size, --members, --ndjson)\n", 
+         cyan, program_name, reset);
   printf("    %s%s --compare <pw1> <pw2>%s         Compare two passwords\n", 
          cyan, program_name, reset);
+  printf("    %s%s --compare-batch <file>%s        Compare old/new pairs (--csv, --summary, --threshold, --threads)\n", 
+         cyan, program_name, reset);
   printf("    %s%s --policy <type> <password>%s    Validate against policy (nist/pci/basic)\n", 
          cyan, program_name, reset);
+  printf("    %s%s --policy all <password> [--details]%s  Check every policy (or a list: nist,pci) at once\n", 
+         cyan, program_name, reset);
+  printf("    %s%s --policy <name> <password> --policy-file <f>%s  Use custom policies from a config file\n", 
+         cyan, program_name, reset);
+  printf("    %s%s --policy <type> --batch <file>%s  Check a whole export (--csv, --summary, --failing, --threads)\n", 
+         cyan, program_name, reset);
+  printf("    %s%s --serve <socket>%s              Answer requests on a unix socket (--threads, --policy-file)\n", 
+         cyan, program_name, reset);
+  printf("    %s%s --http [host:]port%s            Answer the same requests over http/json\n", 
+         cyan, program_name, reset);
   printf("    %s%s --json <password>%s            Output in JSON format\n", 
          cyan, program_name, reset);
   printf("    %s%s --csv <password>%s              Output in CSV format\n", 
@@ -69,15 +102,206 @@ void print_usage(const char *program_name) {
   printf("  ──────────────────────────────────────────────────────────\n");
   printf("    %s%s \"MyP@ssw0rd\"%s\n", dim, program_name, reset);
   printf("    %s%s --generate 24%s\n", dim, program_name, reset);
+  printf("    %s%s --generate 16 --count 100000 --unique%s\n", dim, program_name, reset);
   printf("    %s%s --passphrase 5%s\n", dim, program_name, reset);
+  printf("    %s%s --passphrase 6 --wordlist eff_large.txt --capitalize title --digits 2%s\n", dim, program_name, reset);
+  printf("    %s%s --pronounceable 16%s\n", dim, program_name, reset);
   printf("    %s%s --batch passwords.txt%s\n", dim, program_name, reset);
+  printf("    %s%s --cluster leaked.txt --min-size 5%s\n", dim, program_name, reset);
   printf("    %s%s --compare \"old\" \"new\"%s\n", dim, program_name, reset);
+  printf("    %s%s --compare-batch rotations.tsv --summary%s\n", dim, program_name, reset);
   printf("    %s%s --policy nist \"password\"%s\n", dim, program_name, reset);
   printf("    %s%s --json \"password\"%s\n", dim, program_name, reset);
   
   printf("\n");
 }
 
+// policy name from the command line, POLICY_CUSTOM for anything that isn't
+// built in (which only a policy file can define)
+policy_type_t parse_policy_type(const char *name) {
+  if (strcmp(name, "nist") == 0) {
+    return POLICY_NIST;
+  } else if (strcmp(name, "pci") == 0 || strcmp(name, "pci-dss") == 0) {
+    return POLICY_PCI_DSS;
+  } else if (strcmp(name, "basic") == 0) {
+    return POLICY_BASIC;
+  }
+  return POLICY_CUSTOM;
+}
+
+// check password against "all" policies or a list like "nist,pci,corp",
+// printing one line per policy and the pass bitmask. names that aren't
+// built in are looked up in custom (may be NULL), "all" includes all of it.
+// exits 0 when every policy passes, 1 when any fails and 2 for a name that
+// is neither
+int check_policies(const char *names, const char *password, bool details, const policy_set_t *custom) {
+  password_policy_t builtin[POLICY_SET_MAX];
+  const custom_policy_t *loaded[POLICY_SET_MAX];
+  const char *labels[POLICY_SET_MAX];
+  size_t count = 0;
+  
+  char list[1024];
+  if (strcmp(names, "all") == 0) {
+    size_t used = (size_t)snprintf(list, sizeof(list), "nist,pci,basic");
+    for (size_t i = 0; i < policy_set_count(custom) && used < sizeof(list); i++) {
+      used += (size_t)snprintf(list + used, sizeof(list) - used, ",%s", custom_policy_name(policy_set_get(custom, i)));
+    }
+  } else {
+    snprintf(list, sizeof(list), "%s", names);
+  }
+  
+  for (char *save = NULL, *name = strtok_r(list, ",", &save); name; name = strtok_r(NULL, ",", &save)) {
+    if (count == POLICY_SET_MAX) {
+      fprintf(stderr, "Error: at most %d policies at once\n", POLICY_SET_MAX);
+      cleanup_generator();
+      return 1;
+    }
+    policy_type_t type = parse_policy_type(name);
+    loaded[count] = type == POLICY_CUSTOM ? policy_set_find(custom, name) : NULL;
+    if (type == POLICY_CUSTOM && !loaded[count]) {
+      fprintf(stderr, "Error: unknown policy '%s' (nist, pci, basic%s)\n", name, custom ? " or one from the policy file" : "");
+      cleanup_generator();
+      return 2;
+    }
+    init_policy(&builtin[count], type);
+    labels[count] = loaded[count] ? custom_policy_name(loaded[count]) : policy_type_to_string(type);
+    count++;
+  }
+  
+  // one analysis with every detector any of the policies reads
+  unsigned features = 0;
+  for (size_t i = 0; i < count; i++) {
+    features |= loaded[i] ? custom_policy_features(loaded[i]) : builtin[i].features;
+  }
+  password_strength_t analysis = analyze_password_ex(password, strlen(password), features);
+  
+  printf("\nPolicy Validation (%zu policies):\n", count);
+  printf("──────────────────────────────────────────────────────────\n");
+  uint32_t passed = 0;
+  for (size_t i = 0; i < count; i++) {
+    uint32_t violations = loaded[i] ? custom_policy_check(loaded[i], password, strlen(password), &analysis)
+                                    : evaluate_policy_analysis(&analysis, &builtin[i]).violations;
+    printf("  %-10s %s\n", labels[i], violations ? "FAILED" : "PASSED");
+    
+    // messages only for what is shown
+    for (int v = 0; details && v < POLICY_VIOLATION_COUNT; v++) {
+      if (violations & ((uint32_t)1 << v)) {
+        char message[128];
+        if (loaded[i]) {
+          custom_policy_describe(loaded[i], (policy_violation_t)v, message, sizeof(message));
+        } else {
+          policy_violation_message(&builtin[i], (policy_violation_t)v, message, sizeof(message));
+        }
+        printf("      - %s\n", message);
+      }
+    }
+    passed |= violations ? 0 : (uint32_t)1 << i;
+  }
+  printf("Pass mask: 0x%08x\n", (unsigned)passed);
+  
+  uint32_t all = count == 32 ? UINT32_MAX : ((uint32_t)1 << count) - 1;
+  cleanup_generator();
+  return passed == all ? 0 : 1;
+}
+
+// check every password in filename (- for stdin) against one policy,
+// built in or from custom. exits 0 when all comply, 1 when any doesn't and
+// 2 when the check couldn't be done, so it can gate a nightly job
+int check_compliance_file(const char *name, const char *filename, compliance_options_t *options, const policy_set_t *custom) {
+  password_policy_t policy;
+  policy_type_t type = parse_policy_type(name);
+  init_policy(&policy, type);
+  options->policy = &policy;
+  options->custom = type == POLICY_CUSTOM ? policy_set_find(custom, name) : NULL;
+  if (type == POLICY_CUSTOM && !options->custom) {
+    fprintf(stderr, "Error: unknown policy '%s' (nist, pci, basic%s)\n", name, custom ? " or one from the policy file" : "");
+    cleanup_generator();
+    return 2;
+  }
+  const char *label = options->custom ? custom_policy_name(options->custom) : policy_type_to_string(type);
+  
+  bool from_stdin = strcmp(filename, "-") == 0;
+  FILE *in = from_stdin ? stdin : fopen(filename, "r");
+  if (!in) {
+    fprintf(stderr, "Error: Cannot open file '%s'\n", filename);
+    cleanup_generator();
+    return 2;
+  }
+  
+  compliance_stats_t stats;
+  generator_error_t result = check_compliance(in, stdout, options, &stats);
+  if (!from_stdin)
+    fclose(in);
+  if (result != GEN_SUCCESS) {
+    fprintf(stderr, "Error: Compliance check failed after %zu lines: %s\n", stats.lines, generator_error_string(result));
+    cleanup_generator();
+    return 2;
+  }
+  
+  // the summary goes to stderr when stdout carries the verdicts. messages
+  // are made once per violation type here, never per password
+  FILE *summary = options->format == COMPLIANCE_SUMMARY ? stdout : stderr;
+  double share = stats.passwords ? 100.0 * stats.failed / stats.passwords : 0.0;
+  fprintf(summary, "Policy: %s\n", label);
+  fprintf(summary, "Passwords: %zu\n", stats.passwords);
+  fprintf(summary, "Non-compliant: %zu (%.2f%%)\n", stats.failed, share);
+  for (int v = 0; v < POLICY_VIOLATION_COUNT; v++) {
+    if (stats.violations[v] == 0)
+      continue;
+    char message[128];
+    if (options->custom) {
+      custom_policy_describe(options->custom, (policy_violation_t)v, message, sizeof(message));
+    } else {
+      policy_violation_message(&policy, (policy_violation_t)v, message, sizeof(message));
+    }
+    fprintf(summary, "  %-12s %10zu  %s\n", policy_violation_name((policy_violation_t)v), stats.violations[v], message);
+  }
+  
+  cleanup_generator();
+  return stats.failed == 0 ? 0 : 1;
+}
+
+// the server --serve runs, for the signal handler
+static server_t *serving;
+
+static void stop_serving(int sig) {
+  (void)sig;
+  server_stop(serving);
+}
+
+// answer requests until SIGINT or SIGTERM, see server.h
+int serve(server_options_t *options) {
+  generator_error_t err;
+  serving = server_create(options, &err);
+  if (!serving) {
+    if (options->socket_path) {
+      fprintf(stderr, "Error: Cannot serve on '%s': %s\n", options->socket_path, generator_error_string(err));
+    } else {
+      fprintf(stderr, "Error: Cannot serve on port %d: %s\n", options->port, generator_error_string(err));
+    }
+    cleanup_generator();
+    return 1;
+  }
+  
+  signal(SIGINT, stop_serving);
+  signal(SIGTERM, stop_serving);
+  if (options->socket_path) {
+    fprintf(stderr, "Serving on %s\n", options->socket_path);
+  } else {
+    fprintf(stderr, "Serving http on %s:%d\n", options->host ? options->host : "127.0.0.1", server_port(serving));
+  }
+  err = server_run(serving);
+  server_destroy(serving);
+  serving = NULL;
+  
+  cleanup_generator();
+  if (err != GEN_SUCCESS) {
+    fprintf(stderr, "Error: Server stopped: %s\n", generator_error_string(err));
+    return 1;
+  }
+  return 0;
+}
+
 // process batch file
 int process_batch(const char *filename, export_format_t format, const char *output_file) {
   FILE *file = fopen(filename, "r");
@@ -87,6 +311,8 @@ int process_batch(const char *filename, export_format_t format, const char *outp
   }
   
   char line[512];
+  // batch files often repeat the same weak candidates
+  analysis_cache_t *cache = analysis_cache_create(0);
   password_strength_t results[MAX_BATCH_SIZE];
   const char *passwords[MAX_BATCH_SIZE];
   char password_storage[MAX_BATCH_SIZE][MAX_PASSWORD_LENGTH + 1];
@@ -104,11 +330,12 @@ int process_batch(const char *filename, export_format_t format, const char *outp
     
     strcpy(password_storage[count], line);
     passwords[count] = password_storage[count];
-    results[count] = analyze_password(passwords[count]);
+    results[count] = cached_analyze_password(cache, passwords[count]);
     count++;
   }
   
   fclose(file);
+  analysis_cache_destroy(cache);
   
   if (count == 0) {
     fprintf(stderr, "Error: No passwords found in file\n");
@@ -155,31 +382,90 @@ int main(int argc, char *argv[]) {
   // handle --generate
   if (strcmp(argv[1], "--generate") == 0 || strcmp(argv[1], "-g") == 0) {
     size_t length = DEFAULT_GENERATE_LENGTH;
+    bulk_options_t bulk;
+    init_bulk_options(&bulk);
+    bool bulk_mode = false;
+    const char *policy_name = NULL;
     
-    if (argc >= 3) {
+    for (int i = 2; i < argc; i++) {
       char *endptr;
-      long parsed_length = strtol(argv[2], &endptr, 10);
-      
-      if (*endptr != '\0' || parsed_length <= 0) {
-        fprintf(stderr, "Error: Invalid length '%s'. Must be a positive integer.\n", argv[2]);
-        cleanup_generator();
-        return 1;
+      if (strcmp(argv[i], "--count") == 0 || strcmp(argv[i], "-n") == 0) {
+        long long parsed_count = i + 1 < argc ? strtoll(argv[++i], &endptr, 10) : 0;
+        if (parsed_count <= 0 || *endptr != '\0') {
+          fprintf(stderr, "Error: --count requires a positive integer\n");
+          cleanup_generator();
+          return 1;
+        }
+        bulk.count = (size_t)parsed_count;
+        bulk_mode = true;
+      } else if (strcmp(argv[i], "--threads") == 0) {
+        long parsed_threads = i + 1 < argc ? strtol(argv[++i], &endptr, 10) : 0;
+        if (parsed_threads <= 0 || *endptr != '\0') {
+          fprintf(stderr, "Error: --threads requires a positive integer\n");
+          cleanup_generator();
+          return 1;
+        }
+        bulk.threads = (int)parsed_threads;
+      } else if (strcmp(argv[i], "--unique") == 0) {
+        bulk.unique = true;
+      } else if (strcmp(argv[i], "--ndjson") == 0) {
+        bulk.format = BULK_NDJSON;
+      } else if (strcmp(argv[i], "--policy") == 0 && i + 1 < argc) {
+        policy_name = argv[++i];
+      } else {
+        long parsed_length = strtol(argv[i], &endptr, 10);
+        
+        if (*endptr != '\0' || parsed_length <= 0) {
+          fprintf(stderr, "Error: Invalid length '%s'. Must be a positive integer.\n", argv[i]);
+          cleanup_generator();
+          return 1;
+        }
+        
+        if (parsed_length > MAX_PASSWORD_LENGTH) {
+          fprintf(stderr, "Error: Length must be <= %d\n", MAX_PASSWORD_LENGTH);
+          cleanup_generator();
+          return 1;
+        }
+        
+        length = (size_t)parsed_length;
       }
-      
-      if (parsed_length > MAX_PASSWORD_LENGTH) {
-        fprintf(stderr, "Error: Length must be <= %d\n", MAX_PASSWORD_LENGTH);
+    }
+
+    if (bulk_mode && policy_name) {
+      fprintf(stderr, "Error: --policy can't be combined with --count\n");
+      cleanup_generator();
+      return 1;
+    }
+
+    // bulk mode: bare passwords only, no analysis
+    if (bulk_mode) {
+      bulk.length = length;
+      size_t written = 0;
+      generator_error_t gen_result = generate_bulk(stdout, &bulk, &written);
+      fflush(stdout);
+      if (gen_result != GEN_SUCCESS) {
+        fprintf(stderr, "Error generating passwords: %s (%zu written)\n",
+                generator_error_string(gen_result), written);
         cleanup_generator();
         return 1;
       }
-      
-      length = (size_t)parsed_length;
+      cleanup_generator();
+      return 0;
     }
 
     generator_options_t opts;
     init_generator_options(&opts);
     
     char password[MAX_PASSWORD_LENGTH + 1];
-    generator_error_t gen_result = generate_password(password, sizeof(password), length, &opts);
+    generator_error_t gen_result;
+    if (policy_name) {
+      // compliant by construction instead of generate-and-validate
+      password_policy_t policy;
+      init_policy(&policy, parse_policy_type(policy_name));
+      gen_result = generate_password_for_policy(password, sizeof(password), length, &policy, &opts, NULL);
+    } else {
+      gen_result = generate_password(password, sizeof(password), length, &opts);
+    }
     
     if (gen_result != GEN_SUCCESS) {
       fprintf(stderr, "Error generating password: %s\n", generator_error_string(gen_result));
@@ -196,36 +482,134 @@ int main(int argc, char *argv[]) {
 
   // handle --passphrase
   if (strcmp(argv[1], "--passphrase") == 0 || strcmp(argv[1], "-p") == 0) {
-    int word_count = 4;
+    passphrase_options_t passphrase_opts;
+    init_passphrase_options(&passphrase_opts);
+    const char *wordlist_path = NULL;
     
-    if (argc >= 3) {
+    for (int i = 2; i < argc; i++) {
       char *endptr;
-      long parsed_count = strtol(argv[2], &endptr, 10);
-      
-      if (*endptr != '\0' || parsed_count < 2 || parsed_count > 10) {
-        fprintf(stderr, "Error: Word count must be between 2 and 10\n");
+      if (strcmp(argv[i], "--wordlist") == 0 && i + 1 < argc) {
+        wordlist_path = argv[++i];
+      } else if (strcmp(argv[i], "--separator") == 0 && i + 1 < argc) {
+        passphrase_opts.separator = argv[++i];
+        if (strlen(passphrase_opts.separator) > PASSPHRASE_MAX_SEPARATOR) {
+          fprintf(stderr, "Error: Separator must be at most %d bytes\n", PASSPHRASE_MAX_SEPARATOR);
+          cleanup_generator();
+          return 1;
+        }
+      } else if (strcmp(argv[i], "--capitalize") == 0 && i + 1 < argc) {
+        const char *mode = argv[++i];
+        if (strcmp(mode, "lower") == 0) {
+          passphrase_opts.capitalization = PASSPHRASE_LOWER;
+        } else if (strcmp(mode, "title") == 0) {
+          passphrase_opts.capitalization = PASSPHRASE_TITLE;
+        } else if (strcmp(mode, "upper") == 0) {
+          passphrase_opts.capitalization = PASSPHRASE_UPPER;
+        } else if (strcmp(mode, "random") == 0) {
+          passphrase_opts.capitalization = PASSPHRASE_RANDOM_TITLE;
+        } else {
+          fprintf(stderr, "Error: --capitalize must be lower, title, upper or random\n");
+          cleanup_generator();
+          return 1;
+        }
+      } else if (strcmp(argv[i], "--digits") == 0 && i + 1 < argc) {
+        long parsed_digits = strtol(argv[++i], &endptr, 10);
+        if (*endptr != '\0' || parsed_digits < 0 || parsed_digits > PASSPHRASE_MAX_DIGITS) {
+          fprintf(stderr, "Error: --digits must be between 0 and %d\n", PASSPHRASE_MAX_DIGITS);
+          cleanup_generator();
+          return 1;
+        }
+        passphrase_opts.digits = (int)parsed_digits;
+      } else {
+        long parsed_count = strtol(argv[i], &endptr, 10);
+        
+        if (*endptr != '\0' || parsed_count < 2 || parsed_count > PASSPHRASE_MAX_WORDS) {
+          fprintf(stderr, "Error: Word count must be between 2 and %d\n", PASSPHRASE_MAX_WORDS);
+          cleanup_generator();
+          return 1;
+        }
+        
+        passphrase_opts.word_count = (int)parsed_count;
+      }
+    }
+
+    wordlist_t wordlist;
+    if (wordlist_path) {
+      generator_error_t load_result = wordlist_load(&wordlist, wordlist_path);
+      if (load_result != GEN_SUCCESS) {
+        if (load_result == GEN_ERROR_NO_CHARSET)
+          fprintf(stderr, "Error: Word list '%s' has no usable words\n", wordlist_path);
+        else
+          fprintf(stderr, "Error: Cannot load word list '%s'\n", wordlist_path);
         cleanup_generator();
         return 1;
       }
-      
-      word_count = (int)parsed_count;
+      passphrase_opts.words = &wordlist;
     }
-
-    generator_options_t opts;
-    init_generator_options(&opts);
     
-    char passphrase[256];
-    generator_error_t gen_result = generate_passphrase(passphrase, sizeof(passphrase), word_count, &opts);
+    size_t passphrase_size = passphrase_max_length(&passphrase_opts) + 1;
+    char *passphrase = malloc(passphrase_size);
+    double entropy = 0.0;
+    generator_error_t gen_result = passphrase
+        ? generate_passphrase_ex(passphrase, passphrase_size, &passphrase_opts, &entropy)
+        : GEN_ERROR_NULL_POINTER;
+    size_t list_size = passphrase_opts.words ? passphrase_opts.words->count : builtin_wordlist()->count;
+    if (wordlist_path)
+      wordlist_free(&wordlist);
     
     if (gen_result != GEN_SUCCESS) {
       fprintf(stderr, "Error generating passphrase: %s\n", generator_error_string(gen_result));
+      free(passphrase);
       cleanup_generator();
       return 1;
     }
 
     password_strength_t analysis = analyze_password(passphrase);
     display_generated_password(passphrase, &analysis);
+    printf("  Passphrase entropy: %.1f bits (%d words from a %zu-word list)\n\n",
+           entropy, passphrase_opts.word_count, list_size);
+    
+    secure_wipe(passphrase, passphrase_size);
+    free(passphrase);
+    cleanup_generator();
+    return 0;
+  }
+
+  // handle --pronounceable
+  if (strcmp(argv[1], "--pronounceable") == 0) {
+    size_t length = DEFAULT_PRONOUNCEABLE_LENGTH;
+    
+    if (argc >= 3) {
+      char *endptr;
+      long parsed_length = strtol(argv[2], &endptr, 10);
+      
+      if (*endptr != '\0' || parsed_length < PRONOUNCEABLE_MIN_LENGTH || parsed_length > PRONOUNCEABLE_MAX_LENGTH) {
+        fprintf(stderr, "Error: Length must be between %d and %d\n", PRONOUNCEABLE_MIN_LENGTH, PRONOUNCEABLE_MAX_LENGTH);
+        cleanup_generator();
+        return 1;
+      }
+      
+      length = (size_t)parsed_length;
+    }
+    
+    char password[PRONOUNCEABLE_MAX_LENGTH + 1];
+    double surprisal = 0.0;
+    generator_error_t gen_result = generate_pronounceable(password, sizeof(password), length, &surprisal);
+    
+    if (gen_result != GEN_SUCCESS) {
+      fprintf(stderr, "Error generating password: %s\n", generator_error_string(gen_result));
+      cleanup_generator();
+      return 1;
+    }
     
+    password_strength_t analysis = analyze_password(password);
+    display_generated_password(password, &analysis);
+    // the analyzer's charset estimate overstates lowercase letters drawn
+    // from a model; these are the bits against an attacker who has it
+    printf("  Model entropy: %.1f bits (this password: %.1f bits)\n\n",
+           pronounceable_entropy(length), surprisal);
+    
+    secure_wipe(password, sizeof(password));
     cleanup_generator();
     return 0;
   }
@@ -257,6 +641,215 @@ int main(int argc, char *argv[]) {
     return ret;
   }
 
+  // handle --cluster
+  if (strcmp(argv[1], "--cluster") == 0) {
+    if (argc < 3) {
+      fprintf(stderr, "Error: --cluster requires a filename\n");
+      cleanup_generator();
+      return 1;
+    }
+    
+    size_t min_size = 2;
+    size_t members = DEFAULT_CLUSTER_MEMBERS;
+    cluster_format_t format = CLUSTER_TEXT;
+    for (int i = 3; i < argc; i++) {
+      char *endptr;
+      if ((strcmp(argv[i], "--min-size") == 0 || strcmp(argv[i], "--members") == 0) && i + 1 < argc) {
+        const char *option = argv[i];
+        long long parsed = strtoll(argv[++i], &endptr, 10);
+        if (parsed <= 0 || *endptr != '\0') {
+          fprintf(stderr, "Error: %s requires a positive integer\n", option);
+          cleanup_generator();
+          return 1;
+        }
+        if (strcmp(option, "--min-size") == 0)
+          min_size = (size_t)parsed;
+        else
+          members = (size_t)parsed;
+      } else if (strcmp(argv[i], "--ndjson") == 0) {
+        format = CLUSTER_NDJSON;
+      } else {
+        fprintf(stderr, "Error: Unknown option '%s'\n", argv[i]);
+        cleanup_generator();
+        return 1;
+      }
+    }
+    
+    cluster_corpus_t *corpus = cluster_corpus_create();
+    generator_error_t cluster_result = corpus ? cluster_corpus_load(corpus, argv[2]) : GEN_ERROR_NULL_POINTER;
+    if (cluster_result == GEN_ERROR_FILE_ACCESS) {
+      fprintf(stderr, "Error: Cannot open file '%s'\n", argv[2]);
+    } else if (cluster_result == GEN_SUCCESS) {
+      cluster_result = cluster_corpus_build(corpus, min_size);
+      if (cluster_result != GEN_SUCCESS)
+        fprintf(stderr, "Error: Not enough memory to cluster '%s'\n", argv[2]);
+    } else {
+      fprintf(stderr, "Error: Cannot load '%s': %s\n", argv[2], generator_error_string(cluster_result));
+    }
+    
+    if (cluster_result == GEN_SUCCESS) {
+      cluster_stats_t stats = cluster_corpus_stats(corpus);
+      if (format == CLUSTER_TEXT) {
+        printf("\nPassword Clusters:\n");
+        printf("──────────────────────────────────────────────────────────\n");
+        printf("Lines: %zu (%zu distinct, %zu skipped)\n", stats.lines, stats.distinct, stats.skipped);
+        printf("Clusters: %zu covering %zu distinct passwords\n\n", stats.clusters, stats.clustered);
+      }
+      cluster_write(corpus, stdout, format, members);
+    }
+    
+    cluster_corpus_free(corpus);
+    cleanup_generator();
+    return cluster_result == GEN_SUCCESS ? 0 : 1;
+  }
+
+  // handle --serve and --http
+  if (strcmp(argv[1], "--serve") == 0 || strcmp(argv[1], "--http") == 0) {
+    bool http = strcmp(argv[1], "--http") == 0;
+    if (argc < 3) {
+      fprintf(stderr, "Error: %s requires %s\n", argv[1], http ? "a port" : "a socket path");
+      cleanup_generator();
+      return 1;
+    }
+    
+    server_options_t options;
+    init_server_options(&options);
+    char host[256] = "";
+    if (http) {
+      // [host:]port, the host may be a bracketed ipv6 address
+      options.protocol = SERVER_HTTP;
+      const char *colon = strrchr(argv[2], ':');
+      const char *port = colon ? colon + 1 : argv[2];
+      if (colon) {
+        const char *start = argv[2][0] == '[' ? argv[2] + 1 : argv[2];
+        const char *end = colon > start && colon[-1] == ']' ? colon - 1 : colon;
+        snprintf(host, sizeof(host), "%.*s", (int)(end - start), start);
+        options.host = host;
+      }
+      char *endptr;
+      long parsed = strtol(port, &endptr, 10);
+      if (*port == '\0' || *endptr != '\0' || parsed < 0 || parsed > 65535) {
+        fprintf(stderr, "Error: --http requires a port between 0 and 65535\n");
+        cleanup_generator();
+        return 1;
+      }
+      options.port = (int)parsed;
+    } else {
+      options.socket_path = argv[2];
+    }
+    const char *policy_file = NULL;
+    for (int i = 3; i < argc; i++) {
+      if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+        char *endptr;
+        long long parsed = strtoll(argv[++i], &endptr, 10);
+        if (parsed <= 0 || parsed > 256 || *endptr != '\0') {
+          fprintf(stderr, "Error: --threads requires a number between 1 and 256\n");
+          cleanup_generator();
+          return 1;
+        }
+        options.threads = (int)parsed;
+      } else if (strcmp(argv[i], "--policy-file") == 0 && i + 1 < argc) {
+        policy_file = argv[++i];
+      } else {
+        fprintf(stderr, "Error: unknown option '%s' for %s\n", argv[i], argv[1]);
+        cleanup_generator();
+        return 1;
+      }
+    }
+    
+    policy_set_t *custom = NULL;
+    if (policy_file) {
+      generator_error_t err;
+      int line;
+      custom = policy_set_load(policy_file, &err, &line);
+      if (!custom) {
+        if (line > 0) {
+          fprintf(stderr, "Error: %s line %d: %s\n", policy_file, line, generator_error_string(err));
+        } else {
+          fprintf(stderr, "Error: %s: %s\n", policy_file, generator_error_string(err));
+        }
+        cleanup_generator();
+        return 1;
+      }
+    }
+    options.custom = custom;
+    
+    int status = serve(&options);
+    policy_set_free(custom);
+    return status;
+  }
+
+  // handle --compare-batch
+  if (strcmp(argv[1], "--compare-batch") == 0) {
+    if (argc < 3) {
+      fprintf(stderr, "Error: --compare-batch requires a filename (- for stdin)\n");
+      cleanup_generator();
+      return 1;
+    }
+    
+    compare_batch_options_t options;
+    init_compare_batch_options(&options);
+    for (int i = 3; i < argc; i++) {
+      char *endptr;
+      if (strcmp(argv[i], "--threshold") == 0 && i + 1 < argc) {
+        double parsed = strtod(argv[++i], &endptr);
+        if (parsed < 0.0 || parsed > 1.0 || *endptr != '\0') {
+          fprintf(stderr, "Error: --threshold requires a number between 0 and 1\n");
+          cleanup_generator();
+          return 1;
+        }
+        options.threshold = parsed;
+      } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+        long long parsed = strtoll(argv[++i], &endptr, 10);
+        if (parsed <= 0 || parsed > 256 || *endptr != '\0') {
+          fprintf(stderr, "Error: --threads requires a number between 1 and 256\n");
+          cleanup_generator();
+          return 1;
+        }
+        options.threads = (int)parsed;
+      } else if (strcmp(argv[i], "--csv") == 0) {
+        options.format = COMPARE_BATCH_CSV;
+      } else if (strcmp(argv[i], "--ndjson") == 0) {
+        options.format = COMPARE_BATCH_NDJSON;
+      } else if (strcmp(argv[i], "--summary") == 0) {
+        options.format = COMPARE_BATCH_SUMMARY;
+      } else {
+        fprintf(stderr, "Error: Unknown option '%s'\n", argv[i]);
+        cleanup_generator();
+        return 1;
+      }
+    }
+    
+    bool from_stdin = strcmp(argv[2], "-") == 0;
+    FILE *in = from_stdin ? stdin : fopen(argv[2], "r");
+    if (!in) {
+      fprintf(stderr, "Error: Cannot open file '%s'\n", argv[2]);
+      cleanup_generator();
+      return 1;
+    }
+    
+    compare_batch_stats_t stats;
+    generator_error_t batch_result = compare_batch(in, stdout, &options, &stats);
+    if (!from_stdin)
+      fclose(in);
+    if (batch_result != GEN_SUCCESS) {
+      fprintf(stderr, "Error: Comparison failed after %zu lines: %s\n", stats.lines, generator_error_string(batch_result));
+      cleanup_generator();
+      return 1;
+    }
+    
+    // the summary goes to stderr when stdout carries the per-pair results
+    FILE *summary = options.format == COMPARE_BATCH_SUMMARY ? stdout : stderr;
+    double share = stats.pairs ? 100.0 * stats.too_similar / stats.pairs : 0.0;
+    fprintf(summary, "Pairs: %zu\n", stats.pairs);
+    fprintf(summary, "Too similar: %zu (%.2f%%, similarity > %.2f)\n", stats.too_similar, share, options.threshold);
+    if (stats.malformed > 0)
+      fprintf(summary, "Malformed lines skipped: %zu\n", stats.malformed);
+    
+    cleanup_generator();
+    return 0;
+  }
+
   // handle --compare
   if (strcmp(argv[1], "--compare") == 0 || strcmp(argv[1], "-c") == 0) {
     if (argc < 4) {
@@ -291,13 +884,83 @@ int main(int argc, char *argv[]) {
       return 1;
     }
     
-    policy_type_t policy_type = POLICY_CUSTOM;
-    if (strcmp(argv[2], "nist") == 0) {
-      policy_type = POLICY_NIST;
-    } else if (strcmp(argv[2], "pci") == 0 || strcmp(argv[2], "pci-dss") == 0) {
-      policy_type = POLICY_PCI_DSS;
-    } else if (strcmp(argv[2], "basic") == 0) {
-      policy_type = POLICY_BASIC;
+    // --policy <type> --batch <file>: a whole export, one password per line
+    bool batch = strcmp(argv[3], "--batch") == 0;
+    if (batch && argc < 5) {
+      fprintf(stderr, "Error: --batch requires a filename (- for stdin)\n");
+      cleanup_generator();
+      return 2;
+    }
+    
+    bool details = false;
+    const char *policy_file = NULL;
+    compliance_options_t compliance;
+    init_compliance_options(&compliance);
+    for (int i = batch ? 5 : 4; i < argc; i++) {
+      if (strcmp(argv[i], "--details") == 0 && !batch) {
+        details = true;
+      } else if (strcmp(argv[i], "--policy-file") == 0 && i + 1 < argc) {
+        policy_file = argv[++i];
+      } else if (batch && strcmp(argv[i], "--csv") == 0) {
+        compliance.format = COMPLIANCE_CSV;
+      } else if (batch && strcmp(argv[i], "--ndjson") == 0) {
+        compliance.format = COMPLIANCE_NDJSON;
+      } else if (batch && strcmp(argv[i], "--summary") == 0) {
+        compliance.format = COMPLIANCE_SUMMARY;
+      } else if (batch && strcmp(argv[i], "--failing") == 0) {
+        compliance.failing_only = true;
+      } else if (batch && strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+        char *endptr;
+        long long parsed = strtoll(argv[++i], &endptr, 10);
+        if (parsed <= 0 || parsed > 256 || *endptr != '\0') {
+          fprintf(stderr, "Error: --threads requires a number between 1 and 256\n");
+          cleanup_generator();
+          return 2;
+        }
+        compliance.threads = (int)parsed;
+      } else {
+        fprintf(stderr, "Error: unknown option '%s' for --policy\n", argv[i]);
+        cleanup_generator();
+        return batch ? 2 : 1;
+      }
+    }
+    
+    // custom policies from a file, compiled once
+    policy_set_t *custom = NULL;
+    if (policy_file) {
+      generator_error_t err;
+      int line;
+      custom = policy_set_load(policy_file, &err, &line);
+      if (!custom) {
+        if (line > 0) {
+          fprintf(stderr, "Error: %s line %d: %s\n", policy_file, line, generator_error_string(err));
+        } else {
+          fprintf(stderr, "Error: %s: %s\n", policy_file, generator_error_string(err));
+        }
+        cleanup_generator();
+        return batch ? 2 : 1;
+      }
+    }
+    
+    if (batch) {
+      int status = check_compliance_file(argv[2], argv[4], &compliance, custom);
+      policy_set_free(custom);
+      return status;
+    }
+    
+    // "all", a comma-separated list or a custom policy: one analysis, every
+    // policy checked
+    if (custom || strcmp(argv[2], "all") == 0 || strchr(argv[2], ',')) {
+      int status = check_policies(argv[2], argv[3], details, custom);
+      policy_set_free(custom);
+      return status;
+    }
+    
+    policy_type_t policy_type = parse_policy_type(argv[2]);
+    if (policy_type == POLICY_CUSTOM) {
+      fprintf(stderr, "Error: unknown policy '%s' (nist, pci, basic)\n", argv[2]);
+      cleanup_generator();
+      return 2;
     }
     
     password_policy_t policy;
@@ -0,0 +1,187 @@
+#include "clovo/markov.h"
+#include "clovo/sampler.h"
+
+#include "markov_model.h"
+
+#include <math.h>
+#include <string.h>
+
+// candidates that are on the common list are drawn again, running out of
+// attempts would take a model that puts almost all its mass on the list
+#define MAX_ATTEMPTS 16
+
+static const uint16_t *model_row(int a, int b) {
+  return markov_cumulative[a * MARKOV_SYMBOLS + b];
+}
+
+// first letter whose cumulative frequency passes r, r < MARKOV_TOTAL
+static int sample_row(const uint16_t *cumulative, uint32_t r) {
+  int lo = 0, hi = MARKOV_LETTERS - 1;
+  while (lo < hi) {
+    int mid = (lo + hi) / 2;
+    if (cumulative[mid] > r)
+      hi = mid;
+    else
+      lo = mid + 1;
+  }
+  return lo;
+}
+
+static unsigned row_frequency(const uint16_t *cumulative, int letter) {
+  return cumulative[letter] - (letter > 0 ? cumulative[letter - 1] : 0);
+}
+
+// -log2 of the probability the chain produces s[0..len), before common
+// passwords are excluded
+static double model_surprisal(const char *s, size_t len) {
+  double bits = 0.0;
+  int a = 0, b = 0;
+  for (size_t i = 0; i < len; i++) {
+    if (s[i] < 'a' || s[i] > 'z')
+      return INFINITY;
+    int letter = s[i] - 'a';
+    unsigned freq = row_frequency(model_row(a, b), letter);
+    if (freq == 0)
+      return INFINITY;
+    bits += log2((double)MARKOV_TOTAL / freq);
+    a = b;
+    b = letter + 1;
+  }
+  return bits;
+}
+
+// total probability of the distinct common passwords the chain can produce
+// at this length, and the same sum weighted by their surprisal. only
+// all-lowercase entries can match a generated password
+static void excluded_mass(size_t length, double *mass, double *weighted) {
+  *mass = 0.0;
+  *weighted = 0.0;
+  size_t count = common_password_count();
+  for (size_t i = 0; i < count; i++) {
+    const char *entry = common_password_at(i);
+    if (strlen(entry) != length)
+      continue;
+    double bits = model_surprisal(entry, length);
+    if (isinf(bits) || common_password_rank(entry, length) != i + 1)
+      continue;
+    double p = exp2(-bits);
+    *mass += p;
+    *weighted += p * bits;
+  }
+}
+
+generator_error_t generate_pronounceable(char *buffer, size_t buffer_size,
+                                         size_t length, double *surprisal) {
+  if (!buffer)
+    return GEN_ERROR_NULL_POINTER;
+  if (length < PRONOUNCEABLE_MIN_LENGTH || length > PRONOUNCEABLE_MAX_LENGTH)
+    return GEN_ERROR_INVALID_LENGTH;
+  if (buffer_size < length + 1)
+    return GEN_ERROR_BUFFER_TOO_SMALL;
+
+  uint32_t draws[PRONOUNCEABLE_MAX_LENGTH];
+  generator_error_t status = GEN_ERROR_COMMON_PASSWORD;
+  double bits = 0.0;
+
+  for (int attempt = 0; attempt < MAX_ATTEMPTS; attempt++) {
+    // one uniform draw per letter, all from one block; MARKOV_TOTAL is a
+    // power of two so none is ever rejected
+    if (random_indices(MARKOV_TOTAL, draws, length) != GEN_SUCCESS) {
+      status = GEN_ERROR_RANDOM_FAILED;
+      break;
+    }
+
+    // surprisal adds up -log2 of each chosen letter's probability
+    bits = 0.0;
+    int a = 0, b = 0;
+    for (size_t i = 0; i < length; i++) {
+      const uint16_t *row = model_row(a, b);
+      int letter = sample_row(row, draws[i]);
+      bits += log2((double)MARKOV_TOTAL / row_frequency(row, letter));
+      buffer[i] = (char)('a' + letter);
+      a = b;
+      b = letter + 1;
+    }
+    buffer[length] = '\0';
+
+    if (!is_common_password(buffer)) {
+      status = GEN_SUCCESS;
+      break;
+    }
+  }
+  secure_wipe(draws, length * sizeof(*draws));
+
+  if (status != GEN_SUCCESS) {
+    secure_wipe(buffer, length + 1);
+    return status;
+  }
+  if (surprisal) {
+    // rejecting the common passwords scales every other probability up
+    double mass, weighted;
+    excluded_mass(length, &mass, &weighted);
+    *surprisal = bits + log2(1.0 - mass);
+  }
+  return GEN_SUCCESS;
+}
+
+double pronounceable_surprisal(const char *password) {
+  if (!password || !*password || is_common_password(password))
+    return INFINITY;
+
+  size_t length = strlen(password);
+  double bits = model_surprisal(password, length);
+  if (isinf(bits))
+    return INFINITY;
+
+  double mass, weighted;
+  excluded_mass(length, &mass, &weighted);
+  return bits + log2(1.0 - mass);
+}
+
+double pronounceable_entropy(size_t length) {
+  // forward pass over context probabilities: the entropy of a markov
+  // sequence is the sum over steps of the expected entropy of the next
+  // letter given the context the chain is in at that step
+  double row_entropy[MARKOV_SYMBOLS * MARKOV_SYMBOLS];
+  double state[MARKOV_SYMBOLS * MARKOV_SYMBOLS] = {0};
+  double next[MARKOV_SYMBOLS * MARKOV_SYMBOLS];
+
+  for (int ctx = 0; ctx < MARKOV_SYMBOLS * MARKOV_SYMBOLS; ctx++) {
+    const uint16_t *row = markov_cumulative[ctx];
+    double h = 0.0;
+    for (int l = 0; l < MARKOV_LETTERS; l++) {
+      unsigned freq = row_frequency(row, l);
+      if (freq) {
+        double p = (double)freq / MARKOV_TOTAL;
+        h -= p * log2(p);
+      }
+    }
+    row_entropy[ctx] = h;
+  }
+
+  double bits = 0.0;
+  state[0] = 1.0; // both previous symbols are the start marker
+  for (size_t step = 0; step < length; step++) {
+    memset(next, 0, sizeof(next));
+    for (int ctx = 0; ctx < MARKOV_SYMBOLS * MARKOV_SYMBOLS; ctx++) {
+      if (state[ctx] == 0.0)
+        continue;
+      bits += state[ctx] * row_entropy[ctx];
+      const uint16_t *row = markov_cumulative[ctx];
+      int b = ctx % MARKOV_SYMBOLS;
+      for (int l = 0; l < MARKOV_LETTERS; l++) {
+        unsigned freq = row_frequency(row, l);
+        if (freq)
+          next[b * MARKOV_SYMBOLS + l + 1] +=
+              state[ctx] * freq / MARKOV_TOTAL;
+      }
+    }
+    memcpy(state, next, sizeof(state));
+  }
+
+  // conditioning on not drawing a common password: with mass m and
+  // weighted surprisal w removed, H' = (H - w) / (1 - m) + log2(1 - m)
+  double mass, weighted;
+  excluded_mass(length, &mass, &weighted);
+  return (bits - weighted) / (1.0 - mass) + log2(1.0 - mass);
+}
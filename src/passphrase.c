@@ -0,0 +1,419 @@
+#include "clovo/passphrase.h"
+#include "clovo/charclass.h"
+#include "clovo/sampler.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// the list compiled into the program, one word per line
+static const char builtin_words[] =
+    "apple\nbanana\ncherry\ndragon\neagle\nforest\ngarden\nhammer\nisland\n"
+    "jungle\nknight\nlighthouse\nmountain\nocean\nplanet\nquasar\nriver\n"
+    "sunset\ntiger\nuniverse\nvalley\nwaterfall\nxylophone\nyacht\nzebra\n"
+    "anchor\nbridge\ncastle\ndiamond\nelephant\nfalcon\ngalaxy\nhorizon\n"
+    "igloo\njaguar\nkangaroo\nleopard\nmermaid\nnebula\noctopus\npenguin\n"
+    "quill\nrainbow\nsapphire\ntornado\numbrella\nvolcano\nwhale\nxenon\n"
+    "yogurt\nzeppelin\n";
+
+#define BUILTIN_CAPACITY 64
+
+static wordlist_t builtin;
+static wordlist_entry_t builtin_entries[BUILTIN_CAPACITY];
+
+// ============================================
+// Indexing
+// ============================================
+
+static bool is_blank(char c) { return (char_class(c) & CHAR_SPACE) != 0; }
+
+static bool all_digits(const char *s, size_t len) {
+  for (size_t i = 0; i < len; i++)
+    if (!char_is_digit(s[i]))
+      return false;
+  return true;
+}
+
+// find the word on every line of data, storing them in entries when it
+// isn't NULL. returns the number of words
+static size_t scan_words(const char *data, size_t size,
+                         wordlist_entry_t *entries) {
+  size_t count = 0;
+  size_t i = 0;
+  while (i < size) {
+    size_t start = i;
+    while (i < size && data[i] != '\n')
+      i++;
+    size_t end = i++;
+
+    while (start < end && is_blank(data[start]))
+      start++;
+    while (end > start && is_blank(data[end - 1]))
+      end--;
+    if (start == end || data[start] == '#')
+      continue;
+
+    size_t word = end;
+    while (word > start && !is_blank(data[word - 1]))
+      word--;
+    size_t len = end - word;
+    if (len > WORDLIST_MAX_WORD || all_digits(data + word, len))
+      continue;
+
+    if (entries)
+      entries[count] = (wordlist_entry_t){(uint32_t)word, (uint32_t)len};
+    count++;
+  }
+  return count;
+}
+
+static uint32_t fold_hash(const char *s, size_t len) {
+  uint32_t h = 2166136261u;
+  for (size_t i = 0; i < len; i++)
+    h = (h ^ (unsigned char)char_fold(s[i])) * 16777619u;
+  return h;
+}
+
+static bool same_word(const char *arena, wordlist_entry_t a,
+                      wordlist_entry_t b) {
+  if (a.length != b.length)
+    return false;
+  for (uint32_t i = 0; i < a.length; i++)
+    if (char_fold(arena[a.offset + i]) != char_fold(arena[b.offset + i]))
+      return false;
+  return true;
+}
+
+// drop case-insensitive duplicates, keeping the first occurrence. every
+// remaining entry yields a distinct passphrase token in every case mode
+static bool dedup(wordlist_t *list) {
+  size_t slots = 16;
+  while (slots < (size_t)list->count * 2)
+    slots <<= 1;
+  uint32_t *table = malloc(slots * sizeof(*table));
+  if (!table)
+    return false;
+  memset(table, 0xff, slots * sizeof(*table));
+
+  uint32_t kept = 0;
+  for (uint32_t i = 0; i < list->count; i++) {
+    wordlist_entry_t e = list->entries[i];
+    size_t slot = fold_hash(list->arena + e.offset, e.length) & (slots - 1);
+    for (;; slot = (slot + 1) & (slots - 1)) {
+      if (table[slot] == UINT32_MAX) {
+        table[slot] = kept;
+        list->entries[kept++] = e;
+        break;
+      }
+      if (same_word(list->arena, list->entries[table[slot]], e))
+        break;
+    }
+  }
+  free(table);
+  list->count = kept;
+  return true;
+}
+
+static void compute_stats(wordlist_t *list) {
+  list->max_length = 0;
+  list->cased = 0;
+  for (uint32_t i = 0; i < list->count; i++) {
+    wordlist_entry_t e = list->entries[i];
+    if (e.length > list->max_length)
+      list->max_length = e.length;
+    if (char_is_alpha(list->arena[e.offset]))
+      list->cased++;
+  }
+}
+
+// ============================================
+// Word lists
+// ============================================
+
+generator_error_t wordlist_from_buffer(wordlist_t *list, const char *data,
+                                       size_t size) {
+  if (!list || !data)
+    return GEN_ERROR_NULL_POINTER;
+  memset(list, 0, sizeof(*list));
+  if (size > UINT32_MAX)
+    return GEN_ERROR_FILE_ACCESS;
+
+  size_t count = scan_words(data, size, NULL);
+  if (count == 0)
+    return GEN_ERROR_NO_CHARSET;
+
+  list->entries = malloc(count * sizeof(*list->entries));
+  if (!list->entries)
+    return GEN_ERROR_NULL_POINTER;
+  list->arena = data;
+  list->arena_size = size;
+  list->count = (uint32_t)scan_words(data, size, list->entries);
+
+  if (!dedup(list)) {
+    free(list->entries);
+    memset(list, 0, sizeof(*list));
+    return GEN_ERROR_NULL_POINTER;
+  }
+  compute_stats(list);
+  return GEN_SUCCESS;
+}
+
+generator_error_t wordlist_load(wordlist_t *list, const char *path) {
+  if (!list || !path)
+    return GEN_ERROR_NULL_POINTER;
+  memset(list, 0, sizeof(*list));
+
+#ifndef _WIN32
+  int fd = open(path, O_RDONLY);
+  if (fd < 0)
+    return GEN_ERROR_FILE_ACCESS;
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+    close(fd);
+    return GEN_ERROR_FILE_ACCESS;
+  }
+  size_t size = (size_t)st.st_size;
+  void *map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED)
+    return GEN_ERROR_FILE_ACCESS;
+#else
+  FILE *fp = fopen(path, "rb");
+  if (!fp)
+    return GEN_ERROR_FILE_ACCESS;
+  fseek(fp, 0, SEEK_END);
+  long file_size = ftell(fp);
+  fseek(fp, 0, SEEK_SET);
+  if (file_size <= 0) {
+    fclose(fp);
+    return GEN_ERROR_FILE_ACCESS;
+  }
+  size_t size = (size_t)file_size;
+  void *map = malloc(size);
+  if (!map || fread(map, 1, size, fp) != size) {
+    free(map);
+    fclose(fp);
+    return GEN_ERROR_FILE_ACCESS;
+  }
+  fclose(fp);
+#endif
+
+  generator_error_t err = wordlist_from_buffer(list, map, size);
+  if (err != GEN_SUCCESS) {
+#ifndef _WIN32
+    munmap(map, size);
+#else
+    free(map);
+#endif
+    return err;
+  }
+  list->map = map;
+  list->map_size = size;
+  return GEN_SUCCESS;
+}
+
+void wordlist_free(wordlist_t *list) {
+  if (!list || list == &builtin)
+    return;
+  free(list->entries);
+  if (list->map) {
+#ifndef _WIN32
+    munmap(list->map, list->map_size);
+#else
+    free(list->map);
+#endif
+  }
+  memset(list, 0, sizeof(*list));
+}
+
+static void init_builtin(void) {
+  // known to be distinct and small, so no allocation is needed
+  builtin.arena = builtin_words;
+  builtin.arena_size = sizeof(builtin_words) - 1;
+  builtin.entries = builtin_entries;
+  builtin.count =
+      (uint32_t)scan_words(builtin_words, builtin.arena_size, builtin_entries);
+  compute_stats(&builtin);
+}
+
+#ifndef _WIN32
+static pthread_once_t builtin_once = PTHREAD_ONCE_INIT;
+#endif
+
+const wordlist_t *builtin_wordlist(void) {
+#ifndef _WIN32
+  pthread_once(&builtin_once, init_builtin);
+#else
+  if (builtin.count == 0)
+    init_builtin();
+#endif
+  return &builtin;
+}
+
+// ============================================
+// Generation
+// ============================================
+
+void init_passphrase_options(passphrase_options_t *opts) {
+  if (!opts)
+    return;
+  opts->word_count = 4;
+  opts->separator = "-";
+  opts->capitalization = PASSPHRASE_LOWER;
+  opts->digits = 0;
+  opts->words = NULL;
+}
+
+static const wordlist_t *options_words(const passphrase_options_t *opts) {
+  return opts->words ? opts->words : builtin_wordlist();
+}
+
+size_t passphrase_max_length(const passphrase_options_t *opts) {
+  if (!opts)
+    return 0;
+  const wordlist_t *list = options_words(opts);
+  size_t tokens = (size_t)opts->word_count + (opts->digits > 0 ? 1 : 0);
+  size_t separator = opts->separator ? strlen(opts->separator) : 0;
+  return (size_t)opts->word_count * list->max_length +
+         (tokens - 1) * separator + (size_t)opts->digits;
+}
+
+double passphrase_entropy(const passphrase_options_t *opts) {
+  if (!opts)
+    return 0.0;
+  const wordlist_t *list = options_words(opts);
+  if (list->count == 0)
+    return 0.0;
+
+  double per_word = log2((double)list->count);
+  // a coin flip per word, but only words starting with a letter change
+  if (opts->capitalization == PASSPHRASE_RANDOM_TITLE)
+    per_word += (double)list->cased / list->count;
+
+  double bits = opts->word_count * per_word;
+  if (opts->digits > 0)
+    bits += opts->digits * log2(10.0) + log2(opts->word_count + 1.0);
+  return bits;
+}
+
+// copy a word through the case mapping, returns the new cursor
+static char *put_word(char *p, const char *word, uint32_t len,
+                      passphrase_case_t mode, bool title) {
+  for (uint32_t i = 0; i < len; i++) {
+    char c = char_fold(word[i]);
+    if ((mode == PASSPHRASE_UPPER || (title && i == 0)) && char_is_lower(c))
+      c = (char)(c - 'a' + 'A');
+    p[i] = c;
+  }
+  return p + len;
+}
+
+generator_error_t generate_passphrase_ex(char *buffer, size_t buffer_size,
+                                         const passphrase_options_t *opts,
+                                         double *entropy) {
+  if (!buffer || !opts)
+    return GEN_ERROR_NULL_POINTER;
+  if (opts->word_count < 1 || opts->word_count > PASSPHRASE_MAX_WORDS ||
+      opts->digits < 0 || opts->digits > PASSPHRASE_MAX_DIGITS)
+    return GEN_ERROR_INVALID_LENGTH;
+
+  const char *separator = opts->separator ? opts->separator : "";
+  size_t separator_len = strlen(separator);
+  if (separator_len > PASSPHRASE_MAX_SEPARATOR)
+    return GEN_ERROR_INVALID_LENGTH;
+
+  const wordlist_t *list = options_words(opts);
+  if (list->count == 0)
+    return GEN_ERROR_NO_CHARSET;
+  if (buffer_size < passphrase_max_length(opts) + 1)
+    return GEN_ERROR_BUFFER_TOO_SMALL;
+
+  int words = opts->word_count;
+  uint32_t indices[PASSPHRASE_MAX_WORDS];
+  uint32_t titles[PASSPHRASE_MAX_WORDS] = {0};
+  uint32_t digits[PASSPHRASE_MAX_DIGITS];
+  uint32_t digits_at = UINT32_MAX;
+
+  generator_error_t err = random_indices(list->count, indices, words);
+  if (err == GEN_SUCCESS && opts->capitalization == PASSPHRASE_RANDOM_TITLE)
+    err = random_indices(2, titles, words);
+  if (err == GEN_SUCCESS && opts->digits > 0) {
+    err = random_indices(10, digits, opts->digits);
+    if (err == GEN_SUCCESS)
+      err = random_index((uint32_t)words + 1, &digits_at);
+  }
+
+  if (err == GEN_SUCCESS) {
+    // tokens go out in order through one cursor, the number (if any) takes
+    // slot digits_at among the words
+    char *p = buffer;
+    bool first = true;
+    for (int i = 0; i <= words; i++) {
+      if ((uint32_t)i == digits_at) {
+        if (!first) {
+          memcpy(p, separator, separator_len);
+          p += separator_len;
+        }
+        for (int d = 0; d < opts->digits; d++)
+          *p++ = (char)('0' + digits[d]);
+        first = false;
+      }
+      if (i == words)
+        break;
+
+      if (!first) {
+        memcpy(p, separator, separator_len);
+        p += separator_len;
+      }
+      wordlist_entry_t e = list->entries[indices[i]];
+      bool title = opts->capitalization == PASSPHRASE_TITLE || titles[i];
+      p = put_word(p, list->arena + e.offset, e.length, opts->capitalization,
+                   title);
+      first = false;
+    }
+    *p = '\0';
+
+    if (entropy)
+      *entropy = passphrase_entropy(opts);
+  }
+
+  secure_wipe(indices, sizeof(indices));
+  secure_wipe(titles, sizeof(titles));
+  secure_wipe(digits, sizeof(digits));
+  secure_wipe(&digits_at, sizeof(digits_at));
+  return err == GEN_SUCCESS ? GEN_SUCCESS : GEN_ERROR_RANDOM_FAILED;
+}
+
+// generate passphrase (multiple words)
+generator_error_t generate_passphrase(char *buffer, size_t buffer_size,
+                                      int word_count,
+                                      const generator_options_t *opts) {
+  if (!buffer)
+    return GEN_ERROR_NULL_POINTER;
+  if (word_count < 2 || word_count > PASSPHRASE_MAX_WORDS)
+    return GEN_ERROR_INVALID_LENGTH;
+
+  passphrase_options_t passphrase;
+  init_passphrase_options(&passphrase);
+  passphrase.word_count = word_count;
+
+  generator_error_t err =
+      generate_passphrase_ex(buffer, buffer_size, &passphrase, NULL);
+
+  // check if generated passphrase is too common, try once more
+  if (err == GEN_SUCCESS && opts && opts->check_common &&
+      is_common_password(buffer))
+    err = generate_passphrase_ex(buffer, buffer_size, &passphrase, NULL);
+
+  return err;
+}
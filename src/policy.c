@@ -1,7 +1,6 @@
 #include "clovo/policy.h"
 #include "clovo/analyzer.h"
 
-#include <ctype.h>
 #include <stdio.h>
 #include <string.h>
 
@@ -63,70 +62,205 @@ void init_policy(password_policy_t *policy, policy_type_t type) {
     policy->min_entropy = 0;
     break;
   }
+  policy->features = policy_features(policy);
 }
 
-policy_result_t validate_policy(const char *password,
-                                const password_policy_t *policy) {
-  policy_result_t result = {0};
+unsigned policy_features(const password_policy_t *policy) {
+  if (!policy)
+    return 0;
 
-  if (!password || !policy) {
-    result.passed = false;
-    strcpy(result.violations[result.violations_count++], "Invalid input");
-    return result;
-  }
+  // lengths and character classes come with every analysis
+  unsigned features = 0;
+  if (!policy->allow_sequential_patterns)
+    features |= ANALYZE_SEQUENTIAL;
+  if (!policy->allow_repeated_chars)
+    features |= ANALYZE_REPEATS;
+  if (!policy->allow_common_passwords)
+    features |= ANALYZE_DICTIONARY;
+  if (policy->min_entropy > 0)
+    features |= ANALYZE_ENTROPY;
+  return features;
+}
 
-  int len = strlen(password);
-  password_strength_t analysis = analyze_password(password);
+policy_verdict_t evaluate_policy(const char *password,
+                                 const password_policy_t *policy) {
+  if (!password || !policy)
+    return evaluate_policy_analysis(NULL, NULL);
 
-  // check length
-  if (policy->min_length > 0 && len < policy->min_length) {
-    snprintf(result.violations[result.violations_count++], 128,
-             "Password too short (minimum %d characters)", policy->min_length);
-  }
-  if (policy->max_length > 0 && len > policy->max_length) {
-    snprintf(result.violations[result.violations_count++], 128,
-             "Password too long (maximum %d characters)", policy->max_length);
-  }
+  password_strength_t analysis = analyze_password_ex(
+      password, strlen(password), policy->features | policy_features(policy));
+  return evaluate_policy_analysis(&analysis, policy);
+}
 
-  // check character requirements
-  if (policy->require_lowercase && !analysis.has_lower) {
-    strcpy(result.violations[result.violations_count++],
-           "Missing lowercase letters");
-  }
-  if (policy->require_uppercase && !analysis.has_upper) {
-    strcpy(result.violations[result.violations_count++],
-           "Missing uppercase letters");
-  }
-  if (policy->require_digits && !analysis.has_digit) {
-    strcpy(result.violations[result.violations_count++], "Missing digits");
-  }
-  if (policy->require_symbols && !analysis.has_symbol) {
-    strcpy(result.violations[result.violations_count++], "Missing symbols");
+policy_verdict_t evaluate_policy_analysis(const password_strength_t *analysis,
+                                          const password_policy_t *policy) {
+  policy_verdict_t verdict = {0};
+  if (!analysis || !policy) {
+    verdict.violations = (uint32_t)1 << POLICY_VIOLATION_INVALID;
+    return verdict;
   }
 
-  // check patterns
-  if (!policy->allow_sequential_patterns && analysis.has_sequential_pattern) {
-    strcpy(result.violations[result.violations_count++],
-           "Contains sequential patterns");
+  // lengths are in characters, not utf-8 bytes
+  int len = analysis->length;
+  verdict.length = len;
+  verdict.entropy = (float)analysis->entropy;
+
+  // each rule sets its bit without a branch
+  uint32_t v = 0;
+#define RULE(code, broken) v |= (uint32_t)(broken) << (code)
+  RULE(POLICY_VIOLATION_TOO_SHORT,
+       policy->min_length > 0 && len < policy->min_length);
+  RULE(POLICY_VIOLATION_TOO_LONG,
+       policy->max_length > 0 && len > policy->max_length);
+  RULE(POLICY_VIOLATION_LOWERCASE,
+       policy->require_lowercase && !analysis->has_lower);
+  RULE(POLICY_VIOLATION_UPPERCASE,
+       policy->require_uppercase && !analysis->has_upper);
+  RULE(POLICY_VIOLATION_DIGITS, policy->require_digits && !analysis->has_digit);
+  RULE(POLICY_VIOLATION_SYMBOLS,
+       policy->require_symbols && !analysis->has_symbol);
+  RULE(POLICY_VIOLATION_SEQUENTIAL, !policy->allow_sequential_patterns &&
+                                        analysis->has_sequential_pattern);
+  RULE(POLICY_VIOLATION_REPEATED,
+       !policy->allow_repeated_chars && analysis->has_repeated_chars);
+  RULE(POLICY_VIOLATION_COMMON, !policy->allow_common_passwords &&
+                                    analysis->contains_dictionary_word);
+  RULE(POLICY_VIOLATION_ENTROPY, policy->min_entropy > 0 &&
+                                     analysis->entropy < policy->min_entropy);
+#undef RULE
+  verdict.violations = v;
+  return verdict;
+}
+
+size_t policy_violation_message(const password_policy_t *policy,
+                                policy_violation_t violation, char *buffer,
+                                size_t size) {
+  int n;
+  switch (violation) {
+  case POLICY_VIOLATION_TOO_SHORT:
+    n = snprintf(buffer, size, "Password too short (minimum %d characters)",
+                 policy ? policy->min_length : 0);
+    break;
+  case POLICY_VIOLATION_TOO_LONG:
+    n = snprintf(buffer, size, "Password too long (maximum %d characters)",
+                 policy ? policy->max_length : 0);
+    break;
+  case POLICY_VIOLATION_LOWERCASE:
+    n = snprintf(buffer, size, "Missing lowercase letters");
+    break;
+  case POLICY_VIOLATION_UPPERCASE:
+    n = snprintf(buffer, size, "Missing uppercase letters");
+    break;
+  case POLICY_VIOLATION_DIGITS:
+    n = snprintf(buffer, size, "Missing digits");
+    break;
+  case POLICY_VIOLATION_SYMBOLS:
+    n = snprintf(buffer, size, "Missing symbols");
+    break;
+  case POLICY_VIOLATION_SEQUENTIAL:
+    n = snprintf(buffer, size, "Contains sequential patterns");
+    break;
+  case POLICY_VIOLATION_REPEATED:
+    n = snprintf(buffer, size, "Contains repeated characters");
+    break;
+  case POLICY_VIOLATION_COMMON:
+    n = snprintf(buffer, size, "Contains common dictionary word");
+    break;
+  case POLICY_VIOLATION_ENTROPY:
+    n = snprintf(buffer, size, "Entropy too low (minimum %.1f bits)",
+                 (double)(policy ? policy->min_entropy : 0));
+    break;
+  case POLICY_VIOLATION_REPEAT_RUN:
+    n = snprintf(buffer, size, "Same character repeated too many times");
+    break;
+  case POLICY_VIOLATION_BANNED:
+    n = snprintf(buffer, size, "Contains a banned word");
+    break;
+  default:
+    n = snprintf(buffer, size, "Invalid input");
+    break;
   }
-  if (!policy->allow_repeated_chars && analysis.has_repeated_chars) {
-    strcpy(result.violations[result.violations_count++],
-           "Contains repeated characters");
+  return n > 0 ? (size_t)n : 0;
+}
+
+policy_result_t policy_verdict_to_result(const policy_verdict_t *verdict,
+                                         const password_policy_t *policy) {
+  policy_result_t result = {0};
+  uint32_t violations =
+      verdict ? verdict->violations : (uint32_t)1 << POLICY_VIOLATION_INVALID;
+  int max = (int)(sizeof(result.violations) / sizeof(result.violations[0]));
+
+  for (int v = 0; v < POLICY_VIOLATION_COUNT && result.violations_count < max;
+       v++) {
+    if (violations & ((uint32_t)1 << v))
+      policy_violation_message(policy, (policy_violation_t)v,
+                               result.violations[result.violations_count++],
+                               sizeof(result.violations[0]));
   }
-  if (!policy->allow_common_passwords && analysis.contains_dictionary_word) {
-    strcpy(result.violations[result.violations_count++],
-           "Contains common dictionary word");
+  result.passed = violations == 0;
+  return result;
+}
+
+policy_result_t validate_policy(const char *password,
+                                const password_policy_t *policy) {
+  policy_verdict_t verdict = evaluate_policy(password, policy);
+  return policy_verdict_to_result(&verdict, policy);
+}
+
+policy_result_t validate_policy_analysis(const password_strength_t *analysis,
+                                         const password_policy_t *policy) {
+  policy_verdict_t verdict = evaluate_policy_analysis(analysis, policy);
+  return policy_verdict_to_result(&verdict, policy);
+}
+
+uint32_t validate_policies(const char *password,
+                           const password_policy_t *policies, size_t count,
+                           policy_result_t *details) {
+  if (count > POLICY_SET_MAX)
+    count = POLICY_SET_MAX;
+  if (!password || (!policies && count > 0)) {
+    for (size_t i = 0; details && i < count; i++)
+      details[i] = validate_policy_analysis(NULL, NULL);
+    return 0;
   }
 
-  // check entropy
-  if (policy->min_entropy > 0 && analysis.entropy < policy->min_entropy) {
-    snprintf(result.violations[result.violations_count++], 128,
-             "Entropy too low (minimum %.1f bits)",
-             (double)policy->min_entropy);
+  // one analysis covering every policy's rules
+  unsigned features = 0;
+  for (size_t i = 0; i < count; i++)
+    features |= policies[i].features | policy_features(&policies[i]);
+  password_strength_t analysis =
+      analyze_password_ex(password, strlen(password), features);
+
+  uint32_t passed = 0;
+  for (size_t i = 0; i < count; i++) {
+    policy_verdict_t verdict =
+        evaluate_policy_analysis(&analysis, &policies[i]);
+    if (details)
+      details[i] = policy_verdict_to_result(&verdict, &policies[i]);
+    if (verdict.violations == 0)
+      passed |= (uint32_t)1 << i;
   }
+  return passed;
+}
 
-  result.passed = (result.violations_count == 0);
-  return result;
+const char *policy_violation_name(policy_violation_t violation) {
+  static const char *const names[POLICY_VIOLATION_COUNT] = {
+      [POLICY_VIOLATION_TOO_SHORT] = "too_short",
+      [POLICY_VIOLATION_TOO_LONG] = "too_long",
+      [POLICY_VIOLATION_LOWERCASE] = "lowercase",
+      [POLICY_VIOLATION_UPPERCASE] = "uppercase",
+      [POLICY_VIOLATION_DIGITS] = "digits",
+      [POLICY_VIOLATION_SYMBOLS] = "symbols",
+      [POLICY_VIOLATION_SEQUENTIAL] = "sequential",
+      [POLICY_VIOLATION_REPEATED] = "repeated",
+      [POLICY_VIOLATION_COMMON] = "common",
+      [POLICY_VIOLATION_ENTROPY] = "entropy",
+      [POLICY_VIOLATION_REPEAT_RUN] = "repeat_run",
+      [POLICY_VIOLATION_BANNED] = "banned",
+      [POLICY_VIOLATION_INVALID] = "invalid",
+  };
+  return (unsigned)violation < POLICY_VIOLATION_COUNT ? names[violation]
+                                                      : "unknown";
 }
 
 const char *policy_type_to_string(policy_type_t type) {
@@ -0,0 +1,283 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "clovo/pool.h"
+#include "clovo/drbg.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// how long the refill thread sleeps before re-checking the fill level on
+// its own, bounds the delay if a wake-up signal is missed
+#define REFILL_POLL_NS 50000000L
+
+// slot i is free for the producer when seq == position and holds a password
+// for consumers when seq == position + 1 (a bounded mpmc queue in the style
+// of dmitry vyukov's, with a single producer)
+typedef struct {
+  atomic_size_t seq;
+  password_strength_t analysis;
+  char password[POOL_MAX_LENGTH + 1];
+} pool_slot_t;
+
+struct password_pool {
+  pool_slot_t *slots;
+  size_t mask;
+  size_t low_water;
+  size_t length;
+  generator_options_t opts;
+  password_policy_t policy;
+  bool has_policy;
+
+  // consumers and the producer each get their own cache line
+  _Alignas(64) atomic_size_t head; // next slot to take
+  _Alignas(64) atomic_size_t tail; // next slot to fill, refill thread only
+
+  atomic_uint_fast64_t issued;
+  atomic_uint_fast64_t generated;
+  atomic_uint_fast64_t empty;
+
+  pthread_t thread;
+  pthread_mutex_t lock;
+  pthread_cond_t wake;
+  atomic_bool stop;
+};
+
+// ============================================
+// Ring
+// ============================================
+
+static size_t ring_available(password_pool_t *pool) {
+  size_t tail = atomic_load_explicit(&pool->tail, memory_order_acquire);
+  size_t head = atomic_load_explicit(&pool->head, memory_order_acquire);
+  return tail > head ? tail - head : 0;
+}
+
+static generator_error_t make_password(password_pool_t *pool, char *out,
+                                       password_strength_t *analysis) {
+  generator_error_t err =
+      pool->has_policy
+          ? generate_password_for_policy(out, POOL_MAX_LENGTH + 1,
+                                         pool->length, &pool->policy,
+                                         &pool->opts, NULL)
+          : generate_password(out, POOL_MAX_LENGTH + 1, pool->length,
+                              &pool->opts);
+  if (err == GEN_SUCCESS && analysis)
+    *analysis = analyze_password(out);
+  return err;
+}
+
+// fill the next slot, false when the ring is full or generation failed
+static bool ring_push(password_pool_t *pool) {
+  size_t pos = atomic_load_explicit(&pool->tail, memory_order_relaxed);
+  pool_slot_t *slot = &pool->slots[pos & pool->mask];
+  if (atomic_load_explicit(&slot->seq, memory_order_acquire) != pos)
+    return false; // a consumer hasn't released it yet
+
+  if (make_password(pool, slot->password, &slot->analysis) != GEN_SUCCESS)
+    return false;
+
+  atomic_store_explicit(&slot->seq, pos + 1, memory_order_release);
+  atomic_store_explicit(&pool->tail, pos + 1, memory_order_release);
+  atomic_fetch_add_explicit(&pool->generated, 1, memory_order_relaxed);
+  return true;
+}
+
+// take the oldest password, false when the ring is empty
+static bool ring_pop(password_pool_t *pool, char *buffer,
+                     password_strength_t *analysis) {
+  size_t pos = atomic_load_explicit(&pool->head, memory_order_relaxed);
+  pool_slot_t *slot;
+  for (;;) {
+    slot = &pool->slots[pos & pool->mask];
+    size_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+    if (seq == pos + 1) {
+      // the one atomic that hands the slot to this caller
+      if (atomic_compare_exchange_weak_explicit(&pool->head, &pos, pos + 1,
+                                                memory_order_relaxed,
+                                                memory_order_relaxed))
+        break;
+    } else if (seq < pos + 1) {
+      return false;
+    } else {
+      pos = atomic_load_explicit(&pool->head, memory_order_relaxed);
+    }
+  }
+
+  memcpy(buffer, slot->password, pool->length + 1);
+  if (analysis)
+    *analysis = slot->analysis;
+  secure_wipe(slot->password, sizeof(slot->password));
+  secure_wipe(&slot->analysis, sizeof(slot->analysis));
+
+  // free for the producer's next lap around the ring
+  atomic_store_explicit(&slot->seq, pos + pool->mask + 1,
+                        memory_order_release);
+  return true;
+}
+
+// ============================================
+// Refill thread
+// ============================================
+
+static void *refill_thread(void *arg) {
+  password_pool_t *pool = arg;
+
+  while (!atomic_load(&pool->stop)) {
+    while (!atomic_load(&pool->stop) && ring_push(pool))
+      ;
+
+    pthread_mutex_lock(&pool->lock);
+    while (!atomic_load(&pool->stop) &&
+           ring_available(pool) >= pool->low_water) {
+      struct timespec until;
+      clock_gettime(CLOCK_REALTIME, &until);
+      until.tv_nsec += REFILL_POLL_NS;
+      if (until.tv_nsec >= 1000000000L) {
+        until.tv_sec++;
+        until.tv_nsec -= 1000000000L;
+      }
+      pthread_cond_timedwait(&pool->wake, &pool->lock, &until);
+    }
+    pthread_mutex_unlock(&pool->lock);
+  }
+
+  drbg_clear();
+  return NULL;
+}
+
+// ============================================
+// Public API
+// ============================================
+
+void init_pool_options(pool_options_t *options) {
+  if (!options)
+    return;
+  options->capacity = POOL_DEFAULT_CAPACITY;
+  options->low_water = 0;
+  options->length = 16;
+  options->opts = NULL;
+  options->policy = NULL;
+}
+
+password_pool_t *password_pool_create(const pool_options_t *options) {
+  if (!options || options->length == 0 ||
+      options->length > POOL_MAX_LENGTH)
+    return NULL;
+
+  // sizeof is a multiple of the 64-byte member alignment
+  password_pool_t *pool = aligned_alloc(_Alignof(password_pool_t),
+                                        sizeof(*pool));
+  if (!pool)
+    return NULL;
+  memset(pool, 0, sizeof(*pool));
+
+  size_t capacity = 2;
+  while (capacity < options->capacity)
+    capacity <<= 1;
+  pool->slots = calloc(capacity, sizeof(*pool->slots));
+  if (!pool->slots) {
+    free(pool);
+    return NULL;
+  }
+  for (size_t i = 0; i < capacity; i++)
+    atomic_init(&pool->slots[i].seq, i);
+
+  pool->mask = capacity - 1;
+  pool->low_water = options->low_water ? options->low_water : capacity / 4;
+  if (pool->low_water > capacity)
+    pool->low_water = capacity;
+  pool->length = options->length;
+  if (options->opts)
+    pool->opts = *options->opts;
+  else
+    init_generator_options(&pool->opts);
+  if (options->policy) {
+    pool->policy = *options->policy;
+    pool->has_policy = true;
+  }
+  atomic_init(&pool->head, 0);
+  atomic_init(&pool->tail, 0);
+  atomic_init(&pool->issued, 0);
+  atomic_init(&pool->generated, 0);
+  atomic_init(&pool->empty, 0);
+  atomic_init(&pool->stop, false);
+
+  // reject options that can't produce a password before starting the thread
+  char probe[POOL_MAX_LENGTH + 1];
+  generator_error_t err = make_password(pool, probe, NULL);
+  secure_wipe(probe, sizeof(probe));
+
+  pthread_mutex_init(&pool->lock, NULL);
+  pthread_cond_init(&pool->wake, NULL);
+  if (err != GEN_SUCCESS ||
+      pthread_create(&pool->thread, NULL, refill_thread, pool) != 0) {
+    pthread_cond_destroy(&pool->wake);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool->slots);
+    free(pool);
+    return NULL;
+  }
+  return pool;
+}
+
+void password_pool_destroy(password_pool_t *pool) {
+  if (!pool)
+    return;
+
+  pthread_mutex_lock(&pool->lock);
+  atomic_store(&pool->stop, true);
+  pthread_cond_signal(&pool->wake);
+  pthread_mutex_unlock(&pool->lock);
+  pthread_join(pool->thread, NULL);
+
+  secure_wipe(pool->slots, (pool->mask + 1) * sizeof(*pool->slots));
+  secure_wipe(&pool->opts, sizeof(pool->opts));
+  pthread_cond_destroy(&pool->wake);
+  pthread_mutex_destroy(&pool->lock);
+  free(pool->slots);
+  free(pool);
+}
+
+generator_error_t password_pool_take(password_pool_t *pool, char *buffer,
+                                     size_t buffer_size,
+                                     password_strength_t *analysis) {
+  if (!pool || !buffer)
+    return GEN_ERROR_NULL_POINTER;
+  if (buffer_size < pool->length + 1)
+    return GEN_ERROR_BUFFER_TOO_SMALL;
+
+  generator_error_t err = GEN_SUCCESS;
+  if (!ring_pop(pool, buffer, analysis)) {
+    // drained faster than the thread refills, pay the generation cost here
+    atomic_fetch_add_explicit(&pool->empty, 1, memory_order_relaxed);
+    char fresh[POOL_MAX_LENGTH + 1];
+    err = make_password(pool, fresh, analysis);
+    if (err == GEN_SUCCESS)
+      memcpy(buffer, fresh, pool->length + 1);
+    secure_wipe(fresh, sizeof(fresh));
+  }
+  if (err == GEN_SUCCESS)
+    atomic_fetch_add_explicit(&pool->issued, 1, memory_order_relaxed);
+
+  // no lock here: a signal lost to a thread about to wait only delays the
+  // refill until its next poll
+  if (ring_available(pool) < pool->low_water)
+    pthread_cond_signal(&pool->wake);
+  return err;
+}
+
+pool_stats_t password_pool_stats(password_pool_t *pool) {
+  pool_stats_t stats = {0};
+  if (!pool)
+    return stats;
+  stats.issued = atomic_load(&pool->issued);
+  stats.generated = atomic_load(&pool->generated);
+  stats.empty = atomic_load(&pool->empty);
+  stats.available = ring_available(pool);
+  stats.capacity = pool->mask + 1;
+  return stats;
+}
@@ -0,0 +1,161 @@
+#include "clovo/sampler.h"
+#include "clovo/drbg.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+// range^k is kept at or below 2^BATCH_BITS. a word is rejected with
+// probability (2^64 mod range^k) / 2^64 < range^k / 2^64, so this keeps
+// rejections under 1 in 256 while still packing e.g. 8 indices of a
+// 94-character charset into each word
+#define BATCH_BITS 56
+#define MAX_BATCH BATCH_BITS
+// words fetched from the drbg per call, enough for a 256 character password
+// over a 2-symbol charset
+#define WORD_BLOCK 32
+
+// full 128-bit product of two 64-bit words
+static inline uint64_t mul64(uint64_t a, uint64_t b, uint64_t *lo) {
+#ifdef __SIZEOF_INT128__
+  unsigned __int128 m = (unsigned __int128)a * b;
+  *lo = (uint64_t)m;
+  return (uint64_t)(m >> 64);
+#else
+  uint64_t a_lo = (uint32_t)a, a_hi = a >> 32;
+  uint64_t b_lo = (uint32_t)b, b_hi = b >> 32;
+  uint64_t ll = a_lo * b_lo, lh = a_lo * b_hi;
+  uint64_t hl = a_hi * b_lo, hh = a_hi * b_hi;
+  uint64_t mid = (ll >> 32) + (uint32_t)lh + (uint32_t)hl;
+  *lo = (mid << 32) | (uint32_t)ll;
+  return hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+#endif
+}
+
+// k and range^k for the range, range >= 2
+static int batch(uint32_t range, uint64_t *product) {
+  const uint64_t limit = (uint64_t)1 << BATCH_BITS;
+  int k = 1;
+  uint64_t p = range;
+  while (p <= limit / range) {
+    p *= range;
+    k++;
+  }
+  *product = p;
+  return k;
+}
+
+int sampler_batch_size(uint32_t range) {
+  uint64_t product;
+  return range < 2 ? MAX_BATCH : batch(range, &product);
+}
+
+size_t indices_from_words(uint32_t range, const uint64_t *words,
+                          size_t word_count, uint32_t *out, size_t n) {
+  if (!words || !out || range == 0)
+    return 0;
+  if (range == 1) {
+    memset(out, 0, n * sizeof(*out));
+    return n;
+  }
+
+  uint64_t product;
+  int k = batch(range, &product);
+  // 2^64 mod range^k, only computed once a word lands close enough to need
+  // it
+  uint64_t threshold = 0;
+  bool have_threshold = false;
+
+  size_t filled = 0;
+  uint32_t idx[MAX_BATCH];
+  for (size_t w = 0; w < word_count && filled < n; w++) {
+    uint64_t low = words[w];
+    for (int j = 0; j < k; j++)
+      idx[j] = (uint32_t)mul64(low, range, &low);
+
+    // the k indices are uniform over range^k unless low is in the short
+    // leftover interval, which happens with probability < range^k / 2^64
+    if (low < product) {
+      if (!have_threshold) {
+        threshold = (0 - product) % product;
+        have_threshold = true;
+      }
+      if (low < threshold)
+        continue;
+    }
+
+    size_t take = n - filled < (size_t)k ? n - filled : (size_t)k;
+    memcpy(out + filled, idx, take * sizeof(*out));
+    filled += take;
+  }
+  secure_wipe(idx, (size_t)k * sizeof(*idx));
+  return filled;
+}
+
+generator_error_t random_indices(uint32_t range, uint32_t *out, size_t n) {
+  if (!out)
+    return GEN_ERROR_NULL_POINTER;
+  if (range == 0)
+    return GEN_ERROR_NO_CHARSET;
+
+  int k = sampler_batch_size(range);
+  uint64_t words[WORD_BLOCK];
+  size_t used = 0; // most words held at once, all that needs wiping
+  generator_error_t err = GEN_SUCCESS;
+  size_t filled = 0;
+  while (filled < n) {
+    size_t want = (n - filled + (size_t)k - 1) / (size_t)k;
+    if (want > WORD_BLOCK)
+      want = WORD_BLOCK;
+    if (want > used)
+      used = want;
+    err = drbg_random_bytes(words, want * sizeof(*words));
+    if (err != GEN_SUCCESS)
+      break;
+    filled += indices_from_words(range, words, want, out + filled, n - filled);
+  }
+  secure_wipe(words, used * sizeof(*words));
+  return err;
+}
+
+generator_error_t random_index(uint32_t range, uint32_t *out) {
+  return random_indices(range, out, 1);
+}
+
+generator_error_t random_shuffle(char *items, size_t n) {
+  if (!items)
+    return GEN_ERROR_NULL_POINTER;
+  if (n > UINT32_MAX)
+    return GEN_ERROR_INVALID_LENGTH;
+
+  uint32_t words[2 * WORD_BLOCK];
+  size_t available = 0, next = 0, used = 0;
+  generator_error_t err = GEN_SUCCESS;
+
+  for (size_t i = n; i > 1 && err == GEN_SUCCESS; i--) {
+    uint32_t range = (uint32_t)i;
+    for (;;) {
+      if (next == available) {
+        // one word per remaining swap, rejections refill
+        available = i - 1 < 2 * WORD_BLOCK ? i - 1 : 2 * WORD_BLOCK;
+        next = 0;
+        if (available > used)
+          used = available;
+        err = drbg_random_bytes(words, available * sizeof(*words));
+        if (err != GEN_SUCCESS)
+          break;
+      }
+      uint64_t m = (uint64_t)words[next++] * range;
+      uint32_t low = (uint32_t)m;
+      if (low < range && low < (0 - range) % range)
+        continue;
+
+      size_t j = (size_t)(m >> 32);
+      char tmp = items[i - 1];
+      items[i - 1] = items[j];
+      items[j] = tmp;
+      break;
+    }
+  }
+  secure_wipe(words, used * sizeof(*words));
+  return err;
+}
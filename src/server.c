@@ -0,0 +1,918 @@
+#define _GNU_SOURCE // accept4, memrchr
+
+#include "clovo/server.h"
+#include "clovo/analyzer.h"
+#include "clovo/batch.h"
+#include "clovo/comparison.h"
+#include "clovo/export.h"
+#include "clovo/http.h"
+#include "clovo/policy.h"
+#include "clovo/pool.h"
+
+#include <errno.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#define DEFAULT_MAX_CONNECTIONS 1024
+#define MAX_THREADS 256
+#define MAX_EVENTS 256
+
+// input a connection can have buffered, several pipelined requests
+#define INPUT_SIZE (4 * SERVER_MAX_REQUEST)
+
+// longest answer to one request, an analysis with every field
+#define RESPONSE_MAX 2048
+
+// room for the status line and headers of an http answer
+#define HTTP_HEAD_MAX 128
+
+// what "generate" with no length gives, straight from the pool
+#define GENERATE_DEFAULT_LENGTH 16
+
+// a client socket. while busy, a worker owns in[0..job_end) and out and
+// the event loop leaves the connection alone
+typedef struct connection {
+  int fd; // -1 while the slot is free
+  bool busy;
+  bool eof;    // the client won't send anything more
+  bool broken; // reading or writing failed, close without answering
+  bool hangup; // close once answered, set by a worker
+  char *in;    // INPUT_SIZE bytes, kept with the slot
+  size_t in_used;
+  size_t job_end;
+  batch_output_t out;
+  size_t out_sent;
+  struct connection *next; // on the job queue, the done list or free
+} connection_t;
+
+struct server {
+  server_options_t options;
+  char socket_path[sizeof(((struct sockaddr_un *)0)->sun_path)];
+  int port; // -1 on a unix socket
+  int listen_fd;
+  int epoll_fd;
+  int wake_fd; // eventfd, a job is done or the server should stop
+  atomic_bool stopping;
+
+  password_policy_t builtin[POLICY_BASIC + 1]; // by policy_type_t
+  password_pool_t *pool;
+
+  connection_t *connections;
+  char *input; // every connection's input buffer, one block
+  connection_t *free_list;
+  connection_t *closed; // freed once the events at hand are handled
+
+  pthread_mutex_t lock; // guards jobs, done and quit
+  pthread_cond_t work;
+  connection_t *jobs;
+  connection_t *jobs_tail;
+  connection_t *done;
+  bool quit;
+  pthread_t workers[MAX_THREADS];
+  int worker_count;
+};
+
+static const struct {
+  const char *name;
+  policy_type_t type;
+} builtin_names[] = {{"nist", POLICY_NIST},
+                     {"pci", POLICY_PCI_DSS},
+                     {"pci-dss", POLICY_PCI_DSS},
+                     {"basic", POLICY_BASIC}};
+
+// an answer being written: json text in data[0..size) and, for http, its
+// status. what doesn't fit is counted in used but not written
+typedef struct {
+  char *data;
+  size_t size;
+  size_t used;
+  int status;
+} reply_t;
+
+static void reply_printf(reply_t *reply, const char *format, ...) {
+  size_t room = reply->used < reply->size ? reply->size - reply->used : 0;
+  va_list args;
+  va_start(args, format);
+  int n = vsnprintf(room ? reply->data + reply->used : NULL, room, format,
+                    args);
+  va_end(args);
+  reply->used += n > 0 ? (size_t)n : 0;
+}
+
+static void reply_string(reply_t *reply, const char *text) {
+  size_t room = reply->used < reply->size ? reply->size - reply->used : 0;
+  reply->used += export_json_string(
+      text, room ? reply->data + reply->used : NULL, room);
+}
+
+// replace whatever was written with {"error":message}
+static void reply_error(reply_t *reply, int status, const char *message) {
+  reply->used = 0;
+  reply->status = status;
+  reply_printf(reply, "{\"error\":");
+  reply_string(reply, message);
+  reply_printf(reply, "}");
+}
+
+static void answer_analyze(const char *password, reply_t *reply) {
+  password_strength_t analysis = analyze_password(password);
+  size_t room = reply->size - reply->used;
+  reply->used +=
+      export_analysis_json(&analysis, reply->data + reply->used, room);
+  secure_wipe(&analysis, sizeof(analysis));
+}
+
+static void answer_policy(server_t *server, const char *name,
+                          const char *password, reply_t *reply) {
+  const password_policy_t *policy = NULL;
+  const custom_policy_t *custom = NULL;
+  const char *label = NULL;
+  for (size_t i = 0; i < sizeof(builtin_names) / sizeof(builtin_names[0]);
+       i++) {
+    if (strcmp(name, builtin_names[i].name) == 0) {
+      policy = &server->builtin[builtin_names[i].type];
+      label = policy_type_to_string(builtin_names[i].type);
+    }
+  }
+  if (!policy) {
+    custom = policy_set_find(server->options.custom, name);
+    if (!custom) {
+      reply_error(reply, 404, "unknown policy");
+      return;
+    }
+    label = custom_policy_name(custom);
+  }
+
+  uint32_t violations =
+      custom ? custom_policy_check(custom, password, strlen(password), NULL)
+             : evaluate_policy(password, policy).violations;
+
+  reply_printf(reply, "{\"policy\":");
+  reply_string(reply, label);
+  reply_printf(reply, ",\"passed\":%s,\"violations\":[",
+               violations ? "false" : "true");
+  const char *separator = "";
+  for (int v = 0; v < POLICY_VIOLATION_COUNT; v++) {
+    if (!(violations & ((uint32_t)1 << v)))
+      continue;
+    reply_printf(reply, "%s\"%s\"", separator,
+                 policy_violation_name((policy_violation_t)v));
+    separator = ",";
+  }
+  reply_printf(reply, "]}");
+}
+
+// length as text, empty for the default
+static void answer_generate(server_t *server, const char *length_text,
+                            reply_t *reply) {
+  long length = GENERATE_DEFAULT_LENGTH;
+  if (*length_text != '\0') {
+    char *end;
+    length = strtol(length_text, &end, 10);
+    if (*end != '\0' || length <= 0 || length > POOL_MAX_LENGTH) {
+      reply_error(reply, 400, "length must be a number from 1 to 256");
+      return;
+    }
+  }
+
+  char password[POOL_MAX_LENGTH + 1];
+  generator_error_t err;
+  if (length == GENERATE_DEFAULT_LENGTH) {
+    err = password_pool_take(server->pool, password, sizeof(password), NULL);
+  } else {
+    generator_options_t opts;
+    init_generator_options(&opts);
+    err = generate_password(password, sizeof(password), (size_t)length,
+                            &opts);
+  }
+  if (err != GEN_SUCCESS) {
+    reply_error(reply, 400, generator_error_string(err));
+    return;
+  }
+
+  reply_printf(reply, "{\"password\":");
+  reply_string(reply, password);
+  reply_printf(reply, "}");
+  secure_wipe(password, sizeof(password));
+}
+
+static void answer_compare(const char *old_pw, const char *new_pw,
+                           reply_t *reply) {
+  similarity_result_t result = compare_passwords(old_pw, new_pw);
+  reply_printf(
+      reply, "{\"similarity\":%.4f,\"edit_distance\":%d,\"too_similar\":%s}",
+      result.similarity_score, result.edit_distance,
+      result.is_similar ? "true" : "false");
+}
+
+// answer one request line (NUL-terminated, no newline)
+static void answer_line(server_t *server, char *line, reply_t *reply) {
+  char *args = strchr(line, ' ');
+  if (args)
+    *args++ = '\0';
+  else
+    args = line + strlen(line);
+
+  if (strcmp(line, "analyze") == 0) {
+    if (*args == '\0')
+      reply_error(reply, 400, "usage: analyze <password>");
+    else
+      answer_analyze(args, reply);
+  } else if (strcmp(line, "policy") == 0) {
+    char *password = strchr(args, ' ');
+    if (!password || password == args) {
+      reply_error(reply, 400, "usage: policy <name> <password>");
+      return;
+    }
+    *password++ = '\0';
+    answer_policy(server, args, password, reply);
+  } else if (strcmp(line, "generate") == 0) {
+    answer_generate(server, args, reply);
+  } else if (strcmp(line, "compare") == 0) {
+    char *new_pw = strchr(args, '\t');
+    if (!new_pw) {
+      reply_error(reply, 400, "usage: compare <old>\\t<new>");
+      return;
+    }
+    *new_pw++ = '\0';
+    answer_compare(args, new_pw, reply);
+  } else if (strcmp(line, "ping") == 0 && *args == '\0') {
+    reply_printf(reply, "{\"ok\":true}");
+  } else {
+    reply_error(reply, 400, "unknown request");
+  }
+}
+
+// room for the next answer at the end of conn's output, false when out of
+// memory
+static bool start_reply(connection_t *conn, reply_t *reply, size_t skip) {
+  if (!batch_output_reserve(&conn->out, skip + RESPONSE_MAX)) {
+    conn->broken = true;
+    return false;
+  }
+  reply->data = conn->out.data + conn->out.used + skip;
+  reply->size = RESPONSE_MAX;
+  reply->used = 0;
+  reply->status = 200;
+  return true;
+}
+
+// answer every line of the job, on a worker
+static void run_line_job(server_t *server, connection_t *conn) {
+  char *line = conn->in;
+  char *end = conn->in + conn->job_end;
+  while (line < end) {
+    char *newline = memchr(line, '\n', (size_t)(end - line));
+    size_t len = (size_t)(newline - line);
+    *newline = '\0';
+    if (len > 0 && line[len - 1] == '\r')
+      line[--len] = '\0';
+
+    reply_t reply;
+    if (len > 0) {
+      if (!start_reply(conn, &reply, 0))
+        return;
+      // one byte is kept for the newline
+      reply.size--;
+      if (len + 1 > SERVER_MAX_REQUEST)
+        reply_error(&reply, 400, "request too long");
+      else
+        answer_line(server, line, &reply);
+      if (reply.used >= reply.size)
+        reply_error(&reply, 500, "response too long");
+      reply.data[reply.used++] = '\n';
+      conn->out.used += reply.used;
+    }
+    line = newline + 1;
+  }
+}
+
+// answer one http request, its fields decoded into values
+static void answer_http(server_t *server, const http_request_t *request,
+                        char (*values)[SERVER_MAX_REQUEST], reply_t *reply) {
+  static const char *const endpoints[] = {"/analyze", "/policy", "/generate",
+                                          "/compare"};
+  http_json_field_t fields[2] = {
+      {.value = values[0], .size = SERVER_MAX_REQUEST},
+      {.value = values[1], .size = SERVER_MAX_REQUEST}};
+  int endpoint = -1;
+  for (int i = 0; i < 4; i++) {
+    if (request->path_len == strlen(endpoints[i]) &&
+        memcmp(request->path, endpoints[i], request->path_len) == 0)
+      endpoint = i;
+  }
+  if (endpoint < 0) {
+    reply_error(reply, 404, "no such endpoint");
+    return;
+  }
+  // generate takes no body when it's a get
+  if (endpoint == 2 && http_request_is(request, "GET", "/generate")) {
+    answer_generate(server, "", reply);
+    return;
+  }
+  if (!http_request_is(request, "POST", endpoints[endpoint])) {
+    reply_error(reply, 405, "method not allowed");
+    return;
+  }
+
+  static const char *const names[][2] = {{"password", NULL},
+                                         {"policy", "password"},
+                                         {"length", NULL},
+                                         {"old", "new"}};
+  size_t count = names[endpoint][1] ? 2 : 1;
+  fields[0].name = names[endpoint][0];
+  fields[1].name = names[endpoint][1];
+  bool generate = endpoint == 2;
+  if (!(generate && request->body_len == 0) &&
+      !http_json_fields(request->body, request->body_len, fields, count)) {
+    reply_error(reply, 400, "body must be a flat json object");
+    return;
+  }
+  if (generate) {
+    answer_generate(server, fields[0].found ? fields[0].value : "", reply);
+    return;
+  }
+  if (!fields[0].found || (count == 2 && !fields[1].found)) {
+    reply_error(reply, 400,
+                endpoint == 0   ? "expected {\"password\":..}"
+                : endpoint == 1 ? "expected {\"policy\":..,\"password\":..}"
+                                : "expected {\"old\":..,\"new\":..}");
+    return;
+  }
+  if (endpoint == 0)
+    answer_analyze(values[0], reply);
+  else if (endpoint == 1)
+    answer_policy(server, values[0], values[1], reply);
+  else
+    answer_compare(values[0], values[1], reply);
+}
+
+// the status line and headers go in front of the body, which was written
+// HTTP_HEAD_MAX bytes further on
+static void finish_http_reply(connection_t *conn, reply_t *reply,
+                              bool keep_alive) {
+  char *head = conn->out.data + conn->out.used;
+  size_t head_len = http_response_head(head, HTTP_HEAD_MAX, reply->status,
+                                       reply->used, keep_alive);
+  memmove(head + head_len, reply->data, reply->used);
+  conn->out.used += head_len + reply->used;
+}
+
+// answer every request of the job, on a worker. one that asks to close the
+// connection is the last one answered
+static void run_http_job(server_t *server, connection_t *conn) {
+  char values[2][SERVER_MAX_REQUEST];
+  size_t offset = 0;
+  while (offset < conn->job_end) {
+    http_request_t request;
+    if (http_parse_request(conn->in + offset, conn->job_end - offset,
+                           SERVER_MAX_REQUEST, &request) != HTTP_COMPLETE)
+      break; // framed on the event loop, can't happen
+    offset += request.length;
+
+    reply_t reply;
+    if (!start_reply(conn, &reply, HTTP_HEAD_MAX))
+      break;
+    answer_http(server, &request, values, &reply);
+    if (reply.used >= reply.size)
+      reply_error(&reply, 500, "response too long");
+    finish_http_reply(conn, &reply, request.keep_alive);
+    if (!request.keep_alive) {
+      conn->hangup = true;
+      break;
+    }
+  }
+  secure_wipe(values, sizeof(values));
+}
+
+static void *server_worker(void *arg) {
+  server_t *server = arg;
+  for (;;) {
+    pthread_mutex_lock(&server->lock);
+    while (!server->jobs && !server->quit)
+      pthread_cond_wait(&server->work, &server->lock);
+    connection_t *conn = server->jobs;
+    if (!conn) {
+      pthread_mutex_unlock(&server->lock);
+      return NULL;
+    }
+    server->jobs = conn->next;
+    pthread_mutex_unlock(&server->lock);
+
+    if (server->options.protocol == SERVER_HTTP)
+      run_http_job(server, conn);
+    else
+      run_line_job(server, conn);
+
+    pthread_mutex_lock(&server->lock);
+    conn->next = server->done;
+    server->done = conn;
+    pthread_mutex_unlock(&server->lock);
+    uint64_t one = 1;
+    ssize_t ignored = write(server->wake_fd, &one, sizeof(one));
+    (void)ignored;
+  }
+}
+
+static void queue_job(server_t *server, connection_t *conn) {
+  conn->busy = true;
+  conn->next = NULL;
+  pthread_mutex_lock(&server->lock);
+  if (server->jobs)
+    server->jobs_tail->next = conn;
+  else
+    server->jobs = conn;
+  server->jobs_tail = conn;
+  pthread_cond_signal(&server->work);
+  pthread_mutex_unlock(&server->lock);
+}
+
+static void close_connection(server_t *server, connection_t *conn) {
+  close(conn->fd); // also takes it out of the epoll set
+  conn->fd = -1;
+  secure_wipe(conn->in, conn->in_used);
+  secure_wipe(conn->out.data, conn->out.used);
+  conn->next = server->closed;
+  server->closed = conn;
+}
+
+// read until the socket is drained or the buffer is full. edge-triggered,
+// so whatever is left is picked up by the next call, not a new event
+static void read_input(connection_t *conn) {
+  while (conn->in_used < INPUT_SIZE) {
+    ssize_t n = read(conn->fd, conn->in + conn->in_used,
+                     INPUT_SIZE - conn->in_used);
+    if (n > 0) {
+      conn->in_used += (size_t)n;
+    } else if (n == 0) {
+      conn->eof = true;
+      return;
+    } else if (errno != EINTR) {
+      conn->broken = errno != EAGAIN && errno != EWOULDBLOCK;
+      return;
+    }
+  }
+}
+
+static void write_output(connection_t *conn) {
+  while (conn->out_sent < conn->out.used) {
+    ssize_t n = send(conn->fd, conn->out.data + conn->out_sent,
+                     conn->out.used - conn->out_sent, MSG_NOSIGNAL);
+    if (n > 0) {
+      conn->out_sent += (size_t)n;
+    } else if (n < 0 && errno != EINTR) {
+      conn->broken = errno != EAGAIN && errno != EWOULDBLOCK;
+      return;
+    }
+  }
+}
+
+// where the whole requests at the start of conn's input end, 0 when none
+// has fully arrived. *refusal is the status to refuse the connection with
+// when the next request can never be served, 0 otherwise
+static size_t frame_requests(server_t *server, connection_t *conn,
+                             int *refusal) {
+  *refusal = 0;
+  if (server->options.protocol == SERVER_HTTP) {
+    size_t end = 0;
+    for (;;) {
+      http_request_t request;
+      http_parse_t result =
+          http_parse_request(conn->in + end, conn->in_used - end,
+                             SERVER_MAX_REQUEST, &request);
+      if (result == HTTP_COMPLETE) {
+        end += request.length;
+        continue;
+      }
+      // the ones before a bad request are answered first
+      if (result != HTTP_INCOMPLETE && end == 0)
+        *refusal = result == HTTP_TOO_LARGE ? 413 : 400;
+      return end;
+    }
+  }
+
+  char *newline = memrchr(conn->in, '\n', conn->in_used);
+  size_t end = newline ? (size_t)(newline - conn->in) + 1 : 0;
+  if (end == 0 && conn->in_used >= SERVER_MAX_REQUEST) {
+    *refusal = 413;
+  } else if (end == 0 && conn->eof && conn->in_used > 0) {
+    // the last request needs no newline
+    conn->in[conn->in_used++] = '\n';
+    end = conn->in_used;
+  }
+  return end;
+}
+
+// answer once with an error and hang up, dropping the input
+static void refuse(server_t *server, connection_t *conn, int status) {
+  secure_wipe(conn->in, conn->in_used);
+  conn->in_used = 0;
+  conn->eof = true;
+
+  bool http = server->options.protocol == SERVER_HTTP;
+  reply_t reply;
+  if (!start_reply(conn, &reply, http ? HTTP_HEAD_MAX : 0))
+    return;
+  reply_error(&reply, status,
+              status == 413 ? "request too long" : "malformed request");
+  if (http) {
+    finish_http_reply(conn, &reply, false);
+  } else {
+    reply.data[reply.used++] = '\n';
+    conn->out.used += reply.used;
+  }
+}
+
+// move the connection along: send what was answered, read what came in
+// and hand the whole requests in it to a worker
+static void service(server_t *server, connection_t *conn) {
+  if (conn->fd < 0 || conn->busy)
+    return;
+  write_output(conn);
+  if (conn->broken) {
+    close_connection(server, conn);
+    return;
+  }
+  if (conn->out_sent < conn->out.used)
+    return; // the rest goes on EPOLLOUT
+  // answers can hold generated passwords
+  secure_wipe(conn->out.data, conn->out.used);
+  conn->out.used = conn->out_sent = 0;
+
+  if (!conn->eof)
+    read_input(conn);
+  if (conn->broken) {
+    close_connection(server, conn);
+    return;
+  }
+
+  int refusal;
+  size_t end = frame_requests(server, conn, &refusal);
+  if (refusal) {
+    refuse(server, conn, refusal);
+    service(server, conn);
+  } else if (end > 0) {
+    conn->job_end = end;
+    queue_job(server, conn);
+  } else if (conn->eof) {
+    close_connection(server, conn);
+  }
+}
+
+static void finish_jobs(server_t *server) {
+  uint64_t count;
+  ssize_t ignored = read(server->wake_fd, &count, sizeof(count));
+  (void)ignored;
+
+  pthread_mutex_lock(&server->lock);
+  connection_t *conn = server->done;
+  server->done = NULL;
+  pthread_mutex_unlock(&server->lock);
+
+  while (conn) {
+    connection_t *next = conn->next;
+    conn->busy = false;
+    // drop the answered requests, wiping where they were
+    size_t rest = conn->in_used - conn->job_end;
+    memmove(conn->in, conn->in + conn->job_end, rest);
+    secure_wipe(conn->in + rest, conn->job_end);
+    conn->in_used = rest;
+    if (conn->hangup) {
+      // the client asked to close: nothing more is read or answered
+      secure_wipe(conn->in, conn->in_used);
+      conn->in_used = 0;
+      conn->eof = true;
+    }
+    service(server, conn);
+    conn = next;
+  }
+}
+
+static void accept_connections(server_t *server) {
+  for (;;) {
+    int fd = accept4(server->listen_fd, NULL, NULL,
+                     SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0) {
+      if (errno == EINTR || errno == ECONNABORTED)
+        continue;
+      return;
+    }
+    connection_t *conn = server->free_list;
+    if (!conn) {
+      close(fd);
+      continue;
+    }
+
+    // answers are written whole, no reason to hold them back
+    if (server->port >= 0) {
+      int one = 1;
+      setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+    conn->fd = fd;
+    conn->busy = conn->eof = conn->broken = conn->hangup = false;
+    conn->in_used = conn->job_end = 0;
+    conn->out.used = conn->out_sent = 0;
+    struct epoll_event event = {
+        .events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET,
+        .data.ptr = conn};
+    if (epoll_ctl(server->epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0) {
+      close(fd);
+      conn->fd = -1;
+      continue;
+    }
+    server->free_list = conn->next;
+  }
+}
+
+void init_server_options(server_options_t *options) {
+  if (!options)
+    return;
+  options->protocol = SERVER_LINES;
+  options->socket_path = NULL;
+  options->host = NULL;
+  options->port = -1;
+  options->threads = 0;
+  options->max_connections = 0;
+  options->custom = NULL;
+}
+
+static int listen_unix(const char *path) {
+  struct sockaddr_un address = {.sun_family = AF_UNIX};
+  if (strlen(path) >= sizeof(address.sun_path))
+    return -1;
+  strcpy(address.sun_path, path);
+
+  int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (fd < 0)
+    return -1;
+
+  // a socket left behind by a server that is gone is replaced, one that
+  // still answers is not
+  struct stat st;
+  if (lstat(path, &st) == 0 && S_ISSOCK(st.st_mode)) {
+    if (connect(fd, (struct sockaddr *)&address, sizeof(address)) == 0 ||
+        errno == EAGAIN) {
+      close(fd);
+      return -1;
+    }
+    unlink(path);
+  }
+  if (bind(fd, (struct sockaddr *)&address, sizeof(address)) != 0 ||
+      chmod(path, 0660) != 0 || listen(fd, SOMAXCONN) != 0) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+// listen on host and port (0 = any free one), *bound_port is the one used
+static int listen_tcp(const char *host, int port, int *bound_port) {
+  struct addrinfo hints = {.ai_family = AF_UNSPEC,
+                           .ai_socktype = SOCK_STREAM,
+                           .ai_flags = AI_PASSIVE | AI_NUMERICSERV};
+  char service[8];
+  snprintf(service, sizeof(service), "%d", port);
+  struct addrinfo *addresses;
+  if (getaddrinfo(host ? host : "127.0.0.1", service, &hints, &addresses) !=
+      0)
+    return -1;
+
+  int fd = -1;
+  for (struct addrinfo *ai = addresses; ai && fd < 0; ai = ai->ai_next) {
+    fd = socket(ai->ai_family, ai->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                ai->ai_protocol);
+    if (fd < 0)
+      continue;
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    if (bind(fd, ai->ai_addr, ai->ai_addrlen) != 0 ||
+        listen(fd, SOMAXCONN) != 0) {
+      close(fd);
+      fd = -1;
+    }
+  }
+  freeaddrinfo(addresses);
+
+  struct sockaddr_storage bound;
+  socklen_t bound_len = sizeof(bound);
+  if (fd >= 0 &&
+      getsockname(fd, (struct sockaddr *)&bound, &bound_len) == 0) {
+    *bound_port =
+        bound.ss_family == AF_INET6
+            ? ntohs(((struct sockaddr_in6 *)&bound)->sin6_port)
+            : ntohs(((struct sockaddr_in *)&bound)->sin_port);
+  }
+  return fd;
+}
+
+server_t *server_create(const server_options_t *options,
+                        generator_error_t *error) {
+  generator_error_t err = GEN_ERROR_NULL_POINTER;
+  server_t *server = NULL;
+  if (!options || (!options->socket_path && options->port < 0))
+    goto fail;
+  err = GEN_ERROR_INVALID_CONFIG;
+  if (options->threads < 0 || options->max_connections < 0 ||
+      options->port > 65535 ||
+      (options->socket_path &&
+       strlen(options->socket_path) >= sizeof(server->socket_path)))
+    goto fail;
+
+  err = GEN_ERROR_NULL_POINTER;
+  server = calloc(1, sizeof(*server));
+  if (!server)
+    goto fail;
+  server->options = *options;
+  if (server->options.max_connections == 0)
+    server->options.max_connections = DEFAULT_MAX_CONNECTIONS;
+  if (options->socket_path) {
+    strcpy(server->socket_path, options->socket_path);
+    server->options.socket_path = server->socket_path;
+  }
+  server->port = -1;
+  server->listen_fd = server->epoll_fd = server->wake_fd = -1;
+  atomic_init(&server->stopping, false);
+  pthread_mutex_init(&server->lock, NULL);
+  pthread_cond_init(&server->work, NULL);
+  for (int type = POLICY_NIST; type <= POLICY_BASIC; type++)
+    init_policy(&server->builtin[type], (policy_type_t)type);
+
+  // every buffer up front, nothing is allocated per connection
+  size_t slots = (size_t)server->options.max_connections;
+  server->connections = calloc(slots, sizeof(connection_t));
+  server->input = malloc(slots * INPUT_SIZE);
+  if (!server->connections || !server->input)
+    goto fail;
+  for (size_t i = slots; i-- > 0;) {
+    connection_t *conn = &server->connections[i];
+    conn->fd = -1;
+    conn->in = server->input + i * INPUT_SIZE;
+    if (!batch_output_reserve(&conn->out, HTTP_HEAD_MAX + RESPONSE_MAX))
+      goto fail;
+    conn->next = server->free_list;
+    server->free_list = conn;
+  }
+
+  pool_options_t pool_options;
+  init_pool_options(&pool_options);
+  pool_options.length = GENERATE_DEFAULT_LENGTH;
+  server->pool = password_pool_create(&pool_options);
+  if (!server->pool)
+    goto fail;
+
+  err = GEN_ERROR_FILE_ACCESS;
+  server->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  server->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (server->epoll_fd < 0 || server->wake_fd < 0)
+    goto fail;
+  if (server->options.socket_path)
+    server->listen_fd = listen_unix(server->socket_path);
+  else
+    server->listen_fd = listen_tcp(options->host, options->port, &server->port);
+  if (server->listen_fd < 0)
+    goto fail;
+
+  struct epoll_event listen_event = {.events = EPOLLIN | EPOLLET,
+                                     .data.ptr = &server->listen_fd};
+  struct epoll_event wake_event = {.events = EPOLLIN | EPOLLET,
+                                   .data.ptr = &server->wake_fd};
+  if (epoll_ctl(server->epoll_fd, EPOLL_CTL_ADD, server->listen_fd,
+                &listen_event) != 0 ||
+      epoll_ctl(server->epoll_fd, EPOLL_CTL_ADD, server->wake_fd,
+                &wake_event) != 0)
+    goto fail;
+
+  if (error)
+    *error = GEN_SUCCESS;
+  return server;
+
+fail:
+  server_destroy(server);
+  if (error)
+    *error = err;
+  return NULL;
+}
+
+static void stop_workers(server_t *server) {
+  pthread_mutex_lock(&server->lock);
+  server->quit = true;
+  pthread_cond_broadcast(&server->work);
+  pthread_mutex_unlock(&server->lock);
+  for (int i = 0; i < server->worker_count; i++)
+    pthread_join(server->workers[i], NULL);
+  server->worker_count = 0;
+}
+
+generator_error_t server_run(server_t *server) {
+  if (!server)
+    return GEN_ERROR_NULL_POINTER;
+
+  int threads = server->options.threads;
+  if (threads <= 0) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    threads = cpus > 0 ? (int)cpus : 1;
+  }
+  if (threads > MAX_THREADS)
+    threads = MAX_THREADS;
+  server->quit = false;
+  for (; server->worker_count < threads; server->worker_count++) {
+    if (pthread_create(&server->workers[server->worker_count], NULL,
+                       server_worker, server) != 0)
+      break;
+  }
+  if (server->worker_count == 0)
+    return GEN_ERROR_NULL_POINTER;
+
+  generator_error_t err = GEN_SUCCESS;
+  struct epoll_event events[MAX_EVENTS];
+  while (!atomic_load(&server->stopping)) {
+    int count = epoll_wait(server->epoll_fd, events, MAX_EVENTS, -1);
+    if (count < 0) {
+      if (errno == EINTR)
+        continue;
+      err = GEN_ERROR_FILE_ACCESS;
+      break;
+    }
+    for (int i = 0; i < count; i++) {
+      void *tag = events[i].data.ptr;
+      if (tag == &server->listen_fd)
+        accept_connections(server);
+      else if (tag == &server->wake_fd)
+        finish_jobs(server);
+      else
+        service(server, tag);
+    }
+    // a slot closed above may still have an event further down the list,
+    // so it is only reused from the next round on
+    while (server->closed) {
+      connection_t *conn = server->closed;
+      server->closed = conn->next;
+      conn->next = server->free_list;
+      server->free_list = conn;
+    }
+  }
+
+  // the jobs running are finished, their answers are not sent
+  stop_workers(server);
+  return err;
+}
+
+int server_port(const server_t *server) { return server ? server->port : -1; }
+
+void server_stop(server_t *server) {
+  if (!server)
+    return;
+  atomic_store(&server->stopping, true);
+  uint64_t one = 1;
+  ssize_t ignored = write(server->wake_fd, &one, sizeof(one));
+  (void)ignored;
+}
+
+void server_destroy(server_t *server) {
+  if (!server)
+    return;
+  stop_workers(server);
+  if (server->connections) {
+    for (int i = 0; i < server->options.max_connections; i++) {
+      connection_t *conn = &server->connections[i];
+      if (conn->fd >= 0)
+        close(conn->fd);
+      if (conn->in)
+        secure_wipe(conn->in, conn->in_used);
+      if (conn->out.data) {
+        secure_wipe(conn->out.data, conn->out.used);
+        free(conn->out.data);
+      }
+    }
+  }
+  if (server->listen_fd >= 0) {
+    close(server->listen_fd);
+    if (server->options.socket_path)
+      unlink(server->socket_path);
+  }
+  if (server->epoll_fd >= 0)
+    close(server->epoll_fd);
+  if (server->wake_fd >= 0)
+    close(server->wake_fd);
+  password_pool_destroy(server->pool);
+  pthread_cond_destroy(&server->work);
+  pthread_mutex_destroy(&server->lock);
+  free(server->connections);
+  free(server->input);
+  free(server);
+}
@@ -157,6 +157,8 @@ void display_password_analysis(const password_strength_t *result) {
          dim, reset, bold, result->entropy, reset);
   printf("  %sCrack time:%s       %s%s%s\n", 
          dim, reset, bold, format_crack_time(result->crack_time_seconds), reset);
+  printf("  %sGuesses:%s          %s10^%.1f%s\n", 
+         dim, reset, bold, result->guesses_log10, reset);
   
   printf("\n");
   
@@ -165,7 +167,8 @@ void display_password_analysis(const password_strength_t *result) {
                         result->has_keyboard_pattern ||
                         result->has_repeated_chars ||
                         result->has_repeated_pattern ||
-                        result->contains_dictionary_word;
+                        result->contains_dictionary_word ||
+                        result->common_distance >= 0;
   
   if (has_weaknesses) {
     printf("  %sWeaknesses detected:%s\n", dim, reset);
@@ -176,8 +179,9 @@ void display_password_analysis(const password_strength_t *result) {
              use_colors ? YELLOW : "", reset);
     }
     if (result->has_keyboard_pattern) {
-      printf("    %s- Keyboard pattern found (e.g., qwerty, asdf)%s\n",
-             use_colors ? YELLOW : "", reset);
+      printf("    %s- Keyboard pattern found (%d-key walk, e.g., qwerty, "
+             "wsxedc)%s\n",
+             use_colors ? YELLOW : "", result->keyboard_walk_length, reset);
     }
     if (result->has_repeated_chars) {
       printf("    %s- Repeated characters found (e.g., aaa, 111)%s\n",
@@ -191,10 +195,13 @@ void display_password_analysis(const password_strength_t *result) {
       printf("    %s- Dictionary word detected%s\n",
              use_colors ? YELLOW : "", reset);
     }
-    
-    if (result->pattern_penalty > 0) {
-      printf("    %s- Pattern penalty: -%d points%s\n",
-             use_colors ? RED : "", result->pattern_penalty, reset);
+    if (result->common_distance == 0) {
+      printf("    %s- Common password%s\n", use_colors ? YELLOW : "", reset);
+    } else if (result->common_distance > 0) {
+      printf("    %s- %d edit%s from common password \"%s\"%s\n",
+             use_colors ? YELLOW : "", result->common_distance,
+             result->common_distance == 1 ? "" : "s", result->nearest_common,
+             reset);
     }
     
     printf("\n");
@@ -0,0 +1,1227 @@
+// generated by tools/gen_unicode_table.py from unicode 14.0.0, do not edit
+#ifndef UNICODE_TABLE_H
+#define UNICODE_TABLE_H
+
+#include <stdint.h>
+
+typedef enum {
+  UNI_LOWER,
+  UNI_UPPER,
+  UNI_LETTER,
+  UNI_DIGIT,
+  UNI_MARK,
+  UNI_SPACE,
+  UNI_UPPER_LOWER,
+  UNI_LOWER_UPPER
+} unicode_kind_t;
+
+// first code point, number of code points - 1, kind
+typedef struct {
+  uint32_t first;
+  uint16_t extra;
+  uint8_t kind;
+} unicode_range_t;
+
+#define UNICODE_RANGE_COUNT 1197
+
+static const unicode_range_t unicode_ranges[UNICODE_RANGE_COUNT] = {
+    {0x000A0, 0, UNI_SPACE},
+    {0x000AA, 0, UNI_LETTER},
+    {0x000B5, 0, UNI_LOWER},
+    {0x000BA, 0, UNI_LETTER},
+    {0x000C0, 22, UNI_UPPER},
+    {0x000D8, 6, UNI_UPPER},
+    {0x000DF, 23, UNI_LOWER},
+    {0x000F8, 7, UNI_LOWER},
+    {0x00100, 55, UNI_UPPER_LOWER},
+    {0x00138, 16, UNI_LOWER_UPPER},
+    {0x00149, 47, UNI_LOWER_UPPER},
+    {0x00179, 5, UNI_UPPER_LOWER},
+    {0x0017F, 1, UNI_LOWER},
+    {0x00181, 1, UNI_UPPER},
+    {0x00183, 3, UNI_LOWER_UPPER},
+    {0x00187, 2, UNI_UPPER_LOWER},
+    {0x0018A, 1, UNI_UPPER},
+    {0x0018C, 1, UNI_LOWER},
+    {0x0018E, 3, UNI_UPPER},
+    {0x00192, 1, UNI_LOWER_UPPER},
+    {0x00194, 2, UNI_UPPER_LOWER},
+    {0x00197, 1, UNI_UPPER},
+    {0x00199, 2, UNI_LOWER},
+    {0x0019C, 1, UNI_UPPER},
+    {0x0019E, 1, UNI_LOWER_UPPER},
+    {0x001A0, 6, UNI_UPPER_LOWER},
+    {0x001A7, 3, UNI_UPPER_LOWER},
+    {0x001AB, 3, UNI_LOWER_UPPER},
+    {0x001AF, 2, UNI_UPPER_LOWER},
+    {0x001B2, 1, UNI_UPPER},
+    {0x001B4, 3, UNI_LOWER_UPPER},
+    {0x001B8, 1, UNI_UPPER_LOWER},
+    {0x001BA, 0, UNI_LOWER},
+    {0x001BB, 0, UNI_LETTER},
+    {0x001BC, 1, UNI_UPPER_LOWER},
+    {0x001BE, 1, UNI_LOWER},
+    {0x001C0, 3, UNI_LETTER},
+    {0x001C4, 1, UNI_UPPER},
+    {0x001C6, 1, UNI_LOWER_UPPER},
+    {0x001C8, 2, UNI_UPPER_LOWER},
+    {0x001CB, 17, UNI_UPPER_LOWER},
+    {0x001DD, 18, UNI_LOWER_UPPER},
+    {0x001F0, 1, UNI_LOWER_UPPER},
+    {0x001F2, 4, UNI_UPPER_LOWER},
+    {0x001F7, 1, UNI_UPPER},
+    {0x001F9, 58, UNI_LOWER_UPPER},
+    {0x00234, 5, UNI_LOWER},
+    {0x0023A, 1, UNI_UPPER},
+    {0x0023C, 1, UNI_LOWER_UPPER},
+    {0x0023E, 1, UNI_UPPER_LOWER},
+    {0x00240, 3, UNI_LOWER_UPPER},
+    {0x00244, 2, UNI_UPPER},
+    {0x00247, 8, UNI_LOWER_UPPER},
+    {0x00250, 67, UNI_LOWER},
+    {0x00294, 0, UNI_LETTER},
+    {0x00295, 26, UNI_LOWER},
+    {0x002B0, 17, UNI_LETTER},
+    {0x002C6, 11, UNI_LETTER},
+    {0x002E0, 4, UNI_LETTER},
+    {0x002EC, 0, UNI_LETTER},
+    {0x002EE, 0, UNI_LETTER},
+    {0x00300, 111, UNI_MARK},
+    {0x00370, 3, UNI_UPPER_LOWER},
+    {0x00374, 0, UNI_LETTER},
+    {0x00376, 1, UNI_UPPER_LOWER},
+    {0x0037A, 0, UNI_LETTER},
+    {0x0037B, 2, UNI_LOWER},
+    {0x0037F, 0, UNI_UPPER},
+    {0x00386, 0, UNI_UPPER},
+    {0x00388, 2, UNI_UPPER},
+    {0x0038C, 0, UNI_UPPER},
+    {0x0038E, 1, UNI_UPPER},
+    {0x00390, 1, UNI_LOWER_UPPER},
+    {0x00392, 15, UNI_UPPER},
+    {0x003A3, 8, UNI_UPPER},
+    {0x003AC, 34, UNI_LOWER},
+    {0x003CF, 1, UNI_UPPER_LOWER},
+    {0x003D1, 1, UNI_LOWER_UPPER},
+    {0x003D3, 1, UNI_UPPER},
+    {0x003D5, 2, UNI_LOWER},
+    {0x003D8, 23, UNI_UPPER_LOWER},
+    {0x003F0, 3, UNI_LOWER},
+    {0x003F4, 1, UNI_UPPER_LOWER},
+    {0x003F7, 2, UNI_UPPER_LOWER},
+    {0x003FA, 1, UNI_UPPER_LOWER},
+    {0x003FC, 1, UNI_LOWER_UPPER},
+    {0x003FE, 49, UNI_UPPER},
+    {0x00430, 47, UNI_LOWER},
+    {0x00460, 33, UNI_UPPER_LOWER},
+    {0x00483, 6, UNI_MARK},
+    {0x0048A, 54, UNI_UPPER_LOWER},
+    {0x004C1, 13, UNI_UPPER_LOWER},
+    {0x004CF, 96, UNI_LOWER_UPPER},
+    {0x00531, 37, UNI_UPPER},
+    {0x00559, 0, UNI_LETTER},
+    {0x00560, 40, UNI_LOWER},
+    {0x00591, 44, UNI_MARK},
+    {0x005BF, 0, UNI_MARK},
+    {0x005C1, 1, UNI_MARK},
+    {0x005C4, 1, UNI_MARK},
+    {0x005C7, 0, UNI_MARK},
+    {0x005D0, 26, UNI_LETTER},
+    {0x005EF, 3, UNI_LETTER},
+    {0x00610, 10, UNI_MARK},
+    {0x00620, 42, UNI_LETTER},
+    {0x0064B, 20, UNI_MARK},
+    {0x00660, 9, UNI_DIGIT},
+    {0x0066E, 1, UNI_LETTER},
+    {0x00670, 0, UNI_MARK},
+    {0x00671, 98, UNI_LETTER},
+    {0x006D5, 0, UNI_LETTER},
+    {0x006D6, 6, UNI_MARK},
+    {0x006DF, 5, UNI_MARK},
+    {0x006E5, 1, UNI_LETTER},
+    {0x006E7, 1, UNI_MARK},
+    {0x006EA, 3, UNI_MARK},
+    {0x006EE, 1, UNI_LETTER},
+    {0x006F0, 9, UNI_DIGIT},
+    {0x006FA, 2, UNI_LETTER},
+    {0x006FF, 0, UNI_LETTER},
+    {0x00710, 0, UNI_LETTER},
+    {0x00711, 0, UNI_MARK},
+    {0x00712, 29, UNI_LETTER},
+    {0x00730, 26, UNI_MARK},
+    {0x0074D, 88, UNI_LETTER},
+    {0x007A6, 10, UNI_MARK},
+    {0x007B1, 0, UNI_LETTER},
+    {0x007C0, 9, UNI_DIGIT},
+    {0x007CA, 32, UNI_LETTER},
+    {0x007EB, 8, UNI_MARK},
+    {0x007F4, 1, UNI_LETTER},
+    {0x007FA, 0, UNI_LETTER},
+    {0x007FD, 0, UNI_MARK},
+    {0x00800, 21, UNI_LETTER},
+    {0x00816, 3, UNI_MARK},
+    {0x0081A, 0, UNI_LETTER},
+    {0x0081B, 8, UNI_MARK},
+    {0x00824, 0, UNI_LETTER},
+    {0x00825, 2, UNI_MARK},
+    {0x00828, 0, UNI_LETTER},
+    {0x00829, 4, UNI_MARK},
+    {0x00840, 24, UNI_LETTER},
+    {0x00859, 2, UNI_MARK},
+    {0x00860, 10, UNI_LETTER},
+    {0x00870, 23, UNI_LETTER},
+    {0x00889, 5, UNI_LETTER},
+    {0x00898, 7, UNI_MARK},
+    {0x008A0, 41, UNI_LETTER},
+    {0x008CA, 23, UNI_MARK},
+    {0x008E3, 32, UNI_MARK},
+    {0x00904, 53, UNI_LETTER},
+    {0x0093A, 2, UNI_MARK},
+    {0x0093D, 0, UNI_LETTER},
+    {0x0093E, 17, UNI_MARK},
+    {0x00950, 0, UNI_LETTER},
+    {0x00951, 6, UNI_MARK},
+    {0x00958, 9, UNI_LETTER},
+    {0x00962, 1, UNI_MARK},
+    {0x00966, 9, UNI_DIGIT},
+    {0x00971, 15, UNI_LETTER},
+    {0x00981, 2, UNI_MARK},
+    {0x00985, 7, UNI_LETTER},
+    {0x0098F, 1, UNI_LETTER},
+    {0x00993, 21, UNI_LETTER},
+    {0x009AA, 6, UNI_LETTER},
+    {0x009B2, 0, UNI_LETTER},
+    {0x009B6, 3, UNI_LETTER},
+    {0x009BC, 0, UNI_MARK},
+    {0x009BD, 0, UNI_LETTER},
+    {0x009BE, 6, UNI_MARK},
+    {0x009C7, 1, UNI_MARK},
+    {0x009CB, 2, UNI_MARK},
+    {0x009CE, 0, UNI_LETTER},
+    {0x009D7, 0, UNI_MARK},
+    {0x009DC, 1, UNI_LETTER},
+    {0x009DF, 2, UNI_LETTER},
+    {0x009E2, 1, UNI_MARK},
+    {0x009E6, 9, UNI_DIGIT},
+    {0x009F0, 1, UNI_LETTER},
+    {0x009FC, 0, UNI_LETTER},
+    {0x009FE, 0, UNI_MARK},
+    {0x00A01, 2, UNI_MARK},
+    {0x00A05, 5, UNI_LETTER},
+    {0x00A0F, 1, UNI_LETTER},
+    {0x00A13, 21, UNI_LETTER},
+    {0x00A2A, 6, UNI_LETTER},
+    {0x00A32, 1, UNI_LETTER},
+    {0x00A35, 1, UNI_LETTER},
+    {0x00A38, 1, UNI_LETTER},
+    {0x00A3C, 0, UNI_MARK},
+    {0x00A3E, 4, UNI_MARK},
+    {0x00A47, 1, UNI_MARK},
+    {0x00A4B, 2, UNI_MARK},
+    {0x00A51, 0, UNI_MARK},
+    {0x00A59, 3, UNI_LETTER},
+    {0x00A5E, 0, UNI_LETTER},
+    {0x00A66, 9, UNI_DIGIT},
+    {0x00A70, 1, UNI_MARK},
+    {0x00A72, 2, UNI_LETTER},
+    {0x00A75, 0, UNI_MARK},
+    {0x00A81, 2, UNI_MARK},
+    {0x00A85, 8, UNI_LETTER},
+    {0x00A8F, 2, UNI_LETTER},
+    {0x00A93, 21, UNI_LETTER},
+    {0x00AAA, 6, UNI_LETTER},
+    {0x00AB2, 1, UNI_LETTER},
+    {0x00AB5, 4, UNI_LETTER},
+    {0x00ABC, 0, UNI_MARK},
+    {0x00ABD, 0, UNI_LETTER},
+    {0x00ABE, 7, UNI_MARK},
+    {0x00AC7, 2, UNI_MARK},
+    {0x00ACB, 2, UNI_MARK},
+    {0x00AD0, 0, UNI_LETTER},
+    {0x00AE0, 1, UNI_LETTER},
+    {0x00AE2, 1, UNI_MARK},
+    {0x00AE6, 9, UNI_DIGIT},
+    {0x00AF9, 0, UNI_LETTER},
+    {0x00AFA, 5, UNI_MARK},
+    {0x00B01, 2, UNI_MARK},
+    {0x00B05, 7, UNI_LETTER},
+    {0x00B0F, 1, UNI_LETTER},
+    {0x00B13, 21, UNI_LETTER},
+    {0x00B2A, 6, UNI_LETTER},
+    {0x00B32, 1, UNI_LETTER},
+    {0x00B35, 4, UNI_LETTER},
+    {0x00B3C, 0, UNI_MARK},
+    {0x00B3D, 0, UNI_LETTER},
+    {0x00B3E, 6, UNI_MARK},
+    {0x00B47, 1, UNI_MARK},
+    {0x00B4B, 2, UNI_MARK},
+    {0x00B55, 2, UNI_MARK},
+    {0x00B5C, 1, UNI_LETTER},
+    {0x00B5F, 2, UNI_LETTER},
+    {0x00B62, 1, UNI_MARK},
+    {0x00B66, 9, UNI_DIGIT},
+    {0x00B71, 0, UNI_LETTER},
+    {0x00B82, 0, UNI_MARK},
+    {0x00B83, 0, UNI_LETTER},
+    {0x00B85, 5, UNI_LETTER},
+    {0x00B8E, 2, UNI_LETTER},
+    {0x00B92, 3, UNI_LETTER},
+    {0x00B99, 1, UNI_LETTER},
+    {0x00B9C, 0, UNI_LETTER},
+    {0x00B9E, 1, UNI_LETTER},
+    {0x00BA3, 1, UNI_LETTER},
+    {0x00BA8, 2, UNI_LETTER},
+    {0x00BAE, 11, UNI_LETTER},
+    {0x00BBE, 4, UNI_MARK},
+    {0x00BC6, 2, UNI_MARK},
+    {0x00BCA, 3, UNI_MARK},
+    {0x00BD0, 0, UNI_LETTER},
+    {0x00BD7, 0, UNI_MARK},
+    {0x00BE6, 9, UNI_DIGIT},
+    {0x00C00, 4, UNI_MARK},
+    {0x00C05, 7, UNI_LETTER},
+    {0x00C0E, 2, UNI_LETTER},
+    {0x00C12, 22, UNI_LETTER},
+    {0x00C2A, 15, UNI_LETTER},
+    {0x00C3C, 0, UNI_MARK},
+    {0x00C3D, 0, UNI_LETTER},
+    {0x00C3E, 6, UNI_MARK},
+    {0x00C46, 2, UNI_MARK},
+    {0x00C4A, 3, UNI_MARK},
+    {0x00C55, 1, UNI_MARK},
+    {0x00C58, 2, UNI_LETTER},
+    {0x00C5D, 0, UNI_LETTER},
+    {0x00C60, 1, UNI_LETTER},
+    {0x00C62, 1, UNI_MARK},
+    {0x00C66, 9, UNI_DIGIT},
+    {0x00C80, 0, UNI_LETTER},
+    {0x00C81, 2, UNI_MARK},
+    {0x00C85, 7, UNI_LETTER},
+    {0x00C8E, 2, UNI_LETTER},
+    {0x00C92, 22, UNI_LETTER},
+    {0x00CAA, 9, UNI_LETTER},
+    {0x00CB5, 4, UNI_LETTER},
+    {0x00CBC, 0, UNI_MARK},
+    {0x00CBD, 0, UNI_LETTER},
+    {0x00CBE, 6, UNI_MARK},
+    {0x00CC6, 2, UNI_MARK},
+    {0x00CCA, 3, UNI_MARK},
+    {0x00CD5, 1, UNI_MARK},
+    {0x00CDD, 1, UNI_LETTER},
+    {0x00CE0, 1, UNI_LETTER},
+    {0x00CE2, 1, UNI_MARK},
+    {0x00CE6, 9, UNI_DIGIT},
+    {0x00CF1, 1, UNI_LETTER},
+    {0x00D00, 3, UNI_MARK},
+    {0x00D04, 8, UNI_LETTER},
+    {0x00D0E, 2, UNI_LETTER},
+    {0x00D12, 40, UNI_LETTER},
+    {0x00D3B, 1, UNI_MARK},
+    {0x00D3D, 0, UNI_LETTER},
+    {0x00D3E, 6, UNI_MARK},
+    {0x00D46, 2, UNI_MARK},
+    {0x00D4A, 3, UNI_MARK},
+    {0x00D4E, 0, UNI_LETTER},
+    {0x00D54, 2, UNI_LETTER},
+    {0x00D57, 0, UNI_MARK},
+    {0x00D5F, 2, UNI_LETTER},
+    {0x00D62, 1, UNI_MARK},
+    {0x00D66, 9, UNI_DIGIT},
+    {0x00D7A, 5, UNI_LETTER},
+    {0x00D81, 2, UNI_MARK},
+    {0x00D85, 17, UNI_LETTER},
+    {0x00D9A, 23, UNI_LETTER},
+    {0x00DB3, 8, UNI_LETTER},
+    {0x00DBD, 0, UNI_LETTER},
+    {0x00DC0, 6, UNI_LETTER},
+    {0x00DCA, 0, UNI_MARK},
+    {0x00DCF, 5, UNI_MARK},
+    {0x00DD6, 0, UNI_MARK},
+    {0x00DD8, 7, UNI_MARK},
+    {0x00DE6, 9, UNI_DIGIT},
+    {0x00DF2, 1, UNI_MARK},
+    {0x00E01, 47, UNI_LETTER},
+    {0x00E31, 0, UNI_MARK},
+    {0x00E32, 1, UNI_LETTER},
+    {0x00E34, 6, UNI_MARK},
+    {0x00E40, 6, UNI_LETTER},
+    {0x00E47, 7, UNI_MARK},
+    {0x00E50, 9, UNI_DIGIT},
+    {0x00E81, 1, UNI_LETTER},
+    {0x00E84, 0, UNI_LETTER},
+    {0x00E86, 4, UNI_LETTER},
+    {0x00E8C, 23, UNI_LETTER},
+    {0x00EA5, 0, UNI_LETTER},
+    {0x00EA7, 9, UNI_LETTER},
+    {0x00EB1, 0, UNI_MARK},
+    {0x00EB2, 1, UNI_LETTER},
+    {0x00EB4, 8, UNI_MARK},
+    {0x00EBD, 0, UNI_LETTER},
+    {0x00EC0, 4, UNI_LETTER},
+    {0x00EC6, 0, UNI_LETTER},
+    {0x00EC8, 5, UNI_MARK},
+    {0x00ED0, 9, UNI_DIGIT},
+    {0x00EDC, 3, UNI_LETTER},
+    {0x00F00, 0, UNI_LETTER},
+    {0x00F18, 1, UNI_MARK},
+    {0x00F20, 9, UNI_DIGIT},
+    {0x00F35, 0, UNI_MARK},
+    {0x00F37, 0, UNI_MARK},
+    {0x00F39, 0, UNI_MARK},
+    {0x00F3E, 1, UNI_MARK},
+    {0x00F40, 7, UNI_LETTER},
+    {0x00F49, 35, UNI_LETTER},
+    {0x00F71, 19, UNI_MARK},
+    {0x00F86, 1, UNI_MARK},
+    {0x00F88, 4, UNI_LETTER},
+    {0x00F8D, 10, UNI_MARK},
+    {0x00F99, 35, UNI_MARK},
+    {0x00FC6, 0, UNI_MARK},
+    {0x01000, 42, UNI_LETTER},
+    {0x0102B, 19, UNI_MARK},
+    {0x0103F, 0, UNI_LETTER},
+    {0x01040, 9, UNI_DIGIT},
+    {0x01050, 5, UNI_LETTER},
+    {0x01056, 3, UNI_MARK},
+    {0x0105A, 3, UNI_LETTER},
+    {0x0105E, 2, UNI_MARK},
+    {0x01061, 0, UNI_LETTER},
+    {0x01062, 2, UNI_MARK},
+    {0x01065, 1, UNI_LETTER},
+    {0x01067, 6, UNI_MARK},
+    {0x0106E, 2, UNI_LETTER},
+    {0x01071, 3, UNI_MARK},
+    {0x01075, 12, UNI_LETTER},
+    {0x01082, 11, UNI_MARK},
+    {0x0108E, 0, UNI_LETTER},
+    {0x0108F, 0, UNI_MARK},
+    {0x01090, 9, UNI_DIGIT},
+    {0x0109A, 3, UNI_MARK},
+    {0x010A0, 37, UNI_UPPER},
+    {0x010C7, 0, UNI_UPPER},
+    {0x010CD, 0, UNI_UPPER},
+    {0x010D0, 42, UNI_LOWER},
+    {0x010FC, 0, UNI_LETTER},
+    {0x010FD, 2, UNI_LOWER},
+    {0x01100, 328, UNI_LETTER},
+    {0x0124A, 3, UNI_LETTER},
+    {0x01250, 6, UNI_LETTER},
+    {0x01258, 0, UNI_LETTER},
+    {0x0125A, 3, UNI_LETTER},
+    {0x01260, 40, UNI_LETTER},
+    {0x0128A, 3, UNI_LETTER},
+    {0x01290, 32, UNI_LETTER},
+    {0x012B2, 3, UNI_LETTER},
+    {0x012B8, 6, UNI_LETTER},
+    {0x012C0, 0, UNI_LETTER},
+    {0x012C2, 3, UNI_LETTER},
+    {0x012C8, 14, UNI_LETTER},
+    {0x012D8, 56, UNI_LETTER},
+    {0x01312, 3, UNI_LETTER},
+    {0x01318, 66, UNI_LETTER},
+    {0x0135D, 2, UNI_MARK},
+    {0x01380, 15, UNI_LETTER},
+    {0x013A0, 85, UNI_UPPER},
+    {0x013F8, 5, UNI_LOWER},
+    {0x01401, 619, UNI_LETTER},
+    {0x0166F, 16, UNI_LETTER},
+    {0x01680, 0, UNI_SPACE},
+    {0x01681, 25, UNI_LETTER},
+    {0x016A0, 74, UNI_LETTER},
+    {0x016F1, 7, UNI_LETTER},
+    {0x01700, 17, UNI_LETTER},
+    {0x01712, 3, UNI_MARK},
+    {0x0171F, 18, UNI_LETTER},
+    {0x01732, 2, UNI_MARK},
+    {0x01740, 17, UNI_LETTER},
+    {0x01752, 1, UNI_MARK},
+    {0x01760, 12, UNI_LETTER},
+    {0x0176E, 2, UNI_LETTER},
+    {0x01772, 1, UNI_MARK},
+    {0x01780, 51, UNI_LETTER},
+    {0x017B4, 31, UNI_MARK},
+    {0x017D7, 0, UNI_LETTER},
+    {0x017DC, 0, UNI_LETTER},
+    {0x017DD, 0, UNI_MARK},
+    {0x017E0, 9, UNI_DIGIT},
+    {0x0180B, 2, UNI_MARK},
+    {0x0180F, 0, UNI_MARK},
+    {0x01810, 9, UNI_DIGIT},
+    {0x01820, 88, UNI_LETTER},
+    {0x01880, 4, UNI_LETTER},
+    {0x01885, 1, UNI_MARK},
+    {0x01887, 33, UNI_LETTER},
+    {0x018A9, 0, UNI_MARK},
+    {0x018AA, 0, UNI_LETTER},
+    {0x018B0, 69, UNI_LETTER},
+    {0x01900, 30, UNI_LETTER},
+    {0x01920, 11, UNI_MARK},
+    {0x01930, 11, UNI_MARK},
+    {0x01946, 9, UNI_DIGIT},
+    {0x01950, 29, UNI_LETTER},
+    {0x01970, 4, UNI_LETTER},
+    {0x01980, 43, UNI_LETTER},
+    {0x019B0, 25, UNI_LETTER},
+    {0x019D0, 9, UNI_DIGIT},
+    {0x01A00, 22, UNI_LETTER},
+    {0x01A17, 4, UNI_MARK},
+    {0x01A20, 52, UNI_LETTER},
+    {0x01A55, 9, UNI_MARK},
+    {0x01A60, 28, UNI_MARK},
+    {0x01A7F, 0, UNI_MARK},
+    {0x01A80, 9, UNI_DIGIT},
+    {0x01A90, 9, UNI_DIGIT},
+    {0x01AA7, 0, UNI_LETTER},
+    {0x01AB0, 30, UNI_MARK},
+    {0x01B00, 4, UNI_MARK},
+    {0x01B05, 46, UNI_LETTER},
+    {0x01B34, 16, UNI_MARK},
+    {0x01B45, 7, UNI_LETTER},
+    {0x01B50, 9, UNI_DIGIT},
+    {0x01B6B, 8, UNI_MARK},
+    {0x01B80, 2, UNI_MARK},
+    {0x01B83, 29, UNI_LETTER},
+    {0x01BA1, 12, UNI_MARK},
+    {0x01BAE, 1, UNI_LETTER},
+    {0x01BB0, 9, UNI_DIGIT},
+    {0x01BBA, 43, UNI_LETTER},
+    {0x01BE6, 13, UNI_MARK},
+    {0x01C00, 35, UNI_LETTER},
+    {0x01C24, 19, UNI_MARK},
+    {0x01C40, 9, UNI_DIGIT},
+    {0x01C4D, 2, UNI_LETTER},
+    {0x01C50, 9, UNI_DIGIT},
+    {0x01C5A, 35, UNI_LETTER},
+    {0x01C80, 8, UNI_LOWER},
+    {0x01C90, 42, UNI_UPPER},
+    {0x01CBD, 2, UNI_UPPER},
+    {0x01CD0, 2, UNI_MARK},
+    {0x01CD4, 20, UNI_MARK},
+    {0x01CE9, 3, UNI_LETTER},
+    {0x01CED, 0, UNI_MARK},
+    {0x01CEE, 5, UNI_LETTER},
+    {0x01CF4, 0, UNI_MARK},
+    {0x01CF5, 1, UNI_LETTER},
+    {0x01CF7, 2, UNI_MARK},
+    {0x01CFA, 0, UNI_LETTER},
+    {0x01D00, 43, UNI_LOWER},
+    {0x01D2C, 62, UNI_LETTER},
+    {0x01D6B, 12, UNI_LOWER},
+    {0x01D78, 0, UNI_LETTER},
+    {0x01D79, 33, UNI_LOWER},
+    {0x01D9B, 36, UNI_LETTER},
+    {0x01DC0, 63, UNI_MARK},
+    {0x01E00, 149, UNI_UPPER_LOWER},
+    {0x01E96, 7, UNI_LOWER},
+    {0x01E9E, 97, UNI_UPPER_LOWER},
+    {0x01F00, 7, UNI_LOWER},
+    {0x01F08, 7, UNI_UPPER},
+    {0x01F10, 5, UNI_LOWER},
+    {0x01F18, 5, UNI_UPPER},
+    {0x01F20, 7, UNI_LOWER},
+    {0x01F28, 7, UNI_UPPER},
+    {0x01F30, 7, UNI_LOWER},
+    {0x01F38, 7, UNI_UPPER},
+    {0x01F40, 5, UNI_LOWER},
+    {0x01F48, 5, UNI_UPPER},
+    {0x01F50, 7, UNI_LOWER},
+    {0x01F59, 0, UNI_UPPER},
+    {0x01F5B, 0, UNI_UPPER},
+    {0x01F5D, 0, UNI_UPPER},
+    {0x01F5F, 1, UNI_UPPER_LOWER},
+    {0x01F61, 6, UNI_LOWER},
+    {0x01F68, 7, UNI_UPPER},
+    {0x01F70, 13, UNI_LOWER},
+    {0x01F80, 7, UNI_LOWER},
+    {0x01F88, 7, UNI_UPPER},
+    {0x01F90, 7, UNI_LOWER},
+    {0x01F98, 7, UNI_UPPER},
+    {0x01FA0, 7, UNI_LOWER},
+    {0x01FA8, 7, UNI_UPPER},
+    {0x01FB0, 4, UNI_LOWER},
+    {0x01FB6, 1, UNI_LOWER},
+    {0x01FB8, 4, UNI_UPPER},
+    {0x01FBE, 0, UNI_LOWER},
+    {0x01FC2, 2, UNI_LOWER},
+    {0x01FC6, 1, UNI_LOWER},
+    {0x01FC8, 4, UNI_UPPER},
+    {0x01FD0, 3, UNI_LOWER},
+    {0x01FD6, 1, UNI_LOWER},
+    {0x01FD8, 3, UNI_UPPER},
+    {0x01FE0, 7, UNI_LOWER},
+    {0x01FE8, 4, UNI_UPPER},
+    {0x01FF2, 2, UNI_LOWER},
+    {0x01FF6, 1, UNI_LOWER},
+    {0x01FF8, 4, UNI_UPPER},
+    {0x02000, 10, UNI_SPACE},
+    {0x02028, 1, UNI_SPACE},
+    {0x0202F, 0, UNI_SPACE},
+    {0x0205F, 0, UNI_SPACE},
+    {0x02071, 0, UNI_LETTER},
+    {0x0207F, 0, UNI_LETTER},
+    {0x02090, 12, UNI_LETTER},
+    {0x020D0, 32, UNI_MARK},
+    {0x02102, 0, UNI_UPPER},
+    {0x02107, 0, UNI_UPPER},
+    {0x0210A, 1, UNI_LOWER_UPPER},
+    {0x0210C, 1, UNI_UPPER},
+    {0x0210E, 1, UNI_LOWER},
+    {0x02110, 2, UNI_UPPER},
+    {0x02113, 0, UNI_LOWER},
+    {0x02115, 0, UNI_UPPER},
+    {0x02119, 4, UNI_UPPER},
+    {0x02124, 0, UNI_UPPER},
+    {0x02126, 0, UNI_UPPER},
+    {0x02128, 0, UNI_UPPER},
+    {0x0212A, 3, UNI_UPPER},
+    {0x0212F, 1, UNI_LOWER_UPPER},
+    {0x02131, 2, UNI_UPPER},
+    {0x02134, 0, UNI_LOWER},
+    {0x02135, 3, UNI_LETTER},
+    {0x02139, 0, UNI_LOWER},
+    {0x0213C, 1, UNI_LOWER},
+    {0x0213E, 1, UNI_UPPER},
+    {0x02145, 1, UNI_UPPER_LOWER},
+    {0x02147, 2, UNI_LOWER},
+    {0x0214E, 0, UNI_LOWER},
+    {0x02183, 1, UNI_UPPER_LOWER},
+    {0x02C00, 47, UNI_UPPER},
+    {0x02C30, 47, UNI_LOWER},
+    {0x02C60, 2, UNI_UPPER_LOWER},
+    {0x02C63, 1, UNI_UPPER},
+    {0x02C65, 1, UNI_LOWER},
+    {0x02C67, 6, UNI_UPPER_LOWER},
+    {0x02C6E, 2, UNI_UPPER},
+    {0x02C71, 2, UNI_LOWER_UPPER},
+    {0x02C74, 2, UNI_LOWER_UPPER},
+    {0x02C77, 4, UNI_LOWER},
+    {0x02C7C, 1, UNI_LETTER},
+    {0x02C7E, 2, UNI_UPPER},
+    {0x02C81, 98, UNI_LOWER_UPPER},
+    {0x02CE4, 0, UNI_LOWER},
+    {0x02CEB, 3, UNI_UPPER_LOWER},
+    {0x02CEF, 2, UNI_MARK},
+    {0x02CF2, 1, UNI_UPPER_LOWER},
+    {0x02D00, 37, UNI_LOWER},
+    {0x02D27, 0, UNI_LOWER},
+    {0x02D2D, 0, UNI_LOWER},
+    {0x02D30, 55, UNI_LETTER},
+    {0x02D6F, 0, UNI_LETTER},
+    {0x02D7F, 0, UNI_MARK},
+    {0x02D80, 22, UNI_LETTER},
+    {0x02DA0, 6, UNI_LETTER},
+    {0x02DA8, 6, UNI_LETTER},
+    {0x02DB0, 6, UNI_LETTER},
+    {0x02DB8, 6, UNI_LETTER},
+    {0x02DC0, 6, UNI_LETTER},
+    {0x02DC8, 6, UNI_LETTER},
+    {0x02DD0, 6, UNI_LETTER},
+    {0x02DD8, 6, UNI_LETTER},
+    {0x02DE0, 31, UNI_MARK},
+    {0x02E2F, 0, UNI_LETTER},
+    {0x03000, 0, UNI_SPACE},
+    {0x03005, 1, UNI_LETTER},
+    {0x0302A, 5, UNI_MARK},
+    {0x03031, 4, UNI_LETTER},
+    {0x0303B, 1, UNI_LETTER},
+    {0x03041, 85, UNI_LETTER},
+    {0x03099, 1, UNI_MARK},
+    {0x0309D, 2, UNI_LETTER},
+    {0x030A1, 89, UNI_LETTER},
+    {0x030FC, 3, UNI_LETTER},
+    {0x03105, 42, UNI_LETTER},
+    {0x03131, 93, UNI_LETTER},
+    {0x031A0, 31, UNI_LETTER},
+    {0x031F0, 15, UNI_LETTER},
+    {0x03400, 6591, UNI_LETTER},
+    {0x04E00, 22156, UNI_LETTER},
+    {0x0A4D0, 45, UNI_LETTER},
+    {0x0A500, 268, UNI_LETTER},
+    {0x0A610, 15, UNI_LETTER},
+    {0x0A620, 9, UNI_DIGIT},
+    {0x0A62A, 1, UNI_LETTER},
+    {0x0A640, 45, UNI_UPPER_LOWER},
+    {0x0A66E, 0, UNI_LETTER},
+    {0x0A66F, 3, UNI_MARK},
+    {0x0A674, 9, UNI_MARK},
+    {0x0A67F, 0, UNI_LETTER},
+    {0x0A680, 27, UNI_UPPER_LOWER},
+    {0x0A69C, 1, UNI_LETTER},
+    {0x0A69E, 1, UNI_MARK},
+    {0x0A6A0, 69, UNI_LETTER},
+    {0x0A6F0, 1, UNI_MARK},
+    {0x0A717, 8, UNI_LETTER},
+    {0x0A722, 13, UNI_UPPER_LOWER},
+    {0x0A730, 1, UNI_LOWER},
+    {0x0A732, 61, UNI_UPPER_LOWER},
+    {0x0A770, 0, UNI_LETTER},
+    {0x0A771, 7, UNI_LOWER},
+    {0x0A779, 4, UNI_UPPER_LOWER},
+    {0x0A77E, 9, UNI_UPPER_LOWER},
+    {0x0A788, 0, UNI_LETTER},
+    {0x0A78B, 3, UNI_UPPER_LOWER},
+    {0x0A78F, 0, UNI_LETTER},
+    {0x0A790, 3, UNI_UPPER_LOWER},
+    {0x0A794, 1, UNI_LOWER},
+    {0x0A796, 20, UNI_UPPER_LOWER},
+    {0x0A7AB, 3, UNI_UPPER},
+    {0x0A7AF, 1, UNI_LOWER_UPPER},
+    {0x0A7B1, 3, UNI_UPPER},
+    {0x0A7B5, 15, UNI_LOWER_UPPER},
+    {0x0A7C5, 2, UNI_UPPER},
+    {0x0A7C8, 2, UNI_LOWER_UPPER},
+    {0x0A7D0, 1, UNI_UPPER_LOWER},
+    {0x0A7D3, 0, UNI_LOWER},
+    {0x0A7D5, 4, UNI_LOWER_UPPER},
+    {0x0A7F2, 2, UNI_LETTER},
+    {0x0A7F5, 1, UNI_UPPER_LOWER},
+    {0x0A7F7, 2, UNI_LETTER},
+    {0x0A7FA, 0, UNI_LOWER},
+    {0x0A7FB, 6, UNI_LETTER},
+    {0x0A802, 0, UNI_MARK},
+    {0x0A803, 2, UNI_LETTER},
+    {0x0A806, 0, UNI_MARK},
+    {0x0A807, 3, UNI_LETTER},
+    {0x0A80B, 0, UNI_MARK},
+    {0x0A80C, 22, UNI_LETTER},
+    {0x0A823, 4, UNI_MARK},
+    {0x0A82C, 0, UNI_MARK},
+    {0x0A840, 51, UNI_LETTER},
+    {0x0A880, 1, UNI_MARK},
+    {0x0A882, 49, UNI_LETTER},
+    {0x0A8B4, 17, UNI_MARK},
+    {0x0A8D0, 9, UNI_DIGIT},
+    {0x0A8E0, 17, UNI_MARK},
+    {0x0A8F2, 5, UNI_LETTER},
+    {0x0A8FB, 0, UNI_LETTER},
+    {0x0A8FD, 1, UNI_LETTER},
+    {0x0A8FF, 0, UNI_MARK},
+    {0x0A900, 9, UNI_DIGIT},
+    {0x0A90A, 27, UNI_LETTER},
+    {0x0A926, 7, UNI_MARK},
+    {0x0A930, 22, UNI_LETTER},
+    {0x0A947, 12, UNI_MARK},
+    {0x0A960, 28, UNI_LETTER},
+    {0x0A980, 3, UNI_MARK},
+    {0x0A984, 46, UNI_LETTER},
+    {0x0A9B3, 13, UNI_MARK},
+    {0x0A9CF, 0, UNI_LETTER},
+    {0x0A9D0, 9, UNI_DIGIT},
+    {0x0A9E0, 4, UNI_LETTER},
+    {0x0A9E5, 0, UNI_MARK},
+    {0x0A9E6, 9, UNI_LETTER},
+    {0x0A9F0, 9, UNI_DIGIT},
+    {0x0A9FA, 4, UNI_LETTER},
+    {0x0AA00, 40, UNI_LETTER},
+    {0x0AA29, 13, UNI_MARK},
+    {0x0AA40, 2, UNI_LETTER},
+    {0x0AA43, 0, UNI_MARK},
+    {0x0AA44, 7, UNI_LETTER},
+    {0x0AA4C, 1, UNI_MARK},
+    {0x0AA50, 9, UNI_DIGIT},
+    {0x0AA60, 22, UNI_LETTER},
+    {0x0AA7A, 0, UNI_LETTER},
+    {0x0AA7B, 2, UNI_MARK},
+    {0x0AA7E, 49, UNI_LETTER},
+    {0x0AAB0, 0, UNI_MARK},
+    {0x0AAB1, 0, UNI_LETTER},
+    {0x0AAB2, 2, UNI_MARK},
+    {0x0AAB5, 1, UNI_LETTER},
+    {0x0AAB7, 1, UNI_MARK},
+    {0x0AAB9, 4, UNI_LETTER},
+    {0x0AABE, 1, UNI_MARK},
+    {0x0AAC0, 0, UNI_LETTER},
+    {0x0AAC1, 0, UNI_MARK},
+    {0x0AAC2, 0, UNI_LETTER},
+    {0x0AADB, 2, UNI_LETTER},
+    {0x0AAE0, 10, UNI_LETTER},
+    {0x0AAEB, 4, UNI_MARK},
+    {0x0AAF2, 2, UNI_LETTER},
+    {0x0AAF5, 1, UNI_MARK},
+    {0x0AB01, 5, UNI_LETTER},
+    {0x0AB09, 5, UNI_LETTER},
+    {0x0AB11, 5, UNI_LETTER},
+    {0x0AB20, 6, UNI_LETTER},
+    {0x0AB28, 6, UNI_LETTER},
+    {0x0AB30, 42, UNI_LOWER},
+    {0x0AB5C, 3, UNI_LETTER},
+    {0x0AB60, 8, UNI_LOWER},
+    {0x0AB69, 0, UNI_LETTER},
+    {0x0AB70, 79, UNI_LOWER},
+    {0x0ABC0, 34, UNI_LETTER},
+    {0x0ABE3, 7, UNI_MARK},
+    {0x0ABEC, 1, UNI_MARK},
+    {0x0ABF0, 9, UNI_DIGIT},
+    {0x0AC00, 11171, UNI_LETTER},
+    {0x0D7B0, 22, UNI_LETTER},
+    {0x0D7CB, 48, UNI_LETTER},
+    {0x0F900, 365, UNI_LETTER},
+    {0x0FA70, 105, UNI_LETTER},
+    {0x0FB00, 6, UNI_LOWER},
+    {0x0FB13, 4, UNI_LOWER},
+    {0x0FB1D, 0, UNI_LETTER},
+    {0x0FB1E, 0, UNI_MARK},
+    {0x0FB1F, 9, UNI_LETTER},
+    {0x0FB2A, 12, UNI_LETTER},
+    {0x0FB38, 4, UNI_LETTER},
+    {0x0FB3E, 0, UNI_LETTER},
+    {0x0FB40, 1, UNI_LETTER},
+    {0x0FB43, 1, UNI_LETTER},
+    {0x0FB46, 107, UNI_LETTER},
+    {0x0FBD3, 362, UNI_LETTER},
+    {0x0FD50, 63, UNI_LETTER},
+    {0x0FD92, 53, UNI_LETTER},
+    {0x0FDF0, 11, UNI_LETTER},
+    {0x0FE00, 15, UNI_MARK},
+    {0x0FE20, 15, UNI_MARK},
+    {0x0FE70, 4, UNI_LETTER},
+    {0x0FE76, 134, UNI_LETTER},
+    {0x0FF10, 9, UNI_DIGIT},
+    {0x0FF21, 25, UNI_UPPER},
+    {0x0FF41, 25, UNI_LOWER},
+    {0x0FF66, 88, UNI_LETTER},
+    {0x0FFC2, 5, UNI_LETTER},
+    {0x0FFCA, 5, UNI_LETTER},
+    {0x0FFD2, 5, UNI_LETTER},
+    {0x0FFDA, 2, UNI_LETTER},
+    {0x10000, 11, UNI_LETTER},
+    {0x1000D, 25, UNI_LETTER},
+    {0x10028, 18, UNI_LETTER},
+    {0x1003C, 1, UNI_LETTER},
+    {0x1003F, 14, UNI_LETTER},
+    {0x10050, 13, UNI_LETTER},
+    {0x10080, 122, UNI_LETTER},
+    {0x101FD, 0, UNI_MARK},
+    {0x10280, 28, UNI_LETTER},
+    {0x102A0, 48, UNI_LETTER},
+    {0x102E0, 0, UNI_MARK},
+    {0x10300, 31, UNI_LETTER},
+    {0x1032D, 19, UNI_LETTER},
+    {0x10342, 7, UNI_LETTER},
+    {0x10350, 37, UNI_LETTER},
+    {0x10376, 4, UNI_MARK},
+    {0x10380, 29, UNI_LETTER},
+    {0x103A0, 35, UNI_LETTER},
+    {0x103C8, 7, UNI_LETTER},
+    {0x10400, 39, UNI_UPPER},
+    {0x10428, 39, UNI_LOWER},
+    {0x10450, 77, UNI_LETTER},
+    {0x104A0, 9, UNI_DIGIT},
+    {0x104B0, 35, UNI_UPPER},
+    {0x104D8, 35, UNI_LOWER},
+    {0x10500, 39, UNI_LETTER},
+    {0x10530, 51, UNI_LETTER},
+    {0x10570, 10, UNI_UPPER},
+    {0x1057C, 14, UNI_UPPER},
+    {0x1058C, 6, UNI_UPPER},
+    {0x10594, 1, UNI_UPPER},
+    {0x10597, 10, UNI_LOWER},
+    {0x105A3, 14, UNI_LOWER},
+    {0x105B3, 6, UNI_LOWER},
+    {0x105BB, 1, UNI_LOWER},
+    {0x10600, 310, UNI_LETTER},
+    {0x10740, 21, UNI_LETTER},
+    {0x10760, 7, UNI_LETTER},
+    {0x10780, 5, UNI_LETTER},
+    {0x10787, 41, UNI_LETTER},
+    {0x107B2, 8, UNI_LETTER},
+    {0x10800, 5, UNI_LETTER},
+    {0x10808, 0, UNI_LETTER},
+    {0x1080A, 43, UNI_LETTER},
+    {0x10837, 1, UNI_LETTER},
+    {0x1083C, 0, UNI_LETTER},
+    {0x1083F, 22, UNI_LETTER},
+    {0x10860, 22, UNI_LETTER},
+    {0x10880, 30, UNI_LETTER},
+    {0x108E0, 18, UNI_LETTER},
+    {0x108F4, 1, UNI_LETTER},
+    {0x10900, 21, UNI_LETTER},
+    {0x10920, 25, UNI_LETTER},
+    {0x10980, 55, UNI_LETTER},
+    {0x109BE, 1, UNI_LETTER},
+    {0x10A00, 0, UNI_LETTER},
+    {0x10A01, 2, UNI_MARK},
+    {0x10A05, 1, UNI_MARK},
+    {0x10A0C, 3, UNI_MARK},
+    {0x10A10, 3, UNI_LETTER},
+    {0x10A15, 2, UNI_LETTER},
+    {0x10A19, 28, UNI_LETTER},
+    {0x10A38, 2, UNI_MARK},
+    {0x10A3F, 0, UNI_MARK},
+    {0x10A60, 28, UNI_LETTER},
+    {0x10A80, 28, UNI_LETTER},
+    {0x10AC0, 7, UNI_LETTER},
+    {0x10AC9, 27, UNI_LETTER},
+    {0x10AE5, 1, UNI_MARK},
+    {0x10B00, 53, UNI_LETTER},
+    {0x10B40, 21, UNI_LETTER},
+    {0x10B60, 18, UNI_LETTER},
+    {0x10B80, 17, UNI_LETTER},
+    {0x10C00, 72, UNI_LETTER},
+    {0x10C80, 50, UNI_UPPER},
+    {0x10CC0, 50, UNI_LOWER},
+    {0x10D00, 35, UNI_LETTER},
+    {0x10D24, 3, UNI_MARK},
+    {0x10D30, 9, UNI_DIGIT},
+    {0x10E80, 41, UNI_LETTER},
+    {0x10EAB, 1, UNI_MARK},
+    {0x10EB0, 1, UNI_LETTER},
+    {0x10F00, 28, UNI_LETTER},
+    {0x10F27, 0, UNI_LETTER},
+    {0x10F30, 21, UNI_LETTER},
+    {0x10F46, 10, UNI_MARK},
+    {0x10F70, 17, UNI_LETTER},
+    {0x10F82, 3, UNI_MARK},
+    {0x10FB0, 20, UNI_LETTER},
+    {0x10FE0, 22, UNI_LETTER},
+    {0x11000, 2, UNI_MARK},
+    {0x11003, 52, UNI_LETTER},
+    {0x11038, 14, UNI_MARK},
+    {0x11066, 9, UNI_DIGIT},
+    {0x11070, 0, UNI_MARK},
+    {0x11071, 1, UNI_LETTER},
+    {0x11073, 1, UNI_MARK},
+    {0x11075, 0, UNI_LETTER},
+    {0x1107F, 3, UNI_MARK},
+    {0x11083, 44, UNI_LETTER},
+    {0x110B0, 10, UNI_MARK},
+    {0x110C2, 0, UNI_MARK},
+    {0x110D0, 24, UNI_LETTER},
+    {0x110F0, 9, UNI_DIGIT},
+    {0x11100, 2, UNI_MARK},
+    {0x11103, 35, UNI_LETTER},
+    {0x11127, 13, UNI_MARK},
+    {0x11136, 9, UNI_DIGIT},
+    {0x11144, 0, UNI_LETTER},
+    {0x11145, 1, UNI_MARK},
+    {0x11147, 0, UNI_LETTER},
+    {0x11150, 34, UNI_LETTER},
+    {0x11173, 0, UNI_MARK},
+    {0x11176, 0, UNI_LETTER},
+    {0x11180, 2, UNI_MARK},
+    {0x11183, 47, UNI_LETTER},
+    {0x111B3, 13, UNI_MARK},
+    {0x111C1, 3, UNI_LETTER},
+    {0x111C9, 3, UNI_MARK},
+    {0x111CE, 1, UNI_MARK},
+    {0x111D0, 9, UNI_DIGIT},
+    {0x111DA, 0, UNI_LETTER},
+    {0x111DC, 0, UNI_LETTER},
+    {0x11200, 17, UNI_LETTER},
+    {0x11213, 24, UNI_LETTER},
+    {0x1122C, 11, UNI_MARK},
+    {0x1123E, 0, UNI_MARK},
+    {0x11280, 6, UNI_LETTER},
+    {0x11288, 0, UNI_LETTER},
+    {0x1128A, 3, UNI_LETTER},
+    {0x1128F, 14, UNI_LETTER},
+    {0x1129F, 9, UNI_LETTER},
+    {0x112B0, 46, UNI_LETTER},
+    {0x112DF, 11, UNI_MARK},
+    {0x112F0, 9, UNI_DIGIT},
+    {0x11300, 3, UNI_MARK},
+    {0x11305, 7, UNI_LETTER},
+    {0x1130F, 1, UNI_LETTER},
+    {0x11313, 21, UNI_LETTER},
+    {0x1132A, 6, UNI_LETTER},
+    {0x11332, 1, UNI_LETTER},
+    {0x11335, 4, UNI_LETTER},
+    {0x1133B, 1, UNI_MARK},
+    {0x1133D, 0, UNI_LETTER},
+    {0x1133E, 6, UNI_MARK},
+    {0x11347, 1, UNI_MARK},
+    {0x1134B, 2, UNI_MARK},
+    {0x11350, 0, UNI_LETTER},
+    {0x11357, 0, UNI_MARK},
+    {0x1135D, 4, UNI_LETTER},
+    {0x11362, 1, UNI_MARK},
+    {0x11366, 6, UNI_MARK},
+    {0x11370, 4, UNI_MARK},
+    {0x11400, 52, UNI_LETTER},
+    {0x11435, 17, UNI_MARK},
+    {0x11447, 3, UNI_LETTER},
+    {0x11450, 9, UNI_DIGIT},
+    {0x1145E, 0, UNI_MARK},
+    {0x1145F, 2, UNI_LETTER},
+    {0x11480, 47, UNI_LETTER},
+    {0x114B0, 19, UNI_MARK},
+    {0x114C4, 1, UNI_LETTER},
+    {0x114C7, 0, UNI_LETTER},
+    {0x114D0, 9, UNI_DIGIT},
+    {0x11580, 46, UNI_LETTER},
+    {0x115AF, 6, UNI_MARK},
+    {0x115B8, 8, UNI_MARK},
+    {0x115D8, 3, UNI_LETTER},
+    {0x115DC, 1, UNI_MARK},
+    {0x11600, 47, UNI_LETTER},
+    {0x11630, 16, UNI_MARK},
+    {0x11644, 0, UNI_LETTER},
+    {0x11650, 9, UNI_DIGIT},
+    {0x11680, 42, UNI_LETTER},
+    {0x116AB, 12, UNI_MARK},
+    {0x116B8, 0, UNI_LETTER},
+    {0x116C0, 9, UNI_DIGIT},
+    {0x11700, 26, UNI_LETTER},
+    {0x1171D, 14, UNI_MARK},
+    {0x11730, 9, UNI_DIGIT},
+    {0x11740, 6, UNI_LETTER},
+    {0x11800, 43, UNI_LETTER},
+    {0x1182C, 14, UNI_MARK},
+    {0x118A0, 31, UNI_UPPER},
+    {0x118C0, 31, UNI_LOWER},
+    {0x118E0, 9, UNI_DIGIT},
+    {0x118FF, 7, UNI_LETTER},
+    {0x11909, 0, UNI_LETTER},
+    {0x1190C, 7, UNI_LETTER},
+    {0x11915, 1, UNI_LETTER},
+    {0x11918, 23, UNI_LETTER},
+    {0x11930, 5, UNI_MARK},
+    {0x11937, 1, UNI_MARK},
+    {0x1193B, 3, UNI_MARK},
+    {0x1193F, 0, UNI_LETTER},
+    {0x11940, 0, UNI_MARK},
+    {0x11941, 0, UNI_LETTER},
+    {0x11942, 1, UNI_MARK},
+    {0x11950, 9, UNI_DIGIT},
+    {0x119A0, 7, UNI_LETTER},
+    {0x119AA, 38, UNI_LETTER},
+    {0x119D1, 6, UNI_MARK},
+    {0x119DA, 6, UNI_MARK},
+    {0x119E1, 0, UNI_LETTER},
+    {0x119E3, 0, UNI_LETTER},
+    {0x119E4, 0, UNI_MARK},
+    {0x11A00, 0, UNI_LETTER},
+    {0x11A01, 9, UNI_MARK},
+    {0x11A0B, 39, UNI_LETTER},
+    {0x11A33, 6, UNI_MARK},
+    {0x11A3A, 0, UNI_LETTER},
+    {0x11A3B, 3, UNI_MARK},
+    {0x11A47, 0, UNI_MARK},
+    {0x11A50, 0, UNI_LETTER},
+    {0x11A51, 10, UNI_MARK},
+    {0x11A5C, 45, UNI_LETTER},
+    {0x11A8A, 15, UNI_MARK},
+    {0x11A9D, 0, UNI_LETTER},
+    {0x11AB0, 72, UNI_LETTER},
+    {0x11C00, 8, UNI_LETTER},
+    {0x11C0A, 36, UNI_LETTER},
+    {0x11C2F, 7, UNI_MARK},
+    {0x11C38, 7, UNI_MARK},
+    {0x11C40, 0, UNI_LETTER},
+    {0x11C50, 9, UNI_DIGIT},
+    {0x11C72, 29, UNI_LETTER},
+    {0x11C92, 21, UNI_MARK},
+    {0x11CA9, 13, UNI_MARK},
+    {0x11D00, 6, UNI_LETTER},
+    {0x11D08, 1, UNI_LETTER},
+    {0x11D0B, 37, UNI_LETTER},
+    {0x11D31, 5, UNI_MARK},
+    {0x11D3A, 0, UNI_MARK},
+    {0x11D3C, 1, UNI_MARK},
+    {0x11D3F, 6, UNI_MARK},
+    {0x11D46, 0, UNI_LETTER},
+    {0x11D47, 0, UNI_MARK},
+    {0x11D50, 9, UNI_DIGIT},
+    {0x11D60, 5, UNI_LETTER},
+    {0x11D67, 1, UNI_LETTER},
+    {0x11D6A, 31, UNI_LETTER},
+    {0x11D8A, 4, UNI_MARK},
+    {0x11D90, 1, UNI_MARK},
+    {0x11D93, 4, UNI_MARK},
+    {0x11D98, 0, UNI_LETTER},
+    {0x11DA0, 9, UNI_DIGIT},
+    {0x11EE0, 18, UNI_LETTER},
+    {0x11EF3, 3, UNI_MARK},
+    {0x11FB0, 0, UNI_LETTER},
+    {0x12000, 921, UNI_LETTER},
+    {0x12480, 195, UNI_LETTER},
+    {0x12F90, 96, UNI_LETTER},
+    {0x13000, 1070, UNI_LETTER},
+    {0x14400, 582, UNI_LETTER},
+    {0x16800, 568, UNI_LETTER},
+    {0x16A40, 30, UNI_LETTER},
+    {0x16A60, 9, UNI_DIGIT},
+    {0x16A70, 78, UNI_LETTER},
+    {0x16AC0, 9, UNI_DIGIT},
+    {0x16AD0, 29, UNI_LETTER},
+    {0x16AF0, 4, UNI_MARK},
+    {0x16B00, 47, UNI_LETTER},
+    {0x16B30, 6, UNI_MARK},
+    {0x16B40, 3, UNI_LETTER},
+    {0x16B50, 9, UNI_DIGIT},
+    {0x16B63, 20, UNI_LETTER},
+    {0x16B7D, 18, UNI_LETTER},
+    {0x16E40, 31, UNI_UPPER},
+    {0x16E60, 31, UNI_LOWER},
+    {0x16F00, 74, UNI_LETTER},
+    {0x16F4F, 0, UNI_MARK},
+    {0x16F50, 0, UNI_LETTER},
+    {0x16F51, 54, UNI_MARK},
+    {0x16F8F, 3, UNI_MARK},
+    {0x16F93, 12, UNI_LETTER},
+    {0x16FE0, 1, UNI_LETTER},
+    {0x16FE3, 0, UNI_LETTER},
+    {0x16FE4, 0, UNI_MARK},
+    {0x16FF0, 1, UNI_MARK},
+    {0x17000, 6135, UNI_LETTER},
+    {0x18800, 1237, UNI_LETTER},
+    {0x18D00, 8, UNI_LETTER},
+    {0x1AFF0, 3, UNI_LETTER},
+    {0x1AFF5, 6, UNI_LETTER},
+    {0x1AFFD, 1, UNI_LETTER},
+    {0x1B000, 290, UNI_LETTER},
+    {0x1B150, 2, UNI_LETTER},
+    {0x1B164, 3, UNI_LETTER},
+    {0x1B170, 395, UNI_LETTER},
+    {0x1BC00, 106, UNI_LETTER},
+    {0x1BC70, 12, UNI_LETTER},
+    {0x1BC80, 8, UNI_LETTER},
+    {0x1BC90, 9, UNI_LETTER},
+    {0x1BC9D, 1, UNI_MARK},
+    {0x1CF00, 45, UNI_MARK},
+    {0x1CF30, 22, UNI_MARK},
+    {0x1D165, 4, UNI_MARK},
+    {0x1D16D, 5, UNI_MARK},
+    {0x1D17B, 7, UNI_MARK},
+    {0x1D185, 6, UNI_MARK},
+    {0x1D1AA, 3, UNI_MARK},
+    {0x1D242, 2, UNI_MARK},
+    {0x1D400, 25, UNI_UPPER},
+    {0x1D41A, 25, UNI_LOWER},
+    {0x1D434, 25, UNI_UPPER},
+    {0x1D44E, 6, UNI_LOWER},
+    {0x1D456, 17, UNI_LOWER},
+    {0x1D468, 25, UNI_UPPER},
+    {0x1D482, 25, UNI_LOWER},
+    {0x1D49C, 0, UNI_UPPER},
+    {0x1D49E, 1, UNI_UPPER},
+    {0x1D4A2, 0, UNI_UPPER},
+    {0x1D4A5, 1, UNI_UPPER},
+    {0x1D4A9, 3, UNI_UPPER},
+    {0x1D4AE, 7, UNI_UPPER},
+    {0x1D4B6, 3, UNI_LOWER},
+    {0x1D4BB, 0, UNI_LOWER},
+    {0x1D4BD, 6, UNI_LOWER},
+    {0x1D4C5, 10, UNI_LOWER},
+    {0x1D4D0, 25, UNI_UPPER},
+    {0x1D4EA, 25, UNI_LOWER},
+    {0x1D504, 1, UNI_UPPER},
+    {0x1D507, 3, UNI_UPPER},
+    {0x1D50D, 7, UNI_UPPER},
+    {0x1D516, 6, UNI_UPPER},
+    {0x1D51E, 25, UNI_LOWER},
+    {0x1D538, 1, UNI_UPPER},
+    {0x1D53B, 3, UNI_UPPER},
+    {0x1D540, 4, UNI_UPPER},
+    {0x1D546, 0, UNI_UPPER},
+    {0x1D54A, 6, UNI_UPPER},
+    {0x1D552, 25, UNI_LOWER},
+    {0x1D56C, 25, UNI_UPPER},
+    {0x1D586, 25, UNI_LOWER},
+    {0x1D5A0, 25, UNI_UPPER},
+    {0x1D5BA, 25, UNI_LOWER},
+    {0x1D5D4, 25, UNI_UPPER},
+    {0x1D5EE, 25, UNI_LOWER},
+    {0x1D608, 25, UNI_UPPER},
+    {0x1D622, 25, UNI_LOWER},
+    {0x1D63C, 25, UNI_UPPER},
+    {0x1D656, 25, UNI_LOWER},
+    {0x1D670, 25, UNI_UPPER},
+    {0x1D68A, 27, UNI_LOWER},
+    {0x1D6A8, 24, UNI_UPPER},
+    {0x1D6C2, 24, UNI_LOWER},
+    {0x1D6DC, 5, UNI_LOWER},
+    {0x1D6E2, 24, UNI_UPPER},
+    {0x1D6FC, 24, UNI_LOWER},
+    {0x1D716, 5, UNI_LOWER},
+    {0x1D71C, 24, UNI_UPPER},
+    {0x1D736, 24, UNI_LOWER},
+    {0x1D750, 5, UNI_LOWER},
+    {0x1D756, 24, UNI_UPPER},
+    {0x1D770, 24, UNI_LOWER},
+    {0x1D78A, 5, UNI_LOWER},
+    {0x1D790, 24, UNI_UPPER},
+    {0x1D7AA, 24, UNI_LOWER},
+    {0x1D7C4, 5, UNI_LOWER},
+    {0x1D7CA, 1, UNI_UPPER_LOWER},
+    {0x1D7CE, 49, UNI_DIGIT},
+    {0x1DA00, 54, UNI_MARK},
+    {0x1DA3B, 49, UNI_MARK},
+    {0x1DA75, 0, UNI_MARK},
+    {0x1DA84, 0, UNI_MARK},
+    {0x1DA9B, 4, UNI_MARK},
+    {0x1DAA1, 14, UNI_MARK},
+    {0x1DF00, 9, UNI_LOWER},
+    {0x1DF0A, 0, UNI_LETTER},
+    {0x1DF0B, 19, UNI_LOWER},
+    {0x1E000, 6, UNI_MARK},
+    {0x1E008, 16, UNI_MARK},
+    {0x1E01B, 6, UNI_MARK},
+    {0x1E023, 1, UNI_MARK},
+    {0x1E026, 4, UNI_MARK},
+    {0x1E100, 44, UNI_LETTER},
+    {0x1E130, 6, UNI_MARK},
+    {0x1E137, 6, UNI_LETTER},
+    {0x1E140, 9, UNI_DIGIT},
+    {0x1E14E, 0, UNI_LETTER},
+    {0x1E290, 29, UNI_LETTER},
+    {0x1E2AE, 0, UNI_MARK},
+    {0x1E2C0, 43, UNI_LETTER},
+    {0x1E2EC, 3, UNI_MARK},
+    {0x1E2F0, 9, UNI_DIGIT},
+    {0x1E7E0, 6, UNI_LETTER},
+    {0x1E7E8, 3, UNI_LETTER},
+    {0x1E7ED, 1, UNI_LETTER},
+    {0x1E7F0, 14, UNI_LETTER},
+    {0x1E800, 196, UNI_LETTER},
+    {0x1E8D0, 6, UNI_MARK},
+    {0x1E900, 33, UNI_UPPER},
+    {0x1E922, 33, UNI_LOWER},
+    {0x1E944, 6, UNI_MARK},
+    {0x1E94B, 0, UNI_LETTER},
+    {0x1E950, 9, UNI_DIGIT},
+    {0x1EE00, 3, UNI_LETTER},
+    {0x1EE05, 26, UNI_LETTER},
+    {0x1EE21, 1, UNI_LETTER},
+    {0x1EE24, 0, UNI_LETTER},
+    {0x1EE27, 0, UNI_LETTER},
+    {0x1EE29, 9, UNI_LETTER},
+    {0x1EE34, 3, UNI_LETTER},
+    {0x1EE39, 0, UNI_LETTER},
+    {0x1EE3B, 0, UNI_LETTER},
+    {0x1EE42, 0, UNI_LETTER},
+    {0x1EE47, 0, UNI_LETTER},
+    {0x1EE49, 0, UNI_LETTER},
+    {0x1EE4B, 0, UNI_LETTER},
+    {0x1EE4D, 2, UNI_LETTER},
+    {0x1EE51, 1, UNI_LETTER},
+    {0x1EE54, 0, UNI_LETTER},
+    {0x1EE57, 0, UNI_LETTER},
+    {0x1EE59, 0, UNI_LETTER},
+    {0x1EE5B, 0, UNI_LETTER},
+    {0x1EE5D, 0, UNI_LETTER},
+    {0x1EE5F, 0, UNI_LETTER},
+    {0x1EE61, 1, UNI_LETTER},
+    {0x1EE64, 0, UNI_LETTER},
+    {0x1EE67, 3, UNI_LETTER},
+    {0x1EE6C, 6, UNI_LETTER},
+    {0x1EE74, 3, UNI_LETTER},
+    {0x1EE79, 3, UNI_LETTER},
+    {0x1EE7E, 0, UNI_LETTER},
+    {0x1EE80, 9, UNI_LETTER},
+    {0x1EE8B, 16, UNI_LETTER},
+    {0x1EEA1, 2, UNI_LETTER},
+    {0x1EEA5, 4, UNI_LETTER},
+    {0x1EEAB, 16, UNI_LETTER},
+    {0x1FBF0, 9, UNI_DIGIT},
+    {0x20000, 42719, UNI_LETTER},
+    {0x2A700, 4152, UNI_LETTER},
+    {0x2B740, 221, UNI_LETTER},
+    {0x2B820, 5761, UNI_LETTER},
+    {0x2CEB0, 7472, UNI_LETTER},
+    {0x2F800, 541, UNI_LETTER},
+    {0x30000, 4938, UNI_LETTER},
+    {0xE0100, 239, UNI_MARK}
+};
+
+#endif
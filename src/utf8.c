@@ -0,0 +1,186 @@
+#include "clovo/utf8.h"
+#include "clovo/charclass.h"
+
+#include "unicode_table.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+size_t utf8_decode(const char *s, size_t len, uint32_t *code_point) {
+  const unsigned char *p = (const unsigned char *)s;
+  uint32_t cp;
+  size_t need;
+  uint32_t min;
+
+  if (p[0] < 0x80) {
+    *code_point = p[0];
+    return 1;
+  } else if (p[0] >= 0xC2 && p[0] <= 0xDF) {
+    cp = p[0] & 0x1F;
+    need = 1;
+    min = 0x80;
+  } else if (p[0] >= 0xE0 && p[0] <= 0xEF) {
+    cp = p[0] & 0x0F;
+    need = 2;
+    min = 0x800;
+  } else if (p[0] >= 0xF0 && p[0] <= 0xF4) {
+    cp = p[0] & 0x07;
+    need = 3;
+    min = 0x10000;
+  } else {
+    *code_point = UTF8_INVALID;
+    return 1;
+  }
+
+  if (need >= len) {
+    *code_point = UTF8_INVALID;
+    return 1;
+  }
+  for (size_t k = 1; k <= need; k++) {
+    if ((p[k] & 0xC0) != 0x80) {
+      *code_point = UTF8_INVALID;
+      return 1;
+    }
+    cp = (cp << 6) | (p[k] & 0x3F);
+  }
+
+  if (cp < min || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) {
+    *code_point = UTF8_INVALID;
+    return 1;
+  }
+  *code_point = cp;
+  return need + 1;
+}
+
+// classes of ascii bytes, everything but letters and digits as CHAR_PUNCT
+static unsigned ascii_class(char c) {
+  unsigned bits = char_class(c);
+  return bits & CHAR_ALNUM ? bits : CHAR_PUNCT;
+}
+
+static unsigned kind_class(const unicode_range_t *range, uint32_t cp) {
+  switch (range->kind) {
+  case UNI_LOWER:
+    return CHAR_LOWER;
+  case UNI_UPPER:
+    return CHAR_UPPER;
+  case UNI_LETTER:
+    return CHAR_LETTER;
+  case UNI_DIGIT:
+    return CHAR_DIGIT;
+  case UNI_MARK:
+    return 0;
+  case UNI_SPACE:
+    return CHAR_PUNCT;
+  case UNI_UPPER_LOWER:
+    return (cp - range->first) % 2 == 0 ? CHAR_UPPER : CHAR_LOWER;
+  case UNI_LOWER_UPPER:
+    return (cp - range->first) % 2 == 0 ? CHAR_LOWER : CHAR_UPPER;
+  default:
+    return CHAR_PUNCT;
+  }
+}
+
+unsigned unicode_class(uint32_t code_point) {
+  if (code_point < 0x80)
+    return ascii_class((char)code_point);
+  if (code_point == UTF8_INVALID)
+    return CHAR_PUNCT;
+
+  // last range starting at or before the code point
+  int lo = 0;
+  int hi = UNICODE_RANGE_COUNT - 1;
+  int found = -1;
+  while (lo <= hi) {
+    int mid = (lo + hi) / 2;
+    if (unicode_ranges[mid].first <= code_point) {
+      found = mid;
+      lo = mid + 1;
+    } else {
+      hi = mid - 1;
+    }
+  }
+
+  if (found < 0)
+    return CHAR_PUNCT;
+  const unicode_range_t *range = &unicode_ranges[found];
+  if (code_point - range->first > range->extra)
+    return CHAR_PUNCT;
+  return kind_class(range, code_point);
+}
+
+// classify the leading run of ascii bytes in s[0..len), returns its length
+static size_t classify_ascii(const char *s, size_t len, unsigned *classes) {
+  size_t i = 0;
+
+#ifdef __SSE2__
+  // signed compares are fine, bytes >= 0x80 end the run before they matter
+  const __m128i upper_lo = _mm_set1_epi8('A' - 1);
+  const __m128i upper_hi = _mm_set1_epi8('Z' + 1);
+  const __m128i lower_lo = _mm_set1_epi8('a' - 1);
+  const __m128i lower_hi = _mm_set1_epi8('z' + 1);
+  const __m128i digit_lo = _mm_set1_epi8('0' - 1);
+  const __m128i digit_hi = _mm_set1_epi8('9' + 1);
+  __m128i upper = _mm_setzero_si128();
+  __m128i lower = _mm_setzero_si128();
+  __m128i digit = _mm_setzero_si128();
+  __m128i other = _mm_setzero_si128();
+
+  for (; i + 16 <= len; i += 16) {
+    __m128i v = _mm_loadu_si128((const __m128i *)(s + i));
+    if (_mm_movemask_epi8(v))
+      break;
+    __m128i u = _mm_and_si128(_mm_cmpgt_epi8(v, upper_lo),
+                              _mm_cmplt_epi8(v, upper_hi));
+    __m128i l = _mm_and_si128(_mm_cmpgt_epi8(v, lower_lo),
+                              _mm_cmplt_epi8(v, lower_hi));
+    __m128i d = _mm_and_si128(_mm_cmpgt_epi8(v, digit_lo),
+                              _mm_cmplt_epi8(v, digit_hi));
+    upper = _mm_or_si128(upper, u);
+    lower = _mm_or_si128(lower, l);
+    digit = _mm_or_si128(digit, d);
+    // not a letter or digit: all-ones xor (u | l | d)
+    other = _mm_or_si128(
+        other, _mm_xor_si128(_mm_or_si128(_mm_or_si128(u, l), d),
+                             _mm_cmpeq_epi8(v, v)));
+  }
+
+  if (_mm_movemask_epi8(upper))
+    *classes |= CHAR_UPPER;
+  if (_mm_movemask_epi8(lower))
+    *classes |= CHAR_LOWER;
+  if (_mm_movemask_epi8(digit))
+    *classes |= CHAR_DIGIT;
+  if (_mm_movemask_epi8(other))
+    *classes |= CHAR_PUNCT;
+#endif
+
+  // tail, or the block holding the first non-ascii byte
+  for (; i < len && (unsigned char)s[i] < 0x80; i++)
+    *classes |= ascii_class(s[i]);
+  return i;
+}
+
+text_class_t classify_text(const char *s, size_t len) {
+  text_class_t text = {0, 0, true};
+  if (!s)
+    return text;
+
+  size_t i = 0;
+  while (i < len) {
+    size_t run = classify_ascii(s + i, len - i, &text.classes);
+    text.code_points += (int)run;
+    i += run;
+
+    // decode until the next ascii byte
+    while (i < len && (unsigned char)s[i] >= 0x80) {
+      uint32_t cp;
+      i += utf8_decode(s + i, len - i, &cp);
+      text.classes |= unicode_class(cp);
+      text.code_points++;
+      text.ascii = false;
+    }
+  }
+  return text;
+}
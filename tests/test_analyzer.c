@@ -1,5 +1,7 @@
 #include "clovo/analyzer.h"
+#include "clovo/policy.h"
 #include "unity.h"
+#include <math.h>
 #include <string.h>
 
 // setUp and tearDown run before/after each test
@@ -96,14 +98,14 @@ void test_short_password(void) {
 }
 
 void test_medium_length_password(void) {
-  password_strength_t result = analyze_password("abcdefgh");
+  password_strength_t result = analyze_password("kwmxqzrb");
 
   TEST_ASSERT_EQUAL(8, result.length);
   TEST_ASSERT_GREATER_OR_EQUAL(20, result.score);
 }
 
 void test_long_password(void) {
-  password_strength_t result = analyze_password("abcdefghijklmnop");
+  password_strength_t result = analyze_password("kwmxqzrbtfhdjplv");
 
   TEST_ASSERT_EQUAL(16, result.length);
   TEST_ASSERT_GREATER_OR_EQUAL(40, result.score);
@@ -159,17 +161,17 @@ void test_weak_password(void) {
 void test_medium_password(void) {
   password_strength_t result = analyze_password("Password1");
 
-  // Password1 contains dictionary word, gets penalized
-  TEST_ASSERT_EQUAL(WEAK, result.level);
-  TEST_ASSERT_LESS_THAN(70, result.score);
+  // a capitalized word and a digit are among the first guesses
+  TEST_ASSERT_EQUAL(VERY_WEAK, result.level);
+  TEST_ASSERT_LESS_THAN(30, result.score);
 }
 
 void test_strong_password(void) {
   password_strength_t result = analyze_password("P@ssw0rd123");
 
-  // P@ssw0rd123 contains dictionary word and sequential pattern, gets penalized
-  TEST_ASSERT_EQUAL(MEDIUM, result.level);
-  TEST_ASSERT_LESS_THAN(85, result.score);
+  // P@ssw0rd123 is a leetspeak word and a sequence, a few thousand guesses
+  TEST_ASSERT_EQUAL(WEAK, result.level);
+  TEST_ASSERT_LESS_THAN(50, result.score);
 }
 
 void test_very_strong_password(void) {
@@ -200,16 +202,49 @@ void test_score_increases_with_variety(void) {
 void test_score_calculation_length_16plus(void) {
   password_strength_t result = analyze_password("aaaaaaaaaaaaaaaa"); // 16 chars
 
-  // Should get 40 points for length alone
-  TEST_ASSERT_GREATER_OR_EQUAL(40, result.score);
+  // length alone doesn't count, one character repeated is guessed quickly
+  TEST_ASSERT_EQUAL(VERY_WEAK, result.level);
+  TEST_ASSERT_LESS_THAN(30, result.score);
+}
+
+void test_score_follows_guesses(void) {
+  // a dictionary word costs what it saves an attacker, next to 24 random
+  // characters that is nothing, on its own it is everything
+  password_strength_t embedded =
+      analyze_password("xK9#mQ2vLp!zR4wT8nB3password7yHj");
+  TEST_ASSERT_TRUE(embedded.contains_dictionary_word);
+  TEST_ASSERT_GREATER_THAN(14.0, embedded.guesses_log10);
+  TEST_ASSERT_EQUAL(100, embedded.score);
+  TEST_ASSERT_EQUAL(VERY_STRONG, embedded.level);
+
+  password_strength_t bare = analyze_password("password");
+  TEST_ASSERT_LESS_THAN(3.0, bare.guesses_log10);
+  TEST_ASSERT_EQUAL(VERY_WEAK, bare.level);
+
+  // random characters cost their class pool per position, at least 10
+  password_strength_t letters = analyze_password("kwmxqzrb");
+  TEST_ASSERT_TRUE(letters.guesses_log10 >= 8 * log10(26.0) - 1e-9);
+  TEST_ASSERT_EQUAL(VERY_STRONG, letters.level);
+  password_strength_t digits = analyze_password("9157");
+  TEST_ASSERT_TRUE(digits.guesses_log10 >= 4.0 - 1e-9);
+  TEST_ASSERT_EQUAL(WEAK, digits.level);
+  // between the thresholds the score grows with the log of the guesses
+  password_strength_t shorter = analyze_password("91");
+  TEST_ASSERT_LESS_THAN(digits.score, shorter.score);
+  TEST_ASSERT_EQUAL(VERY_WEAK, shorter.level);
+
+  // a random password isn't cracked sooner than its pool suggests
+  password_strength_t random = analyze_password("Zx8q!mB2rT");
+  TEST_ASSERT_EQUAL(VERY_STRONG, random.level);
+  TEST_ASSERT_TRUE(random.crack_time_seconds > 365.0 * 86400.0);
 }
 
 void test_score_calculation_all_types(void) {
   // Password with all character types
   password_strength_t result = analyze_password("Abc123!@");
 
-  // Should have points from all variety types, but may have pattern penalties
-  // At minimum should have base points from length and variety
+  // "Abc" and "123" are runs, but four character types still take a few
+  // thousand guesses
   TEST_ASSERT_GREATER_OR_EQUAL(20, result.score);
 }
 
@@ -217,6 +252,16 @@ void test_score_calculation_all_types(void) {
 // Helper Function Tests
 // ============================================
 
+void test_has_sequential_runs(void) {
+  TEST_ASSERT_TRUE(has_sequential("x123", 4));
+  TEST_ASSERT_TRUE(has_sequential("x321", 4));
+  TEST_ASSERT_TRUE(has_sequential("aBc", 3)); // any case
+  TEST_ASSERT_FALSE(has_sequential("cba", 3)); // letters only forwards
+  TEST_ASSERT_FALSE(has_sequential("89:", 3)); // a digit run, then a symbol
+  TEST_ASSERT_FALSE(has_sequential("YZ[", 3));
+  TEST_ASSERT_FALSE(has_sequential("12", 2));
+}
+
 void test_level_to_string_no_password(void) {
   TEST_ASSERT_EQUAL_STRING("NO PASSWORD", level_to_string(NO_PASSWORD));
 }
@@ -252,6 +297,41 @@ void test_whitespace_in_password(void) {
   TEST_ASSERT_TRUE(result.has_symbol); // Space is treated as symbol
 }
 
+void test_utf8_letters_are_not_symbols(void) {
+  // "Пароль2024" in utf-8: 10 characters, 16 bytes
+  password_strength_t result = analyze_password(
+      "\xd0\x9f\xd0\xb0\xd1\x80\xd0\xbe\xd0\xbb\xd1\x8c"
+      "2024");
+
+  TEST_ASSERT_EQUAL(10, result.length);
+  TEST_ASSERT_EQUAL(16, result.byte_length);
+  TEST_ASSERT_TRUE(result.has_upper);
+  TEST_ASSERT_TRUE(result.has_lower);
+  TEST_ASSERT_TRUE(result.has_digit);
+  TEST_ASSERT_FALSE(result.has_symbol);
+}
+
+void test_utf8_caseless_letters(void) {
+  // "パスワード" (katakana), 5 characters
+  password_strength_t result = analyze_password(
+      "\xe3\x83\x91\xe3\x82\xb9\xe3\x83\xaf\xe3\x83\xbc"
+      "\xe3\x83\x89");
+
+  TEST_ASSERT_EQUAL(5, result.length);
+  TEST_ASSERT_TRUE(result.has_other_letter);
+  TEST_ASSERT_FALSE(result.has_symbol);
+  TEST_ASSERT_TRUE(result.entropy > 0.0);
+}
+
+void test_invalid_utf8_is_symbol(void) {
+  // a lone continuation byte and a truncated sequence, every bad byte counts
+  // as one character
+  password_strength_t result = analyze_password("ab\x80" "cd\xe3\x83");
+
+  TEST_ASSERT_EQUAL(7, result.length);
+  TEST_ASSERT_TRUE(result.has_symbol);
+}
+
 void test_special_characters_variety(void) {
   password_strength_t result = analyze_password("!@#$%^&*()");
 
@@ -310,6 +390,29 @@ void test_common_weak_password_abc123(void) {
   TEST_ASSERT_LESS_THAN(50, result.score);
 }
 
+void test_common_password_variant(void) {
+  // the built-in list has "password" and "qwerty"
+  password_strength_t result = analyze_password("Passwordd");
+  TEST_ASSERT_EQUAL(1, result.common_distance);
+  TEST_ASSERT_EQUAL_STRING("password", result.nearest_common);
+  TEST_ASSERT_GREATER_OR_EQUAL(20, result.pattern_penalty);
+
+  result = analyze_password("qwerty");
+  TEST_ASSERT_EQUAL(0, result.common_distance);
+
+  // one edit from a listed password is guessed by trying its edits, the
+  // level drops with the estimate
+  result = analyze_password("monkez");
+  TEST_ASSERT_EQUAL(1, result.common_distance);
+  TEST_ASSERT_LESS_THAN(6.0, result.guesses_log10);
+  TEST_ASSERT_EQUAL(WEAK, result.level);
+  TEST_ASSERT_LESS_THAN(50, result.score);
+
+  // two edits only count for longer passwords
+  TEST_ASSERT_EQUAL(-1, analyze_password("qwerty9!").common_distance);
+  TEST_ASSERT_EQUAL(-1, analyze_password("MyS3cur3P@ssw0rd!").common_distance);
+}
+
 void test_strong_password_example1(void) {
   password_strength_t result = analyze_password("MyS3cur3P@ssw0rd!");
   TEST_ASSERT_GREATER_OR_EQUAL(70, result.score);
@@ -350,6 +453,131 @@ void test_single_character(void) {
   TEST_ASSERT_EQUAL(VERY_WEAK, result.level);
 }
 
+// ============================================
+// Feature Mask Tests
+// ============================================
+
+void test_analyze_ex_runs_only_requested(void) {
+  password_strength_t result =
+      analyze_password_ex("abcdefgh", 8, ANALYZE_SEQUENTIAL);
+  TEST_ASSERT_EQUAL(ANALYZE_SEQUENTIAL, result.features);
+  TEST_ASSERT_TRUE(result.has_sequential_pattern);
+  TEST_ASSERT_EQUAL(8, result.length);
+  TEST_ASSERT_TRUE(result.has_lower);
+
+  // nothing else ran, and a subset doesn't make a score
+  result = analyze_password_ex("aaaaqwerty", 10, ANALYZE_SEQUENTIAL);
+  TEST_ASSERT_FALSE(result.has_keyboard_pattern);
+  TEST_ASSERT_FALSE(result.has_repeated_chars);
+  TEST_ASSERT_EQUAL(-1, result.common_distance);
+  TEST_ASSERT_TRUE(result.entropy == 0.0);
+  TEST_ASSERT_EQUAL(0, result.score);
+}
+
+void test_analyze_ex_matches_full_analysis(void) {
+  const char *passwords[] = {"password", "aaaaqwerty", "MyS3cur3P@ssw0rd!",
+                             "P@ssw0rd123", "abcdefgh"};
+  for (size_t i = 0; i < sizeof(passwords) / sizeof(passwords[0]); i++) {
+    const char *pw = passwords[i];
+    password_strength_t full = analyze_password(pw);
+    password_strength_t all = analyze_password_ex(pw, strlen(pw), ANALYZE_ALL);
+    TEST_ASSERT_EQUAL(full.score, all.score);
+    TEST_ASSERT_EQUAL(full.level, all.level);
+
+    password_strength_t part = analyze_password_ex(
+        pw, strlen(pw), ANALYZE_REPEATS | ANALYZE_DICTIONARY);
+    TEST_ASSERT_EQUAL(full.has_repeated_chars, part.has_repeated_chars);
+    TEST_ASSERT_EQUAL(full.contains_dictionary_word,
+                      part.contains_dictionary_word);
+    TEST_ASSERT_EQUAL(full.has_upper, part.has_upper);
+  }
+}
+
+void test_analyze_ex_unterminated_input(void) {
+  // only the first len bytes count
+  const char buffer[] = "qwertyXYZ";
+  password_strength_t result =
+      analyze_password_ex(buffer, 6, ANALYZE_KEYBOARD);
+  TEST_ASSERT_EQUAL(6, result.length);
+  TEST_ASSERT_FALSE(result.has_upper);
+  TEST_ASSERT_TRUE(result.has_keyboard_pattern);
+
+  TEST_ASSERT_EQUAL(NO_PASSWORD, analyze_password_ex(NULL, 3, 0).level);
+}
+
+void test_policy_features(void) {
+  password_policy_t policy;
+  init_policy(&policy, POLICY_BASIC);
+  TEST_ASSERT_EQUAL(0, policy.features);
+
+  unsigned strict = ANALYZE_SEQUENTIAL | ANALYZE_REPEATS | ANALYZE_DICTIONARY;
+  init_policy(&policy, POLICY_NIST);
+  TEST_ASSERT_EQUAL(strict, policy.features);
+  init_policy(&policy, POLICY_PCI_DSS);
+  TEST_ASSERT_EQUAL(strict, policy.features);
+
+  // a rule changed by hand still gets its detector
+  init_policy(&policy, POLICY_BASIC);
+  policy.allow_common_passwords = false;
+  TEST_ASSERT_EQUAL(ANALYZE_DICTIONARY, policy_features(&policy));
+  TEST_ASSERT_FALSE(validate_policy("password", &policy).passed);
+}
+
+void test_validate_policies_shared_analysis(void) {
+  password_policy_t policies[3];
+  init_policy(&policies[0], POLICY_NIST);
+  init_policy(&policies[1], POLICY_PCI_DSS);
+  init_policy(&policies[2], POLICY_BASIC);
+
+  const char *passwords[] = {"password", "Tr0ub4dor&3", "abc", "xkcdhorse"};
+  for (size_t p = 0; p < sizeof(passwords) / sizeof(passwords[0]); p++) {
+    policy_result_t details[3];
+    uint32_t mask = validate_policies(passwords[p], policies, 3, details);
+    TEST_ASSERT_EQUAL(mask, validate_policies(passwords[p], policies, 3, NULL));
+    for (int i = 0; i < 3; i++) {
+      policy_result_t alone = validate_policy(passwords[p], &policies[i]);
+      TEST_ASSERT_EQUAL(alone.passed, (mask >> i) & 1);
+      TEST_ASSERT_EQUAL(alone.violations_count, details[i].violations_count);
+    }
+  }
+
+  TEST_ASSERT_EQUAL(0, validate_policies(NULL, policies, 3, NULL));
+  TEST_ASSERT_EQUAL(0, validate_policies("anything", policies, 0, NULL));
+}
+
+void test_policy_verdict_matches_result(void) {
+  password_policy_t pci;
+  init_policy(&pci, POLICY_PCI_DSS);
+
+  policy_verdict_t verdict = evaluate_policy("abc", &pci);
+  uint32_t expected = (1u << POLICY_VIOLATION_TOO_SHORT) |
+                      (1u << POLICY_VIOLATION_UPPERCASE) |
+                      (1u << POLICY_VIOLATION_DIGITS) |
+                      (1u << POLICY_VIOLATION_SEQUENTIAL);
+  TEST_ASSERT_EQUAL_UINT32(expected, verdict.violations);
+  TEST_ASSERT_EQUAL(3, verdict.length);
+
+  // the messages come out as validate_policy() has always given them
+  policy_result_t result = validate_policy("abc", &pci);
+  TEST_ASSERT_FALSE(result.passed);
+  TEST_ASSERT_EQUAL(4, result.violations_count);
+  TEST_ASSERT_EQUAL_STRING("Password too short (minimum 7 characters)",
+                           result.violations[0]);
+  TEST_ASSERT_EQUAL_STRING("Contains sequential patterns",
+                           result.violations[3]);
+
+  char message[128];
+  policy_violation_message(&pci, POLICY_VIOLATION_DIGITS, message,
+                           sizeof(message));
+  TEST_ASSERT_EQUAL_STRING("Missing digits", message);
+
+  TEST_ASSERT_EQUAL(0, evaluate_policy("Tr0ub4dor&3", &pci).violations);
+  TEST_ASSERT_EQUAL_UINT32(1u << POLICY_VIOLATION_INVALID,
+                           evaluate_policy(NULL, &pci).violations);
+  TEST_ASSERT_EQUAL_STRING("Invalid input",
+                           validate_policy(NULL, &pci).violations[0]);
+}
+
 // ============================================
 // Main Test Runner
 // ============================================
@@ -389,9 +617,11 @@ int main(void) {
   RUN_TEST(test_score_increases_with_length);
   RUN_TEST(test_score_increases_with_variety);
   RUN_TEST(test_score_calculation_length_16plus);
+  RUN_TEST(test_score_follows_guesses);
   RUN_TEST(test_score_calculation_all_types);
 
   // Helper function tests
+  RUN_TEST(test_has_sequential_runs);
   RUN_TEST(test_level_to_string_no_password);
   RUN_TEST(test_level_to_string_very_weak);
   RUN_TEST(test_level_to_string_weak);
@@ -401,6 +631,9 @@ int main(void) {
 
   // Edge case tests
   RUN_TEST(test_whitespace_in_password);
+  RUN_TEST(test_utf8_letters_are_not_symbols);
+  RUN_TEST(test_utf8_caseless_letters);
+  RUN_TEST(test_invalid_utf8_is_symbol);
   RUN_TEST(test_special_characters_variety);
   RUN_TEST(test_very_long_password);
   RUN_TEST(test_numbers_at_end);
@@ -411,6 +644,7 @@ int main(void) {
   RUN_TEST(test_common_weak_password_123456);
   RUN_TEST(test_common_weak_password_qwerty);
   RUN_TEST(test_common_weak_password_abc123);
+  RUN_TEST(test_common_password_variant);
   RUN_TEST(test_strong_password_example1);
   RUN_TEST(test_strong_password_example2);
   RUN_TEST(test_strong_password_example3);
@@ -421,5 +655,13 @@ int main(void) {
   RUN_TEST(test_exactly_16_characters);
   RUN_TEST(test_single_character);
 
+  // Feature masks
+  RUN_TEST(test_analyze_ex_runs_only_requested);
+  RUN_TEST(test_analyze_ex_matches_full_analysis);
+  RUN_TEST(test_analyze_ex_unterminated_input);
+  RUN_TEST(test_policy_features);
+  RUN_TEST(test_validate_policies_shared_analysis);
+  RUN_TEST(test_policy_verdict_matches_result);
+
   return UNITY_END();
 }
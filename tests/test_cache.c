@@ -0,0 +1,149 @@
+#include "clovo/cache.h"
+#include "unity.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
+static analysis_cache_t *cache;
+
+void setUp(void) { cache = analysis_cache_create(64); }
+
+void tearDown(void) { analysis_cache_destroy(cache); }
+
+// ============================================
+// Analysis Tests
+// ============================================
+
+void test_cached_result_matches_uncached(void) {
+  const char *passwords[] = {"Password1!", "Welcome2024", "x7#Kp!2qZ"};
+  for (int round = 0; round < 2; round++) {
+    for (int i = 0; i < 3; i++) {
+      password_strength_t expected = analyze_password(passwords[i]);
+      password_strength_t cached = cached_analyze_password(cache, passwords[i]);
+      TEST_ASSERT_EQUAL(expected.score, cached.score);
+      TEST_ASSERT_EQUAL(expected.level, cached.level);
+      TEST_ASSERT_EQUAL(expected.length, cached.length);
+      TEST_ASSERT_TRUE(expected.entropy == cached.entropy);
+    }
+  }
+}
+
+void test_hit_and_miss_counters(void) {
+  cached_analyze_password(cache, "Password1!");
+  cached_analyze_password(cache, "Password1!");
+  cached_analyze_password(cache, "Password1!");
+  cached_analyze_password(cache, "Welcome2024");
+
+  cache_stats_t stats = analysis_cache_stats(cache);
+  TEST_ASSERT_EQUAL(2, stats.hits);
+  TEST_ASSERT_EQUAL(2, stats.misses);
+  TEST_ASSERT_EQUAL(2, stats.entries);
+}
+
+void test_capacity_is_bounded(void) {
+  char password[32];
+  for (int i = 0; i < 1000; i++) {
+    snprintf(password, sizeof(password), "candidate-%d", i);
+    cached_analyze_password(cache, password);
+  }
+
+  cache_stats_t stats = analysis_cache_stats(cache);
+  TEST_ASSERT_TRUE(stats.entries <= stats.capacity);
+  TEST_ASSERT_TRUE(stats.evictions >= 1000 - stats.capacity);
+  TEST_ASSERT_EQUAL(1000, stats.misses);
+}
+
+void test_hot_entry_survives_eviction(void) {
+  char password[32];
+  cached_analyze_password(cache, "Password1!");
+  for (int i = 0; i < 1000; i++) {
+    snprintf(password, sizeof(password), "candidate-%d", i);
+    cached_analyze_password(cache, password);
+    cached_analyze_password(cache, "Password1!");
+  }
+
+  // the hot password was referenced between every insert
+  cache_stats_t stats = analysis_cache_stats(cache);
+  TEST_ASSERT_EQUAL(1000, stats.hits);
+}
+
+void test_null_cache_falls_through(void) {
+  password_strength_t result = cached_analyze_password(NULL, "Password1!");
+  TEST_ASSERT_EQUAL(analyze_password("Password1!").score, result.score);
+}
+
+// ============================================
+// Policy Tests
+// ============================================
+
+void test_policy_verdicts(void) {
+  password_policy_t nist;
+  password_policy_t pci;
+  init_policy(&nist, POLICY_NIST);
+  init_policy(&pci, POLICY_PCI_DSS);
+
+  for (int round = 0; round < 2; round++) {
+    policy_result_t a = cached_validate_policy(cache, "password", &nist);
+    policy_result_t b = validate_policy("password", &nist);
+    TEST_ASSERT_EQUAL(b.passed, a.passed);
+    TEST_ASSERT_EQUAL(b.violations_count, a.violations_count);
+    TEST_ASSERT_EQUAL_STRING(b.violations[0], a.violations[0]);
+
+    // a different policy on the same entry reuses the analysis
+    a = cached_validate_policy(cache, "password", &pci);
+    b = validate_policy("password", &pci);
+    TEST_ASSERT_EQUAL(b.violations_count, a.violations_count);
+  }
+
+  cache_stats_t stats = analysis_cache_stats(cache);
+  TEST_ASSERT_EQUAL(1, stats.misses);
+  TEST_ASSERT_EQUAL(3, stats.hits);
+}
+
+// ============================================
+// Concurrency Tests
+// ============================================
+
+static void *hammer(void *arg) {
+  (void)arg;
+  char password[32];
+  for (int i = 0; i < 2000; i++) {
+    snprintf(password, sizeof(password), "Welcome%d", i % 100);
+    password_strength_t result = cached_analyze_password(cache, password);
+    if (result.length != (int)strlen(password))
+      return (void *)1;
+  }
+  return NULL;
+}
+
+void test_concurrent_callers(void) {
+  pthread_t threads[4];
+  for (int t = 0; t < 4; t++)
+    pthread_create(&threads[t], NULL, hammer, NULL);
+
+  bool failed = false;
+  for (int t = 0; t < 4; t++) {
+    void *result;
+    pthread_join(threads[t], &result);
+    failed |= result != NULL;
+  }
+  TEST_ASSERT_FALSE(failed);
+
+  cache_stats_t stats = analysis_cache_stats(cache);
+  TEST_ASSERT_EQUAL(8000, stats.hits + stats.misses);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_cached_result_matches_uncached);
+  RUN_TEST(test_hit_and_miss_counters);
+  RUN_TEST(test_capacity_is_bounded);
+  RUN_TEST(test_hot_entry_survives_eviction);
+  RUN_TEST(test_null_cache_falls_through);
+  RUN_TEST(test_policy_verdicts);
+  RUN_TEST(test_concurrent_callers);
+
+  return UNITY_END();
+}
@@ -0,0 +1,530 @@
+#include "clovo/charclass.h"
+#include "clovo/cluster.h"
+#include "clovo/comparison.h"
+#include "clovo/fuzzy.h"
+#include "unity.h"
+#include "test_helpers.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_RANDOM_LENGTH 200
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+// textbook two-row dp, the reference the bit-parallel version must match
+static int reference_distance(const char *s1, const char *s2) {
+  int len1 = (int)strlen(s1), len2 = (int)strlen(s2);
+  int *prev = malloc((len2 + 1) * sizeof(int));
+  int *cur = malloc((len2 + 1) * sizeof(int));
+  TEST_ASSERT_NOT_NULL(prev);
+  TEST_ASSERT_NOT_NULL(cur);
+
+  for (int j = 0; j <= len2; j++)
+    prev[j] = j;
+  for (int i = 1; i <= len1; i++) {
+    cur[0] = i;
+    for (int j = 1; j <= len2; j++) {
+      int best = prev[j - 1] + (s1[i - 1] != s2[j - 1]);
+      if (prev[j] + 1 < best)
+        best = prev[j] + 1;
+      if (cur[j - 1] + 1 < best)
+        best = cur[j - 1] + 1;
+      cur[j] = best;
+    }
+    int *swap = prev;
+    prev = cur;
+    cur = swap;
+  }
+  int result = prev[len2];
+  free(prev);
+  free(cur);
+  return result;
+}
+
+static void random_string(uint64_t *state, char *out, int len,
+                          const char *alphabet) {
+  size_t size = strlen(alphabet);
+  for (int i = 0; i < len; i++)
+    out[i] = alphabet[splitmix64(state) % size];
+  out[len] = '\0';
+}
+
+// ============================================
+// Edit Distance
+// ============================================
+
+void test_edit_distance_known_values(void) {
+  TEST_ASSERT_EQUAL(3, edit_distance("kitten", "sitting"));
+  TEST_ASSERT_EQUAL(0, edit_distance("password", "password"));
+  TEST_ASSERT_EQUAL(1, edit_distance("password", "password1"));
+  TEST_ASSERT_EQUAL(2, edit_distance("flaw", "lawn"));
+  TEST_ASSERT_EQUAL(5, edit_distance("", "hello"));
+  TEST_ASSERT_EQUAL(5, edit_distance("hello", ""));
+  TEST_ASSERT_EQUAL(0, edit_distance("", ""));
+  TEST_ASSERT_EQUAL(-1, edit_distance(NULL, "x"));
+}
+
+void test_edit_distance_matches_dp_on_random_strings(void) {
+  // small alphabets give long matching runs and many ties between the
+  // three dp moves, the full byte range exercises every peq entry
+  const char *alphabets[] = {"ab", "abcd",
+                             "abcdefghijklmnopqrstuvwxyz0123456789",
+                             "\x01\x7f\x80\xff"};
+  char s1[MAX_RANDOM_LENGTH + 1], s2[MAX_RANDOM_LENGTH + 1];
+  uint64_t state = 42;
+
+  for (size_t a = 0; a < sizeof(alphabets) / sizeof(alphabets[0]); a++) {
+    for (int round = 0; round < 500; round++) {
+      int len1 = (int)(splitmix64(&state) % (MAX_RANDOM_LENGTH + 1));
+      int len2 = (int)(splitmix64(&state) % (MAX_RANDOM_LENGTH + 1));
+      random_string(&state, s1, len1, alphabets[a]);
+      random_string(&state, s2, len2, alphabets[a]);
+      TEST_ASSERT_EQUAL(reference_distance(s1, s2), edit_distance(s1, s2));
+    }
+  }
+}
+
+void test_edit_distance_block_boundaries(void) {
+  // lengths on both sides of each 64-character block edge, with a few
+  // edits so the carries between blocks matter
+  int lengths[] = {63, 64, 65, 127, 128, 129, 300};
+  char s1[MAX_RANDOM_LENGTH * 2], s2[MAX_RANDOM_LENGTH * 2];
+  uint64_t state = 7;
+
+  for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+    for (size_t k = 0; k < sizeof(lengths) / sizeof(lengths[0]); k++) {
+      random_string(&state, s1, lengths[i], "abc");
+      memcpy(s2, s1, (size_t)lengths[i] + 1);
+      for (int e = 0; e < 5; e++)
+        s2[splitmix64(&state) % (uint64_t)lengths[i]] = 'x';
+      s2[lengths[k] < lengths[i] ? lengths[k] : lengths[i]] = '\0';
+      TEST_ASSERT_EQUAL(reference_distance(s1, s2), edit_distance(s1, s2));
+      TEST_ASSERT_EQUAL(reference_distance(s2, s1), edit_distance(s2, s1));
+    }
+  }
+}
+
+void test_edit_distance_long_strings(void) {
+  size_t len = EDIT_DISTANCE_MAX_LENGTH + 1;
+  char *a = malloc(len + 1), *b = malloc(len + 1);
+  TEST_ASSERT_NOT_NULL(a);
+  TEST_ASSERT_NOT_NULL(b);
+  memset(a, 'a', len);
+  a[len] = '\0';
+  memset(b, 'b', len);
+  b[len] = '\0';
+
+  // past the stack blocks the tables are allocated
+  TEST_ASSERT_EQUAL((int)len, edit_distance(a, b));
+  TEST_ASSERT_EQUAL((int)len - 3, edit_distance("aaa", a));
+  b[0] = 'a';
+  b[len / 2] = 'a';
+  TEST_ASSERT_EQUAL((int)len - 2, edit_distance(a, b));
+  TEST_ASSERT_EQUAL((int)len - 2, compare_passwords(a, b).edit_distance);
+
+  uint64_t state = 11;
+  random_string(&state, a, (int)len, "abc");
+  random_string(&state, b, (int)len - 40, "abc");
+  TEST_ASSERT_EQUAL(reference_distance(a, b), edit_distance(a, b));
+  free(a);
+  free(b);
+}
+
+// ============================================
+// Similarity
+// ============================================
+
+void test_compare_passwords(void) {
+  similarity_result_t r = compare_passwords("Summer2023!", "Summer2024!");
+  TEST_ASSERT_EQUAL(1, r.edit_distance);
+  TEST_ASSERT_EQUAL(10, r.common_positions);
+  TEST_ASSERT_TRUE(r.is_similar);
+  TEST_ASSERT_TRUE(are_passwords_too_similar("Summer2023!", "Summer2024!",
+                                             0.8));
+  TEST_ASSERT_FALSE(are_passwords_too_similar("Summer2023!", "x9#Lq!vT2m",
+                                              0.8));
+}
+
+// ============================================
+// History
+// ============================================
+
+// first entry within threshold by plain edit distance
+static int reference_history(const char *pw, const char *const history[],
+                             size_t n, int threshold) {
+  for (size_t i = 0; i < n; i++)
+    if (history[i] && reference_distance(pw, history[i]) <= threshold)
+      return (int)i;
+  return -1;
+}
+
+void test_history_finds_first_similar_entry(void) {
+  const char *history[] = {"Tr0ub4dor&3", NULL, "Summer2023!", "Winter2023!",
+                           "Summer2023!"};
+  TEST_ASSERT_EQUAL(2, check_against_history("Summer2024!", history, 5, 1));
+  TEST_ASSERT_EQUAL(2, check_against_history("Summer2024!", history, 5, 3));
+  TEST_ASSERT_EQUAL(-1, check_against_history("Summer2024!", history, 2, 3));
+  TEST_ASSERT_EQUAL(-1,
+                    check_against_history("x9#Lq!vT2m&k", history, 5, 4));
+  TEST_ASSERT_EQUAL(0, check_against_history("Tr0ub4dor&3", history, 5, 0));
+  TEST_ASSERT_EQUAL(-1, check_against_history("Tr0ub4dor&3", history, 5, -1));
+  TEST_ASSERT_EQUAL(-1, check_against_history(NULL, history, 5, 2));
+}
+
+void test_history_matches_reference(void) {
+  // 24 stored passwords, as a password-change check would keep. small
+  // alphabets and edited copies put plenty of entries near the threshold;
+  // some entries are past the lane length limit
+  enum { ENTRIES = 24 };
+  static char storage[ENTRIES][MAX_RANDOM_LENGTH + 1];
+  const char *history[ENTRIES];
+  char pw[MAX_RANDOM_LENGTH + 1];
+  uint64_t state = 99;
+
+  for (int round = 0; round < 400; round++) {
+    int max_len = round % 4 == 3 ? MAX_RANDOM_LENGTH : 20;
+    int len = 1 + (int)(splitmix64(&state) % (uint64_t)max_len);
+    random_string(&state, pw, len, round % 2 ? "abc" : "abcdefgh");
+    for (int e = 0; e < ENTRIES; e++) {
+      int entry_len = (int)(splitmix64(&state) % (uint64_t)(max_len + 1));
+      if (splitmix64(&state) % 3 == 0) {
+        int keep = entry_len < len ? entry_len : len;
+        memcpy(storage[e], pw, (size_t)keep);
+        random_string(&state, storage[e] + keep, entry_len - keep, "abc");
+        for (int x = 0; x < 2 && entry_len > 0; x++)
+          storage[e][splitmix64(&state) % (uint64_t)entry_len] = 'z';
+      } else {
+        random_string(&state, storage[e], entry_len, "abcdefgh");
+      }
+      history[e] = storage[e];
+    }
+
+    int threshold = (int)(splitmix64(&state) % 8);
+    if (round % 50 == 0)
+      threshold = 40; // wider than the band, falls back to edit_distance()
+    TEST_ASSERT_EQUAL(reference_history(pw, history, ENTRIES, threshold),
+                      check_against_history(pw, history, ENTRIES, threshold));
+  }
+}
+
+// ============================================
+// Clustering
+// ============================================
+
+// index of the cluster holding password, -1 if none
+static int cluster_of(const cluster_corpus_t *corpus, const char *password) {
+  for (size_t c = 0; c < cluster_count(corpus); c++) {
+    const password_cluster_t *cl = cluster_at(corpus, c);
+    for (size_t k = 0; k < cl->distinct; k++)
+      if (strcmp(cluster_member(corpus, cl, k, NULL), password) == 0)
+        return (int)c;
+  }
+  return -1;
+}
+
+void test_cluster_groups_password_family(void) {
+  cluster_corpus_t *corpus = cluster_corpus_create();
+  TEST_ASSERT_NOT_NULL(corpus);
+  const char *lines[] = {"Summer2023!", "Summer2024!", "summer2024",
+                         "Summer2024!", "Tr0ub4dor&3", "Summer2024!",
+                         "correcthorse", ""};
+  for (size_t i = 0; i < sizeof(lines) / sizeof(lines[0]); i++)
+    TEST_ASSERT_EQUAL(GEN_SUCCESS,
+                      cluster_corpus_add(corpus, lines[i], strlen(lines[i])));
+  TEST_ASSERT_EQUAL(GEN_SUCCESS, cluster_corpus_build(corpus, 2));
+
+  TEST_ASSERT_EQUAL(1, cluster_count(corpus));
+  const password_cluster_t *cl = cluster_at(corpus, 0);
+  TEST_ASSERT_EQUAL(5, cl->lines);
+  TEST_ASSERT_EQUAL(3, cl->distinct);
+  size_t count = 0;
+  TEST_ASSERT_EQUAL_STRING("Summer2024!",
+                           cluster_member(corpus, cl, 0, &count));
+  TEST_ASSERT_EQUAL(3, count);
+  TEST_ASSERT_EQUAL(-1, cluster_of(corpus, "Tr0ub4dor&3"));
+
+  cluster_stats_t stats = cluster_corpus_stats(corpus);
+  TEST_ASSERT_EQUAL(7, stats.lines);
+  TEST_ASSERT_EQUAL(5, stats.distinct);
+  TEST_ASSERT_EQUAL(1, stats.skipped);
+  TEST_ASSERT_EQUAL(3, stats.clustered);
+  cluster_corpus_free(corpus);
+}
+
+// the relation the clusters are built from, by brute force: some deletion
+// of at most one character from each (ignoring case) is equal
+static bool one_deletion_apart(const char *a, const char *b) {
+  char x[MAX_RANDOM_LENGTH + 1], y[MAX_RANDOM_LENGTH + 1];
+  int la = (int)strlen(a), lb = (int)strlen(b);
+  for (int p = -1; p < la; p++) {
+    int n = 0;
+    for (int i = 0; i < la; i++)
+      if (i != p)
+        x[n++] = char_fold(a[i]);
+    x[n] = '\0';
+    for (int q = -1; q < lb; q++) {
+      int m = 0;
+      for (int j = 0; j < lb; j++)
+        if (j != q)
+          y[m++] = char_fold(b[j]);
+      y[m] = '\0';
+      if (strcmp(x, y) == 0)
+        return true;
+    }
+  }
+  return false;
+}
+
+void test_cluster_members_link_to_representative(void) {
+  enum { WORDS = 120 };
+  static char words[WORDS][8];
+  uint64_t state = 3;
+  cluster_corpus_t *corpus = cluster_corpus_create();
+  TEST_ASSERT_NOT_NULL(corpus);
+  for (int i = 0; i < WORDS; i++) {
+    random_string(&state, words[i], 3 + (int)(splitmix64(&state) % 3), "abAB");
+    cluster_corpus_add(corpus, words[i], strlen(words[i]));
+  }
+  TEST_ASSERT_EQUAL(GEN_SUCCESS, cluster_corpus_build(corpus, 1));
+
+  // every member is linked to its representative (member 0), and no two
+  // representatives are, or the later one would have joined
+  size_t distinct = 0;
+  for (size_t c = 0; c < cluster_count(corpus); c++) {
+    const password_cluster_t *cl = cluster_at(corpus, c);
+    const char *representative = cluster_member(corpus, cl, 0, NULL);
+    for (size_t k = 1; k < cl->distinct; k++)
+      TEST_ASSERT_TRUE(one_deletion_apart(
+          representative, cluster_member(corpus, cl, k, NULL)));
+    for (size_t d = c + 1; d < cluster_count(corpus); d++)
+      TEST_ASSERT_FALSE(one_deletion_apart(
+          representative,
+          cluster_member(corpus, cluster_at(corpus, d), 0, NULL)));
+    distinct += cl->distinct;
+  }
+  TEST_ASSERT_EQUAL(cluster_corpus_stats(corpus).distinct, distinct);
+  cluster_corpus_free(corpus);
+}
+
+void test_cluster_does_not_chain(void) {
+  // each password is linked to the next, the ends are 4 edits apart
+  const char *chain[] = {"monkey", "monkey1", "monkey12", "monkey123",
+                         "onkey123", "nkey123"};
+  cluster_corpus_t *corpus = cluster_corpus_create();
+  TEST_ASSERT_NOT_NULL(corpus);
+  size_t n = sizeof(chain) / sizeof(chain[0]);
+  for (size_t i = 0; i < n; i++) {
+    // more frequent towards the start
+    for (size_t copies = 0; copies < n - i; copies++)
+      cluster_corpus_add(corpus, chain[i], strlen(chain[i]));
+  }
+  TEST_ASSERT_EQUAL(GEN_SUCCESS, cluster_corpus_build(corpus, 1));
+
+  TEST_ASSERT_EQUAL(cluster_of(corpus, "monkey"),
+                    cluster_of(corpus, "monkey1"));
+  TEST_ASSERT_TRUE(cluster_of(corpus, "monkey") !=
+                   cluster_of(corpus, "monkey12"));
+  TEST_ASSERT_TRUE(cluster_of(corpus, "monkey") !=
+                   cluster_of(corpus, "nkey123"));
+  TEST_ASSERT_EQUAL(3, cluster_count(corpus));
+  cluster_corpus_free(corpus);
+}
+
+// ============================================
+// Near Matches
+// ============================================
+
+void test_fuzzy_index_nearest_entry(void) {
+  static const char *const list[] = {
+      "password", "qwerty123", "dragon", "passwort",
+      "an entry far longer than the indexed limit"};
+  fuzzy_index_t *index = fuzzy_index_build(list, 5);
+  TEST_ASSERT_NOT_NULL(index);
+
+  size_t entry = 99;
+  TEST_ASSERT_EQUAL(0, fuzzy_index_nearest(index, "PASSWORD", 8, 2, &entry));
+  TEST_ASSERT_EQUAL(0, entry);
+  TEST_ASSERT_EQUAL(1, fuzzy_index_nearest(index, "qwerty12e", 9, 2, &entry));
+  TEST_ASSERT_EQUAL(1, entry);
+  TEST_ASSERT_EQUAL(2, fuzzy_index_nearest(index, "Dr4gon!", 7, 2, &entry));
+  TEST_ASSERT_EQUAL(2, entry);
+  // one edit from both "password" and "passwort", the earlier one wins
+  TEST_ASSERT_EQUAL(1, fuzzy_index_nearest(index, "passwore", 8, 2, &entry));
+  TEST_ASSERT_EQUAL(0, entry);
+
+  TEST_ASSERT_EQUAL(-1, fuzzy_index_nearest(index, "Dr4gon!", 7, 1, NULL));
+  TEST_ASSERT_EQUAL(-1, fuzzy_index_nearest(index, "xK9#mQ2v", 8, 2, NULL));
+  TEST_ASSERT_EQUAL(-1, fuzzy_index_nearest(index, list[4], strlen(list[4]),
+                                            2, NULL));
+  fuzzy_index_free(index);
+}
+
+void test_fuzzy_index_matches_brute_force(void) {
+  // small alphabets so most queries have entries one or two edits away,
+  // queries in upper case to check case is ignored
+  enum { ENTRIES = 400, QUERIES = 2000 };
+  static char storage[ENTRIES][12];
+  const char *list[ENTRIES];
+  uint64_t state = 7;
+  for (int e = 0; e < ENTRIES; e++) {
+    random_string(&state, storage[e], 1 + (int)(splitmix64(&state) % 10),
+                  e % 2 ? "abc" : "abcdef");
+    list[e] = storage[e];
+  }
+  fuzzy_index_t *index = fuzzy_index_build(list, ENTRIES);
+  TEST_ASSERT_NOT_NULL(index);
+
+  char query[16], folded[16];
+  for (int q = 0; q < QUERIES; q++) {
+    int len = 1 + (int)(splitmix64(&state) % 12);
+    random_string(&state, folded, len, q % 2 ? "abc" : "abcdef");
+    for (int i = 0; i <= len; i++)
+      query[i] = char_is_lower(folded[i]) ? (char)(folded[i] - 'a' + 'A')
+                                          : folded[i];
+    int max_distance = (int)(splitmix64(&state) % 3);
+
+    int expected = -1;
+    size_t expected_entry = 0;
+    for (size_t e = 0; e < ENTRIES; e++) {
+      int d = reference_distance(folded, list[e]);
+      if (d <= max_distance && (expected < 0 || d < expected)) {
+        expected = d;
+        expected_entry = e;
+      }
+    }
+
+    size_t entry = 0;
+    TEST_ASSERT_EQUAL(expected, fuzzy_index_nearest(index, query, (size_t)len,
+                                                    max_distance, &entry));
+    if (expected >= 0)
+      TEST_ASSERT_EQUAL(expected_entry, entry);
+  }
+  fuzzy_index_free(index);
+}
+
+// ============================================
+// Batch Comparison
+// ============================================
+
+void test_compare_batch_formats(void) {
+  const char *pairs = "password\tpassword1\n"
+                      "\"a,b\",\"a\"\"b\"\n"
+                      "not a pair\n"
+                      "\n"
+                      "Summer2023!,Summer2024!\r\n"
+                      "abc\txyz";
+  compare_batch_options_t options;
+  init_compare_batch_options(&options);
+  options.threads = 2;
+
+  FILE *in = file_with(pairs), *out = tmpfile();
+  compare_batch_stats_t stats;
+  TEST_ASSERT_EQUAL(GEN_SUCCESS, compare_batch(in, out, &options, &stats));
+  char *text = contents_of(out);
+  TEST_ASSERT_EQUAL_STRING(
+      "{\"line\":1,\"similarity\":0.8889,\"edit_distance\":1,"
+      "\"too_similar\":true}\n"
+      "{\"line\":2,\"similarity\":0.6667,\"edit_distance\":1,"
+      "\"too_similar\":false}\n"
+      "{\"line\":5,\"similarity\":0.9091,\"edit_distance\":1,"
+      "\"too_similar\":true}\n"
+      "{\"line\":6,\"similarity\":0.0000,\"edit_distance\":3,"
+      "\"too_similar\":false}\n",
+      text);
+  free(text);
+  TEST_ASSERT_EQUAL(6, stats.lines);
+  TEST_ASSERT_EQUAL(4, stats.pairs);
+  TEST_ASSERT_EQUAL(2, stats.too_similar);
+  TEST_ASSERT_EQUAL(1, stats.malformed);
+  fclose(in);
+  fclose(out);
+
+  options.format = COMPARE_BATCH_CSV;
+  in = file_with(pairs);
+  out = tmpfile();
+  TEST_ASSERT_EQUAL(GEN_SUCCESS, compare_batch(in, out, &options, NULL));
+  text = contents_of(out);
+  TEST_ASSERT_EQUAL_STRING("line,similarity,edit_distance,too_similar\n"
+                           "1,0.8889,1,true\n2,0.6667,1,false\n"
+                           "5,0.9091,1,true\n6,0.0000,3,false\n",
+                           text);
+  free(text);
+  fclose(in);
+  fclose(out);
+
+  // summary only: same counts, nothing written
+  options.format = COMPARE_BATCH_SUMMARY;
+  in = file_with(pairs);
+  out = tmpfile();
+  TEST_ASSERT_EQUAL(GEN_SUCCESS, compare_batch(in, out, &options, &stats));
+  TEST_ASSERT_EQUAL(0, ftell(out));
+  TEST_ASSERT_EQUAL(2, stats.too_similar);
+  fclose(in);
+  fclose(out);
+}
+
+void test_compare_batch_keeps_order_across_blocks(void) {
+  // well over one read block, so the lines are split between workers
+  enum { PAIRS = 60000 };
+  FILE *in = tmpfile();
+  TEST_ASSERT_NOT_NULL(in);
+  uint64_t state = 3;
+  size_t expected_similar = 0;
+  for (int i = 0; i < PAIRS; i++) {
+    char old_pw[24], new_pw[24];
+    random_string(&state, old_pw, 8 + i % 9, "abcdefghij");
+    memcpy(new_pw, old_pw, sizeof(old_pw));
+    new_pw[0] = i % 3 ? 'Z' : new_pw[0];
+    if (i % 5 == 0)
+      random_string(&state, new_pw, 12, "klmnop");
+    expected_similar += are_passwords_too_similar(old_pw, new_pw, 0.7);
+    fprintf(in, "%s\t%s\n", old_pw, new_pw);
+  }
+  rewind(in);
+
+  compare_batch_options_t options;
+  init_compare_batch_options(&options);
+  options.format = COMPARE_BATCH_CSV;
+  options.threads = 3;
+  FILE *out = tmpfile();
+  compare_batch_stats_t stats;
+  TEST_ASSERT_EQUAL(GEN_SUCCESS, compare_batch(in, out, &options, &stats));
+  TEST_ASSERT_EQUAL(PAIRS, stats.pairs);
+  TEST_ASSERT_EQUAL(expected_similar, stats.too_similar);
+
+  char *text = contents_of(out);
+  char *line = strchr(text, '\n') + 1; // past the header
+  for (long i = 1; i <= PAIRS; i++) {
+    TEST_ASSERT_EQUAL(i, strtol(line, &line, 10));
+    line = strchr(line, '\n') + 1;
+  }
+  TEST_ASSERT_EQUAL('\0', *line);
+  free(text);
+  fclose(in);
+  fclose(out);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_edit_distance_known_values);
+  RUN_TEST(test_edit_distance_matches_dp_on_random_strings);
+  RUN_TEST(test_edit_distance_block_boundaries);
+  RUN_TEST(test_edit_distance_long_strings);
+  RUN_TEST(test_compare_passwords);
+  RUN_TEST(test_history_finds_first_similar_entry);
+  RUN_TEST(test_history_matches_reference);
+  RUN_TEST(test_cluster_groups_password_family);
+  RUN_TEST(test_cluster_members_link_to_representative);
+  RUN_TEST(test_cluster_does_not_chain);
+  RUN_TEST(test_fuzzy_index_nearest_entry);
+  RUN_TEST(test_fuzzy_index_matches_brute_force);
+  RUN_TEST(test_compare_batch_formats);
+  RUN_TEST(test_compare_batch_keeps_order_across_blocks);
+
+  return UNITY_END();
+}
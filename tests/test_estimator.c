@@ -0,0 +1,201 @@
+#include "clovo/estimator.h"
+#include "clovo/keyboard.h"
+#include "unity.h"
+#include <math.h>
+#include <string.h>
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+// ============================================
+// Helpers
+// ============================================
+
+static bool has_match(const guess_estimate_t *e, match_pattern_t pattern,
+                      int i, int j) {
+  for (int k = 0; k < e->sequence_length; k++) {
+    if (e->sequence[k].pattern == pattern && e->sequence[k].i == i &&
+        e->sequence[k].j == j)
+      return true;
+  }
+  return false;
+}
+
+// ============================================
+// Basic Tests
+// ============================================
+
+void test_null_and_empty(void) {
+  guess_estimate_t e = estimate_guesses(NULL);
+  TEST_ASSERT_EQUAL(0, e.sequence_length);
+  TEST_ASSERT_EQUAL(1.0, e.guesses);
+
+  e = estimate_guesses("");
+  TEST_ASSERT_EQUAL(0, e.sequence_length);
+  TEST_ASSERT_EQUAL(0.0, e.guesses_log10);
+}
+
+void test_random_is_bruteforce(void) {
+  guess_estimate_t e = estimate_guesses("xK9#mQ2vLp8z");
+
+  TEST_ASSERT_EQUAL(1, e.sequence_length);
+  TEST_ASSERT_TRUE(has_match(&e, MATCH_BRUTEFORCE, 0, 11));
+  TEST_ASSERT_GREATER_OR_EQUAL(11.9, e.guesses_log10);
+}
+
+void test_bruteforce_uses_character_classes(void) {
+  // every position costs the pool of the classes the token uses
+  guess_estimate_t all = estimate_guesses("xK9#mQ2vLp8z");
+  TEST_ASSERT_TRUE(all.guesses_log10 > 12 * log10(95.0) - 1e-9);
+
+  guess_estimate_t lower = estimate_guesses("qzxwkvbj");
+  guess_estimate_t mixed = estimate_guesses("qZxWkVbJ");
+  TEST_ASSERT_TRUE(lower.guesses_log10 > 8 * log10(26.0) - 1e-9);
+  TEST_ASSERT_TRUE(mixed.guesses_log10 > 8 * log10(52.0) - 1e-9);
+}
+
+void test_sequence_covers_password(void) {
+  guess_estimate_t e = estimate_guesses("password");
+  TEST_ASSERT_TRUE(has_match(&e, MATCH_DICTIONARY, 0, 7));
+  TEST_ASSERT_LESS_THAN(2.0, e.guesses_log10);
+}
+
+// ============================================
+// Matcher Tests
+// ============================================
+
+void test_dictionary_word_inside_long_password(void) {
+  guess_estimate_t alone = estimate_guesses("password");
+  guess_estimate_t inside = estimate_guesses("x7#Kq9passwordZ2!m4Rv8wT1yL6nB3");
+  guess_estimate_t random = estimate_guesses("x7#Kq9d8Lh2ftZ2!m4Rv8wT1yL6nB3");
+
+  // the word is found at its position, the rest is still random
+  TEST_ASSERT_TRUE(has_match(&inside, MATCH_DICTIONARY, 6, 13));
+  TEST_ASSERT_GREATER_THAN(alone.guesses_log10 + 10, inside.guesses_log10);
+  TEST_ASSERT_LESS_THAN(random.guesses_log10, inside.guesses_log10);
+}
+
+void test_capitalized_word_costs_more(void) {
+  guess_estimate_t lower = estimate_guesses("welcome");
+  guess_estimate_t upper = estimate_guesses("Welcome");
+  TEST_ASSERT_GREATER_THAN(lower.guesses, upper.guesses);
+}
+
+void test_l33t_word(void) {
+  guess_estimate_t e = estimate_guesses("p@ssw0rd");
+
+  TEST_ASSERT_EQUAL(1, e.sequence_length);
+  TEST_ASSERT_EQUAL(MATCH_DICTIONARY, e.sequence[0].pattern);
+  TEST_ASSERT_TRUE(e.sequence[0].l33t);
+}
+
+void test_keyboard_walk(void) {
+  match_t matches[ESTIMATE_MAX_MATCHES];
+  int count = enumerate_matches("1qaz2wsx", 8, matches, ESTIMATE_MAX_MATCHES);
+
+  bool found = false;
+  for (int k = 0; k < count; k++) {
+    if (matches[k].pattern == MATCH_KEYBOARD && matches[k].i == 0 &&
+        matches[k].j == 7)
+      found = true;
+  }
+  TEST_ASSERT_TRUE(found);
+}
+
+void test_keyboard_walk_layouts(void) {
+  keyboard_walk_t walk;
+
+  // parallel column strokes chain into one walk
+  TEST_ASSERT_EQUAL(6, longest_keyboard_walk("wsxedc", 6));
+  TEST_ASSERT_EQUAL(8, longest_keyboard_walk("zaq1xsw2", 8));
+
+  TEST_ASSERT_TRUE(find_keyboard_walks("azerty", 6, &walk, 1) > 0);
+  TEST_ASSERT_EQUAL(6, longest_keyboard_walk("azerty", 6));
+  TEST_ASSERT_EQUAL(6, longest_keyboard_walk("qwertz", 6));
+  TEST_ASSERT_EQUAL(6, longest_keyboard_walk("aoeuid", 6));
+  TEST_ASSERT_EQUAL(6, longest_keyboard_walk("789456", 6));
+
+  // abc..h only has short accidental walks (cde, fgh)
+  TEST_ASSERT_EQUAL(3, longest_keyboard_walk("abcdefgh", 8));
+  TEST_ASSERT_EQUAL(0, longest_keyboard_walk("x7Kp", 4));
+}
+
+void test_sequence(void) {
+  guess_estimate_t e = estimate_guesses("lmnopqrs");
+  TEST_ASSERT_TRUE(has_match(&e, MATCH_SEQUENCE, 0, 7));
+  TEST_ASSERT_LESS_THAN(3.0, e.guesses_log10);
+}
+
+void test_repeat(void) {
+  guess_estimate_t e = estimate_guesses("zzzzzzzzzz");
+  TEST_ASSERT_TRUE(has_match(&e, MATCH_REPEAT, 0, 9));
+  TEST_ASSERT_EQUAL(10, e.sequence[0].repeat_count);
+
+  e = estimate_guesses("k8#k8#k8#");
+  TEST_ASSERT_TRUE(has_match(&e, MATCH_REPEAT, 0, 8));
+  TEST_ASSERT_EQUAL(3, e.sequence[0].repeat_count);
+}
+
+void test_dates(void) {
+  guess_estimate_t e = estimate_guesses("12/31/1999");
+  TEST_ASSERT_TRUE(has_match(&e, MATCH_DATE, 0, 9));
+  TEST_ASSERT_EQUAL(1999, e.sequence[0].year);
+
+  e = estimate_guesses("19870415");
+  TEST_ASSERT_TRUE(has_match(&e, MATCH_DATE, 0, 7));
+  TEST_ASSERT_EQUAL(1987, e.sequence[0].year);
+}
+
+// ============================================
+// Bounds Tests
+// ============================================
+
+void test_long_password_tail_is_bruteforce(void) {
+  char pw[ESTIMATE_MAX_LENGTH + 11];
+  memset(pw, 'a', sizeof(pw) - 1);
+  pw[sizeof(pw) - 1] = '\0';
+
+  guess_estimate_t capped = estimate_guesses(pw);
+  pw[ESTIMATE_MAX_LENGTH] = '\0';
+  guess_estimate_t prefix = estimate_guesses(pw);
+
+  TEST_ASSERT_LESS_OR_EQUAL(ESTIMATE_MAX_SEQUENCE, capped.sequence_length);
+  TEST_ASSERT_GREATER_THAN(prefix.guesses_log10 + 9.9, capped.guesses_log10);
+}
+
+void test_match_pattern_to_string(void) {
+  TEST_ASSERT_EQUAL_STRING("dictionary",
+                           match_pattern_to_string(MATCH_DICTIONARY));
+  TEST_ASSERT_EQUAL_STRING("date", match_pattern_to_string(MATCH_DATE));
+}
+
+// ============================================
+// Main Test Runner
+// ============================================
+
+int main(void) {
+  UNITY_BEGIN();
+
+  // Basic tests
+  RUN_TEST(test_null_and_empty);
+  RUN_TEST(test_random_is_bruteforce);
+  RUN_TEST(test_bruteforce_uses_character_classes);
+  RUN_TEST(test_sequence_covers_password);
+
+  // Matcher tests
+  RUN_TEST(test_dictionary_word_inside_long_password);
+  RUN_TEST(test_capitalized_word_costs_more);
+  RUN_TEST(test_l33t_word);
+  RUN_TEST(test_keyboard_walk);
+  RUN_TEST(test_keyboard_walk_layouts);
+  RUN_TEST(test_sequence);
+  RUN_TEST(test_repeat);
+  RUN_TEST(test_dates);
+
+  // Bounds tests
+  RUN_TEST(test_long_password_tail_is_bruteforce);
+  RUN_TEST(test_match_pattern_to_string);
+
+  return UNITY_END();
+}
@@ -1,10 +1,19 @@
+#include "clovo/bulk.h"
+#include "clovo/drbg.h"
 #include "clovo/generator.h"
+#include "clovo/markov.h"
+#include "clovo/passphrase.h"
 
+#include <math.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
+static int failures = 0;
+
 static void test(const char *name, int ok) {
   printf("[%s] %s\n", ok ? "PASS" : "FAIL", name);
+  failures += !ok;
 }
 
 int main(void) {
@@ -20,7 +29,9 @@ int main(void) {
   test("length < min_length => GEN_ERROR_INVALID_LENGTH",
        e == GEN_ERROR_INVALID_LENGTH);
 
-  e = generate_password(buf, sizeof(buf), 999, &opts);
+  char long_buf[128];
+  e = generate_password(long_buf, sizeof(long_buf), opts.max_length + 1,
+                        &opts);
   test("length > max_length => GEN_ERROR_INVALID_LENGTH",
        e == GEN_ERROR_INVALID_LENGTH);
 
@@ -44,8 +55,152 @@ int main(void) {
   test("generate_password() basic success",
        e == GEN_SUCCESS && strlen(buf) == 16);
 
+  unsigned char r1[32], r2[32];
+  test("drbg_random_bytes() success",
+       drbg_random_bytes(r1, sizeof(r1)) == GEN_SUCCESS &&
+           drbg_random_bytes(r2, sizeof(r2)) == GEN_SUCCESS);
+  test("drbg_random_bytes() consecutive draws differ",
+       memcmp(r1, r2, sizeof(r1)) != 0);
+
+  uint64_t seeds = drbg_seed_count();
+  static unsigned char big[DRBG_RESEED_BYTES];
+  drbg_random_bytes(big, sizeof(big));
+  drbg_random_bytes(r1, 1);
+  test("drbg reseeds after DRBG_RESEED_BYTES",
+       drbg_seed_count() == seeds + 1);
+
+  drbg_reseed();
+  drbg_random_bytes(r1, 1);
+  test("drbg_reseed() forces a reseed", drbg_seed_count() == seeds + 2);
+
+  bulk_options_t bulk;
+  init_bulk_options(&bulk);
+  bulk.length = 10;
+  bulk.count = 5000;
+  bulk.threads = 4;
+  bulk.unique = true;
+  FILE *out = tmpfile();
+  size_t written = 0;
+  e = generate_bulk(out, &bulk, &written);
+  test("generate_bulk() writes count passwords",
+       e == GEN_SUCCESS && written == 5000);
+
+  static char lines[5000][16];
+  int line_count = 0;
+  int bad_length = 0;
+  rewind(out);
+  while (line_count < 5000 && fgets(lines[line_count], 16, out)) {
+    lines[line_count][strcspn(lines[line_count], "\n")] = '\0';
+    bad_length += strlen(lines[line_count]) != 10;
+    line_count++;
+  }
+  fclose(out);
+  qsort(lines, line_count, sizeof(lines[0]),
+        (int (*)(const void *, const void *))strcmp);
+  int duplicates = 0;
+  for (int i = 1; i < line_count; i++)
+    duplicates += strcmp(lines[i - 1], lines[i]) == 0;
+  test("generate_bulk() lines have the requested length",
+       line_count == 5000 && bad_length == 0);
+  test("generate_bulk() --unique output has no duplicates", duplicates == 0);
+
+  bulk.length = 3;
+  e = generate_bulk(stdout, &bulk, &written);
+  test("generate_bulk() invalid length => GEN_ERROR_INVALID_LENGTH",
+       e == GEN_ERROR_INVALID_LENGTH && written == 0);
+
+  password_policy_t pci;
+  init_policy(&pci, POLICY_PCI_DSS);
+  generator_options_t lower_only = opts;
+  lower_only.include_uppercase = lower_only.include_digits =
+      lower_only.include_symbols = false;
+  int compliant = 0, total_attempts = 0;
+  for (int i = 0; i < 1000; i++) {
+    int attempts = 0;
+    e = generate_password_for_policy(buf, sizeof(buf), 8, &pci, &lower_only,
+                                     &attempts);
+    total_attempts += attempts;
+    compliant += e == GEN_SUCCESS && strlen(buf) == 8 &&
+                 validate_policy(buf, &pci).passed;
+  }
+  test("generate_password_for_policy() always satisfies PCI-DSS",
+       compliant == 1000);
+  test("generate_password_for_policy() needs ~1 attempt on average",
+       total_attempts < 1300);
+  test("generate_password_for_policy() length below policy minimum",
+       generate_password_for_policy(buf, sizeof(buf), 6, &pci, &opts, NULL) ==
+           GEN_ERROR_INVALID_LENGTH);
+  pci.require_symbols = true;
+  pci.min_length = 0;
+  test("generate_password_for_policy() more classes than characters",
+       generate_password_for_policy(buf, sizeof(buf), 3, &pci, &opts, NULL) ==
+           GEN_ERROR_INVALID_LENGTH);
+
+  char phrase[256];
+  e = generate_passphrase(phrase, sizeof(phrase), 4, &opts);
+  int dashes = 0;
+  for (char *c = phrase; *c; c++)
+    dashes += *c == '-';
+  test("generate_passphrase() joins 4 words", e == GEN_SUCCESS && dashes == 3);
+  test("generate_passphrase() allows more than 10 words",
+       generate_passphrase(phrase, sizeof(phrase), 16, &opts) == GEN_SUCCESS);
+
+  static const char dice[] = "# diceware list\n11111\tabacus\n"
+                             "11112\tabdomen\n\n11113\tAbacus\r\n42\n";
+  wordlist_t list;
+  e = wordlist_from_buffer(&list, dice, sizeof(dice) - 1);
+  test("wordlist_from_buffer() keeps distinct words only",
+       e == GEN_SUCCESS && list.count == 2 && list.max_length == 7);
+
+  passphrase_options_t popts;
+  init_passphrase_options(&popts);
+  popts.words = &list;
+  popts.separator = ".";
+  popts.capitalization = PASSPHRASE_TITLE;
+  popts.digits = 3;
+  double bits = 0.0;
+  e = generate_passphrase_ex(phrase, sizeof(phrase), &popts, &bits);
+  int words = 0, numbers = 0, untitled = 0;
+  for (char *tok = strtok(phrase, "."); tok; tok = strtok(NULL, ".")) {
+    if (strcmp(tok, "Abacus") == 0 || strcmp(tok, "Abdomen") == 0)
+      words++;
+    else if (strlen(tok) == 3 && strspn(tok, "0123456789") == 3)
+      numbers++;
+    else
+      untitled++;
+  }
+  test("generate_passphrase_ex() formats words, separator and digits",
+       e == GEN_SUCCESS && words == 4 && numbers == 1 && untitled == 0);
+  test("generate_passphrase_ex() reports exact entropy",
+       fabs(bits - (4.0 + 3 * log2(10.0) + log2(5.0))) < 1e-9);
+  test("generate_passphrase_ex() small buffer => GEN_ERROR_BUFFER_TOO_SMALL",
+       generate_passphrase_ex(phrase, passphrase_max_length(&popts), &popts,
+                              NULL) == GEN_ERROR_BUFFER_TOO_SMALL);
+  wordlist_free(&list);
+  test("wordlist_load() missing file => GEN_ERROR_FILE_ACCESS",
+       wordlist_load(&list, "./data/no_such_list.txt") ==
+           GEN_ERROR_FILE_ACCESS);
+
+  char spoken[PRONOUNCEABLE_MAX_LENGTH + 1];
+  double surprisal = 0.0;
+  e = generate_pronounceable(spoken, sizeof(spoken), 12, &surprisal);
+  test("generate_pronounceable() writes lowercase letters",
+       e == GEN_SUCCESS && strlen(spoken) == 12 &&
+           strspn(spoken, "abcdefghijklmnopqrstuvwxyz") == 12);
+  test("generate_pronounceable() reports the password's surprisal",
+       fabs(surprisal - pronounceable_surprisal(spoken)) < 1e-9);
+  test("pronounceable_surprisal() of a common password is infinite",
+       isinf(pronounceable_surprisal("password")));
+  test("pronounceable_entropy() is below uniform lowercase",
+       pronounceable_entropy(12) > 30.0 &&
+           pronounceable_entropy(12) < 12 * log2(26.0));
+  test("generate_pronounceable() too short => GEN_ERROR_INVALID_LENGTH",
+       generate_pronounceable(spoken, sizeof(spoken),
+                              PRONOUNCEABLE_MIN_LENGTH - 1,
+                              NULL) == GEN_ERROR_INVALID_LENGTH);
+
   cleanup_generator();
   test("cleanup_generator() completes", 1);
 
-  return 0;
+  return failures ? EXIT_FAILURE : EXIT_SUCCESS;
 }
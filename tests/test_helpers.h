@@ -0,0 +1,38 @@
+#ifndef TEST_HELPERS_H
+#define TEST_HELPERS_H
+
+// helpers shared by the test files, include after unity.h
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// deterministic stream so failures reproduce
+static inline uint64_t splitmix64(uint64_t *state) {
+  uint64_t z = (*state += 0x9e3779b97f4a7c15ULL);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+// a temporary file holding content, read from the start
+static inline FILE *file_with(const char *content) {
+  FILE *file = tmpfile();
+  TEST_ASSERT_NOT_NULL(file);
+  fputs(content, file);
+  rewind(file);
+  return file;
+}
+
+// everything written to file so far, NUL-terminated, caller frees
+static inline char *contents_of(FILE *file) {
+  long size = ftell(file);
+  char *text = malloc((size_t)size + 1);
+  TEST_ASSERT_NOT_NULL(text);
+  rewind(file);
+  TEST_ASSERT_EQUAL(size, (long)fread(text, 1, (size_t)size, file));
+  text[size] = '\0';
+  return text;
+}
+
+#endif
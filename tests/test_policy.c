@@ -0,0 +1,277 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "clovo/compliance.h"
+#include "clovo/custom_policy.h"
+#include "unity.h"
+#include "test_helpers.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BIT(v) ((uint32_t)1 << (v))
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+static policy_set_t *parse(const char *text) {
+  generator_error_t err;
+  int line;
+  policy_set_t *set = policy_set_parse(text, strlen(text), &err, &line);
+  TEST_ASSERT_EQUAL(GEN_SUCCESS, err);
+  TEST_ASSERT_NOT_NULL(set);
+  return set;
+}
+
+static uint32_t check(const custom_policy_t *policy, const char *pw) {
+  return custom_policy_check(policy, pw, strlen(pw), NULL);
+}
+
+void test_parse_sections(void) {
+  policy_set_t *set = parse("# internal policies\n"
+                            "[corp]\n"
+                            "min_length = 12   # at least\n"
+                            "\n"
+                            "[ legacy ]\r\n"
+                            "max_length=8\r\n");
+  TEST_ASSERT_EQUAL(2, policy_set_count(set));
+  TEST_ASSERT_EQUAL_STRING("corp", custom_policy_name(policy_set_get(set, 0)));
+  TEST_ASSERT_EQUAL_STRING("legacy",
+                           custom_policy_name(policy_set_get(set, 1)));
+  TEST_ASSERT_NULL(policy_set_get(set, 2));
+  TEST_ASSERT_NULL(policy_set_find(set, "missing"));
+
+  const custom_policy_t *corp = policy_set_find(set, "corp");
+  TEST_ASSERT_EQUAL(BIT(POLICY_VIOLATION_TOO_SHORT), check(corp, "short"));
+  TEST_ASSERT_EQUAL(0, check(corp, "long enough now"));
+  const custom_policy_t *legacy = policy_set_find(set, "legacy");
+  TEST_ASSERT_EQUAL(BIT(POLICY_VIOLATION_TOO_LONG), check(legacy, "too long!"));
+  policy_set_free(set);
+}
+
+void test_parse_errors_report_line(void) {
+  const char *bad[] = {
+      "min_length = 8\n",               // before any section
+      "[a]\nmin_length = -1\n",         // negative
+      "[a]\nmin_length = 8x\n",         // trailing junk
+      "[a]\nallow_common = maybe\n",    // not a boolean
+      "[a]\nmin_lenght = 8\n",          // unknown key
+      "[a]\n[a]\n",                     // duplicate name
+      "[a]\nmin_length 8\n",            // no '='
+      "[a]\n\n[]\n",                    // empty name
+  };
+  const int lines[] = {1, 2, 2, 2, 2, 2, 2, 3};
+  for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+    generator_error_t err;
+    int line;
+    TEST_ASSERT_NULL(policy_set_parse(bad[i], strlen(bad[i]), &err, &line));
+    TEST_ASSERT_EQUAL(GEN_ERROR_INVALID_CONFIG, err);
+    TEST_ASSERT_EQUAL(lines[i], line);
+  }
+
+  generator_error_t err;
+  TEST_ASSERT_NULL(policy_set_load("/nonexistent/policies.conf", &err, NULL));
+  TEST_ASSERT_EQUAL(GEN_ERROR_FILE_ACCESS, err);
+}
+
+void test_class_minimums_and_runs(void) {
+  policy_set_t *set = parse("[strict]\n"
+                            "min_lower = 2\nmin_upper = 1\n"
+                            "min_digits = 2\nmin_symbols = 1\n"
+                            "max_repeat = 2\n");
+  const custom_policy_t *policy = policy_set_get(set, 0);
+
+  TEST_ASSERT_EQUAL(0, check(policy, "abC12!"));
+  TEST_ASSERT_EQUAL(BIT(POLICY_VIOLATION_LOWERCASE) |
+                        BIT(POLICY_VIOLATION_DIGITS),
+                    check(policy, "aC1!"));
+  TEST_ASSERT_EQUAL(BIT(POLICY_VIOLATION_UPPERCASE) |
+                        BIT(POLICY_VIOLATION_SYMBOLS),
+                    check(policy, "ab12"));
+  TEST_ASSERT_EQUAL(BIT(POLICY_VIOLATION_REPEAT_RUN),
+                    check(policy, "abC12!!!"));
+  // characters are code points: two é are a run of two, both lowercase
+  TEST_ASSERT_EQUAL(0, check(policy, "\xc3\xa9\xc3\xa9" "C12!"));
+  TEST_ASSERT_EQUAL(BIT(POLICY_VIOLATION_REPEAT_RUN),
+                    check(policy, "\xc3\xa9\xc3\xa9\xc3\xa9" "C12!"));
+
+  char message[128];
+  custom_policy_describe(policy, POLICY_VIOLATION_DIGITS, message,
+                         sizeof(message));
+  TEST_ASSERT_EQUAL_STRING("Needs at least 2 digits", message);
+  policy_set_free(set);
+}
+
+void test_banned_substrings(void) {
+  policy_set_t *set = parse("[corp]\n"
+                            "banned = acme, Widget\n"
+                            "banned = he, she, hers, his\n");
+  const custom_policy_t *policy = policy_set_get(set, 0);
+  TEST_ASSERT_EQUAL(BIT(POLICY_VIOLATION_BANNED), check(policy, "xxACMExx"));
+  TEST_ASSERT_EQUAL(BIT(POLICY_VIOLATION_BANNED), check(policy, "wIdGeT"));
+  TEST_ASSERT_EQUAL(BIT(POLICY_VIOLATION_BANNED), check(policy, "ushers"));
+  TEST_ASSERT_EQUAL(0, check(policy, "acm-widge"));
+
+  // the automaton finds exactly what a naive search finds
+  const char *words[] = {"acme", "widget", "he", "she", "hers", "his"};
+  uint64_t state = 46;
+  for (int round = 0; round < 2000; round++) {
+    char pw[24];
+    int len = 1 + (int)(splitmix64(&state) % 20);
+    for (int i = 0; i < len; i++)
+      pw[i] = "acmewidgtHhsr"[splitmix64(&state) % 13];
+    pw[len] = '\0';
+
+    char folded[24];
+    for (int i = 0; i <= len; i++)
+      folded[i] = pw[i] == 'H' ? 'h' : pw[i];
+    bool expected = false;
+    for (size_t w = 0; w < sizeof(words) / sizeof(words[0]); w++)
+      expected |= strstr(folded, words[w]) != NULL;
+    TEST_ASSERT_EQUAL(expected, check(policy, pw) != 0);
+  }
+  policy_set_free(set);
+}
+
+void test_analyzer_rules_share_analysis(void) {
+  policy_set_t *set = parse("[nist-like]\n"
+                            "min_length = 8\n"
+                            "allow_common = no\n"
+                            "allow_sequential = false\n"
+                            "min_entropy = 30\n"
+                            "[lengths-only]\n"
+                            "min_length = 8\n");
+  const custom_policy_t *strict = policy_set_get(set, 0);
+  const custom_policy_t *lengths = policy_set_get(set, 1);
+  TEST_ASSERT_EQUAL(ANALYZE_DICTIONARY | ANALYZE_SEQUENTIAL | ANALYZE_ENTROPY,
+                    custom_policy_features(strict));
+  TEST_ASSERT_EQUAL(0, custom_policy_features(lengths));
+
+  const char *pw = "password123";
+  uint32_t alone = check(strict, pw);
+  TEST_ASSERT_TRUE(alone & BIT(POLICY_VIOLATION_COMMON));
+  TEST_ASSERT_TRUE(alone & BIT(POLICY_VIOLATION_SEQUENTIAL));
+
+  password_strength_t analysis = analyze_password(pw);
+  TEST_ASSERT_EQUAL(alone,
+                    custom_policy_check(strict, pw, strlen(pw), &analysis));
+  TEST_ASSERT_EQUAL(0, check(lengths, pw));
+  policy_set_free(set);
+}
+
+void test_load_from_file(void) {
+  char path[] = "/tmp/test_policy_XXXXXX";
+  FILE *file;
+  int fd = mkstemp(path);
+  TEST_ASSERT_TRUE(fd >= 0);
+  file = fdopen(fd, "w");
+  TEST_ASSERT_NOT_NULL(file);
+  fputs("[corp]\nmin_length = 10\nbanned = acme\n", file);
+  fclose(file);
+
+  generator_error_t err;
+  policy_set_t *set = policy_set_load(path, &err, NULL);
+  remove(path);
+  TEST_ASSERT_EQUAL(GEN_SUCCESS, err);
+  const custom_policy_t *corp = policy_set_find(set, "corp");
+  TEST_ASSERT_NOT_NULL(corp);
+  TEST_ASSERT_EQUAL(BIT(POLICY_VIOLATION_TOO_SHORT) |
+                        BIT(POLICY_VIOLATION_BANNED),
+                    check(corp, "acme1"));
+  policy_set_free(set);
+}
+
+// ============================================
+// Batch Compliance
+// ============================================
+
+void test_compliance_formats(void) {
+  const char *passwords = "password\nTr0ub4dor&3\n\nabc\r\n";
+  password_policy_t pci;
+  init_policy(&pci, POLICY_PCI_DSS);
+  compliance_options_t options;
+  init_compliance_options(&options);
+  options.policy = &pci;
+  options.threads = 2;
+
+  FILE *in = file_with(passwords), *out = tmpfile();
+  compliance_stats_t stats;
+  TEST_ASSERT_EQUAL(GEN_SUCCESS, check_compliance(in, out, &options, &stats));
+  char *text = contents_of(out);
+  TEST_ASSERT_EQUAL_STRING(
+      "{\"line\":1,\"passed\":false,"
+      "\"violations\":[\"uppercase\",\"digits\",\"common\"]}\n"
+      "{\"line\":2,\"passed\":true,\"violations\":[]}\n"
+      "{\"line\":4,\"passed\":false,\"violations\":[\"too_short\","
+      "\"uppercase\",\"digits\",\"sequential\"]}\n",
+      text);
+  free(text);
+  TEST_ASSERT_EQUAL(4, stats.lines);
+  TEST_ASSERT_EQUAL(3, stats.passwords);
+  TEST_ASSERT_EQUAL(2, stats.failed);
+  TEST_ASSERT_EQUAL(2, stats.violations[POLICY_VIOLATION_UPPERCASE]);
+  TEST_ASSERT_EQUAL(1, stats.violations[POLICY_VIOLATION_TOO_SHORT]);
+  TEST_ASSERT_EQUAL(0, stats.violations[POLICY_VIOLATION_SYMBOLS]);
+  fclose(in);
+  fclose(out);
+
+  // only the failures, as csv
+  options.format = COMPLIANCE_CSV;
+  options.failing_only = true;
+  in = file_with(passwords);
+  out = tmpfile();
+  TEST_ASSERT_EQUAL(GEN_SUCCESS, check_compliance(in, out, &options, NULL));
+  text = contents_of(out);
+  TEST_ASSERT_EQUAL_STRING("line,passed,violations\n"
+                           "1,false,uppercase|digits|common\n"
+                           "4,false,too_short|uppercase|digits|sequential\n",
+                           text);
+  free(text);
+  fclose(in);
+  fclose(out);
+}
+
+void test_compliance_custom_policy(void) {
+  policy_set_t *set = parse("[corp]\nmin_length = 6\nbanned = acme\n");
+  compliance_options_t options;
+  init_compliance_options(&options);
+  options.custom = policy_set_get(set, 0);
+  options.format = COMPLIANCE_SUMMARY;
+
+  FILE *in = file_with("acme-2024\nshort\nfine-password\n");
+  FILE *out = tmpfile();
+  compliance_stats_t stats;
+  TEST_ASSERT_EQUAL(GEN_SUCCESS, check_compliance(in, out, &options, &stats));
+  TEST_ASSERT_EQUAL(0, ftell(out));
+  TEST_ASSERT_EQUAL(3, stats.passwords);
+  TEST_ASSERT_EQUAL(2, stats.failed);
+  TEST_ASSERT_EQUAL(1, stats.violations[POLICY_VIOLATION_BANNED]);
+  TEST_ASSERT_EQUAL(1, stats.violations[POLICY_VIOLATION_TOO_SHORT]);
+  fclose(in);
+  fclose(out);
+  policy_set_free(set);
+
+  // no policy at all
+  options.custom = NULL;
+  in = file_with("x\n");
+  TEST_ASSERT_EQUAL(GEN_ERROR_NULL_POINTER,
+                    check_compliance(in, NULL, &options, NULL));
+  fclose(in);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_parse_sections);
+  RUN_TEST(test_parse_errors_report_line);
+  RUN_TEST(test_class_minimums_and_runs);
+  RUN_TEST(test_banned_substrings);
+  RUN_TEST(test_analyzer_rules_share_analysis);
+  RUN_TEST(test_load_from_file);
+  RUN_TEST(test_compliance_formats);
+  RUN_TEST(test_compliance_custom_policy);
+
+  return UNITY_END();
+}
@@ -0,0 +1,184 @@
+#define _POSIX_C_SOURCE 199309L
+
+#include "clovo/pool.h"
+#include "unity.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define TAKERS 4
+#define TAKES_PER_THREAD 1000
+
+static password_pool_t *pool;
+
+void setUp(void) { pool = NULL; }
+
+void tearDown(void) { password_pool_destroy(pool); }
+
+static void sleep_ms(long ms) {
+  struct timespec ts = {ms / 1000, (ms % 1000) * 1000000L};
+  nanosleep(&ts, NULL);
+}
+
+// poll until the refill thread has filled the ring, false after 5 seconds
+static bool wait_until_full(password_pool_t *p) {
+  for (int i = 0; i < 500; i++) {
+    pool_stats_t stats = password_pool_stats(p);
+    if (stats.available == stats.capacity)
+      return true;
+    sleep_ms(10);
+  }
+  return false;
+}
+
+// ============================================
+// Issuing
+// ============================================
+
+void test_take_returns_analyzed_password(void) {
+  pool_options_t options;
+  init_pool_options(&options);
+  options.capacity = 16;
+  options.length = 20;
+  pool = password_pool_create(&options);
+  TEST_ASSERT_NOT_NULL(pool);
+
+  char password[32];
+  password_strength_t analysis;
+  TEST_ASSERT_EQUAL(GEN_SUCCESS, password_pool_take(pool, password,
+                                                    sizeof(password),
+                                                    &analysis));
+  TEST_ASSERT_EQUAL(20, strlen(password));
+
+  password_strength_t expected = analyze_password(password);
+  TEST_ASSERT_EQUAL(expected.score, analysis.score);
+  TEST_ASSERT_TRUE(expected.entropy == analysis.entropy);
+}
+
+void test_takes_come_from_the_ring_and_refill(void) {
+  pool_options_t options;
+  init_pool_options(&options);
+  options.capacity = 64;
+  pool = password_pool_create(&options);
+  TEST_ASSERT_NOT_NULL(pool);
+  TEST_ASSERT_TRUE(wait_until_full(pool));
+
+  char password[32];
+  for (int i = 0; i < 64; i++)
+    TEST_ASSERT_EQUAL(GEN_SUCCESS, password_pool_take(pool, password,
+                                                      sizeof(password), NULL));
+
+  pool_stats_t stats = password_pool_stats(pool);
+  TEST_ASSERT_EQUAL(64, stats.issued);
+  TEST_ASSERT_EQUAL(0, stats.empty);
+
+  // dropping below the low-water mark wakes the thread to fill it again
+  TEST_ASSERT_TRUE(wait_until_full(pool));
+  TEST_ASSERT_GREATER_OR_EQUAL(128, password_pool_stats(pool).generated);
+}
+
+void test_policy_pool_is_compliant(void) {
+  password_policy_t pci;
+  init_policy(&pci, POLICY_PCI_DSS);
+  pool_options_t options;
+  init_pool_options(&options);
+  options.capacity = 32;
+  options.length = 8;
+  options.policy = &pci;
+  pool = password_pool_create(&options);
+  TEST_ASSERT_NOT_NULL(pool);
+
+  char password[16];
+  for (int i = 0; i < 100; i++) {
+    TEST_ASSERT_EQUAL(GEN_SUCCESS, password_pool_take(pool, password,
+                                                      sizeof(password), NULL));
+    TEST_ASSERT_TRUE(validate_policy(password, &pci).passed);
+  }
+}
+
+void test_invalid_options(void) {
+  pool_options_t options;
+  init_pool_options(&options);
+  options.length = 0;
+  TEST_ASSERT_NULL(password_pool_create(&options));
+
+  password_policy_t pci;
+  init_policy(&pci, POLICY_PCI_DSS);
+  options.length = 4; // shorter than the policy allows
+  options.policy = &pci;
+  TEST_ASSERT_NULL(password_pool_create(&options));
+
+  init_pool_options(&options);
+  options.length = 16;
+  pool = password_pool_create(&options);
+  char small[8];
+  TEST_ASSERT_EQUAL(GEN_ERROR_BUFFER_TOO_SMALL,
+                    password_pool_take(pool, small, sizeof(small), NULL));
+}
+
+// ============================================
+// Concurrency
+// ============================================
+
+typedef struct {
+  char passwords[TAKES_PER_THREAD][17];
+  int failures;
+} taker_t;
+
+static void *taker(void *arg) {
+  taker_t *t = arg;
+  for (int i = 0; i < TAKES_PER_THREAD; i++)
+    t->failures += password_pool_take(pool, t->passwords[i],
+                                      sizeof(t->passwords[i]),
+                                      NULL) != GEN_SUCCESS;
+  return NULL;
+}
+
+static int compare_passwords(const void *a, const void *b) {
+  return strcmp(a, b);
+}
+
+void test_concurrent_takers_never_share_a_password(void) {
+  pool_options_t options;
+  init_pool_options(&options);
+  options.capacity = 256;
+  pool = password_pool_create(&options);
+  TEST_ASSERT_NOT_NULL(pool);
+
+  static taker_t takers[TAKERS];
+  pthread_t threads[TAKERS];
+  memset(takers, 0, sizeof(takers));
+  for (int i = 0; i < TAKERS; i++)
+    TEST_ASSERT_EQUAL(0, pthread_create(&threads[i], NULL, taker, &takers[i]));
+  for (int i = 0; i < TAKERS; i++)
+    pthread_join(threads[i], NULL);
+
+  // 16 random characters never repeat by chance, a duplicate means a slot
+  // was handed out twice
+  static char all[TAKERS * TAKES_PER_THREAD][17];
+  for (int i = 0; i < TAKERS; i++) {
+    TEST_ASSERT_EQUAL(0, takers[i].failures);
+    memcpy(all[i * TAKES_PER_THREAD], takers[i].passwords,
+           sizeof(takers[i].passwords));
+  }
+  qsort(all, TAKERS * TAKES_PER_THREAD, sizeof(all[0]), compare_passwords);
+  for (int i = 1; i < TAKERS * TAKES_PER_THREAD; i++)
+    TEST_ASSERT_TRUE(strcmp(all[i - 1], all[i]) != 0);
+
+  TEST_ASSERT_EQUAL(TAKERS * TAKES_PER_THREAD,
+                    password_pool_stats(pool).issued);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_take_returns_analyzed_password);
+  RUN_TEST(test_takes_come_from_the_ring_and_refill);
+  RUN_TEST(test_policy_pool_is_compliant);
+  RUN_TEST(test_invalid_options);
+  RUN_TEST(test_concurrent_takers_never_share_a_password);
+
+  return UNITY_END();
+}
@@ -0,0 +1,285 @@
+#include "clovo/charset.h"
+#include "clovo/drbg.h"
+#include "clovo/sampler.h"
+#include "unity.h"
+#include "test_helpers.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+// pearson's chi-square statistic of n indices against a uniform range
+static double chi_square(const uint32_t *indices, size_t n, uint32_t range) {
+  size_t *counts = calloc(range, sizeof(*counts));
+  TEST_ASSERT_NOT_NULL(counts);
+  for (size_t i = 0; i < n; i++) {
+    TEST_ASSERT_LESS_THAN(range, indices[i]);
+    counts[indices[i]]++;
+  }
+  double expected = (double)n / range;
+  double chi = 0.0;
+  for (uint32_t v = 0; v < range; v++) {
+    double d = counts[v] - expected;
+    chi += d * d / expected;
+  }
+  free(counts);
+  return chi;
+}
+
+// chi-square bound with range - 1 degrees of freedom that a uniform source
+// exceeds with probability well under one in a million
+static double chi_square_limit(uint32_t range) {
+  double df = range - 1;
+  return df + 7.0 * sqrt(2.0 * df);
+}
+
+// ============================================
+// Deterministic Core
+// ============================================
+
+void test_batch_size(void) {
+  TEST_ASSERT_EQUAL(56, sampler_batch_size(2));
+  TEST_ASSERT_EQUAL(14, sampler_batch_size(16));
+  TEST_ASSERT_EQUAL(9, sampler_batch_size(51)); // 51^9 <= 2^56 < 51^10
+  TEST_ASSERT_EQUAL(8, sampler_batch_size(94));
+  TEST_ASSERT_EQUAL(1, sampler_batch_size(UINT32_MAX));
+}
+
+void test_power_of_two_range_reads_bits(void) {
+  // multiplying by 16 shifts the next nibble into the high word, and with
+  // 16^14 dividing 2^64 nothing is ever rejected
+  uint64_t word = 0x0123456789abcdefULL;
+  uint32_t out[14];
+  TEST_ASSERT_EQUAL(14, indices_from_words(16, &word, 1, out, 14));
+  for (uint32_t i = 0; i < 14; i++)
+    TEST_ASSERT_EQUAL_UINT32(i, out[i]);
+
+  word = 0;
+  TEST_ASSERT_EQUAL(1, indices_from_words(16, &word, 1, out, 1));
+  TEST_ASSERT_EQUAL_UINT32(0, out[0]);
+}
+
+void test_rejects_leftover_interval(void) {
+  // word 0 leaves low = 0, below 2^64 mod 51^9, so it must be thrown away
+  uint64_t words[2] = {0, UINT64_MAX};
+  uint32_t out[9];
+  TEST_ASSERT_EQUAL(0, indices_from_words(51, words, 1, out, 9));
+
+  // the largest word maps to the largest index in every position
+  TEST_ASSERT_EQUAL(9, indices_from_words(51, words, 2, out, 9));
+  for (int i = 0; i < 9; i++)
+    TEST_ASSERT_EQUAL_UINT32(50, out[i]);
+}
+
+void test_partial_batch(void) {
+  uint64_t state = 1;
+  uint64_t words[4];
+  for (int i = 0; i < 4; i++)
+    words[i] = splitmix64(&state);
+
+  // asking for fewer indices than a word holds uses the leading ones
+  uint32_t all[8], some[4];
+  TEST_ASSERT_EQUAL(8, indices_from_words(94, words, 1, all, 8));
+  TEST_ASSERT_EQUAL(4, indices_from_words(94, words, 1, some, 4));
+  TEST_ASSERT_EQUAL_MEMORY(all, some, sizeof(some));
+}
+
+void test_uniform_over_word_stream(void) {
+  const uint32_t ranges[] = {7, 51, 62, 94};
+  const size_t n = 1000000;
+  uint32_t *out = malloc(n * sizeof(*out));
+  uint64_t *words = malloc(n * sizeof(*words));
+  TEST_ASSERT_NOT_NULL(out);
+  TEST_ASSERT_NOT_NULL(words);
+
+  uint64_t state = 42;
+  for (size_t i = 0; i < n; i++)
+    words[i] = splitmix64(&state);
+
+  for (int r = 0; r < 4; r++) {
+    size_t filled = indices_from_words(ranges[r], words, n, out, n);
+    TEST_ASSERT_EQUAL(n, filled);
+    TEST_ASSERT_TRUE(chi_square(out, n, ranges[r]) <
+                     chi_square_limit(ranges[r]));
+  }
+  free(words);
+  free(out);
+}
+
+void test_positions_are_independent(void) {
+  // index pairs from the same word must be uniform over range^2 too,
+  // correlated positions inside a batch would show up here
+  const uint32_t range = 13;
+  const size_t pairs = 500000;
+  uint32_t *joint = malloc(pairs * sizeof(*joint));
+  uint64_t *words = malloc(pairs * sizeof(*words));
+  TEST_ASSERT_NOT_NULL(joint);
+  TEST_ASSERT_NOT_NULL(words);
+
+  uint64_t state = 7;
+  for (size_t i = 0; i < pairs; i++)
+    words[i] = splitmix64(&state);
+  // the pair is the first two of the 15 indices each word holds, rejected
+  // words are skipped like random_indices() does
+  size_t n = 0;
+  for (size_t i = 0; i < pairs; i++) {
+    uint32_t two[2];
+    if (indices_from_words(range, &words[i], 1, two, 2) == 2)
+      joint[n++] = two[0] * range + two[1];
+  }
+  TEST_ASSERT_GREATER_THAN(pairs - pairs / 64, n);
+  TEST_ASSERT_TRUE(chi_square(joint, n, range * range) <
+                   chi_square_limit(range * range));
+
+  free(words);
+  free(joint);
+}
+
+// ============================================
+// DRBG-backed Sampling
+// ============================================
+
+void test_random_indices_uniform(void) {
+  const uint32_t range = 51;
+  const size_t n = 51 * 20000;
+  uint32_t *out = malloc(n * sizeof(*out));
+  TEST_ASSERT_NOT_NULL(out);
+
+  TEST_ASSERT_EQUAL(GEN_SUCCESS, random_indices(range, out, n));
+  TEST_ASSERT_TRUE(chi_square(out, n, range) < chi_square_limit(range));
+  free(out);
+  drbg_clear();
+}
+
+void test_random_index_bounds(void) {
+  for (uint32_t range = 1; range <= 300; range++) {
+    uint32_t idx;
+    TEST_ASSERT_EQUAL(GEN_SUCCESS, random_index(range, &idx));
+    TEST_ASSERT_LESS_THAN(range, idx);
+  }
+  uint32_t idx;
+  TEST_ASSERT_EQUAL(GEN_SUCCESS, random_index(UINT32_MAX, &idx));
+  TEST_ASSERT_LESS_THAN(UINT32_MAX, idx);
+}
+
+void test_invalid_arguments(void) {
+  uint32_t idx;
+  TEST_ASSERT_EQUAL(GEN_ERROR_NULL_POINTER, random_indices(10, NULL, 1));
+  TEST_ASSERT_EQUAL(GEN_ERROR_NO_CHARSET, random_indices(0, &idx, 1));
+  TEST_ASSERT_EQUAL(GEN_SUCCESS, random_indices(10, &idx, 0));
+}
+
+// ============================================
+// Charset Kernel
+// ============================================
+
+void test_charset_kernel_sorts_and_dedups(void) {
+  charset_kernel_t kernel;
+  TEST_ASSERT_EQUAL(GEN_SUCCESS, charset_kernel_init(&kernel, "zyxa0za"));
+  TEST_ASSERT_EQUAL_STRING("0axyz", kernel.chars);
+  TEST_ASSERT_EQUAL(5, kernel.size);
+  TEST_ASSERT_EQUAL(65536 % 5, kernel.threshold);
+  TEST_ASSERT_EQUAL(3, kernel.runs); // "0", "a", "xyz"
+
+  TEST_ASSERT_EQUAL(GEN_ERROR_NO_CHARSET, charset_kernel_init(&kernel, ""));
+  TEST_ASSERT_EQUAL(GEN_ERROR_NULL_POINTER, charset_kernel_init(&kernel, NULL));
+}
+
+void test_charset_maps_words_with_rejection(void) {
+  charset_kernel_t kernel;
+  charset_kernel_init(&kernel, "abcdefghijklmnopqrstuvwxyz0123456789");
+  // 65536 mod 36 = 16: word 0 has low half 0 and is dropped, 0xffff maps
+  // to the last character
+  uint16_t words[3] = {0, 0xffff, 0x8001};
+  char out[4] = "";
+  TEST_ASSERT_EQUAL(2, charset_map_words_scalar(&kernel, words, 3, out, 3));
+  TEST_ASSERT_EQUAL('z', out[0]);
+  TEST_ASSERT_EQUAL(kernel.chars[18], out[1]);
+}
+
+// the vector path must give the scalar path's output byte for byte, on
+// charsets with one run, several runs and too many runs to vectorize, with
+// rejected words mixed in
+void test_charset_vector_matches_scalar(void) {
+  const char *charsets[] = {
+      "abcdefghijklmnopqrstuvwxyz",
+      "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789"
+      "!@#$%^&*()_+-=[]{}|;:,.<>?/~`",
+      "acegikmoqsuwyACEGIKMOQSUWY02468",
+      "\x01\x7f\x80\xfe\xff"};
+  const size_t word_count = 4099;
+  uint16_t *words = malloc(word_count * sizeof(*words));
+  char *vector = malloc(word_count);
+  char *scalar = malloc(word_count);
+  TEST_ASSERT_NOT_NULL(words);
+  TEST_ASSERT_NOT_NULL(vector);
+  TEST_ASSERT_NOT_NULL(scalar);
+
+  uint64_t state = 7;
+  for (size_t i = 0; i < word_count; i++)
+    words[i] = i % 37 == 5 ? 0 : (uint16_t)splitmix64(&state);
+
+  for (size_t c = 0; c < sizeof(charsets) / sizeof(charsets[0]); c++) {
+    charset_kernel_t kernel;
+    TEST_ASSERT_EQUAL(GEN_SUCCESS, charset_kernel_init(&kernel, charsets[c]));
+    // odd limits exercise the scalar tails
+    size_t limits[] = {word_count, word_count - 200, 17, 15};
+    for (size_t l = 0; l < sizeof(limits) / sizeof(limits[0]); l++) {
+      size_t a = charset_map_words(&kernel, words, word_count, vector,
+                                   limits[l]);
+      size_t b = charset_map_words_scalar(&kernel, words, word_count, scalar,
+                                          limits[l]);
+      TEST_ASSERT_EQUAL(b, a);
+      TEST_ASSERT_EQUAL_MEMORY(scalar, vector, a);
+    }
+  }
+  free(words);
+  free(vector);
+  free(scalar);
+}
+
+void test_charset_fill_uniform(void) {
+  charset_kernel_t kernel;
+  charset_kernel_init(&kernel, "!@#$%^&*()_+-=[]{}|;:,.<>?/~`0123456789");
+  const size_t n = 39 * 20000;
+  char *out = malloc(n);
+  uint32_t *indices = malloc(n * sizeof(*indices));
+  TEST_ASSERT_NOT_NULL(out);
+  TEST_ASSERT_NOT_NULL(indices);
+
+  TEST_ASSERT_EQUAL(GEN_SUCCESS, charset_fill(&kernel, out, n));
+  for (size_t i = 0; i < n; i++) {
+    const char *at = memchr(kernel.chars, out[i], kernel.size);
+    TEST_ASSERT_NOT_NULL(at);
+    indices[i] = (uint32_t)(at - kernel.chars);
+  }
+  TEST_ASSERT_TRUE(chi_square(indices, n, kernel.size) <
+                   chi_square_limit(kernel.size));
+  free(out);
+  free(indices);
+  drbg_clear();
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_batch_size);
+  RUN_TEST(test_power_of_two_range_reads_bits);
+  RUN_TEST(test_rejects_leftover_interval);
+  RUN_TEST(test_partial_batch);
+  RUN_TEST(test_uniform_over_word_stream);
+  RUN_TEST(test_positions_are_independent);
+  RUN_TEST(test_random_indices_uniform);
+  RUN_TEST(test_random_index_bounds);
+  RUN_TEST(test_invalid_arguments);
+  RUN_TEST(test_charset_kernel_sorts_and_dedups);
+  RUN_TEST(test_charset_maps_words_with_rejection);
+  RUN_TEST(test_charset_vector_matches_scalar);
+  RUN_TEST(test_charset_fill_uniform);
+
+  return UNITY_END();
+}
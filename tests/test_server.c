@@ -0,0 +1,523 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "clovo/http.h"
+#include "clovo/server.h"
+#include "unity.h"
+
+#include <netinet/in.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#define CLIENTS 8
+#define REQUESTS_PER_CLIENT 200
+
+static char socket_path[64];
+static policy_set_t *custom;
+static server_t *server;
+static pthread_t runner;
+static generator_error_t run_result;
+
+static void *run_server(void *arg) {
+  (void)arg;
+  run_result = server_run(server);
+  return NULL;
+}
+
+void setUp(void) {
+  snprintf(socket_path, sizeof(socket_path), "/tmp/clovo_test_%d.sock",
+           (int)getpid());
+  const char *config = "[corp]\nmin_length = 12\nbanned = acme\n";
+  custom = policy_set_parse(config, strlen(config), NULL, NULL);
+
+  server_options_t options;
+  init_server_options(&options);
+  options.socket_path = socket_path;
+  options.threads = 4;
+  options.max_connections = 64;
+  options.custom = custom;
+  generator_error_t err;
+  server = server_create(&options, &err);
+  TEST_ASSERT_EQUAL_INT(GEN_SUCCESS, err);
+  TEST_ASSERT_NOT_NULL(server);
+  TEST_ASSERT_EQUAL_INT(0, pthread_create(&runner, NULL, run_server, NULL));
+}
+
+void tearDown(void) {
+  server_stop(server);
+  pthread_join(runner, NULL);
+  TEST_ASSERT_EQUAL_INT(GEN_SUCCESS, run_result);
+  server_destroy(server);
+  policy_set_free(custom);
+  TEST_ASSERT_TRUE(access(socket_path, F_OK) != 0);
+}
+
+// -1 when the server can't be reached
+static int open_client(void) {
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  struct sockaddr_un address = {.sun_family = AF_UNIX};
+  strcpy(address.sun_path, socket_path);
+  if (fd < 0 ||
+      connect(fd, (struct sockaddr *)&address, sizeof(address)) != 0) {
+    if (fd >= 0)
+      close(fd);
+    return -1;
+  }
+  // a test that waits forever is worse than one that fails
+  struct timeval timeout = {5, 0};
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+  return fd;
+}
+
+static int connect_client(void) {
+  int fd = open_client();
+  TEST_ASSERT_TRUE(fd >= 0);
+  return fd;
+}
+
+static bool send_all(int fd, const char *text) {
+  size_t len = strlen(text);
+  while (len > 0) {
+    ssize_t n = write(fd, text, len);
+    if (n <= 0)
+      return false;
+    text += n;
+    len -= (size_t)n;
+  }
+  return true;
+}
+
+static void send_text(int fd, const char *text) {
+  TEST_ASSERT_TRUE(send_all(fd, text));
+}
+
+// read count answer lines into buffer, one after the other. returns the
+// number of lines read before the connection closed
+static int read_lines(int fd, char *buffer, size_t size, int count) {
+  size_t used = 0;
+  int lines = 0;
+  while (lines < count && used + 1 < size) {
+    ssize_t n = read(fd, buffer + used, 1);
+    if (n <= 0)
+      break;
+    lines += buffer[used] == '\n';
+    used++;
+  }
+  buffer[used] = '\0';
+  return lines;
+}
+
+// the n-th line (0-based) of text, in line
+static void nth_line(const char *text, int n, char *line, size_t size) {
+  for (; n > 0 && text; n--) {
+    text = strchr(text, '\n');
+    text = text ? text + 1 : NULL;
+  }
+  TEST_ASSERT_NOT_NULL(text);
+  size_t len = strcspn(text, "\n");
+  TEST_ASSERT_TRUE(len < size);
+  memcpy(line, text, len);
+  line[len] = '\0';
+}
+
+// characters in the json string value of "password" in line
+static size_t password_length(const char *line) {
+  const char *p = strstr(line, "{\"password\":\"");
+  TEST_ASSERT_NOT_NULL(p);
+  size_t length = 0;
+  for (p += strlen("{\"password\":\""); *p != '"'; p++, length++)
+    if (*p == '\\')
+      p++;
+  return length;
+}
+
+// ============================================
+// Requests
+// ============================================
+
+void test_pipelined_requests_are_answered_in_order(void) {
+  int fd = connect_client();
+  send_text(fd, "ping\nanalyze MyS3cur3P@ssw0rd!\r\n\nbogus request\n"
+                "analyze\n");
+  char text[4096], line[2048];
+  TEST_ASSERT_EQUAL_INT(4, read_lines(fd, text, sizeof(text), 4));
+
+  nth_line(text, 0, line, sizeof(line));
+  TEST_ASSERT_EQUAL_STRING("{\"ok\":true}", line);
+  nth_line(text, 1, line, sizeof(line));
+  TEST_ASSERT_NOT_NULL(strstr(line, "{\"length\":17,"));
+  TEST_ASSERT_NOT_NULL(strstr(line, "\"score\":100,"));
+  TEST_ASSERT_NOT_NULL(strstr(line, "\"pattern_penalty\":"));
+  // the password is never echoed back
+  TEST_ASSERT_NULL(strstr(line, "MyS3cur3"));
+  nth_line(text, 2, line, sizeof(line));
+  TEST_ASSERT_EQUAL_STRING("{\"error\":\"unknown request\"}", line);
+  nth_line(text, 3, line, sizeof(line));
+  TEST_ASSERT_NOT_NULL(strstr(line, "\"error\":\"usage: analyze"));
+  close(fd);
+}
+
+void test_policy_requests(void) {
+  int fd = connect_client();
+  send_text(fd, "policy nist password\n"
+                "policy pci-dss Kq7#mZp2!vLx9w\n"
+                "policy corp acmepassword12\n"
+                "policy nope password\n");
+  char text[4096], line[2048];
+  TEST_ASSERT_EQUAL_INT(4, read_lines(fd, text, sizeof(text), 4));
+
+  nth_line(text, 0, line, sizeof(line));
+  TEST_ASSERT_NOT_NULL(strstr(line, "{\"policy\":\"NIST"));
+  TEST_ASSERT_NOT_NULL(strstr(line, "\"passed\":false"));
+  TEST_ASSERT_NOT_NULL(strstr(line, "\"common\""));
+  nth_line(text, 1, line, sizeof(line));
+  TEST_ASSERT_NOT_NULL(strstr(line, "\"passed\":true,\"violations\":[]}"));
+  nth_line(text, 2, line, sizeof(line));
+  TEST_ASSERT_EQUAL_STRING(
+      "{\"policy\":\"corp\",\"passed\":false,\"violations\":[\"banned\"]}",
+      line);
+  nth_line(text, 3, line, sizeof(line));
+  TEST_ASSERT_EQUAL_STRING("{\"error\":\"unknown policy\"}", line);
+  close(fd);
+}
+
+void test_generate_and_compare(void) {
+  int fd = connect_client();
+  send_text(fd, "generate\ngenerate 24\ngenerate 0\n"
+                "compare password1\tpassword2\ncompare nothing\n");
+  char text[4096], line[2048];
+  TEST_ASSERT_EQUAL_INT(5, read_lines(fd, text, sizeof(text), 5));
+
+  nth_line(text, 0, line, sizeof(line));
+  TEST_ASSERT_EQUAL_size_t(16, password_length(line));
+  nth_line(text, 1, line, sizeof(line));
+  TEST_ASSERT_EQUAL_size_t(24, password_length(line));
+  nth_line(text, 2, line, sizeof(line));
+  TEST_ASSERT_NOT_NULL(strstr(line, "\"error\""));
+  nth_line(text, 3, line, sizeof(line));
+  TEST_ASSERT_EQUAL_STRING(
+      "{\"similarity\":0.8889,\"edit_distance\":1,\"too_similar\":true}",
+      line);
+  nth_line(text, 4, line, sizeof(line));
+  TEST_ASSERT_NOT_NULL(strstr(line, "\"error\":\"usage: compare"));
+  close(fd);
+}
+
+// ============================================
+// Connections
+// ============================================
+
+void test_last_request_needs_no_newline(void) {
+  int fd = connect_client();
+  send_text(fd, "ping\nping");
+  shutdown(fd, SHUT_WR);
+  char text[256];
+  TEST_ASSERT_EQUAL_INT(2, read_lines(fd, text, sizeof(text), 3));
+  TEST_ASSERT_EQUAL_STRING("{\"ok\":true}\n{\"ok\":true}\n", text);
+  close(fd);
+}
+
+void test_overlong_request_is_refused(void) {
+  int fd = connect_client();
+  char request[SERVER_MAX_REQUEST + 16];
+  memset(request, 'a', sizeof(request) - 1);
+  memcpy(request, "analyze ", 8);
+  request[sizeof(request) - 1] = '\0';
+  send_text(fd, request);
+  char text[256];
+  TEST_ASSERT_EQUAL_INT(1, read_lines(fd, text, sizeof(text), 2));
+  TEST_ASSERT_EQUAL_STRING("{\"error\":\"request too long\"}\n", text);
+  close(fd);
+}
+
+void test_running_server_is_not_replaced(void) {
+  server_options_t options;
+  init_server_options(&options);
+  options.socket_path = socket_path;
+  generator_error_t err;
+  TEST_ASSERT_NULL(server_create(&options, &err));
+  TEST_ASSERT_EQUAL_INT(GEN_ERROR_FILE_ACCESS, err);
+
+  // and still answers
+  int fd = connect_client();
+  send_text(fd, "ping\n");
+  char text[64];
+  TEST_ASSERT_EQUAL_INT(1, read_lines(fd, text, sizeof(text), 1));
+  close(fd);
+}
+
+// no assertions off the test thread, mismatches are counted instead
+static void *client_thread(void *arg) {
+  int *mismatches = arg;
+  int fd = open_client();
+  if (fd < 0) {
+    *mismatches = REQUESTS_PER_CLIENT;
+    return NULL;
+  }
+  char text[64];
+  for (int i = 0; i < REQUESTS_PER_CLIENT; i++) {
+    if (!send_all(fd, i % 2 ? "ping\n" : "nothing\n") ||
+        read_lines(fd, text, sizeof(text), 1) != 1 ||
+        strcmp(text, i % 2 ? "{\"ok\":true}\n"
+                           : "{\"error\":\"unknown request\"}\n") != 0)
+      (*mismatches)++;
+  }
+  close(fd);
+  return NULL;
+}
+
+void test_concurrent_clients(void) {
+  pthread_t threads[CLIENTS];
+  int mismatches[CLIENTS] = {0};
+  for (int i = 0; i < CLIENTS; i++)
+    TEST_ASSERT_EQUAL_INT(
+        0, pthread_create(&threads[i], NULL, client_thread, &mismatches[i]));
+  for (int i = 0; i < CLIENTS; i++) {
+    pthread_join(threads[i], NULL);
+    TEST_ASSERT_EQUAL_INT(0, mismatches[i]);
+  }
+}
+
+// ============================================
+// HTTP
+// ============================================
+
+void test_http_parse_request(void) {
+  const char *get = "GET /generate?x=1 HTTP/1.1\r\nHost: a\r\n\r\nGET";
+  http_request_t request;
+  TEST_ASSERT_EQUAL_INT(HTTP_COMPLETE,
+                        http_parse_request(get, strlen(get), 4096, &request));
+  TEST_ASSERT_TRUE(http_request_is(&request, "GET", "/generate"));
+  TEST_ASSERT_TRUE(request.keep_alive);
+  TEST_ASSERT_EQUAL_size_t(strlen(get) - 3, request.length);
+
+  const char *post = "POST /analyze HTTP/1.0\r\ncontent-length: 5\r\n"
+                     "Connection: keep-alive\r\n\r\nabcde";
+  for (size_t len = 0; len < strlen(post); len++)
+    TEST_ASSERT_EQUAL_INT(HTTP_INCOMPLETE,
+                          http_parse_request(post, len, 4096, &request));
+  TEST_ASSERT_EQUAL_INT(
+      HTTP_COMPLETE, http_parse_request(post, strlen(post), 4096, &request));
+  TEST_ASSERT_TRUE(request.keep_alive);
+  TEST_ASSERT_EQUAL_size_t(5, request.body_len);
+  TEST_ASSERT_EQUAL_INT(0, memcmp(request.body, "abcde", 5));
+
+  const char *closing = "GET / HTTP/1.1\r\nConnection: close\r\n\r\n";
+  TEST_ASSERT_EQUAL_INT(HTTP_COMPLETE, http_parse_request(
+                                           closing, strlen(closing), 4096,
+                                           &request));
+  TEST_ASSERT_FALSE(request.keep_alive);
+
+  const char *bad[] = {
+      "GET / HTTP/2.0\r\n\r\n",
+      "GET nope HTTP/1.1\r\n\r\n",
+      "POST / HTTP/1.1\r\nContent-Length: x\r\n\r\n",
+      "POST / HTTP/1.1\r\nContent-Length: 1\r\nContent-Length: 2\r\n\r\n",
+      "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n",
+      "GET / HTTP/1.1\r\nno colon\r\n\r\n"};
+  for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++)
+    TEST_ASSERT_EQUAL_INT(
+        HTTP_BAD_REQUEST,
+        http_parse_request(bad[i], strlen(bad[i]), 4096, &request));
+
+  const char *large = "POST / HTTP/1.1\r\nContent-Length: 5000\r\n\r\n";
+  TEST_ASSERT_EQUAL_INT(HTTP_TOO_LARGE, http_parse_request(
+                                            large, strlen(large), 4096,
+                                            &request));
+  char headers[64];
+  memset(headers, 'a', sizeof(headers));
+  TEST_ASSERT_EQUAL_INT(HTTP_TOO_LARGE,
+                        http_parse_request(headers, sizeof(headers), 64,
+                                           &request));
+}
+
+void test_http_json_fields(void) {
+  char password[32], policy[16];
+  http_json_field_t fields[] = {
+      {.name = "password", .value = password, .size = sizeof(password)},
+      {.name = "policy", .value = policy, .size = sizeof(policy)}};
+  const char *body = " { \"other\": [1], \"password\" : \"a\\\"b\\\\c\\u00e9"
+                     "\\ud83d\\ude00\", \"policy\": 12 } ";
+  // nested values are not flat
+  TEST_ASSERT_FALSE(http_json_fields(body, strlen(body), fields, 2));
+
+  body = " { \"other\": null, \"password\" : \"a\\\"b\\\\c\\u00e9"
+         "\\ud83d\\ude00\", \"policy\": 12 } ";
+  TEST_ASSERT_TRUE(http_json_fields(body, strlen(body), fields, 2));
+  TEST_ASSERT_TRUE(fields[0].found && fields[1].found);
+  TEST_ASSERT_EQUAL_STRING("a\"b\\c\xc3\xa9\xf0\x9f\x98\x80", password);
+  TEST_ASSERT_EQUAL_STRING("12", policy);
+
+  TEST_ASSERT_TRUE(http_json_fields("{}", 2, fields, 2));
+  TEST_ASSERT_FALSE(fields[0].found);
+
+  const char *bad[] = {"", "[]", "{\"password\":}", "{\"password\":\"x\"",
+                       "{\"password\":\"x\"} x", "{\"password\":\"\\ud83d\"}",
+                       "{\"policy\":\"seventeen chars..\"}",
+                       "{\"password\":\"p\\u0000ss\"}"};
+  for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++)
+    TEST_ASSERT_FALSE(http_json_fields(bad[i], strlen(bad[i]), fields, 2));
+}
+
+// an http server on a free port next to the line one
+static server_t *http_server;
+static pthread_t http_runner;
+
+static void *run_http_server(void *arg) {
+  (void)arg;
+  server_run(http_server);
+  return NULL;
+}
+
+static int connect_http(void) {
+  server_options_t options;
+  init_server_options(&options);
+  options.protocol = SERVER_HTTP;
+  options.port = 0;
+  options.threads = 2;
+  options.max_connections = 8;
+  options.custom = custom;
+  http_server = server_create(&options, NULL);
+  TEST_ASSERT_NOT_NULL(http_server);
+  TEST_ASSERT_TRUE(server_port(http_server) > 0);
+  TEST_ASSERT_EQUAL_INT(
+      0, pthread_create(&http_runner, NULL, run_http_server, NULL));
+
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  struct sockaddr_in address = {.sin_family = AF_INET,
+                                .sin_port = htons(server_port(http_server)),
+                                .sin_addr.s_addr = htonl(INADDR_LOOPBACK)};
+  TEST_ASSERT_EQUAL_INT(
+      0, connect(fd, (struct sockaddr *)&address, sizeof(address)));
+  struct timeval timeout = {5, 0};
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+  return fd;
+}
+
+static void stop_http(void) {
+  server_stop(http_server);
+  pthread_join(http_runner, NULL);
+  server_destroy(http_server);
+}
+
+// everything the server sends until it closes the connection
+static size_t read_all(int fd, char *buffer, size_t size) {
+  size_t used = 0;
+  ssize_t n;
+  while (used + 1 < size &&
+         (n = read(fd, buffer + used, size - used - 1)) > 0)
+    used += (size_t)n;
+  buffer[used] = '\0';
+  return used;
+}
+
+void test_http_pipelined_requests(void) {
+  int fd = connect_http();
+  const char *body = "{\"policy\":\"corp\",\"password\":\"acme\\u0041\"}";
+  char requests[1024];
+  snprintf(requests, sizeof(requests),
+           "POST /policy HTTP/1.1\r\nContent-Length: %zu\r\n\r\n%s"
+           "GET /generate HTTP/1.1\r\n\r\n"
+           "GET /analyze HTTP/1.1\r\n\r\n"
+           "POST /compare HTTP/1.1\r\nContent-Length: 2\r\n\r\n{}"
+           "GET /nope HTTP/1.1\r\nConnection: close\r\n\r\n"
+           "GET /generate HTTP/1.1\r\n\r\n",
+           strlen(body), body);
+  send_text(fd, requests);
+
+  char text[4096];
+  read_all(fd, text, sizeof(text));
+  close(fd);
+  stop_http();
+
+  const char *expected[] = {
+      "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\n"
+      "Content-Length: 68\r\n\r\n{\"policy\":\"corp\",\"passed\":false,"
+      "\"violations\":[\"too_short\",\"banned\"]}",
+      "HTTP/1.1 200 OK\r\n", "{\"password\":\"",
+      "HTTP/1.1 405 Method Not Allowed\r\n",
+      "HTTP/1.1 400 Bad Request\r\n", "{\"error\":\"expected {\\\"old",
+      "HTTP/1.1 404 Not Found\r\n", "Connection: close\r\n"};
+  const char *p = text;
+  for (size_t i = 0; i < sizeof(expected) / sizeof(expected[0]); i++) {
+    p = strstr(p, expected[i]);
+    TEST_ASSERT_NOT_NULL(p);
+  }
+  // nothing after the request that closed the connection
+  TEST_ASSERT_NULL(strstr(p, "HTTP/1.1"));
+}
+
+void test_http_malformed_request_is_refused(void) {
+  int fd = connect_http();
+  send_text(fd, "GET /generate HTTP/1.1\r\n\r\nHELLO\r\n\r\n");
+  char text[1024];
+  read_all(fd, text, sizeof(text));
+  close(fd);
+  stop_http();
+
+  const char *refusal = strstr(text, "HTTP/1.1 400 Bad Request\r\n");
+  TEST_ASSERT_NOT_NULL(refusal);
+  TEST_ASSERT_NOT_NULL(strstr(refusal, "Connection: close\r\n"));
+  TEST_ASSERT_TRUE(strncmp(text, "HTTP/1.1 200 OK", 15) == 0);
+}
+
+void test_http_embedded_nul_is_refused(void) {
+  // decoded to a C string only "p" would be analyzed
+  int fd = connect_http();
+  const char *body = "{\"password\":\"p\\u0000ssw0rd\"}";
+  char request[256];
+  snprintf(request, sizeof(request),
+           "POST /analyze HTTP/1.1\r\nContent-Length: %zu\r\n"
+           "Connection: close\r\n\r\n%s",
+           strlen(body), body);
+  send_text(fd, request);
+  char text[1024];
+  read_all(fd, text, sizeof(text));
+  close(fd);
+  stop_http();
+
+  TEST_ASSERT_TRUE(strncmp(text, "HTTP/1.1 400 Bad Request\r\n", 26) == 0);
+  TEST_ASSERT_NULL(strstr(text, "\"length\":"));
+}
+
+void test_invalid_options(void) {
+  generator_error_t err;
+  TEST_ASSERT_NULL(server_create(NULL, &err));
+  TEST_ASSERT_EQUAL_INT(GEN_ERROR_NULL_POINTER, err);
+
+  server_options_t options;
+  init_server_options(&options);
+  TEST_ASSERT_NULL(server_create(&options, &err));
+  options.socket_path = socket_path;
+  options.threads = -1;
+  TEST_ASSERT_NULL(server_create(&options, &err));
+  TEST_ASSERT_EQUAL_INT(GEN_ERROR_INVALID_CONFIG, err);
+}
+
+int main(void) {
+  init_generator("./data");
+  UNITY_BEGIN();
+
+  RUN_TEST(test_pipelined_requests_are_answered_in_order);
+  RUN_TEST(test_policy_requests);
+  RUN_TEST(test_generate_and_compare);
+  RUN_TEST(test_last_request_needs_no_newline);
+  RUN_TEST(test_overlong_request_is_refused);
+  RUN_TEST(test_running_server_is_not_replaced);
+  RUN_TEST(test_concurrent_clients);
+  RUN_TEST(test_http_parse_request);
+  RUN_TEST(test_http_json_fields);
+  RUN_TEST(test_http_pipelined_requests);
+  RUN_TEST(test_http_malformed_request_is_refused);
+  RUN_TEST(test_http_embedded_nul_is_refused);
+  RUN_TEST(test_invalid_options);
+
+  int failures = UNITY_END();
+  cleanup_generator();
+  return failures;
+}
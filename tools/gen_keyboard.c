@@ -0,0 +1,245 @@
+// generates keyboard_layouts.h: per-layout byte -> key and key -> neighbour
+// tables used by src/keyboard.c. run by cmake at build time:
+//   gen_keyboard <output header>
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_ROWS 5
+#define MAX_KEYS 64
+#define DIRECTIONS 8
+
+// keys are placed on a grid in quarter-key units, each row starts at its
+// physical offset. keys one row apart touch when their centers are less
+// than a key apart (staggered layouts) or at most a key apart (grid
+// layouts, where diagonal neighbours count too)
+typedef struct {
+  const char *unshifted;
+  const char *shifted; // NULL when the row has no shift level
+  int offset;
+} row_t;
+
+typedef struct {
+  const char *name;
+  bool grid;
+  row_t rows[MAX_ROWS];
+} layout_t;
+
+// "·" marks a key position without an ascii character on that level
+static const layout_t layouts[] = {
+    {"qwerty",
+     false,
+     {{"`1234567890-=", "~!@#$%^&*()_+", 0},
+      {"qwertyuiop[]\\", "QWERTYUIOP{}|", 6},
+      {"asdfghjkl;'", "ASDFGHJKL:\"", 7},
+      {"zxcvbnm,./", "ZXCVBNM<>?", 9},
+      {NULL, NULL, 0}}},
+    {"azerty",
+     false,
+     {{"²&é\"'(-è_çà)=", "·1234567890°+", 0},
+      {"azertyuiop^$", "AZERTYUIOP¨£", 6},
+      {"qsdfghjklmù*", "QSDFGHJKLM%µ", 7},
+      {"<wxcvbn,;:!", ">WXCVBN?./§", 5},
+      {NULL, NULL, 0}}},
+    {"qwertz",
+     false,
+     {{"^1234567890ß´", "°!\"§$%&/()=?`", 0},
+      {"qwertzuiopü+", "QWERTZUIOPÜ*", 6},
+      {"asdfghjklöä#", "ASDFGHJKLÖÄ'", 7},
+      {"<yxcvbnm,.-", ">YXCVBNM;:_", 5},
+      {NULL, NULL, 0}}},
+    {"dvorak",
+     false,
+     {{"`1234567890[]", "~!@#$%^&*(){}", 0},
+      {"',.pyfgcrl/=\\", "\"<>PYFGCRL?+|", 6},
+      {"aoeuidhtns-", "AOEUIDHTNS_", 7},
+      {";qjkxbmwvz", ":QJKXBMWVZ", 9},
+      {NULL, NULL, 0}}},
+    {"keypad",
+     true,
+     {{"/*-", NULL, 4},
+      {"789+", NULL, 0},
+      {"456", NULL, 0},
+      {"123", NULL, 0},
+      {"0·.", NULL, 0}}},
+};
+
+#define LAYOUT_COUNT ((int)(sizeof(layouts) / sizeof(layouts[0])))
+
+typedef struct {
+  int row;
+  int x;
+  unsigned char plain;   // 0 when the position has no ascii character
+  unsigned char shifted; // 0 when the position has no ascii character
+} key_pos_t;
+
+// split a utf-8 row into one entry per key, non-ascii keys become 0
+static int split_row(const char *row, unsigned char *out) {
+  int count = 0;
+  for (const unsigned char *p = (const unsigned char *)row; *p;) {
+    if (*p < 0x80) {
+      out[count++] = *p++;
+      continue;
+    }
+    out[count++] = 0;
+    p++;
+    while ((*p & 0xC0) == 0x80)
+      p++;
+  }
+  return count;
+}
+
+// direction slot from key a to key b, -1 if they don't touch
+static int direction(const layout_t *layout, const key_pos_t *a,
+                     const key_pos_t *b) {
+  int dr = b->row - a->row;
+  int dx = b->x - a->x;
+
+  if (dr == 0)
+    return dx == -4 ? 0 : dx == 4 ? 1 : -1;
+  if (dr != -1 && dr != 1)
+    return -1;
+
+  bool touches = layout->grid ? abs(dx) <= 4 : abs(dx) < 4;
+  if (!touches)
+    return -1;
+
+  // 2-4 above (left, straight, right), 5-7 below
+  int column = dx < 0 ? 0 : dx == 0 ? 1 : 2;
+  return (dr < 0 ? 2 : 5) + column;
+}
+
+static int emit_layout(FILE *out, int index, const layout_t *layout,
+                       unsigned char keys_by_byte[256], double *degree) {
+  key_pos_t keys[MAX_KEYS];
+  int key_count = 0;
+
+  for (int r = 0; r < MAX_ROWS && layout->rows[r].unshifted; r++) {
+    unsigned char plain[MAX_KEYS];
+    unsigned char shifted[MAX_KEYS];
+    int n = split_row(layout->rows[r].unshifted, plain);
+    if (layout->rows[r].shifted &&
+        split_row(layout->rows[r].shifted, shifted) != n) {
+      fprintf(stderr, "%s: row %d shift level has a different length\n",
+              layout->name, r);
+      exit(1);
+    }
+    for (int k = 0; k < n; k++) {
+      if (key_count >= MAX_KEYS) {
+        fprintf(stderr, "%s: too many keys\n", layout->name);
+        exit(1);
+      }
+      keys[key_count].row = r;
+      keys[key_count].x = layout->rows[r].offset + k * 4;
+      keys[key_count].plain = plain[k];
+      keys[key_count].shifted = layout->rows[r].shifted ? shifted[k] : 0;
+      key_count++;
+    }
+  }
+
+  // byte -> key id + 1, high bit set for the shifted level
+  memset(keys_by_byte, 0, 256);
+  for (int k = key_count - 1; k >= 0; k--) {
+    if (keys[k].plain)
+      keys_by_byte[keys[k].plain] = (unsigned char)(k + 1);
+    if (keys[k].shifted)
+      keys_by_byte[keys[k].shifted] = (unsigned char)((k + 1) | 0x80);
+  }
+
+  fprintf(out, "    // %s\n    {", layout->name);
+  int edges = 0;
+  int characters = 0;
+  for (int a = 0; a < key_count; a++) {
+    int neighbors[DIRECTIONS] = {0};
+    for (int b = 0; b < key_count; b++) {
+      if (a == b)
+        continue;
+      int d = direction(layout, &keys[a], &keys[b]);
+      if (d >= 0)
+        neighbors[d] = b + 1;
+    }
+    fprintf(out, "%s{", a == 0 ? "" : ",\n     ");
+    for (int d = 0; d < DIRECTIONS; d++) {
+      fprintf(out, "%s%d", d == 0 ? "" : ", ", neighbors[d]);
+      edges += neighbors[d] != 0;
+    }
+    fprintf(out, "}");
+    characters += (keys[a].plain != 0) + (keys[a].shifted != 0);
+  }
+  fprintf(out, "}%s\n", index == LAYOUT_COUNT - 1 ? "" : ",");
+
+  *degree = (double)edges / key_count;
+  return characters;
+}
+
+int main(int argc, char *argv[]) {
+  if (argc != 2) {
+    fprintf(stderr, "usage: %s <output header>\n", argv[0]);
+    return 1;
+  }
+
+  FILE *out = fopen(argv[1], "w");
+  if (!out) {
+    perror(argv[1]);
+    return 1;
+  }
+
+  unsigned char keys_by_byte[LAYOUT_COUNT][256];
+  int characters[LAYOUT_COUNT];
+  double degrees[LAYOUT_COUNT];
+
+  fprintf(out, "// generated by tools/gen_keyboard.c, do not edit\n");
+  fprintf(out, "#ifndef KEYBOARD_LAYOUTS_H\n#define KEYBOARD_LAYOUTS_H\n\n");
+  fprintf(out, "#define KEYBOARD_LAYOUT_COUNT %d\n", LAYOUT_COUNT);
+  fprintf(out, "#define KEYBOARD_MAX_KEYS %d\n", MAX_KEYS);
+  fprintf(out, "#define KEYBOARD_DIRECTIONS %d\n\n", DIRECTIONS);
+
+  fprintf(out, "// neighbour key id + 1 per direction: left, right, up-left, "
+               "up,\n// up-right, down-left, down, down-right\n");
+  fprintf(out, "static const unsigned char keyboard_neighbors"
+               "[KEYBOARD_LAYOUT_COUNT][KEYBOARD_MAX_KEYS]"
+               "[KEYBOARD_DIRECTIONS] = {\n");
+  for (int l = 0; l < LAYOUT_COUNT; l++)
+    characters[l] =
+        emit_layout(out, l, &layouts[l], keys_by_byte[l], &degrees[l]);
+  fprintf(out, "};\n\n");
+
+  fprintf(out, "// byte -> key id + 1 (0 = not on the layout), high bit = "
+               "shifted\n");
+  fprintf(out, "static const unsigned char keyboard_keys"
+               "[KEYBOARD_LAYOUT_COUNT][256] = {\n");
+  for (int l = 0; l < LAYOUT_COUNT; l++) {
+    fprintf(out, "    {");
+    for (int c = 0; c < 256; c++)
+      fprintf(out, "%s%d", c == 0 ? "" : c % 16 == 0 ? ",\n     " : ", ",
+              keys_by_byte[l][c]);
+    fprintf(out, "}%s\n", l == LAYOUT_COUNT - 1 ? "" : ",");
+  }
+  fprintf(out, "};\n\n");
+
+  fprintf(out, "static const char *const keyboard_layout_names"
+               "[KEYBOARD_LAYOUT_COUNT] = {");
+  for (int l = 0; l < LAYOUT_COUNT; l++)
+    fprintf(out, "%s\"%s\"", l == 0 ? "" : ", ", layouts[l].name);
+  fprintf(out, "};\n\n");
+
+  // guess estimation inputs: typeable characters and average neighbours
+  fprintf(out, "static const double keyboard_starting_positions"
+               "[KEYBOARD_LAYOUT_COUNT] = {");
+  for (int l = 0; l < LAYOUT_COUNT; l++)
+    fprintf(out, "%s%d.0", l == 0 ? "" : ", ", characters[l]);
+  fprintf(out, "};\n");
+  fprintf(out, "static const double keyboard_average_degree"
+               "[KEYBOARD_LAYOUT_COUNT] = {");
+  for (int l = 0; l < LAYOUT_COUNT; l++)
+    fprintf(out, "%s%.4f", l == 0 ? "" : ", ", degrees[l]);
+  fprintf(out, "};\n\n#endif\n");
+
+  if (fclose(out) != 0) {
+    perror(argv[1]);
+    return 1;
+  }
+  return 0;
+}
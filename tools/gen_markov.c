@@ -0,0 +1,187 @@
+// generates markov_model.h: an order-2 letter model for the pronounceable
+// password generator in src/markov.c. run by cmake at build time:
+//   gen_markov <word list> <output header>
+// every line that is 3 or more ascii letters trains the model once, other
+// lines are skipped, as are keyboard walks and runs of one letter that a
+// password list is full of
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LETTERS 26
+// context symbols: 0 = before the first letter, 1..26 = a..z
+#define SYMBOLS (LETTERS + 1)
+#define CONTEXTS (SYMBOLS * SYMBOLS)
+// every row of the table sums to this, a power of two so sampling a row
+// never rejects
+#define TOTAL 4096
+#define MAX_LINE 256
+
+static uint64_t counts2[SYMBOLS][SYMBOLS][LETTERS];
+static uint64_t counts1[SYMBOLS][LETTERS];
+static uint64_t counts0[LETTERS];
+
+// the alphabet counts as a row too, "abcd" is as typed as "asdf"
+static const char *const keyboard_rows[] = {
+    "qwertyuiop", "asdfghjkl", "zxcvbnm", "abcdefghijklmnopqrstuvwxyz", NULL};
+
+// four keys along a row (either direction) or three of one letter
+static bool looks_typed(const char *word, size_t len) {
+  for (size_t i = 0; i + 2 < len; i++)
+    if (word[i] == word[i + 1] && word[i] == word[i + 2])
+      return true;
+
+  for (size_t i = 0; i + 3 < len; i++) {
+    for (int r = 0; keyboard_rows[r]; r++) {
+      const char *row = keyboard_rows[r];
+      const char *at = strchr(row, word[i]);
+      if (!at)
+        continue;
+      size_t pos = (size_t)(at - row), row_len = strlen(row);
+      bool forward = pos + 3 < row_len, backward = pos >= 3;
+      for (size_t k = 1; k < 4; k++) {
+        forward = forward && row[pos + k] == word[i + k];
+        backward = backward && row[pos - k] == word[i + k];
+      }
+      if (forward || backward)
+        return true;
+    }
+  }
+  return false;
+}
+
+static void train(const char *word, size_t len) {
+  int a = 0, b = 0;
+  for (size_t i = 0; i < len; i++) {
+    int next = word[i] - 'a';
+    counts2[a][b][next]++;
+    counts1[b][next]++;
+    counts0[next]++;
+    a = b;
+    b = next + 1;
+  }
+}
+
+// scale counts to sum to TOTAL, every seen transition keeps at least 1
+static void quantize(const uint64_t *counts, uint16_t *out) {
+  uint64_t total = 0;
+  for (int i = 0; i < LETTERS; i++)
+    total += counts[i];
+
+  long sum = 0;
+  for (int i = 0; i < LETTERS; i++) {
+    long q = counts[i] ? (long)(counts[i] * TOTAL / total) : 0;
+    if (counts[i] && q == 0)
+      q = 1;
+    out[i] = (uint16_t)q;
+    sum += q;
+  }
+
+  // rounding leftovers go to (or come from) the most likely letter
+  while (sum != TOTAL) {
+    int max = 0;
+    for (int i = 1; i < LETTERS; i++)
+      if (out[i] > out[max])
+        max = i;
+    long step = TOTAL - sum;
+    if (step < 0 && out[max] + step < 1)
+      step = 1 - out[max];
+    out[max] = (uint16_t)(out[max] + step);
+    sum += step;
+  }
+}
+
+static bool any(const uint64_t *counts) {
+  for (int i = 0; i < LETTERS; i++)
+    if (counts[i])
+      return true;
+  return false;
+}
+
+int main(int argc, char *argv[]) {
+  if (argc != 3) {
+    fprintf(stderr, "usage: %s <word list> <output header>\n", argv[0]);
+    return 1;
+  }
+
+  FILE *in = fopen(argv[1], "r");
+  if (!in) {
+    perror(argv[1]);
+    return 1;
+  }
+
+  char line[MAX_LINE];
+  long words = 0;
+  while (fgets(line, sizeof(line), in)) {
+    size_t len = strcspn(line, "\r\n");
+    line[len] = '\0';
+    bool letters = len >= 3;
+    for (size_t i = 0; i < len && letters; i++) {
+      if (line[i] >= 'A' && line[i] <= 'Z')
+        line[i] = (char)(line[i] - 'A' + 'a');
+      letters = line[i] >= 'a' && line[i] <= 'z';
+    }
+    if (!letters || looks_typed(line, len))
+      continue;
+    train(line, len);
+    words++;
+  }
+  fclose(in);
+
+  if (words == 0) {
+    fprintf(stderr, "%s: no usable words\n", argv[1]);
+    return 1;
+  }
+
+  FILE *out = fopen(argv[2], "w");
+  if (!out) {
+    perror(argv[2]);
+    return 1;
+  }
+
+  fprintf(out, "// generated by tools/gen_markov.c from %ld words, do not "
+               "edit\n",
+          words);
+  fprintf(out, "#ifndef MARKOV_MODEL_H\n#define MARKOV_MODEL_H\n\n");
+  fprintf(out, "#include <stdint.h>\n\n");
+  fprintf(out, "#define MARKOV_LETTERS %d\n", LETTERS);
+  fprintf(out, "#define MARKOV_SYMBOLS %d\n", SYMBOLS);
+  fprintf(out, "#define MARKOV_TOTAL %d\n\n", TOTAL);
+
+  // contexts never followed by a letter in training fall back to the
+  // last letter alone, then to plain letter frequencies
+  fprintf(out, "// cumulative frequencies of the next letter per context "
+               "(two previous\n// symbols, 0 = start), row [a * "
+               "MARKOV_SYMBOLS + b] ends at MARKOV_TOTAL\n");
+  fprintf(out, "static const uint16_t markov_cumulative"
+               "[MARKOV_SYMBOLS * MARKOV_SYMBOLS][MARKOV_LETTERS] = {\n");
+  for (int ctx = 0; ctx < CONTEXTS; ctx++) {
+    int a = ctx / SYMBOLS, b = ctx % SYMBOLS;
+    const uint64_t *counts = counts0;
+    if (any(counts2[a][b]))
+      counts = counts2[a][b];
+    else if (any(counts1[b]))
+      counts = counts1[b];
+    uint16_t freq[LETTERS];
+    quantize(counts, freq);
+
+    fprintf(out, "    {");
+    unsigned cumulative = 0;
+    for (int i = 0; i < LETTERS; i++) {
+      cumulative += freq[i];
+      fprintf(out, "%s%u", i == 0 ? "" : i == 13 ? ",\n     " : ", ",
+              cumulative);
+    }
+    fprintf(out, "}%s\n", ctx == CONTEXTS - 1 ? "" : ",");
+  }
+  fprintf(out, "};\n\n#endif\n");
+
+  if (fclose(out) != 0) {
+    perror(argv[2]);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,92 @@
+#!/usr/bin/env python3
+# generates src/unicode_table.h: sorted code point ranges with the class the
+# analyzer cares about (cased/caseless letter, digit, mark, space). anything
+# not covered by a range is a symbol. uses the unicode database bundled with
+# python, rerun when moving to a newer python to pick up a newer unicode:
+#   python3 tools/gen_unicode_table.py > src/unicode_table.h
+
+import sys
+import unicodedata
+
+# single letters of alternating case (latin extended, cyrillic, greek) are
+# folded into one range so the table stays small
+KINDS = ["UNI_LOWER", "UNI_UPPER", "UNI_LETTER", "UNI_DIGIT", "UNI_MARK",
+         "UNI_SPACE", "UNI_UPPER_LOWER", "UNI_LOWER_UPPER"]
+
+
+def kind(cp):
+    category = unicodedata.category(chr(cp))
+    if category == "Ll":
+        return "UNI_LOWER"
+    if category in ("Lu", "Lt"):
+        return "UNI_UPPER"
+    if category in ("Lo", "Lm"):
+        return "UNI_LETTER"
+    if category == "Nd":
+        return "UNI_DIGIT"
+    if category[0] == "M":
+        return "UNI_MARK"
+    if category in ("Zs", "Zl", "Zp"):
+        return "UNI_SPACE"
+    return None
+
+
+def alternation(first):
+    return "UNI_UPPER_LOWER" if first == "UNI_UPPER" else "UNI_LOWER_UPPER"
+
+
+def expected(range_kind, offset):
+    upper_first = range_kind == "UNI_UPPER_LOWER"
+    return "UNI_UPPER" if (offset % 2 == 0) == upper_first else "UNI_LOWER"
+
+
+def build():
+    ranges = []
+    for cp in range(0x80, 0x110000):
+        k = kind(cp)
+        if k is None:
+            continue
+        if ranges and ranges[-1][1] == cp - 1:
+            last = ranges[-1]
+            if last[2] == k:
+                last[1] = cp
+                continue
+            cased = ("UNI_LOWER", "UNI_UPPER")
+            if k in cased and last[2] in cased and last[0] == last[1]:
+                last[1] = cp
+                last[2] = alternation(last[2])
+                continue
+            if (k in cased and last[2] in KINDS[6:] and
+                    expected(last[2], cp - last[0]) == k):
+                last[1] = cp
+                continue
+        ranges.append([cp, cp, k])
+    return ranges
+
+
+def main():
+    ranges = build()
+    out = sys.stdout
+    out.write("// generated by tools/gen_unicode_table.py from unicode %s, "
+              "do not edit\n" % unicodedata.unidata_version)
+    out.write("#ifndef UNICODE_TABLE_H\n#define UNICODE_TABLE_H\n\n")
+    out.write("#include <stdint.h>\n\n")
+    out.write("typedef enum {\n")
+    for i, k in enumerate(KINDS):
+        out.write("  %s%s\n" % (k, "," if i < len(KINDS) - 1 else ""))
+    out.write("} unicode_kind_t;\n\n")
+    out.write("// first code point, number of code points - 1, kind\n")
+    out.write("typedef struct {\n  uint32_t first;\n  uint16_t extra;\n"
+              "  uint8_t kind;\n} unicode_range_t;\n\n")
+    out.write("#define UNICODE_RANGE_COUNT %d\n\n" % len(ranges))
+    out.write("static const unicode_range_t unicode_ranges"
+              "[UNICODE_RANGE_COUNT] = {\n")
+    for i, (first, last, k) in enumerate(ranges):
+        assert last - first < 0x10000
+        out.write("    {0x%05X, %d, %s}%s\n" %
+                  (first, last - first, k, "," if i < len(ranges) - 1 else ""))
+    out.write("};\n\n#endif\n")
+
+
+if __name__ == "__main__":
+    main()